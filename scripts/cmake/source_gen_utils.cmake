@@ -165,6 +165,36 @@ function(generate_labels_code)
 endfunction()
 
 
+##############################################################################
+# This function generates C++ file with the audio front end tables (windows,
+# DCT matrices and mel filter banks) of the known use case configurations.
+# @param[in]    DESTINATION     directory in which the output cc must be
+#                               placed
+# @param[in]    OUTPUT_FILENAME name of the output file, without extension
+# NOTE: Uses python
+##############################################################################
+function(generate_dsp_tables_code)
+
+    set(oneValueArgs DESTINATION OUTPUT_FILENAME)
+    cmake_parse_arguments(PARSED "" "${oneValueArgs}" "" ${ARGN} )
+
+    # Absolute paths for passing into python script
+    get_filename_component(dest_abs ${PARSED_DESTINATION} ABSOLUTE)
+    file(MAKE_DIRECTORY ${dest_abs})
+
+    message(STATUS "Generating DSP tables to ${dest_abs}/${PARSED_OUTPUT_FILENAME}.cc")
+    execute_process(
+        COMMAND ${PYTHON} ${MLEK_SCRIPTS_DIR}/py/gen_dsp_tables_cpp.py
+        --source_folder_path ${dest_abs}
+        --output_file_name ${PARSED_OUTPUT_FILENAME}
+        RESULT_VARIABLE return_code
+    )
+    if (NOT return_code EQUAL "0")
+        message(FATAL_ERROR "Failed to generate DSP tables.")
+    endif ()
+endfunction()
+
+
 ##############################################################################
 # This function generates C++ data files for test located in the directory it is
 # pointed at.
@@ -0,0 +1,295 @@
+#!env/bin/python3
+
+#  SPDX-FileCopyrightText:  Copyright 2024 Arm Limited and/or its affiliates <open-source-office@arm.com>
+#  SPDX-License-Identifier: Apache-2.0
+#
+#  Licensed under the Apache License, Version 2.0 (the "License");
+#  you may not use this file except in compliance with the License.
+#  You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+#  Unless required by applicable law or agreed to in writing, software
+#  distributed under the License is distributed on an "AS IS" BASIS,
+#  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#  See the License for the specific language governing permissions and
+#  limitations under the License.
+
+"""
+Utility script to generate the audio front end tables (windows, DCT matrices
+and mel filter banks) of the known use case configurations as constant arrays.
+The arrays are placed in read-only memory and picked up at run time by the MFCC,
+mel spectrogram and RNNoise front ends instead of building them on the target.
+Configurations without generated tables are still built at run time.
+
+The computations follow the single precision arithmetic of the C++ code so
+that the tables match the ones built at run time.
+"""
+from argparse import ArgumentParser
+from dataclasses import dataclass
+from pathlib import Path
+
+import numpy as np
+from jinja2 import Environment, FileSystemLoader
+
+from gen_utils import GenUtils
+
+F32 = np.float32
+
+# Slaney mel scale constants, as in MelFilterBank.
+LOG_STEP = F32(1.8562979903656 / 27.0)
+FREQ_STEP = F32(200.0 / 3)
+MIN_LOG_HZ = F32(1000.0)
+MIN_LOG_MEL = F32(MIN_LOG_HZ / FREQ_STEP)
+
+
+@dataclass
+class FrontEndConfig:
+    """
+    Front end configuration; mirrors the defaults of the use case API classes.
+    """
+    name: str
+    kind: str
+    sampling_freq: int
+    num_fbank_bins: int
+    mel_lo_freq: int
+    mel_hi_freq: int
+    use_htk_method: bool
+    frame_len: int
+    num_mfcc_features: int
+
+
+@dataclass
+class RNNoiseConfig:
+    """
+    RNNoise feature processor configuration.
+    """
+    name: str
+    frame_size: int
+    num_bands: int
+
+
+FRONT_ENDS = [
+    # MicroNetKwsMFCC, kws and kws_asr use cases.
+    FrontEndConfig("MicroNetKws", "Mfcc", 16000, 40, 20, 4000, True, 640, 10),
+    # Wav2LetterMFCC, asr and kws_asr use cases.
+    FrontEndConfig("Wav2Letter", "Wav2LetterMfcc", 16000, 128, 0, 8000, False, 512, 13),
+    # AdMelSpectrogram, ad use case.
+    FrontEndConfig("Ad", "AdMelSpectrogram", 16000, 64, 0, 8000, False, 1024, 0),
+]
+
+RNNOISE = [
+    RNNoiseConfig("RNNoise", 512, 22),
+]
+
+parser = ArgumentParser()
+
+parser.add_argument(
+    "--source_folder_path",
+    type=str,
+    help="path to source folder to be generated.",
+    required=True
+)
+
+parser.add_argument(
+    "--output_file_name",
+    type=str,
+    help="Required output file name",
+    default="DspTablesData"
+)
+
+parser.add_argument(
+    "--license_template",
+    type=str,
+    help="Header template file",
+    default="header_template.txt"
+)
+
+parsed_args = parser.parse_args()
+
+env = Environment(loader=FileSystemLoader(Path(__file__).parent / 'templates'),
+                  trim_blocks=True,
+                  lstrip_blocks=True)
+
+
+def mel_scale(freq, use_htk_method):
+    """
+    Frequency to mel, as MelFilterBank::MelScale.
+    """
+    if use_htk_method:
+        return F32(F32(1127.0) * np.log(F32(1.0) + freq / F32(700.0)))
+    mel = F32(freq / FREQ_STEP)
+    if freq >= MIN_LOG_HZ:
+        mel = F32(MIN_LOG_MEL + np.log(F32(freq / MIN_LOG_HZ)) / LOG_STEP)
+    return mel
+
+
+def inverse_mel_scale(mel, use_htk_method):
+    """
+    Mel to frequency, as MelFilterBank::InverseMelScale.
+    """
+    if use_htk_method:
+        return F32(F32(700.0) * (np.exp(F32(mel / F32(1127.0))) - F32(1.0)))
+    freq = F32(FREQ_STEP * mel)
+    if mel >= MIN_LOG_MEL:
+        freq = F32(MIN_LOG_HZ * np.exp(F32(LOG_STEP * F32(mel - MIN_LOG_MEL))))
+    return freq
+
+
+def frame_len_padded(frame_len):
+    """
+    Smallest power of 2 >= frame length.
+    """
+    return 1 << (frame_len - 1).bit_length()
+
+
+def hann_window(frame_len):
+    """
+    Window of MFCC and MelSpectrogram.
+    """
+    multiplier = F32(2 * np.pi / frame_len)
+    return [F32(0.5 - 0.5 * float(np.cos(F32(F32(i) * multiplier))))
+            for i in range(frame_len)]
+
+
+def mel_filter_bank(cfg: FrontEndConfig):
+    """
+    Packed mel filter bank, as the MelFilterBank constructor.
+    @return:    weights, offsets and first bins
+    """
+    padded = frame_len_padded(cfg.frame_len)
+    num_fft_bins = padded // 2
+    fft_bin_width = F32(F32(cfg.sampling_freq) / F32(padded))
+    mel_low = mel_scale(F32(cfg.mel_lo_freq), cfg.use_htk_method)
+    mel_high = mel_scale(F32(cfg.mel_hi_freq), cfg.use_htk_method)
+    mel_delta = F32((mel_high - mel_low) / F32(cfg.num_fbank_bins + 1))
+    mel_points = [F32(mel_low + F32(i) * mel_delta) for i in range(cfg.num_fbank_bins + 2)]
+    bin_mel = [mel_scale(F32(fft_bin_width * F32(i)), cfg.use_htk_method) for i in range(num_fft_bins)]
+
+    weights, offsets, first_bins = [], [0], []
+    for bank in range(cfg.num_fbank_bins):
+        left, center, right = mel_points[bank], mel_points[bank + 1], mel_points[bank + 2]
+        normaliser = F32(1.0)
+        if cfg.kind != "Mfcc":
+            normaliser = F32(F32(2.0) / (inverse_mel_scale(right, cfg.use_htk_method) -
+                                         inverse_mel_scale(left, cfg.use_htk_method)))
+
+        bins = [i for i in range(num_fft_bins) if left < bin_mel[i] < right]
+        first_bins.append(bins[0] if bins else 0)
+        for i in bins:
+            mel = bin_mel[i]
+            if mel <= center:
+                weight = F32((mel - left) / (center - left))
+            else:
+                weight = F32((right - mel) / (right - center))
+            weights.append(F32(weight * normaliser))
+        offsets.append(len(weights))
+    return weights, offsets, first_bins
+
+
+def dct_matrix(cfg: FrontEndConfig):
+    """
+    DCT matrix, as MFCC::CreateDCTMatrix and Wav2LetterMFCC::CreateDCTMatrix.
+    """
+    n_in = cfg.num_fbank_bins
+    angle_incr = F32(np.pi / n_in)
+    matrix = []
+    if cfg.kind == "Wav2LetterMfcc":
+        normaliser_k0 = F32(2 * np.sqrt(F32(F32(1.0) / F32(4 * n_in))))
+        normaliser = F32(2 * np.sqrt(F32(F32(1.0) / F32(2 * n_in))))
+        matrix.extend([normaliser_k0] * n_in)
+        angle = angle_incr
+        first_row = 1
+    else:
+        normaliser = F32(np.sqrt(F32(F32(2.0) / F32(n_in))))
+        angle = F32(0)
+        first_row = 0
+
+    for _ in range(first_row, cfg.num_mfcc_features):
+        matrix.extend(F32(normaliser * np.cos(F32((F32(n) + F32(0.5)) * angle)))
+                      for n in range(n_in))
+        angle = F32(angle + angle_incr)
+    return matrix
+
+
+def rnnoise_tables(cfg: RNNoiseConfig):
+    """
+    Half window and band DCT, as RNNoiseFeatureProcessor::InitTables.
+    """
+    pi = F32(np.pi)
+    half_pi = F32(np.pi / 2)
+    half_pi_over_frame = F32(half_pi / F32(cfg.frame_size))
+    half_window = []
+    for i in range(cfg.frame_size):
+        sin_val = F32(np.sin(F32(half_pi_over_frame * F32(F32(i) + F32(0.5)))))
+        half_window.append(F32(np.sin(F32(F32(half_pi * sin_val) * sin_val))))
+
+    dct = []
+    for i in range(cfg.num_bands):
+        for j in range(cfg.num_bands):
+            dct.append(F32(np.cos(F32(F32(F32(F32(i) + F32(0.5)) * F32(j)) * pi) / F32(cfg.num_bands))))
+        dct[i * cfg.num_bands] = F32(dct[i * cfg.num_bands] * np.sqrt(F32(0.5)))
+    return half_window, dct
+
+
+def to_literals(values, fmt, per_line=8):
+    """
+    Format values as C++ initialiser lines.
+    """
+    literals = [fmt(v) for v in values]
+    return [", ".join(literals[i:i + per_line]) for i in range(0, len(literals), per_line)]
+
+
+def float_literals(values):
+    """
+    Single precision literals that round trip.
+    """
+    return to_literals(values, lambda v: f"{float(v):.9e}f", 6)
+
+
+def uint_literals(values):
+    """
+    Unsigned integer literals.
+    """
+    return to_literals(values, lambda v: f"{int(v)}u", 12)
+
+
+def main(args):
+    """
+    Generate DSP tables .cc
+    @param args:    Parsed args
+    """
+    front_ends = []
+    for cfg in FRONT_ENDS:
+        weights, offsets, first_bins = mel_filter_bank(cfg)
+        front_ends.append({
+            "cfg": cfg,
+            "frame_len_padded": frame_len_padded(cfg.frame_len),
+            "window": float_literals(hann_window(cfg.frame_len)),
+            "dct": float_literals(dct_matrix(cfg)) if cfg.num_mfcc_features else [],
+            "dct_size": cfg.num_mfcc_features * cfg.num_fbank_bins,
+            "mel_weights": float_literals(weights),
+            "mel_weights_size": len(weights),
+            "mel_offsets": uint_literals(offsets),
+            "mel_first_bins": uint_literals(first_bins),
+        })
+
+    rnnoise = []
+    for cfg in RNNOISE:
+        half_window, dct = rnnoise_tables(cfg)
+        rnnoise.append({
+            "cfg": cfg,
+            "half_window": float_literals(half_window),
+            "dct": float_literals(dct),
+        })
+
+    hdr = GenUtils.gen_header(env, args.license_template, Path(__file__).name)
+    cc_filename = Path(args.source_folder_path) / (args.output_file_name + ".cc")
+    env.get_template('dsp_tables/DspTables.cc.template').stream(common_template_header=hdr,
+                                                               front_ends=front_ends,
+                                                               rnnoise=rnnoise) \
+        .dump(str(cc_filename))
+
+
+if __name__ == '__main__':
+    main(parsed_args)
@@ -0,0 +1,164 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ARENA_PLANNER_HPP
+#define ARENA_PLANNER_HPP
+
+#include "Model.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tflite {
+    class SingleArenaBufferAllocator;
+} /* namespace tflite */
+
+namespace arm {
+namespace app {
+
+    /** Where a model's tensors live in the tensor arena. */
+    enum class ArenaPlacement {
+        Resident,   /* Loaded at registration and kept for the application's lifetime. */
+        Swapped     /* Loaded on demand into the swap region, one model at a time. */
+    };
+
+    /**
+     * @brief   Shares one tensor arena between several models and reports how much
+     *          of it each model uses.
+     *
+     *          The arena is split in two regions:
+     *          - the resident region, used by one allocator shared by all resident
+     *            models. Their persistent allocations (tensor metadata, kernel data)
+     *            stack up, while the scratch area holding the activations is shared,
+     *            sized for the largest model, since only one model runs at a time.
+     *          - the optional swap region, at the end of the arena. Swapped models
+     *            take turns in it: loading one unloads the previous occupant and
+     *            starts over with an empty allocator, reclaiming all of its memory.
+     *
+     *          A model needed only now and then can therefore be added without
+     *          growing the arena by more than its own footprint.
+     */
+    class ArenaPlanner {
+    public:
+        /**
+         * @brief       Constructor.
+         * @param[in]   arena       Tensor arena, aligned to 16 bytes.
+         * @param[in]   arenaSize   Size of the tensor arena in bytes.
+         * @param[in]   swapSize    Bytes at the end of the arena reserved for
+         *                          swapped models; 0 if there are none.
+         **/
+        ArenaPlanner(uint8_t* arena, size_t arenaSize, size_t swapSize = 0);
+
+        ArenaPlanner(const ArenaPlanner&) = delete;
+        ArenaPlanner& operator=(const ArenaPlanner&) = delete;
+
+        /**
+         * @brief       Registers a model. Resident models are initialised straight away;
+         *              swapped models are initialised by Load.
+         * @param[in]   model       Model to place. It must outlive this object.
+         * @param[in]   name        Name used in the report.
+         * @param[in]   modelAddr   Pointer to the model data.
+         * @param[in]   modelSize   Size of the model data in bytes.
+         * @param[in]   placement   Region the model's tensors are allocated in.
+         * @param[in]   opProfiler  Optional per-operator profiler, see Model::Init.
+         * @return      true if the model is registered (and, if resident, initialised).
+         **/
+        bool Register(Model& model,
+                      const char* name,
+                      const uint8_t* modelAddr,
+                      uint32_t modelSize,
+                      ArenaPlacement placement = ArenaPlacement::Resident,
+                      OpProfiler* opProfiler = nullptr);
+
+        /**
+         * @brief       Makes a registered model ready for inference. Loading a swapped
+         *              model unloads the swapped model that was loaded before it.
+         * @param[in]   model   Registered model.
+         * @return      true if the model is initialised.
+         **/
+        bool Load(Model& model);
+
+        /**
+         * @brief       Unloads a swapped model, leaving the swap region free.
+         *              Resident models cannot be unloaded.
+         * @param[in]   model   Registered model.
+         **/
+        void Unload(Model& model);
+
+        /** @brief  Logs the usage of the arena, per region and per model. */
+        void PrintReport() const;
+
+        /** @brief  Gets the bytes used in the resident region, including its scratch area. */
+        size_t GetResidentUsedBytes() const;
+
+        /** @brief  Gets the bytes of the resident region not used yet. */
+        size_t GetResidentFreeBytes() const;
+
+        /** @brief  Gets the largest footprint of a swapped model loaded so far. */
+        size_t GetSwapPeakBytes() const;
+
+        /** Memory used by a registered model. */
+        struct ModelUsage {
+            Model* model = nullptr;
+            const char* name = nullptr;
+            const uint8_t* modelAddr = nullptr;
+            uint32_t modelSize = 0;
+            ArenaPlacement placement = ArenaPlacement::Resident;
+            OpProfiler* opProfiler = nullptr;
+            size_t persistentBytes = 0;     /* Persistent allocations made by the model. */
+            size_t scratchBytes = 0;        /* Scratch area after the model was loaded. */
+            size_t scratchGrowth = 0;       /* Scratch added to the shared area by the model. */
+            bool loaded = false;
+        };
+
+        /** @brief  Gets the usage of the registered models, in registration order. */
+        const std::vector<ModelUsage>& GetModelUsage() const;
+
+    private:
+        /**
+         * @brief   Creates an empty allocator over a region of the arena.
+         * @return  Allocator, or nullptr if the region is too small.
+         **/
+        static tflite::MicroAllocator* CreateAllocator(uint8_t* region, size_t size,
+                                                       tflite::SingleArenaBufferAllocator*& buffers);
+
+        /** @brief  Initialises a model with an allocator and records its usage. */
+        bool InitModel(ModelUsage& usage, tflite::MicroAllocator* allocator,
+                       tflite::SingleArenaBufferAllocator* buffers);
+
+        /** @brief  Finds the usage record of a registered model. */
+        ModelUsage* Find(const Model& model);
+
+        uint8_t* m_arena;                   /* Start of the tensor arena. */
+        size_t m_arenaSize;                 /* Size of the tensor arena. */
+        size_t m_residentSize;              /* Size of the resident region, at the start. */
+        size_t m_swapSize;                  /* Size of the swap region, at the end. */
+
+        tflite::MicroAllocator* m_residentAllocator = nullptr;
+        tflite::SingleArenaBufferAllocator* m_residentBuffers = nullptr;
+        size_t m_residentOverhead = 0;      /* Persistent bytes used by the allocator itself. */
+
+        Model* m_swapped = nullptr;         /* Model loaded in the swap region. */
+        size_t m_swapPeak = 0;              /* Largest footprint in the swap region. */
+
+        std::vector<ModelUsage> m_models{};
+    };
+
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* ARENA_PLANNER_HPP */
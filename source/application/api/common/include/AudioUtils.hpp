@@ -164,6 +164,48 @@ namespace audio {
         }
     };
 
+    /*
+     * Sliding window over data held in a ring buffer: the data may run past the
+     * end of the ring and continue from its start. Window start positions wrap
+     * accordingly; each window is contiguous in memory only if the ring storage
+     * is followed by (window size - 1) elements mirroring its start.
+     */
+    template<class T>
+    class WrappedSlidingWindow : public SlidingWindow<T> {
+    public:
+        using SlidingWindow<T>::SlidingWindow;
+
+        /**
+         * @brief     Sets the ring buffer the data lives in.
+         * @param[in] ringStart   Pointer to the first element of the ring.
+         * @param[in] ringSize    Ring size in T type elements, 0 disables wrapping.
+         */
+        void SetWrapRegion(T *ringStart, size_t ringSize) {
+            m_ringStart = ringStart;
+            m_ringSize = ringSize;
+        }
+
+        /**
+         * @brief  Get the next data window.
+         * @return Pointer to the next window, if next window is not available nullptr is returned.
+         */
+        T *Next() {
+            if (!this->HasNext()) {
+                return nullptr;
+            }
+            this->m_count++;
+
+            const size_t offset = this->Index() * this->m_stride;
+            if (0 == m_ringSize) {
+                return this->m_start + offset;
+            }
+            return m_ringStart + ((this->m_start - m_ringStart) + offset) % m_ringSize;
+        }
+
+    private:
+        T *m_ringStart = nullptr;
+        size_t m_ringSize = 0;
+    };
 
 } /* namespace audio */
 } /* namespace app */
@@ -36,6 +36,17 @@ namespace app {
         ~ClassificationResult() = default;
     };
 
+    /**
+     * @brief   Single classification result referring to its label in the labels
+     *          vector instead of holding a copy of it.
+     */
+    class ClassificationResultRef {
+    public:
+        double              m_normalisedVal = 0.0;
+        const std::string*  m_label = nullptr;
+        uint32_t            m_labelIdx = 0;
+    };
+
 } /* namespace app */
 } /* namespace arm */
 
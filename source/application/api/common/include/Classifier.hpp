@@ -20,6 +20,8 @@
 #include "ClassificationResult.hpp"
 #include "TensorFlowLiteMicro.hpp"
 
+#include <set>
+#include <string>
 #include <vector>
 
 namespace arm {
@@ -54,6 +56,28 @@ namespace app {
             const std::vector <std::string>& labels, uint32_t topNCount,
             bool use_softmax);
 
+        /**
+         * @brief       Gets the top N classification results straight from the output
+         *              tensor. Selection runs on the raw (quantised) values, whose order
+         *              dequantisation preserves, and only the selected entries are
+         *              dequantised; the Softmax normaliser is accumulated in the same
+         *              pass. Nothing is allocated and labels are not copied.
+         *              Equal scores rank the higher class index first.
+         * @param[in]   outputTensor   Inference output tensor from an NN model.
+         * @param[out]  results        Array of at least topNCount results, populated
+         *                             best first by this function.
+         * @param[in]   labels         Labels vector to match classified classes; must
+         *                             outlive the results.
+         * @param[in]   topNCount      Number of top classifications to pick.
+         * @param[in]   useSoftmax     Whether Softmax normalisation should be applied to output.
+         * @return      true if successful, false otherwise.
+         **/
+        bool GetClassificationResultRefs(
+            TfLiteTensor* outputTensor,
+            ClassificationResultRef* results,
+            const std::vector <std::string>& labels, uint32_t topNCount,
+            bool useSoftmax);
+
         /**
         * @brief       Populate the elements of the Classification Result object.
         * @param[in]   topNSet        Ordered set of top 5 output class scores and labels.
@@ -68,6 +92,9 @@ namespace app {
             const std::vector <std::string>& labels);
 
     protected:
+        /** Top N counts up to which GetClassificationResults works without heap allocation. */
+        static constexpr uint32_t ms_maxTopNOnStack = 16;
+
         /**
          * @brief       Utility function that gets the top N classification results from the
          *              output vector.
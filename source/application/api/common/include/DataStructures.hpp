@@ -17,6 +17,7 @@
 #ifndef DATA_STRUCTURES_HPP
 #define DATA_STRUCTURES_HPP
 
+#include <cstddef>
 #include <iterator>
 #include <vector>
 
@@ -119,6 +120,117 @@ namespace app {
         std::vector<T> m_data;
     };
 
+    /**
+     * Class FeatureRing is a fixed capacity ring of equally sized rows, allocated
+     * once in contiguous memory. Rows are addressed by a logical index relative to
+     * the ring head; Advance() moves the head so that rows computed for one window
+     * can be read back at their new position in the next, overlapping, window
+     * without being copied. Rows are expected to be written in increasing order,
+     * the rows [0, NumValid()) hold data.
+     */
+    template<typename T>
+    class FeatureRing {
+    public:
+        FeatureRing() = default;
+
+        /**
+         * @brief     Creates the ring with the given sizes.
+         * @param[in] capacity   Maximum number of rows.
+         * @param[in] rowSize    Number of elements in one row.
+         */
+        FeatureRing(size_t capacity, size_t rowSize):
+            m_capacity(capacity),
+            m_rowSize(rowSize),
+            m_data(capacity * rowSize)
+        {}
+
+        ~FeatureRing() = default;
+
+        /**
+         * @brief     Gets the row at the given logical index.
+         * @param[in] idx   Row index relative to the ring head.
+         * @return    Pointer to the first element of the row, nullptr if
+         *            the index is not within capacity.
+         */
+        T* Row(size_t idx)
+        {
+            if (idx >= m_capacity) {
+                return nullptr;
+            }
+            return m_data.data() + ((m_head + idx) % m_capacity) * m_rowSize;
+        }
+
+        /**
+         * @brief     Checks if the row at the given logical index holds data.
+         * @param[in] idx   Row index relative to the ring head.
+         * @return    true if the row has been written since it was last dropped.
+         */
+        bool IsValid(size_t idx) const
+        {
+            return idx < m_numValid;
+        }
+
+        /**
+         * @brief     Marks the row at the given logical index as written. Only
+         *            extends the valid rows if it is the first row past them.
+         * @param[in] idx   Row index relative to the ring head.
+         */
+        void Commit(size_t idx)
+        {
+            if (idx == m_numValid && idx < m_capacity) {
+                ++m_numValid;
+            }
+        }
+
+        /**
+         * @brief     Drops the first rows and moves the ring head past them.
+         * @param[in] numRows   Number of rows to drop.
+         */
+        void Advance(size_t numRows)
+        {
+            if (numRows >= m_numValid) {
+                this->Reset();
+                return;
+            }
+            m_head = (m_head + numRows) % m_capacity;
+            m_numValid -= numRows;
+        }
+
+        /**
+         * @brief Drops all the rows.
+         */
+        void Reset()
+        {
+            m_head = 0;
+            m_numValid = 0;
+        }
+
+        /**
+         * @brief  Gets the number of valid rows, starting from the ring head.
+         * @return Number of valid rows.
+         */
+        size_t NumValid() const
+        {
+            return m_numValid;
+        }
+
+        /**
+         * @brief  Gets the maximum number of rows.
+         * @return Ring capacity in rows.
+         */
+        size_t Capacity() const
+        {
+            return m_capacity;
+        }
+
+    private:
+        size_t m_capacity{0};
+        size_t m_rowSize{0};
+        size_t m_head{0};
+        size_t m_numValid{0};
+        std::vector<T> m_data;
+    };
+
 } /* namespace app */
 } /* namespace arm */
 
@@ -0,0 +1,88 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef DSP_TABLES_HPP
+#define DSP_TABLES_HPP
+
+#include "MelFilterBank.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace arm {
+namespace app {
+namespace audio {
+
+    /**
+     * Audio front ends with tables that can be generated at build time
+     * (scripts/py/gen_dsp_tables_cpp.py). Each kind fixes how the tables are
+     * computed from the parameters: the window, the mel filter bank normaliser
+     * and the DCT matrix. Custom front ends always build their tables at run time.
+     */
+    enum class FrontEndKind : uint8_t {
+        Custom,             /* Tables built at run time. */
+        Mfcc,               /* MFCC defaults: no normaliser, orthogonal DCT. */
+        Wav2LetterMfcc,     /* Slaney normaliser, orthonormal DCT. */
+        AdMelSpectrogram    /* Slaney normaliser, no DCT. */
+    };
+
+    /* Precomputed tables of one front end configuration, in read-only memory. */
+    struct FrontEndTables {
+        FrontEndKind        kind;
+        MelFilterBankParams melParams;
+        uint32_t            frameLen;
+        uint32_t            numMfccFeatures;    /* 0 if there is no DCT. */
+        const float*        window;             /* frameLen Hann window weights. */
+        const float*        dctMatrix;          /* numMfccFeatures x numFbankBins, or nullptr. */
+        const float*        melWeights;         /* Packed mel filter bank weights. */
+        const uint32_t*     melOffsets;         /* numFbankBins + 1 offsets into melWeights. */
+        const uint32_t*     melFirstBins;       /* First FFT bin of each bank. */
+    };
+
+    /* Precomputed RNNoise analysis window and band DCT. */
+    struct RNNoiseTables {
+        uint32_t        frameSize;
+        uint32_t        numBands;
+        const float*    halfWindow;     /* frameSize weights. */
+        const float*    dctTable;       /* numBands x numBands. */
+    };
+
+    /**
+     * @brief       Finds generated tables for a front end configuration.
+     * @param[in]   kind              Front end kind.
+     * @param[in]   melParams         Mel filter bank parameters.
+     * @param[in]   frameLen          Frame (window) length.
+     * @param[in]   numMfccFeatures   Number of DCT outputs, 0 for none.
+     * @return      Tables, or nullptr if none were generated for this configuration.
+     **/
+    const FrontEndTables* FindFrontEndTables(FrontEndKind kind,
+                                             const MelFilterBankParams& melParams,
+                                             uint32_t frameLen,
+                                             uint32_t numMfccFeatures);
+
+    /**
+     * @brief       Finds generated RNNoise tables.
+     * @param[in]   frameSize   Frame size (half the window length).
+     * @param[in]   numBands    Number of bands.
+     * @return      Tables, or nullptr if none were generated for this configuration.
+     **/
+    const RNNoiseTables* FindRNNoiseTables(uint32_t frameSize, uint32_t numBands);
+
+} /* namespace audio */
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* DSP_TABLES_HPP */
@@ -0,0 +1,143 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef FIXED_POINT_MEL_HPP
+#define FIXED_POINT_MEL_HPP
+
+#include "MelFilterBank.hpp"
+#include "PlatformMath.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace arm {
+namespace app {
+namespace audio {
+
+    /**
+     * @brief   Integer log-mel front end for cores without a fast FPU. Audio is
+     *          windowed with a Q31 window, scaled so that its peak uses the full
+     *          Q31 range (block floating point), transformed with a Q31 FFT and
+     *          passed through an integer mel filter bank, and the mel energies are returned
+     *          as Q16 base 2 logarithms from a lookup table. All floating point work
+     *          happens in Init, which quantises the tables of the floating point
+     *          front end.
+     */
+    class FixedPointMel {
+    public:
+        /** Spectrum the mel filter bank weights apply to. */
+        enum class Spectrum {
+            Magnitude,  /* sqrt(re^2 + im^2) */
+            Power       /* re^2 + im^2 */
+        };
+
+        /* Fractional bits of the logarithms. */
+        static constexpr int ms_log2FracBits = 16;
+
+        /* Logarithm used for a zero energy: log2(FLT_MIN), the floor of the floating point path. */
+        static constexpr int32_t ms_log2Floor = -126 * (1 << ms_log2FracBits);
+
+        /**
+         * @brief       Quantises the floating point front end tables.
+         * @param[in]   window                  Window function, one weight per frame sample.
+         * @param[in]   windowLen               Number of window weights.
+         * @param[in]   frameLenPadded          FFT length, a power of two.
+         * @param[in]   melFilterBank           Floating point mel filter bank.
+         * @param[in]   spectrum                Spectrum the weights apply to.
+         * @return      true if successful, false otherwise.
+         **/
+        bool Init(const float* window,
+                  size_t windowLen,
+                  uint32_t frameLenPadded,
+                  const MelFilterBank& melFilterBank,
+                  Spectrum spectrum);
+
+        /**
+         * @brief   Signals whether Init has succeeded.
+         * @return  true if initialised, false otherwise.
+         **/
+        bool IsInitialised() const;
+
+        /**
+         * @brief       Computes the base 2 logarithms of the mel energies of one frame.
+         * @param[in]   audioData      Pointer to the first audio sample of the frame.
+         * @param[in]   audioDataLen   Number of samples available at audioData. Samples
+         *                             beyond it, up to the FFT length, are zeros.
+         * @param[out]  log2Energies   One Q16 logarithm per mel filter bank.
+         **/
+        void ComputeLog2MelEnergies(const int16_t* audioData, size_t audioDataLen,
+                                    int32_t* log2Energies);
+
+        /**
+         * @brief       Base 2 logarithm from a 256 entry table with linear interpolation.
+         *              The error is below 2^-16 on top of the Q16 rounding.
+         * @param[in]   value   Value to take the logarithm of, non-zero.
+         * @return      Q16 logarithm.
+         **/
+        static int32_t Log2Q16(uint64_t value);
+
+    private:
+        std::vector<int32_t>            m_windowQ31;        /* Q31 window. */
+        std::vector<int64_t>            m_windowed;         /* Q46 windowed samples. */
+        std::vector<int32_t>            m_frame;            /* Windowed frame, scaled to the full Q31 range. */
+        std::vector<int32_t>            m_fftOutput;        /* Spectrum divided by the FFT length. */
+        std::vector<uint64_t>           m_spectrum;         /* Magnitude in Q31 or power in Q46, per FFT bin. */
+        std::vector<uint16_t>           m_weights;          /* Packed filter bank weights, each bank scaled to 16 bits. */
+        std::vector<uint32_t>           m_bankOffsets;      /* Start of each bank in m_weights, plus the end. */
+        std::vector<uint32_t>           m_bankFirst;        /* First FFT bin of each bank. */
+        std::vector<int32_t>            m_bankLog2Offset;   /* Q16 correction from the integer to the real energy. */
+        uint32_t                        m_numSpectrumBins{0};
+        Spectrum                        m_spectrumType{Spectrum::Magnitude};
+        arm::app::math::FftInstanceQ31  m_fftInstance;
+    };
+
+    /**
+     * @brief   Requantises fixed point values with an integer multiplier, shift and
+     *          bias: round(value * multiplier + bias) without floating point
+     *          arithmetic per value.
+     */
+    class FixedPointRequantiser {
+    public:
+        /**
+         * @brief       Sets the real multiplier and bias.
+         * @param[in]   multiplier   Positive real multiplier.
+         * @param[in]   bias         Real bias added after the multiplication.
+         * @return      true if both can be represented, false otherwise.
+         **/
+        bool Set(double multiplier, double bias);
+
+        /**
+         * @brief       Requantises a value, |value| < 2^31.
+         * @param[in]   value   Fixed point value.
+         * @return      Rounded result.
+         **/
+        int32_t Apply(int64_t value) const
+        {
+            return static_cast<int32_t>((value * this->m_multiplier + this->m_bias) >> this->m_shift);
+        }
+
+    private:
+        int64_t m_multiplier{0};    /* Q31 mantissa of the multiplier. */
+        int64_t m_bias{0};          /* Bias and rounding term, scaled by 2^m_shift. */
+        int     m_shift{0};
+    };
+
+} /* namespace audio */
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* FIXED_POINT_MEL_HPP */
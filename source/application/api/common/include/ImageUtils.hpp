@@ -115,6 +115,60 @@ namespace image {
      **/
     void RgbToGrayscale(const uint8_t* srcPtr, uint8_t* dstPtr, size_t dstImgSz);
 
+    /** Number of entries in a pixel to int8 look-up table, one per uint8 pixel value. */
+    constexpr size_t PixelLutSize = 256;
+
+    /**
+     * @brief       Converts an RGB pixel to grayscale with integer arithmetic only.
+     *              Gives floor((299 * R + 587 * G + 114 * B) / 1000) for all inputs; the
+     *              floating point RgbToGrayscale can be one lower where that sum is an
+     *              exact multiple of 1000 (836 of the 2^24 colours).
+     * @param[in]   r   Red component.
+     * @param[in]   g   Green component.
+     * @param[in]   b   Blue component.
+     * @return      Grayscale value.
+     **/
+    inline uint8_t RgbToGray(uint32_t r, uint32_t g, uint32_t b)
+    {
+        /* Weights are 0.299, 0.587 and 0.114 in Q19, rounded down, with a bias
+         * making up for the rounding. The sum fits in 28 bits. */
+        return static_cast<uint8_t>((156762 * r + 307757 * g + 59769 * b + 42) >> 19);
+    }
+
+    /**
+     * @brief       Fills a look-up table mapping every uint8 pixel value to its value in
+     *              an int8 input tensor expecting the pixels normalised to [0, 1], i.e.
+     *              saturate((pixel / 255) / scale + offset), truncated as a cast would.
+     * @param[in]   scale    Quantisation scale of the input tensor.
+     * @param[in]   offset   Quantisation offset (zero point) of the input tensor.
+     * @param[out]  lut      Table of PixelLutSize entries.
+     **/
+    void GetNormalisedInt8Lut(float scale, int offset, int8_t* lut);
+
+    /**
+     * @brief       Converts a UINT8 image to INT8 in a single pass from source to
+     *              destination buffer, which may be the same.
+     * @param[in]   srcPtr   Pointer to the source image.
+     * @param[out]  dstPtr   Pointer to the destination tensor data.
+     * @param[in]   imgSz    Number of bytes in the image.
+     * @param[in]   lut      Optional pixel to int8 look-up table of PixelLutSize entries.
+     *                       If nullptr, pixels are offset by -128 as ConvertImgToInt8 does.
+     **/
+    void ConvertImgToInt8(const uint8_t* srcPtr, int8_t* dstPtr, size_t imgSz,
+                          const int8_t* lut = nullptr);
+
+    /**
+     * @brief       Converts an RGB image to an INT8 grayscale tensor in a single pass,
+     *              using integer arithmetic only (see RgbToGray).
+     * @param[in]   srcPtr     Pointer to RGB source image.
+     * @param[out]  dstPtr     Pointer to the destination tensor data.
+     * @param[in]   dstImgSz   Destination image size.
+     * @param[in]   lut        Optional pixel to int8 look-up table of PixelLutSize entries.
+     *                         If nullptr, gray values are offset by -128.
+     **/
+    void RgbToGrayscaleInt8(const uint8_t* srcPtr, int8_t* dstPtr, size_t dstImgSz,
+                            const int8_t* lut = nullptr);
+
 } /* namespace image */
 } /* namespace app */
 } /* namespace arm */
@@ -0,0 +1,166 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MEL_FILTER_BANK_HPP
+#define MEL_FILTER_BANK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace arm {
+namespace app {
+namespace audio {
+
+    /* Parameters defining the triangular filters of a mel filter bank. */
+    struct MelFilterBankParams {
+        float       samplingFreq{0};
+        uint32_t    numFbankBins{0};
+        float       melLoFreq{0};
+        float       melHiFreq{0};
+        uint32_t    frameLenPadded{0};
+        bool        useHtkMethod{true};
+    };
+
+    /**
+     * @brief   Mel filter bank in compressed sparse row form: the non-zero weights
+     *          of all banks are packed into one buffer, with the offset of each bank
+     *          into it and the first FFT bin it applies to. Filter banks are
+     *          immutable once built, so instances with the same parameters and
+     *          normalisers share one through GetShared.
+     */
+    class MelFilterBank {
+    public:
+        /**
+         * @brief       Builds the filter bank.
+         * @param[in]   params        Filter bank parameters.
+         * @param[in]   normalisers   Weight normaliser of each bank, as many as
+         *                            params.numFbankBins.
+         **/
+        MelFilterBank(const MelFilterBankParams& params, const std::vector<float>& normalisers);
+
+        /**
+         * @brief       Wraps a filter bank built ahead of time, without copying it.
+         * @param[in]   params      Filter bank parameters.
+         * @param[in]   weights     Weights of all banks, back to back.
+         * @param[in]   offsets     Start of each bank in weights, plus the end.
+         * @param[in]   firstBins   First FFT bin of each bank.
+         **/
+        MelFilterBank(const MelFilterBankParams& params, const float* weights,
+                      const uint32_t* offsets, const uint32_t* firstBins);
+
+        MelFilterBank(const MelFilterBank&) = delete;
+        MelFilterBank& operator=(const MelFilterBank&) = delete;
+
+        /**
+         * @brief       Gets a filter bank built with the given parameters and
+         *              normalisers, reusing one that is still alive if possible.
+         *              Not thread safe.
+         * @param[in]   params        Filter bank parameters.
+         * @param[in]   normalisers   Weight normaliser of each bank.
+         * @return      Shared, read-only filter bank.
+         **/
+        static std::shared_ptr<const MelFilterBank> GetShared(
+                const MelFilterBankParams& params, const std::vector<float>& normalisers);
+
+        /**
+         * @brief       Gets the mel frequencies delimiting the triangular filters:
+         *              bank i rises from point i, peaks at i + 1 and falls to i + 2.
+         * @param[in]   params   Filter bank parameters.
+         * @return      params.numFbankBins + 2 mel frequencies.
+         **/
+        static std::vector<float> GetMelPoints(const MelFilterBankParams& params);
+
+        /**
+         * @brief       Project input frequency to Mel Scale.
+         * @param[in]   freq           Input frequency in floating point.
+         * @param[in]   useHTKMethod   bool to signal if HTK method is to be
+         *                             used for calculation.
+         * @return      Mel transformed frequency in floating point.
+         **/
+        static float MelScale(float freq, bool useHTKMethod = true);
+
+        /**
+         * @brief       Inverse Mel transform - convert MEL warped frequency
+         *              back to normal frequency.
+         * @param[in]   melFreq        Mel frequency in floating point.
+         * @param[in]   useHTKMethod   bool to signal if HTK method is to be
+         *                             used for calculation.
+         * @return      Real world frequency in floating point.
+         **/
+        static float InverseMelScale(float melFreq, bool useHTKMethod = true);
+
+        /**
+         * @brief       Weighted sums of the spectrum for each bank.
+         * @param[in]   spectrum        Spectrum, at least GetEndBin() bins.
+         * @param[out]  melEnergies     One energy per bank.
+         * @param[in]   initialEnergy   Value each sum starts from, to avoid log of zero.
+         **/
+        void Apply(const float* spectrum, float* melEnergies, float initialEnergy) const;
+
+        /** @brief  Number of banks. */
+        uint32_t GetNumBanks() const;
+
+        /** @brief  Lowest FFT bin any bank applies to. */
+        uint32_t GetFirstBin() const;
+
+        /** @brief  One past the highest FFT bin any bank applies to. */
+        uint32_t GetEndBin() const;
+
+        /** @brief  First FFT bin of a bank. */
+        uint32_t GetBankFirstBin(uint32_t bank) const;
+
+        /** @brief  Number of weights of a bank. */
+        uint32_t GetBankSize(uint32_t bank) const;
+
+        /** @brief  Weights of a bank, GetBankSize(bank) of them. */
+        const float* GetBankWeights(uint32_t bank) const;
+
+    private:
+        MelFilterBankParams     m_params;
+        std::vector<float>      m_normalisers;
+        std::vector<float>      m_weightsStorage;   /* Storage of filter banks built at run time. */
+        std::vector<uint32_t>   m_offsetsStorage;
+        std::vector<uint32_t>   m_firstBinStorage;
+        const float*            m_weights{nullptr};     /* Weights of all banks, back to back. */
+        const uint32_t*         m_offsets{nullptr};     /* Start of each bank in m_weights, plus the end. */
+        const uint32_t*         m_firstBin{nullptr};    /* First FFT bin of each bank. */
+        uint32_t                m_numBanks{0};
+        uint32_t                m_minBin{0};
+        uint32_t                m_endBin{0};
+
+        /** @brief  Sets the range of FFT bins used by any bank. */
+        void InitBinRange();
+
+        /* Constants for the Slaney mel scale. */
+        static constexpr float ms_logStep = /*logf(6.4)*/ 1.8562979903656 / 27.0;
+        static constexpr float ms_freqStep = 200.0 / 3;
+        static constexpr float ms_minLogHz = 1000.0;
+        static constexpr float ms_minLogMel = ms_minLogHz / ms_freqStep;
+
+        /**
+         * @brief       Signals whether this filter bank was built from the given
+         *              parameters and normalisers.
+         **/
+        bool Matches(const MelFilterBankParams& params, const std::vector<float>& normalisers) const;
+    };
+
+} /* namespace audio */
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* MEL_FILTER_BANK_HPP */
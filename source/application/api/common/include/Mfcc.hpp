@@ -29,6 +29,9 @@
 #ifndef MFCC_HPP
 #define MFCC_HPP
 
+#include "DspTables.hpp"
+#include "FixedPointMel.hpp"
+#include "MelFilterBank.hpp"
 #include "PlatformMath.hpp"
 
 #include <vector>
@@ -36,12 +39,33 @@
 #include <cmath>
 #include <limits>
 #include <string>
+#include <algorithm>
+#include <memory>
 
 namespace arm {
 namespace app {
 namespace audio {
 
-    /* MFCC's consolidated parameters. */
+    /**
+     * MFCC's consolidated parameters.
+     *
+     * m_useFixedPoint selects the integer front end (FixedPointMel): Q31 window,
+     * frame scaled to the full Q31 range, Q31 FFT, packed 16-bit mel weights, table
+     * based log2 and a Q31 DCT, quantised to the output type with an integer
+     * multiplier. It follows the natural logarithm MFCC of this class; overrides of
+     * ApplyMelFilterBank and ConvertToLogarithmicScale are not used.
+     * The FFT scales by 1/N, so its rounding error sits at a fixed depth below the
+     * frame's strongest spectral bin whatever the frame level; the accuracy depends
+     * on the frame's dynamic range, not its amplitude. Against the floating point
+     * path, mel energies within 80 dB of the strongest bin differ by less than 0.003
+     * (natural log), and by less than 0.01 within 100 dB. MFCCs of frames whose mel
+     * energies all lie within 80 dB (100 dB) of the strongest bin differ by less than
+     * 0.003 (0.01), so quantised outputs differ by at most one step for scales above
+     * that. Bands deeper than this, as in pure tones or DC frames (115-140 dB),
+     * differ by up to 0.25; tones above the mel range push every band down
+     * further and can differ by more. A filter bank with no energy at all takes the
+     * floating point floor, log(FLT_MIN).
+     */
     class MfccParams {
     public:
         float       m_samplingFreq;
@@ -52,12 +76,13 @@ namespace audio {
         uint32_t    m_frameLen;
         uint32_t    m_frameLenPadded;
         bool        m_useHtkMethod;
+        bool        m_useFixedPoint;
 
         /** @brief  Constructor */
         MfccParams(float samplingFreq, uint32_t numFbankBins,
                    float melLoFreq, float melHiFreq,
                    uint32_t numMfccFeats, uint32_t frameLen,
-                   bool useHtkMethod);
+                   bool useHtkMethod, bool useFixedPoint = false);
 
         MfccParams()  = delete;
 
@@ -95,6 +120,22 @@ namespace audio {
         **/
         std::vector<float> MfccCompute(const std::vector<int16_t>& audioData);
 
+        /**
+        * @brief        Extract MFCC features for one single small frame of
+        *               audio data into a caller owned buffer. No memory is
+        *               allocated by this call.
+        * @param[in]    audioData      Pointer to the first audio sample of the frame.
+        * @param[in]    audioDataLen   Number of samples available at audioData. If
+        *                              less than the frame length, the remainder of
+        *                              the frame is treated as zeros.
+        * @param[out]   mfccOut        Output buffer with space for the MFCC features.
+        * @param[in]    outStride      Distance (in elements) between consecutive
+        *                              features in the output buffer.
+        * @return       true if successful, false otherwise.
+        **/
+        bool MfccCompute(const int16_t* audioData, size_t audioDataLen,
+                         float* mfccOut, size_t outStride = 1);
+
         /** @brief  Initialise. */
         void Init();
 
@@ -112,31 +153,78 @@ namespace audio {
                                         const float quantScale,
                                         const int quantOffset)
         {
-            this->MfccComputePreFeature(audioData);
-            float minVal = std::numeric_limits<T>::min();
-            float maxVal = std::numeric_limits<T>::max();
-
             std::vector<T> mfccOut(this->m_params.m_numMfccFeatures);
+            this->MfccComputeQuant<T>(audioData.data(), audioData.size(),
+                                      mfccOut.data(), quantScale, quantOffset);
+            return mfccOut;
+        }
+
+       /**
+        * @brief        Extract MFCC features and quantise for one single small
+        *               frame of audio data, writing straight into a caller owned
+        *               buffer (for example, a row of the input tensor). No memory
+        *               is allocated by this call.
+        * @param[in]    audioData      Pointer to the first audio sample of the frame.
+        * @param[in]    audioDataLen   Number of samples available at audioData. If
+        *                              less than the frame length, the remainder of
+        *                              the frame is treated as zeros.
+        * @param[out]   mfccOut        Output buffer with space for the MFCC features.
+        * @param[in]    quantScale     Quantisation scale.
+        * @param[in]    quantOffset    Quantisation offset.
+        * @return       true if successful, false otherwise.
+        **/
+        template<typename T>
+        bool MfccComputeQuant(const int16_t* audioData, const size_t audioDataLen,
+                              T* mfccOut, const float quantScale, const int quantOffset)
+        {
+            if (!mfccOut) {
+                return false;
+            }
+
+            /* Initialisation may fall back to floating point. */
+            this->InitMelFilterBank();
+            if (this->m_params.m_useFixedPoint) {
+                if (!this->MfccComputeQuantFixedPoint(audioData, audioDataLen, quantScale, quantOffset)) {
+                    return false;
+                }
+                for (size_t i = 0; i < this->m_params.m_numMfccFeatures; ++i) {
+                    mfccOut[i] = static_cast<T>(std::min<int32_t>(std::max<int32_t>(
+                        this->m_quantFeatures[i], std::numeric_limits<T>::min()), std::numeric_limits<T>::max()));
+                }
+                return true;
+            }
+
+            this->MfccComputePreFeature(audioData, audioDataLen);
+            const float minVal = std::numeric_limits<T>::min();
+            const float maxVal = std::numeric_limits<T>::max();
+
             const size_t numFbankBins = this->m_params.m_numFbankBins;
 
             /* Take DCT. Uses matrix mul. */
-            for (size_t i = 0, j = 0; i < mfccOut.size(); ++i, j += numFbankBins) {
+            for (size_t i = 0, j = 0; i < this->m_params.m_numMfccFeatures; ++i, j += numFbankBins) {
 
-                float sum = math::MathUtils::DotProductF32(this->m_dctMatrix.data() + j, this->m_melEnergies.data(), numFbankBins);
+                float sum = math::MathUtils::DotProductF32(const_cast<float*>(this->m_dct) + j, this->m_melEnergies.data(), numFbankBins);
 
                 /* Quantize to T. */
                 sum = std::round((sum / quantScale) + quantOffset);
                 mfccOut[i] = static_cast<T>(std::min<float>(std::max<float>(sum, minVal), maxVal));
             }
 
-            return mfccOut;
+            return true;
         }
 
+        /**
+         * @brief       Gets the number of MFCC features produced per frame.
+         * @return      Number of MFCC features.
+         **/
+        uint32_t GetNumMfccFeatures() const;
+
         /* Constants */
         static constexpr float ms_logStep = /*logf(6.4)*/ 1.8562979903656 / 27.0;
         static constexpr float ms_freqStep = 200.0 / 3;
         static constexpr float ms_minLogHz = 1000.0;
         static constexpr float ms_minLogMel = ms_minLogHz / ms_freqStep;
+        static constexpr double ms_ln2 = 0.6931471805599453;
 
     protected:
         /**
@@ -162,26 +250,20 @@ namespace audio {
 
         /**
          * @brief       Populates MEL energies after applying the MEL filter
-         *              bank weights and adding them up to be placed into
-         *              bins, according to the filter bank's first and last
-         *              indices (pre-computed for each filter bank element
-         *              by CreateMelFilterBank function).
-         * @param[in]   fftVec                  Vector populated with FFT magnitudes.
-         * @param[in]   melFilterBank           2D Vector with filter bank weights.
-         * @param[in]   filterBankFilterFirst   Vector containing the first indices of filter bank
-         *                                      to be used for each bin.
-         * @param[in]   filterBankFilterLast    Vector containing the last indices of filter bank
-         *                                      to be used for each bin.
-         * @param[out]  melEnergies             Pre-allocated vector of MEL energies to be
-         *                                      populated.
+         *              bank weights to the FFT magnitudes. The magnitude of
+         *              each FFT bin the filter bank uses is computed once, in
+         *              place, before the weighted sums.
+         * @param[in,out]   fftVec          Vector populated with the power spectrum;
+         *                                  magnitudes on return.
+         * @param[in]       melFilterBank   Packed filter bank weights.
+         * @param[out]      melEnergies     Pre-allocated vector of MEL energies to be
+         *                                  populated.
          * @return      true if successful, false otherwise.
          */
         virtual bool ApplyMelFilterBank(
-            std::vector<float>&                 fftVec,
-            std::vector<std::vector<float>>&    melFilterBank,
-            std::vector<uint32_t>&               filterBankFilterFirst,
-            std::vector<uint32_t>&               filterBankFilterLast,
-            std::vector<float>&                 melEnergies);
+            std::vector<float>&     fftVec,
+            const MelFilterBank&    melFilterBank,
+            std::vector<float>&     melEnergies);
 
         /**
          * @brief           Converts the Mel energies for logarithmic scale.
@@ -217,21 +299,42 @@ namespace audio {
                         const float&   rightMel,
                         bool     useHTKMethod);
 
+        /**
+         * @brief       Gets the kind of front end this class computes. Tables
+         *              generated at build time for the kind are used instead of
+         *              building them when the parameters match; classes overriding
+         *              how the tables are built should return their own kind, or
+         *              Custom (the default) to always build them at run time.
+         * @return      Front end kind.
+         */
+        virtual FrontEndKind GetFrontEndKind() const;
+
     private:
         MfccParams                      m_params;
         std::vector<float>              m_frame;
         std::vector<float>              m_buffer;
         std::vector<float>              m_melEnergies;
-        std::vector<float>              m_windowFunc;
-        std::vector<std::vector<float>> m_melFilterBank;
-        std::vector<float>              m_dctMatrix;
-        std::vector<uint32_t>           m_filterBankFilterFirst;
-        std::vector<uint32_t>           m_filterBankFilterLast;
+        std::vector<float>              m_windowFunc;       /* Window, if built at run time. */
+        std::vector<float>              m_dctMatrix;        /* DCT matrix, if built at run time. */
+        const float*                    m_window{nullptr};  /* Window in use. */
+        const float*                    m_dct{nullptr};     /* DCT matrix in use. */
+        std::shared_ptr<const MelFilterBank> m_melFilterBank;
         bool                            m_filterBankInitialised;
         arm::app::math::FftInstance     m_fftInstance;
 
+        /* Fixed point path. */
+        FixedPointMel                   m_fixedPointMel;
+        std::vector<int32_t>            m_log2MelEnergies;  /* Q16 log2 of the mel energies. */
+        std::vector<int32_t>            m_dctMatrixQ31;     /* Q31 DCT matrix. */
+        std::vector<int32_t>            m_mfccFixedPoint;   /* MFCCs in Q15 log2 units. */
+        std::vector<int32_t>            m_quantFeatures;    /* Quantised MFCCs before clamping. */
+        FixedPointRequantiser           m_requantiser;
+        float                           m_requantScale{0};
+        int                             m_requantOffset{0};
+
         /**
-         * @brief       Initialises the filter banks and the DCT matrix. **/
+         * @brief       Initialises the window, filter banks and the DCT matrix,
+         *              from generated tables if there are any for the parameters. **/
         void InitMelFilterBank();
 
         /**
@@ -241,22 +344,54 @@ namespace audio {
          **/
         bool IsMelFilterBankInited() const;
 
+        /** @brief  Gets the mel filter bank parameters. */
+        MelFilterBankParams GetMelFilterBankParams() const;
+
         /**
-         * @brief       Create mel filter banks for MFCC calculation.
-         * @return      2D vector of floats.
+         * @brief       Gets the mel filter bank for MFCC calculation, shared
+         *              with other instances using the same parameters.
+         * @return      Shared filter bank.
          **/
-        std::vector<std::vector<float>> CreateMelFilterBank();
+        std::shared_ptr<const MelFilterBank> CreateMelFilterBank();
 
         /**
          * @brief       Computes and populates internal memeber buffers used
          *              in MFCC feature calculation
-         * @param[in]   audioData   1D vector of 16-bit audio data.
+         * @param[in]   audioData      Pointer to 16-bit audio data.
+         * @param[in]   audioDataLen   Number of samples available at audioData.
          */
-        void MfccComputePreFeature(const std::vector<int16_t>& audioData);
+        void MfccComputePreFeature(const int16_t* audioData, size_t audioDataLen);
 
         /** @brief       Computes the magnitude from an interleaved complex array. */
         void ConvertToPowerSpectrum();
 
+        /**
+         * @brief       Initialises the fixed point front end and DCT matrix from the
+         *              floating point tables.
+         * @return      true if successful, false otherwise.
+         **/
+        bool InitFixedPoint();
+
+        /**
+         * @brief       Computes the MFCCs of a frame on the fixed point path, in Q15
+         *              log2 units, into m_mfccFixedPoint.
+         * @param[in]   audioData      Pointer to 16-bit audio data.
+         * @param[in]   audioDataLen   Number of samples available at audioData.
+         **/
+        void MfccComputeFixedPoint(const int16_t* audioData, size_t audioDataLen);
+
+        /**
+         * @brief       Computes the quantised MFCCs of a frame on the fixed point path,
+         *              before clamping, into m_quantFeatures.
+         * @param[in]   audioData      Pointer to 16-bit audio data.
+         * @param[in]   audioDataLen   Number of samples available at audioData.
+         * @param[in]   quantScale     Quantisation scale.
+         * @param[in]   quantOffset    Quantisation offset.
+         * @return      true if successful, false otherwise.
+         **/
+        bool MfccComputeQuantFixedPoint(const int16_t* audioData, size_t audioDataLen,
+                                        float quantScale, int quantOffset);
+
     };
 
 } /* namespace audio */
@@ -18,6 +18,7 @@
 #define MODEL_HPP
 
 #include "TensorFlowLiteMicro.hpp"
+#include "OpProfiler.hpp"
 
 #include <cstdint>
 
@@ -70,13 +71,23 @@ namespace app {
          *  @param[in]  allocator   Optional: a pre-initialised micro allocator pointer,
          *                          if available. If supplied, this allocator will be used
          *                          to create the interpreter instance.
+         *  @param[in]  opProfiler  Optional: per-operator profiler to attach to the
+         *                          interpreter. It must outlive this object.
          *  @return     true if initialisation succeeds, false otherwise.
         **/
         bool Init(uint8_t* tensorArenaAddr,
                   uint32_t tensorArenaSize,
                   const uint8_t* nnModelAddr,
                   uint32_t nnModelSize,
-                  tflite::MicroAllocator* allocator = nullptr);
+                  tflite::MicroAllocator* allocator = nullptr,
+                  OpProfiler* opProfiler = nullptr);
+
+        /**
+         * @brief   Destroys the interpreter, so that the tensor arena memory it used
+         *          can be given to another model. Init must be called again before
+         *          the next inference.
+         **/
+        void Release();
 
         /**
          * @brief       Gets the allocator pointer for this instance.
@@ -136,7 +147,9 @@ namespace app {
         const tflite::Model* m_pModel{nullptr};            /* Tflite model pointer. */
         std::unique_ptr<tflite::MicroInterpreter> m_pInterpreter{nullptr}; /* Tflite interpreter. */
         tflite::MicroAllocator* m_pAllocator{nullptr};     /* Tflite micro allocator. */
+        OpProfiler* m_pOpProfiler{nullptr};                /* Per-operator profiler, if attached. */
         bool m_inited{false};                              /* Indicates whether this object has been initialised. */
+        bool m_opsEnlisted{false};                         /* Operators added to the resolver. */
         const uint8_t* m_modelAddr{nullptr};               /* Model address */
         uint32_t m_modelSize{0};                           /* Model size */
 
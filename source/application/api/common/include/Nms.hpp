@@ -0,0 +1,138 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef NMS_HPP
+#define NMS_HPP
+
+#include "ImageUtils.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace arm {
+namespace app {
+namespace image {
+
+    /** How boxes of different classes interact during non-maxima suppression. */
+    enum class NmsMode {
+        ClassAgnostic,  /* Any box can suppress any other box. */
+        PerClass,       /* Boxes only suppress boxes of the same class. */
+        BatchedOffset   /* As PerClass, by moving every class to its own region of the
+                         * plane and running a single class-agnostic pass. */
+    };
+
+    /** Non-maxima suppression parameters. */
+    struct NmsParams {
+        NmsMode mode = NmsMode::PerClass;
+        float iouThreshold = 0.45f;     /* Overlap above which a box is suppressed. */
+        size_t maxDetections = 0;       /* Stop once this many boxes are kept, 0 for no limit. */
+        bool softNms = false;           /* Gaussian Soft-NMS: decay overlapping scores instead. */
+        float softSigma = 0.5f;         /* Soft-NMS: Gaussian decay parameter. */
+        float scoreThreshold = 0.0f;    /* Soft-NMS: boxes decayed to this score or below are dropped. */
+    };
+
+    /**
+     * @brief   Contiguous struct-of-arrays buffer of boxes for non-maxima suppression.
+     *          Boxes are stored as corners with their area precomputed, one entry per
+     *          box and class.
+     */
+    struct NmsBoxes {
+        std::vector<float> x0;      /* Left edge. */
+        std::vector<float> y0;      /* Top edge. */
+        std::vector<float> x1;      /* Right edge. */
+        std::vector<float> y1;      /* Bottom edge. */
+        std::vector<float> area;    /* Box area. */
+        std::vector<float> score;   /* Box score, decayed in place by Soft-NMS. */
+        std::vector<int> classId;   /* Class of the box. */
+
+        /**
+         * @brief       Reserves room for a number of boxes.
+         * @param[in]   capacity   Number of boxes.
+         **/
+        void Reserve(size_t capacity);
+
+        /** @brief  Removes all boxes, keeping the storage. */
+        void Clear();
+
+        /**
+         * @brief       Adds a box.
+         * @param[in]   box       Box centre and size.
+         * @param[in]   score     Box score.
+         * @param[in]   classId   Box class.
+         **/
+        void Add(const Box& box, float score, int classId);
+
+        /**
+         * @brief   Gets the number of boxes.
+         * @return  Number of boxes.
+         **/
+        size_t Size() const;
+    };
+
+    /**
+     * @brief   Greedy non-maxima suppression over an NmsBoxes buffer. Boxes are sorted
+     *          by score once, whatever the mode, and the overlap of two boxes uses the
+     *          precomputed areas. Working storage is kept between runs.
+     */
+    class NonMaxSuppression {
+    public:
+        /**
+         * @brief       Constructor.
+         * @param[in]   params   Non-maxima suppression parameters.
+         **/
+        explicit NonMaxSuppression(const NmsParams& params);
+
+        /**
+         * @brief       Runs non-maxima suppression.
+         * @param[in,out]   boxes   Boxes; Soft-NMS decays their scores.
+         * @param[out]      keep    Indices of the boxes kept, by decreasing score. Boxes
+         *                          with equal scores stay in the order they were added.
+         * @return      Number of boxes kept.
+         **/
+        size_t Run(NmsBoxes& boxes, std::vector<uint32_t>& keep);
+
+    private:
+        /* Hard suppression: removes boxes overlapping a kept box. */
+        void RunHard(const NmsBoxes& boxes, std::vector<uint32_t>& keep);
+
+        /* Soft-NMS: decays the scores of boxes overlapping a kept box. */
+        void RunSoft(NmsBoxes& boxes, std::vector<uint32_t>& keep);
+
+        /* Intersection over union of two boxes, using the working coordinates. */
+        float Iou(const NmsBoxes& boxes, uint32_t a, uint32_t b) const;
+
+        /* Whether box a may suppress box b in the current mode. */
+        bool Competes(const NmsBoxes& boxes, uint32_t a, uint32_t b) const;
+
+        NmsParams               m_params;       /* Parameters. */
+        std::vector<uint32_t>   m_order;        /* Box indices by decreasing score. */
+        std::vector<uint8_t>    m_removed;      /* Box suppressed or kept already. */
+        std::vector<float>      m_offsetX0;     /* Class-offset corners for BatchedOffset. */
+        std::vector<float>      m_offsetY0;
+        std::vector<float>      m_offsetX1;
+        std::vector<float>      m_offsetY1;
+        const float*            m_x0{nullptr};  /* Working coordinates. */
+        const float*            m_y0{nullptr};
+        const float*            m_x1{nullptr};
+        const float*            m_y1{nullptr};
+    };
+
+} /* namespace image */
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* NMS_HPP */
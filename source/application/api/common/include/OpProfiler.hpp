@@ -0,0 +1,163 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef OP_PROFILER_HPP
+#define OP_PROFILER_HPP
+
+#include "tensorflow/lite/micro/micro_profiler_interface.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace arm {
+namespace app {
+
+    /** Cost of one operator of the graph, accumulated over inferences. */
+    struct OpStats {
+        const char* name = nullptr;     /* Operator name, as tagged by the interpreter. */
+        bool isNpu = false;             /* Operator runs on the Ethos-U NPU. */
+        uint32_t count = 0;             /* Number of times the operator ran. */
+        uint64_t total = 0;             /* Sum of the costs. */
+        uint64_t min = UINT64_MAX;      /* Lowest cost. */
+        uint64_t max = 0;               /* Highest cost. */
+    };
+
+    /**
+     * @brief   Per-operator profiler for the TensorFlow Lite Micro interpreter.
+     *
+     *          The interpreter reports every operator it invokes, in graph order,
+     *          through the tflite::MicroProfilerInterface. This class attributes the
+     *          cost of each report to the operator index and to the operator type, and
+     *          splits the total between Ethos-U custom operators and operators that
+     *          fell back to the CPU.
+     *
+     *          Only operators between Model::RunInference start and end are recorded,
+     *          and events nested in an operator (e.g. subgraphs of control flow
+     *          operators) count towards that operator only. All storage is reserved
+     *          when the model is initialised, so recording does not allocate.
+     *
+     *          The cost source is left to the derived class, so that this library does
+     *          not depend on the HAL.
+     *
+     *          NOTE: the interpreter only emits operator events when TensorFlow Lite
+     *          Micro is built without TF_LITE_STRIP_ERROR_STRINGS.
+     */
+    class OpProfiler : public tflite::MicroProfilerInterface {
+    public:
+        OpProfiler() = default;
+        ~OpProfiler() override = default;
+
+        OpProfiler(const OpProfiler&) = delete;
+        OpProfiler& operator=(const OpProfiler&) = delete;
+
+        /**
+         * @brief       Reserves storage for a graph. Called by Model::Init.
+         * @param[in]   numOperators   Number of operators in the graph.
+         **/
+        void Prepare(size_t numOperators);
+
+        /** @brief  Marks the start of an inference. Called by Model::RunInference. */
+        void BeginInvoke();
+
+        /** @brief  Marks the end of an inference. Called by Model::RunInference. */
+        void EndInvoke();
+
+        /**
+         * @brief       Records the start of an interpreter event.
+         * @param[in]   tag   Event tag; the operator name for operator events.
+         * @return      Handle to pass to EndEvent.
+         **/
+        uint32_t BeginEvent(const char* tag) override;
+
+        /**
+         * @brief       Records the end of an interpreter event.
+         * @param[in]   eventHandle   Handle returned by BeginEvent.
+         **/
+        void EndEvent(uint32_t eventHandle) override;
+
+        /** @brief  Clears the recorded costs, keeping the storage. */
+        void Reset();
+
+        /**
+         * @brief       Prints the operators ranked by total cost, the cost per operator
+         *              type and the NPU/CPU split.
+         * @param[in]   maxRows   Maximum number of operators listed; 0 lists all.
+         **/
+        void PrintResults(size_t maxRows = 0) const;
+
+        /** @brief  Gets the cost of each operator, in graph order. */
+        const std::vector<OpStats>& GetOpStats() const;
+
+        /** @brief  Gets the cost of each operator type, in order of first appearance. */
+        const std::vector<OpStats>& GetOpTypeStats() const;
+
+        /** @brief  Gets the number of inferences recorded. */
+        uint32_t GetInvokeCount() const;
+
+        /** @brief  Gets the total cost of operators run on the NPU. */
+        uint64_t GetNpuTotal() const;
+
+        /** @brief  Gets the total cost of operators run on the CPU. */
+        uint64_t GetCpuTotal() const;
+
+        /**
+         * @brief       Checks if an operator runs on the Ethos-U NPU.
+         * @param[in]   name   Operator name.
+         * @return      true for the Ethos-U custom operator, false otherwise.
+         **/
+        static bool IsNpuOperator(const char* name);
+
+    protected:
+        /** @brief  Gets the current value of the cost counter. */
+        virtual uint64_t GetTimestamp() = 0;
+
+        /** @brief  Gets the unit of the cost counter, e.g. "cycles". */
+        virtual const char* GetUnit() const = 0;
+
+        /**
+         * @brief   Whether the cost counter runs for every operator, on the CPU or the
+         *          NPU. Without one the NPU/CPU split would be misleading, so no
+         *          results are printed.
+         **/
+        virtual bool HasClock() const
+        {
+            return true;
+        }
+
+    private:
+        /** @brief  Adds a cost to the statistics. */
+        static void Accumulate(OpStats& stats, uint64_t cost);
+
+        /** @brief  Finds or adds the statistics entry for an operator type. */
+        OpStats* FindOpType(const char* name);
+
+        std::vector<OpStats> m_ops{};           /* Per operator index. */
+        std::vector<OpStats> m_opTypes{};       /* Per operator type. */
+        const char* m_opTag = nullptr;          /* Tag of the running operator. */
+        uint64_t m_opStart = 0;                 /* Counter value when the running operator started. */
+        uint32_t m_opsStarted = 0;              /* Operators started in this inference. */
+        uint32_t m_depth = 0;                   /* Number of open events. */
+        uint32_t m_invokes = 0;                 /* Number of inferences recorded. */
+        uint64_t m_npuTotal = 0;                /* Cost of NPU operators. */
+        uint64_t m_cpuTotal = 0;                /* Cost of CPU operators. */
+        bool m_recording = false;               /* An inference is in progress. */
+    };
+
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* OP_PROFILER_HPP */
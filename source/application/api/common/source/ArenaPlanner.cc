@@ -0,0 +1,268 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ArenaPlanner.hpp"
+#include "log_macros.h"
+
+#include "tensorflow/lite/micro/arena_allocator/single_arena_buffer_allocator.h"
+#include "tensorflow/lite/micro/memory_planner/greedy_memory_planner.h"
+
+#include <algorithm>
+#include <new>
+
+namespace arm {
+namespace app {
+
+    /* Alignment of the regions the arena is split in. */
+    static constexpr size_t regionAlignment = 16;
+
+    ArenaPlanner::ArenaPlanner(uint8_t* arena, size_t arenaSize, size_t swapSize)
+    :   m_arena{arena},
+        m_arenaSize{arenaSize}
+    {
+        if (swapSize > arenaSize) {
+            printf_err("Swap region (%zu bytes) larger than the tensor arena (%zu bytes)\n",
+                       swapSize, arenaSize);
+            swapSize = arenaSize;
+        }
+
+        /* The swap region takes the end of the arena; keep its start aligned. */
+        this->m_residentSize = (arenaSize - swapSize) & ~(regionAlignment - 1);
+        this->m_swapSize = arenaSize - this->m_residentSize;
+    }
+
+    bool ArenaPlanner::Register(Model& model,
+                                const char* name,
+                                const uint8_t* modelAddr,
+                                uint32_t modelSize,
+                                ArenaPlacement placement,
+                                OpProfiler* opProfiler)
+    {
+        if (this->Find(model)) {
+            printf_err("Model %s is already registered\n", name);
+            return false;
+        }
+
+        if (placement == ArenaPlacement::Swapped && this->m_swapSize == 0) {
+            printf_err("No swap region for model %s\n", name);
+            return false;
+        }
+
+        ModelUsage usage;
+        usage.model = &model;
+        usage.name = name;
+        usage.modelAddr = modelAddr;
+        usage.modelSize = modelSize;
+        usage.placement = placement;
+        usage.opProfiler = opProfiler;
+        this->m_models.push_back(usage);
+
+        if (placement == ArenaPlacement::Swapped) {
+            return true;
+        }
+
+        /* Resident models share one allocator, created with the first of them. */
+        if (!this->m_residentAllocator) {
+            this->m_residentAllocator = CreateAllocator(
+                this->m_arena, this->m_residentSize, this->m_residentBuffers);
+            if (!this->m_residentAllocator) {
+                printf_err("Failed to create the resident allocator\n");
+                this->m_models.pop_back();
+                return false;
+            }
+            this->m_residentOverhead = this->m_residentBuffers->GetPersistentUsedBytes();
+        }
+
+        if (!this->InitModel(this->m_models.back(), this->m_residentAllocator, this->m_residentBuffers)) {
+            this->m_models.pop_back();
+            return false;
+        }
+        return true;
+    }
+
+    bool ArenaPlanner::Load(Model& model)
+    {
+        ModelUsage* usage = this->Find(model);
+        if (!usage) {
+            printf_err("Model is not registered\n");
+            return false;
+        }
+
+        if (usage->loaded) {
+            return true;
+        }
+
+        if (usage->placement == ArenaPlacement::Resident) {
+            printf_err("Resident model %s failed to initialise at registration\n", usage->name);
+            return false;
+        }
+
+        /* The previous occupant must be gone before its memory is reused. */
+        if (this->m_swapped) {
+            this->Unload(*this->m_swapped);
+        }
+
+        tflite::SingleArenaBufferAllocator* buffers = nullptr;
+        tflite::MicroAllocator* allocator = CreateAllocator(
+            this->m_arena + this->m_residentSize, this->m_swapSize, buffers);
+        if (!allocator) {
+            printf_err("Failed to create the swap allocator\n");
+            return false;
+        }
+
+        if (!this->InitModel(*usage, allocator, buffers)) {
+            return false;
+        }
+
+        this->m_swapped = &model;
+        this->m_swapPeak = std::max(this->m_swapPeak,
+            buffers->GetPersistentUsedBytes() + buffers->GetNonPersistentUsedBytes());
+        return true;
+    }
+
+    void ArenaPlanner::Unload(Model& model)
+    {
+        ModelUsage* usage = this->Find(model);
+        if (!usage || !usage->loaded) {
+            return;
+        }
+
+        if (usage->placement == ArenaPlacement::Resident) {
+            printf_err("Resident model %s cannot be unloaded\n", usage->name);
+            return;
+        }
+
+        model.Release();
+        usage->loaded = false;
+        if (this->m_swapped == &model) {
+            this->m_swapped = nullptr;
+        }
+    }
+
+    void ArenaPlanner::PrintReport() const
+    {
+        info("Tensor arena at 0x%p: %zu bytes\n", this->m_arena, this->m_arenaSize);
+        info("%-16s %-9s %12s %12s %12s  %s\n",
+             "Model", "Placement", "Persistent", "Scratch", "Scratch+", "State");
+
+        size_t residentPersistent = 0;
+        for (const auto& usage : this->m_models) {
+            const bool resident = usage.placement == ArenaPlacement::Resident;
+            if (resident) {
+                residentPersistent += usage.persistentBytes;
+            }
+            info("%-16s %-9s %12zu %12zu %12zu  %s\n",
+                 usage.name, resident ? "resident" : "swapped",
+                 usage.persistentBytes, usage.scratchBytes, usage.scratchGrowth,
+                 usage.loaded ? "loaded" : "unloaded");
+        }
+
+        const size_t residentScratch = this->m_residentBuffers ?
+            this->m_residentBuffers->GetNonPersistentUsedBytes() : 0;
+        info("Resident region: %zu of %zu bytes used (allocator %zu, persistent %zu, "
+             "shared scratch %zu), %zu free\n",
+             this->GetResidentUsedBytes(), this->m_residentSize, this->m_residentOverhead,
+             residentPersistent, residentScratch, this->GetResidentFreeBytes());
+
+        if (this->m_swapSize) {
+            info("Swap region: largest model footprint %zu of %zu bytes\n",
+                 this->m_swapPeak, this->m_swapSize);
+        }
+
+        const size_t used = this->GetResidentUsedBytes() + this->m_swapPeak;
+        info("Tensor arena used: %zu of %zu bytes (%.1f%%)\n", used, this->m_arenaSize,
+             this->m_arenaSize ? 100.0 * used / this->m_arenaSize : 0.0);
+    }
+
+    size_t ArenaPlanner::GetResidentUsedBytes() const
+    {
+        if (!this->m_residentBuffers) {
+            return 0;
+        }
+        return this->m_residentBuffers->GetPersistentUsedBytes() +
+               this->m_residentBuffers->GetNonPersistentUsedBytes();
+    }
+
+    size_t ArenaPlanner::GetResidentFreeBytes() const
+    {
+        return this->m_residentSize - std::min(this->m_residentSize, this->GetResidentUsedBytes());
+    }
+
+    size_t ArenaPlanner::GetSwapPeakBytes() const
+    {
+        return this->m_swapPeak;
+    }
+
+    const std::vector<ArenaPlanner::ModelUsage>& ArenaPlanner::GetModelUsage() const
+    {
+        return this->m_models;
+    }
+
+    tflite::MicroAllocator* ArenaPlanner::CreateAllocator(uint8_t* region, size_t size,
+                                                          tflite::SingleArenaBufferAllocator*& buffers)
+    {
+        /* As tflite::MicroAllocator::Create does, but keeping hold of the buffer
+         * allocator to read the persistent and scratch usage from it. */
+        buffers = tflite::SingleArenaBufferAllocator::Create(region, size);
+        if (!buffers) {
+            return nullptr;
+        }
+
+        uint8_t* plannerBuffer = buffers->AllocatePersistentBuffer(
+            sizeof(tflite::GreedyMemoryPlanner), alignof(tflite::GreedyMemoryPlanner));
+        if (!plannerBuffer) {
+            return nullptr;
+        }
+
+        auto* planner = new (plannerBuffer) tflite::GreedyMemoryPlanner();
+        return tflite::MicroAllocator::Create(buffers, planner);
+    }
+
+    bool ArenaPlanner::InitModel(ModelUsage& usage, tflite::MicroAllocator* allocator,
+                                 tflite::SingleArenaBufferAllocator* buffers)
+    {
+        const size_t persistentBefore = buffers->GetPersistentUsedBytes();
+        const size_t scratchBefore = buffers->GetNonPersistentUsedBytes();
+
+        if (!usage.model->Init(this->m_arena, this->m_arenaSize,
+                               usage.modelAddr, usage.modelSize,
+                               allocator, usage.opProfiler)) {
+            printf_err("Failed to initialise model %s\n", usage.name);
+            return false;
+        }
+
+        usage.persistentBytes = buffers->GetPersistentUsedBytes() - persistentBefore;
+        usage.scratchBytes = buffers->GetNonPersistentUsedBytes();
+        usage.scratchGrowth = usage.scratchBytes - std::min(usage.scratchBytes, scratchBefore);
+        usage.loaded = true;
+
+        debug("Model %s: %zu persistent bytes, scratch area %zu bytes\n",
+              usage.name, usage.persistentBytes, usage.scratchBytes);
+        return true;
+    }
+
+    ArenaPlanner::ModelUsage* ArenaPlanner::Find(const Model& model)
+    {
+        for (auto& usage : this->m_models) {
+            if (usage.model == &model) {
+                return &usage;
+            }
+        }
+        return nullptr;
+    }
+
+} /* namespace app */
+} /* namespace arm */
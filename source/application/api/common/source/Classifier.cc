@@ -23,6 +23,7 @@
 #include <vector>
 #include <string>
 #include <set>
+#include <cmath>
 #include <cstdint>
 #include <cinttypes>
 
@@ -30,6 +31,84 @@
 namespace arm {
 namespace app {
 
+namespace {
+
+    /**
+     * @brief       Selects the top N entries of raw tensor data, best first, and
+     *              accumulates the Softmax normaliser in the same pass. On ties the
+     *              earlier entry is kept in the selection and the later one ranked
+     *              first, as with the set based Classifier::GetTopNResults.
+     * @param[in]   data        Raw tensor data.
+     * @param[in]   size        Number of entries.
+     * @param[in]   scale       Dequantisation scale.
+     * @param[out]  results     Array of topNCount results; only label indices are set.
+     * @param[in]   topNCount   Number of results.
+     * @param[out]  max         Largest raw value.
+     * @return      Sum of exp(x - max(x)) over the dequantised entries x.
+     **/
+    template<typename T>
+    float SelectTopN(const T* data, uint32_t size, float scale,
+                     ClassificationResultRef* results, uint32_t topNCount, T& max)
+    {
+        max = data[0];
+        float expSum = 0;
+        uint32_t count = 0;
+
+        for (uint32_t i = 0; i < size; ++i) {
+            const T value = data[i];
+
+            /* Running normaliser, rescaled whenever the maximum grows. */
+            if (value > max) {
+                expSum *= std::exp(scale * (static_cast<float>(max) - static_cast<float>(value)));
+                max = value;
+            }
+            expSum += std::exp(scale * (static_cast<float>(value) - static_cast<float>(max)));
+
+            if (count == topNCount) {
+                if (!(data[results[count - 1].m_labelIdx] < value)) {
+                    continue;
+                }
+                --count;
+            }
+
+            /* Insert into the sorted selection. */
+            uint32_t pos = count++;
+            for (; pos > 0 && data[results[pos - 1].m_labelIdx] <= value; --pos) {
+                results[pos].m_labelIdx = results[pos - 1].m_labelIdx;
+            }
+            results[pos].m_labelIdx = i;
+        }
+        return expSum;
+    }
+
+    /**
+     * @brief       Fills in the top N results from raw tensor data.
+     * @return      true if successful, false otherwise.
+     **/
+    template<typename T>
+    bool GetTopNFromTensor(const T* data, uint32_t size, const QuantParams& quantParams,
+                           ClassificationResultRef* results, uint32_t topNCount,
+                           const std::vector <std::string>& labels, bool useSoftmax)
+    {
+        T max;
+        const float expSum = SelectTopN(data, size, quantParams.scale, results, topNCount, max);
+
+        for (uint32_t i = 0; i < topNCount; ++i) {
+            const T value = data[results[i].m_labelIdx];
+            if (useSoftmax) {
+                results[i].m_normalisedVal = std::exp(quantParams.scale *
+                    (static_cast<float>(value) - static_cast<float>(max))) / expSum;
+            } else {
+                results[i].m_normalisedVal = quantParams.scale *
+                    (static_cast<float>(value) - quantParams.offset);
+            }
+            results[i].m_label = &labels[results[i].m_labelIdx];
+        }
+        return true;
+    }
+
+} /* anonymous namespace */
+
     void Classifier::SetVectorResults(std::set<std::pair<float, uint32_t>>& topNSet,
             std::vector<ClassificationResult>& vecResults,
             const std::vector <std::string>& labels)
@@ -81,7 +160,36 @@ namespace app {
             std::vector<ClassificationResult>& vecResults, const std::vector <std::string>& labels,
             uint32_t topNCount, bool useSoftmax)
     {
-        if (outputTensor == nullptr) {
+        /* Select on the output tensor directly, without a float copy of it. */
+        std::vector<ClassificationResultRef> heapRefs;
+        ClassificationResultRef stackRefs[ms_maxTopNOnStack];
+        ClassificationResultRef* refs = stackRefs;
+        if (topNCount > ms_maxTopNOnStack) {
+            heapRefs.resize(topNCount);
+            refs = heapRefs.data();
+        }
+
+        vecResults.clear();
+        if (!this->GetClassificationResultRefs(outputTensor, refs, labels, topNCount, useSoftmax)) {
+            printf_err("Failed to get top N results set\n");
+            return false;
+        }
+
+        vecResults.resize(topNCount);
+        for (uint32_t i = 0; i < topNCount; ++i) {
+            vecResults[i].m_normalisedVal = refs[i].m_normalisedVal;
+            vecResults[i].m_label = *refs[i].m_label;
+            vecResults[i].m_labelIdx = refs[i].m_labelIdx;
+        }
+
+        return true;
+    }
+
+    bool Classifier::GetClassificationResultRefs(TfLiteTensor* outputTensor,
+            ClassificationResultRef* results, const std::vector <std::string>& labels,
+            uint32_t topNCount, bool useSoftmax)
+    {
+        if (outputTensor == nullptr || results == nullptr) {
             printf_err("Output vector is null pointer.\n");
             return false;
         }
@@ -103,61 +211,23 @@ namespace app {
             return false;
         }
 
-        bool resultState;
-        vecResults.clear();
-
-        /* De-Quantize Output Tensor */
         QuantParams quantParams = GetTensorQuantParams(outputTensor);
 
-        /* Floating point tensor data to be populated
-         * NOTE: The assumption here is that the output tensor size isn't too
-         * big and therefore, there's neglibible impact on heap usage. */
-        std::vector<float> tensorData(totalOutputSize);
-
-        /* Populate the floating point buffer */
         switch (outputTensor->type) {
-            case kTfLiteUInt8: {
-                uint8_t *tensor_buffer = tflite::GetTensorData<uint8_t>(outputTensor);
-                for (size_t i = 0; i < totalOutputSize; ++i) {
-                    tensorData[i] = quantParams.scale *
-                        (static_cast<float>(tensor_buffer[i]) - quantParams.offset);
-                }
-                break;
-            }
-            case kTfLiteInt8: {
-                int8_t *tensor_buffer = tflite::GetTensorData<int8_t>(outputTensor);
-                for (size_t i = 0; i < totalOutputSize; ++i) {
-                    tensorData[i] = quantParams.scale *
-                        (static_cast<float>(tensor_buffer[i]) - quantParams.offset);
-                }
-                break;
-            }
-            case kTfLiteFloat32: {
-                float *tensor_buffer = tflite::GetTensorData<float>(outputTensor);
-                for (size_t i = 0; i < totalOutputSize; ++i) {
-                    tensorData[i] = tensor_buffer[i];
-                }
-                break;
-            }
+            case kTfLiteUInt8:
+                return GetTopNFromTensor(tflite::GetTensorData<uint8_t>(outputTensor), totalOutputSize,
+                                         quantParams, results, topNCount, labels, useSoftmax);
+            case kTfLiteInt8:
+                return GetTopNFromTensor(tflite::GetTensorData<int8_t>(outputTensor), totalOutputSize,
+                                         quantParams, results, topNCount, labels, useSoftmax);
+            case kTfLiteFloat32:
+                return GetTopNFromTensor(tflite::GetTensorData<float>(outputTensor), totalOutputSize,
+                                         QuantParams{}, results, topNCount, labels, useSoftmax);
             default:
                 printf_err("Tensor type %s not supported by classifier\n",
                     TfLiteTypeGetName(outputTensor->type));
                 return false;
         }
-
-        if (useSoftmax) {
-            math::MathUtils::SoftmaxF32(tensorData);
-        }
-
-        /* Get the top N results. */
-        resultState = GetTopNResults(tensorData, vecResults, topNCount, labels);
-
-        if (!resultState) {
-            printf_err("Failed to get top N results set\n");
-            return false;
-        }
-
-        return true;
     }
 } /* namespace app */
 } /* namespace arm */
\ No newline at end of file
@@ -0,0 +1,84 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DspTables.hpp"
+#include "log_macros.h"
+
+namespace arm {
+namespace app {
+namespace audio {
+
+#if defined(DSP_TABLES_GENERATED)
+    /* Defined by the generated DspTablesData.cc. */
+    const FrontEndTables* GetGeneratedFrontEndTables(size_t& count);
+    const RNNoiseTables* GetGeneratedRNNoiseTables(size_t& count);
+#endif /* defined(DSP_TABLES_GENERATED) */
+
+    const FrontEndTables* FindFrontEndTables(const FrontEndKind kind,
+                                             const MelFilterBankParams& melParams,
+                                             const uint32_t frameLen,
+                                             const uint32_t numMfccFeatures)
+    {
+#if defined(DSP_TABLES_GENERATED)
+        if (kind == FrontEndKind::Custom) {
+            return nullptr;
+        }
+
+        size_t count = 0;
+        const FrontEndTables* tables = GetGeneratedFrontEndTables(count);
+        for (size_t i = 0; i < count; ++i) {
+            const FrontEndTables& entry = tables[i];
+            if (entry.kind == kind &&
+                    entry.melParams.samplingFreq == melParams.samplingFreq &&
+                    entry.melParams.numFbankBins == melParams.numFbankBins &&
+                    entry.melParams.melLoFreq == melParams.melLoFreq &&
+                    entry.melParams.melHiFreq == melParams.melHiFreq &&
+                    entry.melParams.frameLenPadded == melParams.frameLenPadded &&
+                    entry.melParams.useHtkMethod == melParams.useHtkMethod &&
+                    entry.frameLen == frameLen &&
+                    entry.numMfccFeatures == numMfccFeatures) {
+                return &entry;
+            }
+        }
+#else /* defined(DSP_TABLES_GENERATED) */
+        UNUSED(kind);
+        UNUSED(melParams);
+        UNUSED(frameLen);
+        UNUSED(numMfccFeatures);
+#endif /* defined(DSP_TABLES_GENERATED) */
+        return nullptr;
+    }
+
+    const RNNoiseTables* FindRNNoiseTables(const uint32_t frameSize, const uint32_t numBands)
+    {
+#if defined(DSP_TABLES_GENERATED)
+        size_t count = 0;
+        const RNNoiseTables* tables = GetGeneratedRNNoiseTables(count);
+        for (size_t i = 0; i < count; ++i) {
+            if (tables[i].frameSize == frameSize && tables[i].numBands == numBands) {
+                return &tables[i];
+            }
+        }
+#else /* defined(DSP_TABLES_GENERATED) */
+        UNUSED(frameSize);
+        UNUSED(numBands);
+#endif /* defined(DSP_TABLES_GENERATED) */
+        return nullptr;
+    }
+
+} /* namespace audio */
+} /* namespace app */
+} /* namespace arm */
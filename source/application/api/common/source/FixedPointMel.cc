@@ -0,0 +1,257 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "FixedPointMel.hpp"
+#include "log_macros.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace arm {
+namespace app {
+namespace audio {
+
+namespace {
+
+    constexpr uint32_t log2TableBits = 8;
+
+    /* log2(1 + i / 256) in Q16, i = 0 ... 256. */
+    struct Log2Table {
+        uint32_t values[(1u << log2TableBits) + 1];
+
+        Log2Table()
+        {
+            for (uint32_t i = 0; i <= (1u << log2TableBits); ++i) {
+                this->values[i] = static_cast<uint32_t>(std::lround(
+                    std::log2(1.0 + static_cast<double>(i) / (1u << log2TableBits)) *
+                    (1 << FixedPointMel::ms_log2FracBits)));
+            }
+        }
+    };
+
+    const Log2Table& GetLog2Table()
+    {
+        static const Log2Table table;
+        return table;
+    }
+
+    /* Floor of the square root. */
+    uint32_t SqrtU64(uint64_t value)
+    {
+        uint64_t root = 0;
+        uint64_t bit = uint64_t{1} << 62;
+        while (bit > value) {
+            bit >>= 2;
+        }
+        while (bit) {
+            if (value >= root + bit) {
+                value -= root + bit;
+                root = (root >> 1) + bit;
+            } else {
+                root >>= 1;
+            }
+            bit >>= 2;
+        }
+        return static_cast<uint32_t>(root);
+    }
+
+} /* anonymous namespace */
+
+    bool FixedPointMel::Init(const float* window,
+                             const size_t windowLen,
+                             const uint32_t frameLenPadded,
+                             const MelFilterBank& melFilterBank,
+                             const Spectrum spectrum)
+    {
+        this->m_fftInstance.m_initialised = false;
+        if (!window || windowLen > frameLenPadded) {
+            printf_err("Unexpected window length\n");
+            return false;
+        }
+        if (!math::MathUtils::FftInitQ31(frameLenPadded, this->m_fftInstance)) {
+            return false;
+        }
+
+        this->m_windowQ31.resize(windowLen);
+        for (size_t i = 0; i < windowLen; ++i) {
+            this->m_windowQ31[i] = static_cast<int32_t>(std::min(std::max(
+                std::round(static_cast<double>(window[i]) * 2147483648.0), -2147483648.0), 2147483647.0));
+        }
+
+        this->m_windowed.assign(windowLen, 0);
+        this->m_frame.assign(frameLenPadded, 0);
+        this->m_fftOutput.assign(frameLenPadded, 0);
+        this->m_numSpectrumBins = frameLenPadded / 2;
+        this->m_spectrum.assign(this->m_numSpectrumBins, 0);
+        this->m_spectrumType = spectrum;
+
+        /* Scaling of the integer spectrum: the magnitude is in Q31 and the power in
+         * Q46, of the spectrum divided by the FFT length. */
+        const double log2FftLen = std::log2(static_cast<double>(frameLenPadded));
+        const double spectrumLog2Scale = (spectrum == Spectrum::Magnitude) ?
+                                         31 - log2FftLen : 46 - 2 * log2FftLen;
+
+        const uint32_t numBanks = melFilterBank.GetNumBanks();
+        this->m_weights.clear();
+        this->m_bankOffsets.assign(1, 0);
+        this->m_bankFirst.resize(numBanks);
+        this->m_bankLog2Offset.assign(numBanks, 0);
+
+        for (uint32_t bank = 0; bank < numBanks; ++bank) {
+            const float* weights = melFilterBank.GetBankWeights(bank);
+            this->m_bankFirst[bank] = melFilterBank.GetBankFirstBin(bank);
+            const uint32_t numWeights = std::min<uint32_t>(melFilterBank.GetBankSize(bank),
+                this->m_numSpectrumBins - std::min(this->m_bankFirst[bank], this->m_numSpectrumBins));
+
+            /* Scale each bank so its largest weight uses the full 16 bits. */
+            float maxWeight = 0;
+            for (uint32_t i = 0; i < numWeights; ++i) {
+                maxWeight = std::max(maxWeight, weights[i]);
+            }
+            const double weightScale = maxWeight > 0 ? 65535.0 / maxWeight : 0;
+            for (uint32_t i = 0; i < numWeights; ++i) {
+                this->m_weights.push_back(static_cast<uint16_t>(
+                    std::lround(std::max(weights[i], 0.0f) * weightScale)));
+            }
+            this->m_bankOffsets.push_back(this->m_weights.size());
+
+            if (weightScale > 0) {
+                this->m_bankLog2Offset[bank] = static_cast<int32_t>(std::lround(
+                    -(spectrumLog2Scale + std::log2(weightScale)) * (1 << ms_log2FracBits)));
+            }
+        }
+
+        return true;
+    }
+
+    bool FixedPointMel::IsInitialised() const
+    {
+        return this->m_fftInstance.m_initialised;
+    }
+
+    void FixedPointMel::ComputeLog2MelEnergies(const int16_t* audioData, const size_t audioDataLen,
+                                               int32_t* log2Energies)
+    {
+        const size_t numSamples = audioData ? std::min(audioDataLen, this->m_windowQ31.size()) : 0;
+
+        /* Q15 sample by Q31 window, to Q46. */
+        int64_t peak = 0;
+        for (size_t i = 0; i < numSamples; ++i) {
+            const int64_t windowed = static_cast<int64_t>(audioData[i]) * this->m_windowQ31[i];
+            this->m_windowed[i] = windowed;
+            peak = std::max(peak, windowed < 0 ? -windowed : windowed);
+        }
+
+        /* Block floating point: the frame is scaled up by 2^scaleBits so that its peak
+         * uses the full Q31 range, keeping quiet and narrowband frames well above the
+         * rounding of the FFT stages. The energies are scaled back in the log domain. */
+        int32_t scaleBits = 0;
+        if (peak) {
+            int32_t msb = 62;
+            while (!(peak >> msb)) {
+                --msb;
+            }
+            scaleBits = 45 - msb;
+        }
+        for (size_t i = 0; i < numSamples; ++i) {
+            const int64_t windowed = this->m_windowed[i];
+            this->m_frame[i] = static_cast<int32_t>(scaleBits >= 15 ?
+                windowed * (int64_t{1} << (scaleBits - 15)) : windowed >> (15 - scaleBits));
+        }
+        std::fill(this->m_frame.begin() + numSamples, this->m_frame.end(), 0);
+
+        math::MathUtils::FftRealQ31(this->m_frame.data(), this->m_fftOutput.data(), this->m_fftInstance);
+
+        /* Bin 0 is real; bin N/2 is not used by the filter banks. */
+        const int32_t* fft = this->m_fftOutput.data();
+        const auto dc = static_cast<uint64_t>(std::abs(static_cast<int64_t>(fft[0])));
+        const bool usePower = this->m_spectrumType == Spectrum::Power;
+        this->m_spectrum[0] = usePower ? (dc * dc) >> 16 : dc;
+        for (uint32_t k = 1; k < this->m_numSpectrumBins; ++k) {
+            const int64_t re = fft[k * 2];
+            const int64_t im = fft[k * 2 + 1];
+            const uint64_t power = static_cast<uint64_t>(re * re) + static_cast<uint64_t>(im * im);
+            this->m_spectrum[k] = usePower ? power >> 16 : SqrtU64(power);
+        }
+
+        /* Both spectra are bounded by the frame energy, so the weighted sums fit. */
+        const int32_t scaleLog2 = (usePower ? 2 : 1) * scaleBits * (1 << ms_log2FracBits);
+        const size_t numBanks = this->m_bankFirst.size();
+        for (size_t bank = 0; bank < numBanks; ++bank) {
+            const uint64_t* spectrum = this->m_spectrum.data() + this->m_bankFirst[bank];
+            const uint16_t* weights = this->m_weights.data() + this->m_bankOffsets[bank];
+            const uint32_t numWeights = this->m_bankOffsets[bank + 1] - this->m_bankOffsets[bank];
+
+            uint64_t energy = 0;
+            for (uint32_t i = 0; i < numWeights; ++i) {
+                energy += spectrum[i] * weights[i];
+            }
+            log2Energies[bank] = energy ?
+                Log2Q16(energy) + this->m_bankLog2Offset[bank] - scaleLog2 : ms_log2Floor;
+        }
+    }
+
+    int32_t FixedPointMel::Log2Q16(const uint64_t value)
+    {
+        /* Integer part from the leading one, fraction from the bits below it. */
+        int32_t msb = 63;
+        while (!(value >> msb)) {
+            --msb;
+        }
+        const uint64_t normalised = value << (63 - msb);
+        const uint32_t index = static_cast<uint32_t>(normalised >> (63 - log2TableBits)) &
+                               ((1u << log2TableBits) - 1);
+        const uint32_t frac = static_cast<uint32_t>(normalised >> (63 - log2TableBits - 16)) & 0xFFFF;
+
+        const uint32_t* table = GetLog2Table().values;
+        const uint32_t interpolated = table[index] +
+            (((table[index + 1] - table[index]) * frac + 0x8000) >> 16);
+        return msb * (1 << ms_log2FracBits) + static_cast<int32_t>(interpolated);
+    }
+
+    bool FixedPointRequantiser::Set(const double multiplier, const double bias)
+    {
+        if (!(multiplier > 0)) {
+            printf_err("Requantisation multiplier must be positive\n");
+            return false;
+        }
+
+        int exponent = 0;
+        const double mantissa = std::frexp(multiplier, &exponent);
+        int64_t fixedMantissa = std::llround(mantissa * (int64_t{1} << 31));
+        if (fixedMantissa == (int64_t{1} << 31)) {
+            fixedMantissa /= 2;
+            ++exponent;
+        }
+
+        /* value * multiplier = (value * fixedMantissa) >> shift; keep 2^31 * 2^31 plus
+         * the bias within 64 bits. */
+        const int shift = 31 - exponent;
+        const double scaledBias = std::ldexp(bias, shift);
+        if (shift < 1 || shift > 62 || std::fabs(scaledBias) >= std::ldexp(1.0, 61)) {
+            printf_err("Requantisation multiplier %f or bias %f out of range\n", multiplier, bias);
+            return false;
+        }
+
+        this->m_multiplier = fixedMantissa;
+        this->m_shift = shift;
+        this->m_bias = std::llround(scaledBias) + (int64_t{1} << (shift - 1));
+        return true;
+    }
+
+} /* namespace audio */
+} /* namespace app */
+} /* namespace arm */
@@ -16,8 +16,13 @@
  */
 #include "ImageUtils.hpp"
 
+#include <algorithm>
 #include <limits>
 
+#if __ARM_FEATURE_MVE & 1
+#include <arm_mve.h>
+#endif /* __ARM_FEATURE_MVE & 1 */
+
 namespace arm {
 namespace app {
 namespace image {
@@ -98,13 +103,8 @@ namespace image {
 
     void ConvertImgToInt8(void* data, const size_t kMaxImageSize)
     {
-        auto* tmp_req_data = static_cast<uint8_t*>(data);
-        auto* tmp_signed_req_data = static_cast<int8_t*>(data);
-
-        for (size_t i = 0; i < kMaxImageSize; i++) {
-            tmp_signed_req_data[i] = (int8_t) (
-                    (int32_t) (tmp_req_data[i]) - 128);
-        }
+        ConvertImgToInt8(static_cast<const uint8_t*>(data), static_cast<int8_t*>(data),
+                         kMaxImageSize);
     }
 
     void RgbToGrayscale(const uint8_t* srcPtr, uint8_t* dstPtr, const size_t dstImgSz)
@@ -121,6 +121,64 @@ namespace image {
         }
     }
 
+    void GetNormalisedInt8Lut(const float scale, const int offset, int8_t* lut)
+    {
+        for (size_t i = 0; i < PixelLutSize; ++i) {
+            const float value = ((static_cast<float>(i) / 255.0f) / scale) + offset;
+            lut[i] = static_cast<int8_t>(std::min<float>(INT8_MAX, std::max<float>(value, INT8_MIN)));
+        }
+    }
+
+    void ConvertImgToInt8(const uint8_t* srcPtr, int8_t* dstPtr, const size_t imgSz,
+                          const int8_t* lut)
+    {
+        /* Kept as plain element-wise loops for the compiler to vectorise. */
+        if (lut) {
+            for (size_t i = 0; i < imgSz; ++i) {
+                dstPtr[i] = lut[srcPtr[i]];
+            }
+        } else {
+            for (size_t i = 0; i < imgSz; ++i) {
+                dstPtr[i] = static_cast<int8_t>(srcPtr[i] ^ 0x80);
+            }
+        }
+    }
+
+    void RgbToGrayscaleInt8(const uint8_t* srcPtr, int8_t* dstPtr, const size_t dstImgSz,
+                            const int8_t* lut)
+    {
+        size_t i = 0;
+
+#if __ARM_FEATURE_MVE & 1
+        /* Four pixels per iteration: de-interleave the channels with gather loads,
+         * then either look the gray values up or flip their top bit. */
+        const uint32x4_t offsets = vmulq_n_u32(vidupq_n_u32(0, 1), 3);
+        for (; i < dstImgSz; i += 4, srcPtr += 12) {
+            const mve_pred16_t p = vctp32q(dstImgSz - i);
+            uint32x4_t gray = vmulq_n_u32(vldrbq_gather_offset_z_u32(srcPtr, offsets, p), 156762);
+            gray = vmlaq_n_u32(gray, vldrbq_gather_offset_z_u32(srcPtr + 1, offsets, p), 307757);
+            gray = vmlaq_n_u32(gray, vldrbq_gather_offset_z_u32(srcPtr + 2, offsets, p), 59769);
+            gray = vshrq_n_u32(vaddq_n_u32(gray, 42), 19);
+            if (lut) {
+                gray = vldrbq_gather_offset_z_u32(reinterpret_cast<const uint8_t*>(lut), gray, p);
+            } else {
+                gray = veorq_u32(gray, vdupq_n_u32(0x80));
+            }
+            vstrbq_p_u32(reinterpret_cast<uint8_t*>(dstPtr + i), gray, p);
+        }
+#else /* __ARM_FEATURE_MVE & 1 */
+        if (lut) {
+            for (; i < dstImgSz; ++i, srcPtr += 3) {
+                dstPtr[i] = lut[RgbToGray(srcPtr[0], srcPtr[1], srcPtr[2])];
+            }
+        } else {
+            for (; i < dstImgSz; ++i, srcPtr += 3) {
+                dstPtr[i] = static_cast<int8_t>(RgbToGray(srcPtr[0], srcPtr[1], srcPtr[2]) ^ 0x80);
+            }
+        }
+#endif /* __ARM_FEATURE_MVE & 1 */
+    }
+
 } /* namespace image */
 } /* namespace app */
 } /* namespace arm */
\ No newline at end of file
@@ -0,0 +1,233 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "MelFilterBank.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace arm {
+namespace app {
+namespace audio {
+
+    MelFilterBank::MelFilterBank(const MelFilterBankParams& params, const std::vector<float>& normalisers)
+    :   m_params{params},
+        m_normalisers{normalisers}
+    {
+        const uint32_t numBanks = params.numFbankBins;
+        const size_t numFftBins = params.frameLenPadded / 2;
+        const float fftBinWidth = static_cast<float>(params.samplingFreq) / params.frameLenPadded;
+        const std::vector<float> melPoints = MelFilterBank::GetMelPoints(params);
+
+        /* Mel frequency of the centre of each FFT bin. */
+        std::vector<float> binMel(numFftBins);
+        for (size_t i = 0; i < numFftBins; ++i) {
+            binMel[i] = MelFilterBank::MelScale(fftBinWidth * i, params.useHtkMethod);
+        }
+
+        this->m_offsetsStorage.assign(1, 0);
+        this->m_firstBinStorage.assign(numBanks, 0);
+
+        for (uint32_t bank = 0; bank < numBanks; ++bank) {
+            const float leftMel = melPoints[bank];
+            const float centerMel = melPoints[bank + 1];
+            const float rightMel = melPoints[bank + 2];
+            const float normaliser = bank < normalisers.size() ? normalisers[bank] : 1.f;
+
+            /* Bins strictly inside the triangle; it is contiguous as the mel scale is monotonic. */
+            size_t first = 0;
+            while (first < numFftBins && !(binMel[first] > leftMel)) {
+                ++first;
+            }
+            size_t end = first;
+            while (end < numFftBins && binMel[end] < rightMel) {
+                ++end;
+            }
+
+            this->m_firstBinStorage[bank] = first < end ? first : 0;
+            for (size_t i = first; i < end; ++i) {
+                const float mel = binMel[i];
+                float weight;
+                if (mel <= centerMel) {
+                    weight = (mel - leftMel) / (centerMel - leftMel);
+                } else {
+                    weight = (rightMel - mel) / (rightMel - centerMel);
+                }
+                this->m_weightsStorage.push_back(weight * normaliser);
+            }
+            this->m_offsetsStorage.push_back(this->m_weightsStorage.size());
+        }
+
+        this->m_weights = this->m_weightsStorage.data();
+        this->m_offsets = this->m_offsetsStorage.data();
+        this->m_firstBin = this->m_firstBinStorage.data();
+        this->m_numBanks = numBanks;
+        this->InitBinRange();
+    }
+
+    MelFilterBank::MelFilterBank(const MelFilterBankParams& params, const float* weights,
+                                 const uint32_t* offsets, const uint32_t* firstBins)
+    :   m_params{params},
+        m_weights{weights},
+        m_offsets{offsets},
+        m_firstBin{firstBins},
+        m_numBanks{params.numFbankBins}
+    {
+        this->InitBinRange();
+    }
+
+    void MelFilterBank::InitBinRange()
+    {
+        this->m_minBin = UINT32_MAX;
+        this->m_endBin = 0;
+        for (uint32_t bank = 0; bank < this->m_numBanks; ++bank) {
+            if (this->GetBankSize(bank)) {
+                this->m_minBin = std::min(this->m_minBin, this->m_firstBin[bank]);
+                this->m_endBin = std::max(this->m_endBin, this->m_firstBin[bank] + this->GetBankSize(bank));
+            }
+        }
+        if (this->m_endBin == 0) {
+            this->m_minBin = 0;
+        }
+    }
+
+    std::shared_ptr<const MelFilterBank> MelFilterBank::GetShared(
+            const MelFilterBankParams& params, const std::vector<float>& normalisers)
+    {
+        static std::vector<std::weak_ptr<const MelFilterBank>> s_filterBanks;
+
+        /* Drop filter banks no instance uses any more. */
+        s_filterBanks.erase(std::remove_if(s_filterBanks.begin(), s_filterBanks.end(),
+                                           [](const std::weak_ptr<const MelFilterBank>& filterBank) {
+                                               return filterBank.expired();
+                                           }),
+                            s_filterBanks.end());
+
+        for (const auto& weakFilterBank : s_filterBanks) {
+            auto filterBank = weakFilterBank.lock();
+            if (filterBank && filterBank->Matches(params, normalisers)) {
+                return filterBank;
+            }
+        }
+
+        auto filterBank = std::make_shared<const MelFilterBank>(params, normalisers);
+        s_filterBanks.push_back(filterBank);
+        return filterBank;
+    }
+
+    std::vector<float> MelFilterBank::GetMelPoints(const MelFilterBankParams& params)
+    {
+        const float melLowFreq = MelFilterBank::MelScale(params.melLoFreq, params.useHtkMethod);
+        const float melHighFreq = MelFilterBank::MelScale(params.melHiFreq, params.useHtkMethod);
+        const float melFreqDelta = (melHighFreq - melLowFreq) / (params.numFbankBins + 1);
+
+        std::vector<float> melPoints(params.numFbankBins + 2);
+        for (size_t i = 0; i < melPoints.size(); ++i) {
+            melPoints[i] = melLowFreq + i * melFreqDelta;
+        }
+        return melPoints;
+    }
+
+    float MelFilterBank::MelScale(const float freq, const bool useHTKMethod)
+    {
+        if (useHTKMethod) {
+            return 1127.0f * logf (1.0f + freq / 700.0f);
+        } else {
+            /* Slaney formula for mel scale. */
+            float mel = freq / ms_freqStep;
+
+            if (freq >= ms_minLogHz) {
+                mel = ms_minLogMel + logf(freq / ms_minLogHz) / ms_logStep;
+            }
+            return mel;
+        }
+    }
+
+    float MelFilterBank::InverseMelScale(const float melFreq, const bool useHTKMethod)
+    {
+        if (useHTKMethod) {
+            return 700.0f * (expf (melFreq / 1127.0f) - 1.0f);
+        } else {
+            /* Slaney formula for inverse mel scale. */
+            float freq = ms_freqStep * melFreq;
+
+            if (melFreq >= ms_minLogMel) {
+                freq = ms_minLogHz * expf(ms_logStep * (melFreq - ms_minLogMel));
+            }
+            return freq;
+        }
+    }
+
+    void MelFilterBank::Apply(const float* spectrum, float* melEnergies, const float initialEnergy) const
+    {
+        const float* weights = this->m_weights;
+        for (size_t bank = 0; bank < this->m_numBanks; ++bank) {
+            const float* bins = spectrum + this->m_firstBin[bank];
+            const uint32_t numWeights = this->m_offsets[bank + 1] - this->m_offsets[bank];
+
+            float melEnergy = initialEnergy;
+            for (uint32_t i = 0; i < numWeights; ++i) {
+                melEnergy += weights[i] * bins[i];
+            }
+            melEnergies[bank] = melEnergy;
+            weights += numWeights;
+        }
+    }
+
+    uint32_t MelFilterBank::GetNumBanks() const
+    {
+        return this->m_numBanks;
+    }
+
+    uint32_t MelFilterBank::GetFirstBin() const
+    {
+        return this->m_minBin;
+    }
+
+    uint32_t MelFilterBank::GetEndBin() const
+    {
+        return this->m_endBin;
+    }
+
+    uint32_t MelFilterBank::GetBankFirstBin(const uint32_t bank) const
+    {
+        return this->m_firstBin[bank];
+    }
+
+    uint32_t MelFilterBank::GetBankSize(const uint32_t bank) const
+    {
+        return this->m_offsets[bank + 1] - this->m_offsets[bank];
+    }
+
+    const float* MelFilterBank::GetBankWeights(const uint32_t bank) const
+    {
+        return this->m_weights + this->m_offsets[bank];
+    }
+
+    bool MelFilterBank::Matches(const MelFilterBankParams& params, const std::vector<float>& normalisers) const
+    {
+        return this->m_params.samplingFreq == params.samplingFreq &&
+               this->m_params.numFbankBins == params.numFbankBins &&
+               this->m_params.melLoFreq == params.melLoFreq &&
+               this->m_params.melHiFreq == params.melHiFreq &&
+               this->m_params.frameLenPadded == params.frameLenPadded &&
+               this->m_params.useHtkMethod == params.useHtkMethod &&
+               this->m_normalisers == normalisers;
+    }
+
+} /* namespace audio */
+} /* namespace app */
+} /* namespace arm */
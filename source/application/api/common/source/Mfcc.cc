@@ -32,7 +32,8 @@ namespace audio {
                     const float melHiFreq,
                     const uint32_t numMfccFeats,
                     const uint32_t frameLen,
-                    const bool useHtkMethod):
+                    const bool useHtkMethod,
+                    const bool useFixedPoint):
                         m_samplingFreq(samplingFreq),
                         m_numFbankBins(numFbankBins),
                         m_melLoFreq(melLoFreq),
@@ -42,7 +43,8 @@ namespace audio {
 
                         /* Smallest power of 2 >= frame length. */
                         m_frameLenPadded(pow(2, ceil((log(frameLen)/log(2))))),
-                        m_useHtkMethod(useHtkMethod)
+                        m_useHtkMethod(useHtkMethod),
+                        m_useFixedPoint(useFixedPoint)
     {}
 
     void MfccParams::Log() const
@@ -56,6 +58,7 @@ namespace audio {
         debug("\t Frame length:               %" PRIu32 "\n", this->m_frameLen);
         debug("\t Padded frame length:        %" PRIu32 "\n", this->m_frameLenPadded);
         debug("\t Using HTK for Mel scale:    %s\n", this->m_useHtkMethod ? "yes" : "no");
+        debug("\t Using fixed point:          %s\n", this->m_useFixedPoint ? "yes" : "no");
     }
 
     MFCC::MFCC(const MfccParams& params):
@@ -69,15 +72,6 @@ namespace audio {
         this->m_melEnergies = std::vector<float>(
                                 this->m_params.m_numFbankBins, 0.0);
 
-        this->m_windowFunc = std::vector<float>(this->m_params.m_frameLen);
-        const auto multiplier = static_cast<float>(2 * M_PI / this->m_params.m_frameLen);
-
-        /* Create window function. */
-        for (size_t i = 0; i < this->m_params.m_frameLen; i++) {
-            this->m_windowFunc[i] = (0.5 - (0.5 *
-                math::MathUtils::CosineF32(static_cast<float>(i) * multiplier)));
-        }
-
         math::MathUtils::FftInitF32(this->m_params.m_frameLenPadded, this->m_fftInstance);
         this->m_params.Log();
     }
@@ -89,66 +83,32 @@ namespace audio {
 
     float MFCC::MelScale(const float freq, const bool useHTKMethod)
     {
-        if (useHTKMethod) {
-            return 1127.0f * logf (1.0f + freq / 700.0f);
-        } else {
-            /* Slaney formula for mel scale. */
-
-            float mel = freq / ms_freqStep;
-
-            if (freq >= ms_minLogHz) {
-                mel = ms_minLogMel + logf(freq / ms_minLogHz) / ms_logStep;
-            }
-            return mel;
-        }
+        return MelFilterBank::MelScale(freq, useHTKMethod);
     }
 
     float MFCC::InverseMelScale(const float melFreq, const bool useHTKMethod)
     {
-        if (useHTKMethod) {
-            return 700.0f * (expf (melFreq / 1127.0f) - 1.0f);
-        } else {
-            /* Slaney formula for mel scale. */
-            float freq = ms_freqStep * melFreq;
-
-            if (melFreq >= ms_minLogMel) {
-                freq = ms_minLogHz * expf(ms_logStep * (melFreq - ms_minLogMel));
-            }
-            return freq;
-        }
+        return MelFilterBank::InverseMelScale(melFreq, useHTKMethod);
     }
 
-
     bool MFCC::ApplyMelFilterBank(
-            std::vector<float>&                 fftVec,
-            std::vector<std::vector<float>>&    melFilterBank,
-            std::vector<uint32_t>&               filterBankFilterFirst,
-            std::vector<uint32_t>&               filterBankFilterLast,
-            std::vector<float>&                 melEnergies)
+            std::vector<float>&     fftVec,
+            const MelFilterBank&    melFilterBank,
+            std::vector<float>&     melEnergies)
     {
-        const size_t numBanks = melEnergies.size();
-
-        if (numBanks != filterBankFilterFirst.size() ||
-                numBanks != filterBankFilterLast.size()) {
+        if (melEnergies.size() != melFilterBank.GetNumBanks() ||
+                fftVec.size() < melFilterBank.GetEndBin()) {
             printf_err("unexpected filter bank lengths\n");
             return false;
         }
 
-        for (size_t bin = 0; bin < numBanks; ++bin) {
-            auto filterBankIter = melFilterBank[bin].begin();
-            auto end = melFilterBank[bin].end();
-            float melEnergy = FLT_MIN;  /* Avoid log of zero at later stages */
-            const uint32_t firstIndex = filterBankFilterFirst[bin];
-            const uint32_t lastIndex = std::min<uint32_t>(filterBankFilterLast[bin], fftVec.size() - 1);
-
-            for (uint32_t i = firstIndex; i <= lastIndex && filterBankIter != end; i++) {
-                float energyRep = math::MathUtils::SqrtF32(fftVec[i]);
-                melEnergy += (*filterBankIter++ * energyRep);
-            }
-
-            melEnergies[bin] = melEnergy;
+        /* Magnitudes of the bins in use, once per bin rather than once per filter. */
+        for (uint32_t i = melFilterBank.GetFirstBin(); i < melFilterBank.GetEndBin(); ++i) {
+            fftVec[i] = math::MathUtils::SqrtF32(fftVec[i]);
         }
 
+        /* Start from FLT_MIN to avoid log of zero at later stages. */
+        melFilterBank.Apply(fftVec.data(), melEnergies.data(), FLT_MIN);
         return true;
     }
 
@@ -209,39 +169,130 @@ namespace audio {
         return 1.f;
     }
 
+    FrontEndKind MFCC::GetFrontEndKind() const
+    {
+        return FrontEndKind::Custom;
+    }
+
     void MFCC::InitMelFilterBank()
     {
         if (!this->IsMelFilterBankInited()) {
-            this->m_melFilterBank = this->CreateMelFilterBank();
-            this->m_dctMatrix = this->CreateDCTMatrix(
-                                    this->m_params.m_numFbankBins,
-                                    this->m_params.m_numMfccFeatures);
+            const MelFilterBankParams melParams = this->GetMelFilterBankParams();
+            const FrontEndTables* tables = FindFrontEndTables(
+                    this->GetFrontEndKind(), melParams,
+                    this->m_params.m_frameLen, this->m_params.m_numMfccFeatures);
+
+            if (tables) {
+                /* Tables generated at build time, in read-only memory. */
+                this->m_window = tables->window;
+                this->m_dct = tables->dctMatrix;
+                this->m_melFilterBank = std::make_shared<const MelFilterBank>(
+                        tables->melParams, tables->melWeights, tables->melOffsets, tables->melFirstBins);
+            } else {
+                this->m_windowFunc = std::vector<float>(this->m_params.m_frameLen);
+                const auto multiplier = static_cast<float>(2 * M_PI / this->m_params.m_frameLen);
+
+                /* Create window function. */
+                for (size_t i = 0; i < this->m_params.m_frameLen; i++) {
+                    this->m_windowFunc[i] = (0.5 - (0.5 *
+                        math::MathUtils::CosineF32(static_cast<float>(i) * multiplier)));
+                }
+
+                this->m_melFilterBank = this->CreateMelFilterBank();
+                this->m_dctMatrix = this->CreateDCTMatrix(
+                                        this->m_params.m_numFbankBins,
+                                        this->m_params.m_numMfccFeatures);
+                this->m_window = this->m_windowFunc.data();
+                this->m_dct = this->m_dctMatrix.data();
+            }
+
+            if (this->m_params.m_useFixedPoint && !this->InitFixedPoint()) {
+                printf_err("Failed to initialise fixed point MFCC, using floating point\n");
+                this->m_params.m_useFixedPoint = false;
+            }
             this->m_filterBankInitialised = true;
         }
     }
 
+    bool MFCC::InitFixedPoint()
+    {
+        if (!this->m_fixedPointMel.Init(this->m_window, this->m_params.m_frameLen,
+                                        this->m_params.m_frameLenPadded,
+                                        *this->m_melFilterBank, FixedPointMel::Spectrum::Magnitude)) {
+            return false;
+        }
+
+        const size_t dctSize = this->m_params.m_numMfccFeatures * this->m_params.m_numFbankBins;
+        this->m_dctMatrixQ31.resize(dctSize);
+        for (size_t i = 0; i < dctSize; ++i) {
+            const double coefficient = std::round(static_cast<double>(this->m_dct[i]) * (1u << 31));
+            this->m_dctMatrixQ31[i] = static_cast<int32_t>(
+                std::min(std::max(coefficient, static_cast<double>(INT32_MIN)), static_cast<double>(INT32_MAX)));
+        }
+
+        this->m_log2MelEnergies.assign(this->m_params.m_numFbankBins, 0);
+        this->m_mfccFixedPoint.assign(this->m_params.m_numMfccFeatures, 0);
+        this->m_quantFeatures.assign(this->m_params.m_numMfccFeatures, 0);
+        this->m_requantScale = 0;
+        return true;
+    }
+
+    void MFCC::MfccComputeFixedPoint(const int16_t* audioData, const size_t audioDataLen)
+    {
+        this->m_fixedPointMel.ComputeLog2MelEnergies(audioData, audioDataLen, this->m_log2MelEnergies.data());
+
+        /* Q31 DCT of Q16 logarithms; the Q47 sums are rounded to Q15. */
+        const size_t numFbankBins = this->m_params.m_numFbankBins;
+        const int32_t* dct = this->m_dctMatrixQ31.data();
+        for (size_t i = 0; i < this->m_params.m_numMfccFeatures; ++i, dct += numFbankBins) {
+            int64_t sum = 0;
+            for (size_t j = 0; j < numFbankBins; ++j) {
+                sum += static_cast<int64_t>(dct[j]) * this->m_log2MelEnergies[j];
+            }
+            this->m_mfccFixedPoint[i] = static_cast<int32_t>((sum + (int64_t{1} << 31)) >> 32);
+        }
+    }
+
+    bool MFCC::MfccComputeQuantFixedPoint(const int16_t* audioData, const size_t audioDataLen,
+                                          const float quantScale, const int quantOffset)
+    {
+        /* Natural logarithm from Q15 log2 units, divided by the scale, plus the offset. */
+        if (quantScale != this->m_requantScale || quantOffset != this->m_requantOffset) {
+            if (!this->m_requantiser.Set(ms_ln2 / (32768.0 * quantScale), quantOffset)) {
+                return false;
+            }
+            this->m_requantScale = quantScale;
+            this->m_requantOffset = quantOffset;
+        }
+
+        this->MfccComputeFixedPoint(audioData, audioDataLen);
+        for (size_t i = 0; i < this->m_params.m_numMfccFeatures; ++i) {
+            this->m_quantFeatures[i] = this->m_requantiser.Apply(this->m_mfccFixedPoint[i]);
+        }
+        return true;
+    }
+
     bool MFCC::IsMelFilterBankInited() const
     {
         return this->m_filterBankInitialised;
     }
 
-    void MFCC::MfccComputePreFeature(const std::vector<int16_t>& audioData)
+    void MFCC::MfccComputePreFeature(const int16_t* audioData, const size_t audioDataLen)
     {
         this->InitMelFilterBank();
 
-        /* TensorFlow way of normalizing .wav data to (-1, 1). */
-        constexpr float normaliser = 1.0/(1u<<15u);
-        for (size_t i = 0; i < this->m_params.m_frameLen; i++) {
-            this->m_frame[i] = static_cast<float>(audioData[i]) * normaliser;
-        }
+        /* Samples beyond what the caller has provided are treated as zeros. */
+        const size_t numSamples = audioData ?
+                std::min<size_t>(audioDataLen, this->m_params.m_frameLen) : 0;
 
-        /* Apply window function to input frame. */
-        for(size_t i = 0; i < this->m_params.m_frameLen; i++) {
-            this->m_frame[i] *= this->m_windowFunc[i];
+        /* TensorFlow way of normalizing .wav data to (-1, 1) and apply window function. */
+        constexpr float normaliser = 1.0/(1u<<15u);
+        for (size_t i = 0; i < numSamples; i++) {
+            this->m_frame[i] = static_cast<float>(audioData[i]) * normaliser * this->m_window[i];
         }
 
         /* Set remaining frame values to 0. */
-        std::fill(this->m_frame.begin() + this->m_params.m_frameLen,this->m_frame.end(), 0);
+        std::fill(this->m_frame.begin() + numSamples, this->m_frame.end(), 0);
 
         /* Compute FFT. */
         math::MathUtils::FftF32(this->m_frame, this->m_buffer, this->m_fftInstance);
@@ -251,9 +302,7 @@ namespace audio {
 
         /* Apply mel filterbanks. */
         if (!this->ApplyMelFilterBank(this->m_buffer,
-                                      this->m_melFilterBank,
-                                      this->m_filterBankFilterFirst,
-                                      this->m_filterBankFilterLast,
+                                      *this->m_melFilterBank,
                                       this->m_melEnergies)) {
             printf_err("Failed to apply MEL filter banks\n");
         }
@@ -264,86 +313,76 @@ namespace audio {
 
     std::vector<float> MFCC::MfccCompute(const std::vector<int16_t>& audioData)
     {
-        this->MfccComputePreFeature(audioData);
-
         std::vector<float> mfccOut(this->m_params.m_numMfccFeatures);
+        this->MfccCompute(audioData.data(), audioData.size(), mfccOut.data());
+        return mfccOut;
+    }
+
+    bool MFCC::MfccCompute(const int16_t* audioData, const size_t audioDataLen,
+                           float* mfccOut, const size_t outStride)
+    {
+        if (!mfccOut || 0 == outStride) {
+            return false;
+        }
+
+        /* Initialisation may fall back to floating point. */
+        this->InitMelFilterBank();
+        if (this->m_params.m_useFixedPoint) {
+            this->MfccComputeFixedPoint(audioData, audioDataLen);
+            constexpr float log2ToLn = ms_ln2 / 32768.0;
+            for (size_t i = 0; i < this->m_params.m_numMfccFeatures; ++i) {
+                *mfccOut = static_cast<float>(this->m_mfccFixedPoint[i]) * log2ToLn;
+                mfccOut += outStride;
+            }
+            return true;
+        }
+
+        this->MfccComputePreFeature(audioData, audioDataLen);
 
         float * ptrMel = this->m_melEnergies.data();
-        float * ptrDct = this->m_dctMatrix.data();
-        float * ptrMfcc = mfccOut.data();
+        float * ptrDct = const_cast<float*>(this->m_dct);
 
         /* Take DCT. Uses matrix mul. */
-        for (size_t i = 0, j = 0; i < mfccOut.size();
+        for (size_t i = 0, j = 0; i < this->m_params.m_numMfccFeatures;
                     ++i, j += this->m_params.m_numFbankBins) {
-            *ptrMfcc++ = math::MathUtils::DotProductF32(
+            *mfccOut = math::MathUtils::DotProductF32(
                                             ptrDct + j,
                                             ptrMel,
                                             this->m_params.m_numFbankBins);
+            mfccOut += outStride;
         }
-        return mfccOut;
+        return true;
     }
 
-    std::vector<std::vector<float>> MFCC::CreateMelFilterBank()
+    uint32_t MFCC::GetNumMfccFeatures() const
     {
-        size_t numFftBins = this->m_params.m_frameLenPadded / 2;
-        float fftBinWidth = static_cast<float>(this->m_params.m_samplingFreq) / this->m_params.m_frameLenPadded;
+        return this->m_params.m_numMfccFeatures;
+    }
 
-        float melLowFreq = MFCC::MelScale(this->m_params.m_melLoFreq,
-                                          this->m_params.m_useHtkMethod);
-        float melHighFreq = MFCC::MelScale(this->m_params.m_melHiFreq,
-                                           this->m_params.m_useHtkMethod);
-        float melFreqDelta = (melHighFreq - melLowFreq) / (this->m_params.m_numFbankBins + 1);
+    MelFilterBankParams MFCC::GetMelFilterBankParams() const
+    {
+        return MelFilterBankParams{
+            this->m_params.m_samplingFreq,
+            this->m_params.m_numFbankBins,
+            this->m_params.m_melLoFreq,
+            this->m_params.m_melHiFreq,
+            this->m_params.m_frameLenPadded,
+            this->m_params.m_useHtkMethod};
+    }
 
-        std::vector<float> thisBin = std::vector<float>(numFftBins);
-        std::vector<std::vector<float>> melFilterBank(
-                                            this->m_params.m_numFbankBins);
-        this->m_filterBankFilterFirst =
-                        std::vector<uint32_t>(this->m_params.m_numFbankBins);
-        this->m_filterBankFilterLast =
-                        std::vector<uint32_t>(this->m_params.m_numFbankBins);
+    std::shared_ptr<const MelFilterBank> MFCC::CreateMelFilterBank()
+    {
+        const MelFilterBankParams params = this->GetMelFilterBankParams();
 
+        /* Normalisers come from the (possibly overridden) virtual, and key the sharing. */
+        const std::vector<float> melPoints = MelFilterBank::GetMelPoints(params);
+        std::vector<float> normalisers(this->m_params.m_numFbankBins);
         for (size_t bin = 0; bin < this->m_params.m_numFbankBins; bin++) {
-            float leftMel = melLowFreq + bin * melFreqDelta;
-            float centerMel = melLowFreq + (bin + 1) * melFreqDelta;
-            float rightMel = melLowFreq + (bin + 2) * melFreqDelta;
-
-            uint32_t firstIndex = 0;
-            uint32_t lastIndex = 0;
-            bool firstIndexFound = false;
-            const float normaliser = this->GetMelFilterBankNormaliser(leftMel, rightMel, this->m_params.m_useHtkMethod);
-
-            for (size_t i = 0; i < numFftBins; i++) {
-                float freq = (fftBinWidth * i);  /* Center freq of this fft bin. */
-                float mel = MFCC::MelScale(freq, this->m_params.m_useHtkMethod);
-                thisBin[i] = 0.0;
-
-                if (mel > leftMel && mel < rightMel) {
-                    float weight;
-                    if (mel <= centerMel) {
-                        weight = (mel - leftMel) / (centerMel - leftMel);
-                    } else {
-                        weight = (rightMel - mel) / (rightMel - centerMel);
-                    }
-
-                    thisBin[i] = weight * normaliser;
-                    if (!firstIndexFound) {
-                        firstIndex = i;
-                        firstIndexFound = true;
-                    }
-                    lastIndex = i;
-                }
-            }
-
-            this->m_filterBankFilterFirst[bin] = firstIndex;
-            this->m_filterBankFilterLast[bin] = lastIndex;
-
-            /* Copy the part we care about. */
-            for (uint32_t i = firstIndex; i <= lastIndex; i++) {
-                melFilterBank[bin].push_back(thisBin[i]);
-            }
+            normalisers[bin] = this->GetMelFilterBankNormaliser(
+                                    melPoints[bin], melPoints[bin + 2], this->m_params.m_useHtkMethod);
         }
 
-        return melFilterBank;
+        return MelFilterBank::GetShared(params, normalisers);
     }
 
 } /* namespace audio */
@@ -27,7 +27,8 @@ bool arm::app::Model::Init(uint8_t* tensorArenaAddr,
                            uint32_t tensorArenaSize,
                            const uint8_t* nnModelAddr,
                            uint32_t nnModelSize,
-                           tflite::MicroAllocator* allocator)
+                           tflite::MicroAllocator* allocator,
+                           OpProfiler* opProfiler)
 {
     /* Following tf lite micro example:
      * Map the model into a usable data structure. This doesn't involve any
@@ -57,7 +58,11 @@ bool arm::app::Model::Init(uint8_t* tensorArenaAddr,
     /* NOLINTNEXTLINE(runtime-global-variables) */
     debug("loading op resolver\n");
 
-    this->EnlistOperations();
+    /* The resolver keeps its operators when the model is initialised again. */
+    if (!this->m_opsEnlisted) {
+        this->EnlistOperations();
+        this->m_opsEnlisted = true;
+    }
 
     /* Create allocator instance, if it doesn't exist */
     this->m_pAllocator = allocator;
@@ -76,8 +81,15 @@ bool arm::app::Model::Init(uint8_t* tensorArenaAddr,
         debug("Using existing allocator @ 0x%p\n", this->m_pAllocator);
     }
 
+    /* Reserve the per-operator records now, so that inferences do not allocate. */
+    this->m_pOpProfiler = opProfiler;
+    if (this->m_pOpProfiler) {
+        this->m_pOpProfiler->Prepare(tflite::NumSubgraphOperators(this->m_pModel, 0));
+    }
+
     this->m_pInterpreter = std::make_unique<tflite::MicroInterpreter>(
-        this->m_pModel, this->GetOpResolver(), this->m_pAllocator);
+        this->m_pModel, this->GetOpResolver(), this->m_pAllocator,
+        nullptr, this->m_pOpProfiler);
 
     if (!this->m_pInterpreter) {
         printf_err("Failed to allocate interpreter\n");
@@ -123,6 +135,15 @@ bool arm::app::Model::Init(uint8_t* tensorArenaAddr,
     return true;
 }
 
+void arm::app::Model::Release()
+{
+    this->m_inited = false;
+    this->m_input.clear();
+    this->m_output.clear();
+    this->m_pInterpreter.reset();
+    this->m_pAllocator = nullptr;
+}
+
 tflite::MicroAllocator* arm::app::Model::GetAllocator()
 {
     if (this->IsInited()) {
@@ -244,7 +265,15 @@ bool arm::app::Model::RunInference()
 {
     bool inference_state = false;
     if (this->m_pModel && this->m_pInterpreter) {
-        if (kTfLiteOk != this->m_pInterpreter->Invoke()) {
+        if (this->m_pOpProfiler) {
+            this->m_pOpProfiler->BeginInvoke();
+        }
+        const TfLiteStatus status = this->m_pInterpreter->Invoke();
+        if (this->m_pOpProfiler) {
+            this->m_pOpProfiler->EndInvoke();
+        }
+
+        if (kTfLiteOk != status) {
             printf_err("Invoke failed.\n");
         } else {
             inference_state = true;
@@ -0,0 +1,212 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "Nms.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace arm {
+namespace app {
+namespace image {
+
+    void NmsBoxes::Reserve(const size_t capacity)
+    {
+        this->x0.reserve(capacity);
+        this->y0.reserve(capacity);
+        this->x1.reserve(capacity);
+        this->y1.reserve(capacity);
+        this->area.reserve(capacity);
+        this->score.reserve(capacity);
+        this->classId.reserve(capacity);
+    }
+
+    void NmsBoxes::Clear()
+    {
+        this->x0.clear();
+        this->y0.clear();
+        this->x1.clear();
+        this->y1.clear();
+        this->area.clear();
+        this->score.clear();
+        this->classId.clear();
+    }
+
+    void NmsBoxes::Add(const Box& box, const float boxScore, const int boxClassId)
+    {
+        this->x0.push_back(box.x - box.w/2);
+        this->y0.push_back(box.y - box.h/2);
+        this->x1.push_back(box.x + box.w/2);
+        this->y1.push_back(box.y + box.h/2);
+        this->area.push_back(box.w * box.h);
+        this->score.push_back(boxScore);
+        this->classId.push_back(boxClassId);
+    }
+
+    size_t NmsBoxes::Size() const
+    {
+        return this->score.size();
+    }
+
+    NonMaxSuppression::NonMaxSuppression(const NmsParams& params)
+    :   m_params{params}
+    {}
+
+    size_t NonMaxSuppression::Run(NmsBoxes& boxes, std::vector<uint32_t>& keep)
+    {
+        const size_t numBoxes = boxes.Size();
+        keep.clear();
+
+        this->m_order.resize(numBoxes);
+        std::iota(this->m_order.begin(), this->m_order.end(), 0);
+        std::stable_sort(this->m_order.begin(), this->m_order.end(),
+                         [&boxes](uint32_t a, uint32_t b) { return boxes.score[a] > boxes.score[b]; });
+        this->m_removed.assign(numBoxes, 0);
+
+        this->m_x0 = boxes.x0.data();
+        this->m_y0 = boxes.y0.data();
+        this->m_x1 = boxes.x1.data();
+        this->m_y1 = boxes.y1.data();
+
+        if (this->m_params.mode == NmsMode::BatchedOffset && numBoxes) {
+            /* Shift each class by more than the extent of all boxes, so that boxes
+             * of different classes can no longer overlap. */
+            const float minCoord = std::min(*std::min_element(boxes.x0.begin(), boxes.x0.end()),
+                                            *std::min_element(boxes.y0.begin(), boxes.y0.end()));
+            const float maxCoord = std::max(*std::max_element(boxes.x1.begin(), boxes.x1.end()),
+                                            *std::max_element(boxes.y1.begin(), boxes.y1.end()));
+            const float classOffset = maxCoord - minCoord + 1;
+
+            this->m_offsetX0.resize(numBoxes);
+            this->m_offsetY0.resize(numBoxes);
+            this->m_offsetX1.resize(numBoxes);
+            this->m_offsetY1.resize(numBoxes);
+            for (size_t i = 0; i < numBoxes; ++i) {
+                const float offset = boxes.classId[i] * classOffset;
+                this->m_offsetX0[i] = boxes.x0[i] + offset;
+                this->m_offsetY0[i] = boxes.y0[i] + offset;
+                this->m_offsetX1[i] = boxes.x1[i] + offset;
+                this->m_offsetY1[i] = boxes.y1[i] + offset;
+            }
+            this->m_x0 = this->m_offsetX0.data();
+            this->m_y0 = this->m_offsetY0.data();
+            this->m_x1 = this->m_offsetX1.data();
+            this->m_y1 = this->m_offsetY1.data();
+        }
+
+        if (this->m_params.softNms) {
+            this->RunSoft(boxes, keep);
+        } else {
+            this->RunHard(boxes, keep);
+        }
+        return keep.size();
+    }
+
+    void NonMaxSuppression::RunHard(const NmsBoxes& boxes, std::vector<uint32_t>& keep)
+    {
+        const size_t numBoxes = this->m_order.size();
+        for (size_t i = 0; i < numBoxes; ++i) {
+            const uint32_t kept = this->m_order[i];
+            if (this->m_removed[kept]) {
+                continue;
+            }
+            keep.push_back(kept);
+            if (keep.size() == this->m_params.maxDetections) {
+                break;
+            }
+
+            for (size_t j = i + 1; j < numBoxes; ++j) {
+                const uint32_t other = this->m_order[j];
+                if (this->m_removed[other] || !this->Competes(boxes, kept, other)) {
+                    continue;
+                }
+                if (this->Iou(boxes, kept, other) > this->m_params.iouThreshold) {
+                    this->m_removed[other] = 1;
+                }
+            }
+        }
+    }
+
+    void NonMaxSuppression::RunSoft(NmsBoxes& boxes, std::vector<uint32_t>& keep)
+    {
+        const size_t numBoxes = this->m_order.size();
+        for (size_t i = 0; i < numBoxes; ++i) {
+            if (boxes.score[i] <= this->m_params.scoreThreshold) {
+                this->m_removed[i] = 1;
+            }
+        }
+
+        while (!this->m_params.maxDetections || keep.size() < this->m_params.maxDetections) {
+            /* Decayed scores no longer follow the initial order: pick the best
+             * remaining box, the first one in the initial order on ties. */
+            uint32_t kept = 0;
+            bool found = false;
+            for (const uint32_t idx : this->m_order) {
+                if (!this->m_removed[idx] && (!found || boxes.score[idx] > boxes.score[kept])) {
+                    kept = idx;
+                    found = true;
+                }
+            }
+            if (!found) {
+                break;
+            }
+            keep.push_back(kept);
+            this->m_removed[kept] = 1;
+
+            for (const uint32_t other : this->m_order) {
+                if (this->m_removed[other] || !this->Competes(boxes, kept, other)) {
+                    continue;
+                }
+                const float iou = this->Iou(boxes, kept, other);
+                boxes.score[other] *= std::exp(-(iou * iou) / this->m_params.softSigma);
+                if (boxes.score[other] <= this->m_params.scoreThreshold) {
+                    this->m_removed[other] = 1;
+                }
+            }
+        }
+    }
+
+    float NonMaxSuppression::Iou(const NmsBoxes& boxes, const uint32_t a, const uint32_t b) const
+    {
+        const float width = std::min(this->m_x1[a], this->m_x1[b]) - std::max(this->m_x0[a], this->m_x0[b]);
+        if (width < 0) {
+            return 0;
+        }
+        const float height = std::min(this->m_y1[a], this->m_y1[b]) - std::max(this->m_y0[a], this->m_y0[b]);
+        if (height < 0) {
+            return 0;
+        }
+
+        const float intersection = width * height;
+        if (intersection == 0) {
+            return 0;
+        }
+        const float boxesUnion = boxes.area[a] + boxes.area[b] - intersection;
+        if (boxesUnion == 0) {
+            return 0;
+        }
+        return intersection / boxesUnion;
+    }
+
+    bool NonMaxSuppression::Competes(const NmsBoxes& boxes, const uint32_t a, const uint32_t b) const
+    {
+        return this->m_params.mode != NmsMode::PerClass || boxes.classId[a] == boxes.classId[b];
+    }
+
+} /* namespace image */
+} /* namespace app */
+} /* namespace arm */
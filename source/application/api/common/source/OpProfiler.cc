@@ -0,0 +1,243 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "OpProfiler.hpp"
+#include "log_macros.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+
+namespace arm {
+namespace app {
+
+    void OpProfiler::Prepare(size_t numOperators)
+    {
+        this->m_ops.assign(numOperators, OpStats{});
+
+        /* There cannot be more operator types than operators. */
+        this->m_opTypes.clear();
+        this->m_opTypes.reserve(numOperators);
+        this->Reset();
+    }
+
+    void OpProfiler::BeginInvoke()
+    {
+        this->m_recording = true;
+        this->m_depth = 0;
+        this->m_opsStarted = 0;
+    }
+
+    void OpProfiler::EndInvoke()
+    {
+        if (this->m_recording) {
+            ++this->m_invokes;
+        }
+        this->m_recording = false;
+    }
+
+    uint32_t OpProfiler::BeginEvent(const char* tag)
+    {
+        if (!this->m_recording) {
+            return 0;
+        }
+
+        const uint32_t handle = this->m_depth++;
+        if (handle == 0) {
+            this->m_opTag = tag;
+            ++this->m_opsStarted;
+
+            /* Read the counter last to leave the bookkeeping out of the cost. */
+            this->m_opStart = this->GetTimestamp();
+        }
+        return handle;
+    }
+
+    void OpProfiler::EndEvent(uint32_t eventHandle)
+    {
+        const uint64_t now = this->GetTimestamp();
+
+        if (!this->m_recording || eventHandle >= this->m_depth) {
+            return;
+        }
+
+        /* Events nested in an operator are part of its cost. */
+        this->m_depth = eventHandle;
+        if (eventHandle != 0) {
+            return;
+        }
+
+        const uint64_t cost = now > this->m_opStart ? now - this->m_opStart : 0;
+        const bool isNpu = IsNpuOperator(this->m_opTag);
+
+        const uint32_t opIndex = this->m_opsStarted - 1;
+        if (opIndex < this->m_ops.size()) {
+            OpStats& op = this->m_ops[opIndex];
+            if (!op.name) {
+                op.name = this->m_opTag;
+                op.isNpu = isNpu;
+            }
+            Accumulate(op, cost);
+        }
+
+        OpStats* opType = this->FindOpType(this->m_opTag);
+        if (opType) {
+            Accumulate(*opType, cost);
+        }
+
+        if (isNpu) {
+            this->m_npuTotal += cost;
+        } else {
+            this->m_cpuTotal += cost;
+        }
+    }
+
+    void OpProfiler::Reset()
+    {
+        for (auto& op : this->m_ops) {
+            op = OpStats{};
+        }
+        this->m_opTypes.clear();
+        this->m_depth = 0;
+        this->m_opsStarted = 0;
+        this->m_invokes = 0;
+        this->m_npuTotal = 0;
+        this->m_cpuTotal = 0;
+        this->m_recording = false;
+    }
+
+    void OpProfiler::PrintResults(size_t maxRows) const
+    {
+        const uint64_t total = this->m_npuTotal + this->m_cpuTotal;
+        const char* unit = this->GetUnit();
+
+        if (!this->HasClock()) {
+            printf_err("No clock to cost every operator with, operator profile not printed\n");
+            return;
+        }
+
+        if (this->m_invokes == 0 || total == 0) {
+            info("No operator events recorded\n");
+            return;
+        }
+
+        auto share = [total](uint64_t cost) {
+            return 100.0 * static_cast<double>(cost) / static_cast<double>(total);
+        };
+
+        /* Rank the operators that ran by their total cost. */
+        std::vector<uint32_t> ranking;
+        ranking.reserve(this->m_ops.size());
+        for (uint32_t i = 0; i < this->m_ops.size(); ++i) {
+            if (this->m_ops[i].count) {
+                ranking.push_back(i);
+            }
+        }
+        std::stable_sort(ranking.begin(), ranking.end(), [this](uint32_t a, uint32_t b) {
+            return this->m_ops[a].total > this->m_ops[b].total;
+        });
+        if (maxRows && ranking.size() > maxRows) {
+            ranking.resize(maxRows);
+        }
+
+        info("Operator profile over %" PRIu32 " inference(s), in %s:\n", this->m_invokes, unit);
+        info("%4s %5s  %-28s %-4s %12s %12s %12s %7s\n",
+             "Rank", "Index", "Operator", "Core", "Average", "Min", "Max", "Share");
+        for (size_t rank = 0; rank < ranking.size(); ++rank) {
+            const OpStats& op = this->m_ops[ranking[rank]];
+            info("%4zu %5" PRIu32 "  %-28s %-4s %12" PRIu64 " %12" PRIu64 " %12" PRIu64 " %6.2f%%\n",
+                 rank + 1, ranking[rank], op.name ? op.name : "<unnamed>", op.isNpu ? "NPU" : "CPU",
+                 op.total / op.count, op.min, op.max, share(op.total));
+        }
+
+        info("Operator types:\n");
+        for (const auto& opType : this->m_opTypes) {
+            info("  %-28s %-4s %6" PRIu32 " run(s) %14" PRIu64 " %6.2f%%\n",
+                 opType.name, opType.isNpu ? "NPU" : "CPU",
+                 opType.count, opType.total, share(opType.total));
+        }
+
+        info("NPU operators: %" PRIu64 " %s (%.2f%%)\n",
+             this->m_npuTotal, unit, share(this->m_npuTotal));
+        info("CPU operators: %" PRIu64 " %s (%.2f%%)\n",
+             this->m_cpuTotal, unit, share(this->m_cpuTotal));
+    }
+
+    const std::vector<OpStats>& OpProfiler::GetOpStats() const
+    {
+        return this->m_ops;
+    }
+
+    const std::vector<OpStats>& OpProfiler::GetOpTypeStats() const
+    {
+        return this->m_opTypes;
+    }
+
+    uint32_t OpProfiler::GetInvokeCount() const
+    {
+        return this->m_invokes;
+    }
+
+    uint64_t OpProfiler::GetNpuTotal() const
+    {
+        return this->m_npuTotal;
+    }
+
+    uint64_t OpProfiler::GetCpuTotal() const
+    {
+        return this->m_cpuTotal;
+    }
+
+    bool OpProfiler::IsNpuOperator(const char* name)
+    {
+        return name && 0 == std::strcmp(name, "ethos-u");
+    }
+
+    void OpProfiler::Accumulate(OpStats& stats, uint64_t cost)
+    {
+        ++stats.count;
+        stats.total += cost;
+        stats.min = std::min(stats.min, cost);
+        stats.max = std::max(stats.max, cost);
+    }
+
+    OpStats* OpProfiler::FindOpType(const char* name)
+    {
+        if (!name) {
+            return nullptr;
+        }
+
+        for (auto& opType : this->m_opTypes) {
+            /* Tags are the interpreter's static name strings, so pointers usually match. */
+            if (opType.name == name || 0 == std::strcmp(opType.name, name)) {
+                return &opType;
+            }
+        }
+
+        /* Never grow past the storage reserved in Prepare. */
+        if (this->m_opTypes.size() == this->m_opTypes.capacity()) {
+            return nullptr;
+        }
+
+        OpStats opType;
+        opType.name = name;
+        opType.isNpu = IsNpuOperator(name);
+        this->m_opTypes.push_back(opType);
+        return &this->m_opTypes.back();
+    }
+
+} /* namespace app */
+} /* namespace arm */
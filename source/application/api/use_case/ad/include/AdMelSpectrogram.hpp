@@ -33,11 +33,11 @@ namespace audio {
         static constexpr uint32_t  ms_defaultMelHiFreq    =  8000;
         static constexpr bool      ms_defaultUseHtkMethod = false;
 
-        explicit AdMelSpectrogram(const size_t frameLen)
+        explicit AdMelSpectrogram(const size_t frameLen, const bool useFixedPoint = false)
                 :  MelSpectrogram(MelSpecParams(
                 ms_defaultSamplingFreq, ms_defaultNumFbankBins,
                 ms_defaultMelLoFreq, ms_defaultMelHiFreq,
-                frameLen, ms_defaultUseHtkMethod))
+                frameLen, ms_defaultUseHtkMethod, useFixedPoint))
         {}
 
         AdMelSpectrogram()  = delete;
@@ -47,22 +47,17 @@ namespace audio {
 
         /**
          * @brief       Overrides base class implementation of this function.
-         * @param[in]   fftVec                  Vector populated with FFT magnitudes
-         * @param[in]   melFilterBank           2D Vector with filter bank weights
-         * @param[in]   filterBankFilterFirst   Vector containing the first indices of filter bank
-         *                                      to be used for each bin.
-         * @param[in]   filterBankFilterLast    Vector containing the last indices of filter bank
-         *                                      to be used for each bin.
-         * @param[out]  melEnergies             Pre-allocated vector of MEL energies to be
-         *                                      populated.
+         *              The filter bank is applied to the power spectrum.
+         * @param[in]   fftVec          Vector populated with the power spectrum
+         * @param[in]   melFilterBank   Packed filter bank weights
+         * @param[out]  melEnergies     Pre-allocated vector of MEL energies to be
+         *                              populated.
          * @return      true if successful, false otherwise
          */
         virtual bool ApplyMelFilterBank(
-                std::vector<float>&                 fftVec,
-                std::vector<std::vector<float>>&    melFilterBank,
-                std::vector<uint32_t>&               filterBankFilterFirst,
-                std::vector<uint32_t>&               filterBankFilterLast,
-                std::vector<float>&                 melEnergies) override;
+                std::vector<float>&     fftVec,
+                const MelFilterBank&    melFilterBank,
+                std::vector<float>&     melEnergies) override;
 
         /**
          * @brief       Override for the base class implementation convert mel
@@ -88,6 +83,25 @@ namespace audio {
                 const float&   leftMel,
                 const float&   rightMel,
                 const bool     useHTKMethod) override;
+
+        /**
+         * @brief       Override for the fixed point path: the filter bank is
+         *              applied to the power spectrum.
+         * @return      Power spectrum.
+         */
+        virtual FixedPointMel::Spectrum GetFixedPointSpectrum() const override;
+
+        /**
+         * @brief       Override for the fixed point path: 10 * log10 of the energies.
+         * @return      Multiplier from base 2 logarithms.
+         */
+        virtual float GetFixedPointLogMultiplier() const override;
+
+        /**
+         * @brief       Override to use the tables generated for this front end.
+         * @return      AdMelSpectrogram.
+         */
+        virtual FrontEndKind GetFrontEndKind() const override;
     };
 
 } /* namespace audio */
@@ -21,6 +21,7 @@
 #include "TensorFlowLiteMicro.hpp"
 #include "AudioUtils.hpp"
 #include "AdMelSpectrogram.hpp"
+#include "DataStructures.hpp"
 #include "log_macros.h"
 
 namespace arm {
@@ -91,7 +92,7 @@ namespace app {
         audio::SlidingWindow<const int16_t> m_melWindowSlider; /**< Internal MEL spectrogram window slider */
         audio::AdMelSpectrogram m_melSpec; /**< MEL spectrogram computation object */
         std::function<void
-            (std::vector<int16_t>&, int, bool, size_t, size_t)> m_featureCalc; /**< Feature calculator object */
+            (const int16_t*, size_t, bool, size_t, size_t)> m_featureCalc; /**< Feature calculator object */
     };
 
     class AdPostProcess : public BasePostProcess {
@@ -166,63 +167,74 @@ namespace app {
      *
      * @tparam T            feature vector type.
      * @param inputTensor   model input tensor pointer.
-     * @param cacheSize     number of feature vectors to cache. Defined by the sliding window overlap.
+     * @param cacheSize     number of feature vectors to cache. Defined by the number of
+     *                      feature vectors in one sliding window.
+     * @param numFeatures   number of features computed per audio window.
      * @param compute       features calculator function.
      * @return              lambda function to compute features.
      */
     template<class T>
-    std::function<void (std::vector<int16_t>&, size_t, bool, size_t, size_t)>
-    FeatureCalc(TfLiteTensor* inputTensor, size_t cacheSize,
-                std::function<std::vector<T> (std::vector<int16_t>& )> compute)
+    std::function<void (const int16_t*, size_t, bool, size_t, size_t)>
+    FeatureCalc(TfLiteTensor* inputTensor, size_t cacheSize, size_t numFeatures,
+                std::function<bool (const int16_t*, T*)> compute)
     {
-        /* Feature cache to be captured by lambda function*/
-        static std::vector<std::vector<T>> featureCache = std::vector<std::vector<T>>(cacheSize);
+        /* Feature cache owned by the returned function object, allocated once. */
+        FeatureRing<T> featureCache(cacheSize, numFeatures);
 
-        return [=](std::vector<int16_t>& audioDataWindow,
+        return [=](const int16_t* audioDataWindow,
                    size_t index,
                    bool useCache,
                    size_t featuresOverlapIndex,
-                   size_t resizeScale)
+                   size_t resizeScale) mutable
         {
-            T* tensorData = tflite::GetTensorData<T>(inputTensor);
-            std::vector<T> features;
-
-            /* Reuse features from cache if cache is ready and sliding windows overlap.
-             * Overlap is in the beginning of sliding window with a size of a feature cache. */
-            if (useCache && index < featureCache.size()) {
-                features = std::move(featureCache[index]);
-            } else {
-                features = std::move(compute(audioDataWindow));
+            /* On a new window, drop the features that are not overlapping anymore.
+             * The remaining ones are now at the beginning of the cache. */
+            if (0 == index) {
+                if (useCache) {
+                    featureCache.Advance(featuresOverlapIndex / resizeScale);
+                } else {
+                    featureCache.Reset();
+                }
+            }
+
+            T* features = featureCache.Row(index);
+            if (!features) {
+                printf_err("Feature index %zu exceeds cache size\n", index);
+                return;
+            }
+
+            /* Features are computed in place, unless kept from the previous window. */
+            if (!featureCache.IsValid(index)) {
+                compute(audioDataWindow, features);
+                featureCache.Commit(index);
             }
-            auto size = features.size() / resizeScale;
+
+            T* tensorData = tflite::GetTensorData<T>(inputTensor);
+            auto size = numFeatures / resizeScale;
             auto sizeBytes = sizeof(T);
 
             /* Input should be transposed and "resized" by skipping elements. */
             for (size_t outIndex = 0; outIndex < size; outIndex++) {
                 std::memcpy(tensorData + (outIndex*size) + index, &features[outIndex*resizeScale], sizeBytes);
             }
-
-            /* Start renewing cache as soon iteration goes out of the windows overlap. */
-            if (index >= featuresOverlapIndex / resizeScale) {
-                featureCache[index - featuresOverlapIndex / resizeScale] = std::move(features);
-            }
         };
     }
 
-    template std::function<void (std::vector<int16_t>&, size_t , bool, size_t, size_t)>
+    template std::function<void (const int16_t*, size_t, bool, size_t, size_t)>
     FeatureCalc<int8_t>(TfLiteTensor* inputTensor,
-                        size_t cacheSize,
-                        std::function<std::vector<int8_t> (std::vector<int16_t>&)> compute);
+                        size_t cacheSize, size_t numFeatures,
+                        std::function<bool (const int16_t*, int8_t*)> compute);
 
-    template std::function<void(std::vector<int16_t>&, size_t, bool, size_t, size_t)>
+    template std::function<void (const int16_t*, size_t, bool, size_t, size_t)>
     FeatureCalc<float>(TfLiteTensor *inputTensor,
-                       size_t cacheSize,
-                       std::function<std::vector<float>(std::vector<int16_t>&)> compute);
+                       size_t cacheSize, size_t numFeatures,
+                       std::function<bool (const int16_t*, float*)> compute);
 
-    std::function<void (std::vector<int16_t>&, int, bool, size_t, size_t)>
+    std::function<void (const int16_t*, size_t, bool, size_t, size_t)>
     GetFeatureCalculator(audio::AdMelSpectrogram& melSpec,
                          TfLiteTensor* inputTensor,
                          size_t cacheSize,
+                         size_t frameLen,
                          float trainingMean);
 
 } /* namespace app */
@@ -17,6 +17,9 @@
 #ifndef MELSPECTROGRAM_HPP
 #define MELSPECTROGRAM_HPP
 
+#include "DspTables.hpp"
+#include "FixedPointMel.hpp"
+#include "MelFilterBank.hpp"
 #include "PlatformMath.hpp"
 
 #include <vector>
@@ -24,12 +27,17 @@
 #include <cmath>
 #include <limits>
 #include <string>
+#include <algorithm>
+#include <memory>
 
 namespace arm {
 namespace app {
 namespace audio {
 
-    /* Mel Spectrogram consolidated parameters */
+    /* Mel Spectrogram consolidated parameters. m_useFixedPoint selects the integer
+     * front end (FixedPointMel), with quantisation straight from its Q16 log2 mel
+     * energies. Subclasses describe their filter bank input and logarithm for it
+     * through GetFixedPointSpectrum and GetFixedPointLogMultiplier. */
     class MelSpecParams {
     public:
         float       m_samplingFreq;
@@ -39,11 +47,13 @@ namespace audio {
         uint32_t    m_frameLen;
         uint32_t    m_frameLenPadded;
         bool        m_useHtkMethod;
+        bool        m_useFixedPoint;
 
         /** @brief  Constructor */
         MelSpecParams(const float samplingFreq, const uint32_t numFbankBins,
                       const float melLoFreq, const float melHiFreq,
-                      const uint32_t frameLen, const bool useHtkMethod);
+                      const uint32_t frameLen, const bool useHtkMethod,
+                      const bool useFixedPoint = false);
 
         MelSpecParams()  = delete;
         ~MelSpecParams() = default;
@@ -100,11 +110,69 @@ namespace audio {
                                            const int quantOffset,
                                            float trainingMean = 0)
         {
-            this->ComputeMelSpec(audioData, trainingMean);
+            std::vector<T> melSpecOut(this->m_params.m_numFbankBins);
+            this->MelSpecComputeQuant<T>(audioData.data(), audioData.size(), melSpecOut.data(),
+                                         quantScale, quantOffset, trainingMean);
+            return melSpecOut;
+        }
+
+        /**
+        * @brief        Extract Mel Spectrogram for one single small frame of
+        *               audio data into a caller owned buffer. No memory is
+        *               allocated by this call.
+        * @param[in]    audioData       Pointer to the first audio sample of the frame.
+        * @param[in]    audioDataLen    Number of samples available at audioData. If
+        *                               less than the frame length, the remainder of
+        *                               the frame is treated as zeros.
+        * @param[out]   melSpecOut      Output buffer with space for the Mel energies.
+        * @param[in]    trainingMean    Value to subtract from the the computed mel spectrogram.
+        * @return       true if successful, false otherwise.
+        **/
+        bool ComputeMelSpec(const int16_t* audioData, size_t audioDataLen,
+                            float* melSpecOut, float trainingMean = 0);
+
+        /**
+         * @brief        Extract Mel Spectrogram features and quantise for one single
+         *               small frame of audio data, writing into a caller owned buffer.
+         *               No memory is allocated by this call.
+         * @param[in]    audioData      Pointer to the first audio sample of the frame.
+         * @param[in]    audioDataLen   Number of samples available at audioData.
+         * @param[out]   melSpecOut     Output buffer with space for the Mel energies.
+         * @param[in]    quantScale     quantisation scale.
+         * @param[in]    quantOffset    quantisation offset.
+         * @param[in]    trainingMean   training mean.
+         * @return       true if successful, false otherwise.
+         **/
+        template<typename T>
+        bool MelSpecComputeQuant(const int16_t* audioData,
+                                 const size_t audioDataLen,
+                                 T* melSpecOut,
+                                 const float quantScale,
+                                 const int quantOffset,
+                                 float trainingMean = 0)
+        {
+            if (!melSpecOut) {
+                return false;
+            }
+
+            /* Initialisation may fall back to floating point. */
+            this->InitMelFilterBank();
+            if (this->m_params.m_useFixedPoint) {
+                if (!this->ComputeQuantFixedPoint(audioData, audioDataLen,
+                                                  quantScale, quantOffset, trainingMean)) {
+                    return false;
+                }
+                for (size_t k = 0; k < this->m_params.m_numFbankBins; ++k) {
+                    melSpecOut[k] = static_cast<T>(std::min<int32_t>(std::max<int32_t>(
+                        this->m_quantEnergies[k], std::numeric_limits<T>::min()), std::numeric_limits<T>::max()));
+                }
+                return true;
+            }
+
+            this->ComputeMelEnergies(audioData, audioDataLen, trainingMean);
             float minVal = std::numeric_limits<T>::min();
             float maxVal = std::numeric_limits<T>::max();
 
-            std::vector<T> melSpecOut(this->m_params.m_numFbankBins);
             const size_t numFbankBins = this->m_params.m_numFbankBins;
 
             /* Quantize to T. */
@@ -113,9 +181,15 @@ namespace audio {
                 melSpecOut[k] = static_cast<T>(std::min<float>(std::max<float>(quantizedEnergy, minVal), maxVal));
             }
 
-            return melSpecOut;
+            return true;
         }
 
+        /**
+         * @brief       Gets the number of Mel energies produced per frame.
+         * @return      Number of filter bank bins.
+         **/
+        uint32_t GetNumFbankBins() const;
+
         /* Constants */
         static constexpr float ms_logStep = /*logf(6.4)*/ 1.8562979903656 / 27.0;
         static constexpr float ms_freqStep = 200.0 / 3;
@@ -146,26 +220,20 @@ namespace audio {
 
         /**
          * @brief       Populates MEL energies after applying the MEL filter
-         *              bank weights and adding them up to be placed into
-         *              bins, according to the filter bank's first and last
-         *              indices (pre-computed for each filter bank element
-         *              by CreateMelFilterBank function).
-         * @param[in]   fftVec                  Vector populated with FFT magnitudes
-         * @param[in]   melFilterBank           2D Vector with filter bank weights
-         * @param[in]   filterBankFilterFirst   Vector containing the first indices of filter bank
-         *                                      to be used for each bin.
-         * @param[in]   filterBankFilterLast    Vector containing the last indices of filter bank
-         *                                      to be used for each bin.
-         * @param[out]  melEnergies             Pre-allocated vector of MEL energies to be
-         *                                      populated.
+         *              bank weights to the FFT magnitudes. The magnitude of
+         *              each FFT bin the filter bank uses is computed once, in
+         *              place, before the weighted sums.
+         * @param[in,out]   fftVec          Vector populated with the power spectrum;
+         *                                  magnitudes on return
+         * @param[in]       melFilterBank   Packed filter bank weights
+         * @param[out]      melEnergies     Pre-allocated vector of MEL energies to be
+         *                                  populated.
          * @return      true if successful, false otherwise
          */
         virtual bool ApplyMelFilterBank(
-                std::vector<float>&                 fftVec,
-                std::vector<std::vector<float>>&    melFilterBank,
-                std::vector<uint32_t>&               filterBankFilterFirst,
-                std::vector<uint32_t>&               filterBankFilterLast,
-                std::vector<float>&                 melEnergies);
+                std::vector<float>&     fftVec,
+                const MelFilterBank&    melFilterBank,
+                std::vector<float>&     melEnergies);
 
         /**
          * @brief           Converts the Mel energies for logarithmic scale
@@ -189,20 +257,52 @@ namespace audio {
                 const float&   rightMel,
                 const bool     useHTKMethod);
 
+        /**
+         * @brief       Spectrum the mel filter bank is applied to on the fixed point
+         *              path, as in ApplyMelFilterBank.
+         * @return      Spectrum type.
+         */
+        virtual FixedPointMel::Spectrum GetFixedPointSpectrum() const;
+
+        /**
+         * @brief       Factor from base 2 logarithms to the scale produced by
+         *              ConvertToLogarithmicScale, for the fixed point path.
+         * @return      Multiplier.
+         */
+        virtual float GetFixedPointLogMultiplier() const;
+
+        /**
+         * @brief       Gets the kind of front end this class computes. Tables
+         *              generated at build time for the kind are used instead of
+         *              building them when the parameters match; Custom (the
+         *              default) always builds them at run time.
+         * @return      Front end kind.
+         */
+        virtual FrontEndKind GetFrontEndKind() const;
+
     private:
         MelSpecParams                   m_params;
         std::vector<float>              m_frame;
         std::vector<float>              m_buffer;
         std::vector<float>              m_melEnergies;
-        std::vector<float>              m_windowFunc;
-        std::vector<std::vector<float>> m_melFilterBank;
-        std::vector<uint32_t>            m_filterBankFilterFirst;
-        std::vector<uint32_t>            m_filterBankFilterLast;
+        std::vector<float>              m_windowFunc;       /* Window, if built at run time. */
+        const float*                    m_window{nullptr};  /* Window in use. */
+        std::shared_ptr<const MelFilterBank> m_melFilterBank;
         bool                            m_filterBankInitialised;
         arm::app::math::FftInstance     m_fftInstance;
 
+        /* Fixed point path. */
+        FixedPointMel                   m_fixedPointMel;
+        std::vector<int32_t>            m_log2MelEnergies;  /* Q16 log2 of the mel energies. */
+        std::vector<int32_t>            m_quantEnergies;    /* Quantised energies before clamping. */
+        FixedPointRequantiser           m_requantiser;
+        float                           m_requantScale{0};
+        int                             m_requantOffset{0};
+        float                           m_requantMean{0};
+
         /**
-         * @brief       Initialises the filter banks.
+         * @brief       Initialises the window and filter banks, from generated
+         *              tables if there are any for the parameters.
          **/
         void InitMelFilterBank();
 
@@ -213,17 +313,43 @@ namespace audio {
          **/
         bool IsMelFilterBankInited() const;
 
+        /** @brief  Gets the mel filter bank parameters. */
+        MelFilterBankParams GetMelFilterBankParams() const;
+
         /**
-         * @brief       Create mel filter banks for Mel Spectrogram calculation.
-         * @return      2D vector of floats
+         * @brief       Gets the mel filter bank for Mel Spectrogram calculation,
+         *              shared with other instances using the same parameters.
+         * @return      Shared filter bank
          **/
-        std::vector<std::vector<float>> CreateMelFilterBank();
+        std::shared_ptr<const MelFilterBank> CreateMelFilterBank();
 
         /**
          * @brief       Computes the magnitude from an interleaved complex array
          **/
         void ConvertToPowerSpectrum();
 
+        /**
+         * @brief       Computes and populates the internal Mel energies buffer
+         *              for one frame of audio.
+         * @param[in]   audioData      Pointer to 16-bit audio data.
+         * @param[in]   audioDataLen   Number of samples available at audioData.
+         * @param[in]   trainingMean   Value to subtract from the computed energies.
+         **/
+        void ComputeMelEnergies(const int16_t* audioData, size_t audioDataLen, float trainingMean);
+
+        /**
+         * @brief       Computes the quantised Mel energies of a frame on the fixed point
+         *              path, before clamping, into m_quantEnergies.
+         * @param[in]   audioData      Pointer to 16-bit audio data.
+         * @param[in]   audioDataLen   Number of samples available at audioData.
+         * @param[in]   quantScale     Quantisation scale.
+         * @param[in]   quantOffset    Quantisation offset.
+         * @param[in]   trainingMean   Value to subtract from the energies.
+         * @return      true if successful, false otherwise.
+         **/
+        bool ComputeQuantFixedPoint(const int16_t* audioData, size_t audioDataLen,
+                                    float quantScale, int quantOffset, float trainingMean);
+
     };
 
 } /* namespace audio */
@@ -25,56 +25,35 @@ namespace app {
 namespace audio {
 
     bool AdMelSpectrogram::ApplyMelFilterBank(
-            std::vector<float>&                 fftVec,
-            std::vector<std::vector<float>>&    melFilterBank,
-            std::vector<uint32_t>&               filterBankFilterFirst,
-            std::vector<uint32_t>&               filterBankFilterLast,
-            std::vector<float>&                 melEnergies)
+            std::vector<float>&     fftVec,
+            const MelFilterBank&    melFilterBank,
+            std::vector<float>&     melEnergies)
     {
-        const size_t numBanks = melEnergies.size();
-
-        if (numBanks != filterBankFilterFirst.size() ||
-            numBanks != filterBankFilterLast.size()) {
+        if (melEnergies.size() != melFilterBank.GetNumBanks() ||
+            fftVec.size() < melFilterBank.GetEndBin()) {
             printf_err("unexpected filter bank lengths\n");
             return false;
         }
 
-        for (size_t bin = 0; bin < numBanks; ++bin) {
-            auto filterBankIter = melFilterBank[bin].begin();
-            auto end = melFilterBank[bin].end();
-            float melEnergy = FLT_MIN; /* Avoid log of zero at later stages. */
-            const uint32_t firstIndex = filterBankFilterFirst[bin];
-            const uint32_t lastIndex = std::min<int32_t>(filterBankFilterLast[bin], fftVec.size() - 1);
-
-            for (uint32_t i = firstIndex; i <= lastIndex && filterBankIter != end; ++i) {
-                melEnergy += (*filterBankIter++ * fftVec[i]);
-            }
-
-            melEnergies[bin] = melEnergy;
-        }
-
+        /* Start from FLT_MIN to avoid log of zero at later stages. */
+        melFilterBank.Apply(fftVec.data(), melEnergies.data(), FLT_MIN);
         return true;
     }
 
     void AdMelSpectrogram::ConvertToLogarithmicScale(
             std::vector<float>& melEnergies)
     {
-        /* Container for natural logarithms of mel energies */
-        std::vector <float> vecLogEnergies(melEnergies.size(), 0.f);
-
         /* Because we are taking natural logs, we need to multiply by log10(e).
          * Also, for wav2letter model, we scale our log10 values by 10 */
         constexpr float multiplier = 10.0 * /* default scalar */
                                      0.4342944819032518; /* log10f(std::exp(1.0))*/
 
-        /* Take log of the whole vector */
-        math::MathUtils::VecLogarithmF32(melEnergies, vecLogEnergies);
+        /* Take log of the whole vector (in place) */
+        math::MathUtils::VecLogarithmF32(melEnergies, melEnergies);
 
         /* Scale the log values. */
-        for (auto iterM = melEnergies.begin(), iterL = vecLogEnergies.begin();
-             iterM != melEnergies.end() && iterL != vecLogEnergies.end(); ++iterM, ++iterL) {
-
-            *iterM = *iterL * multiplier;
+        for (float& melEnergy : melEnergies) {
+            melEnergy *= multiplier;
         }
     }
 
@@ -88,6 +67,21 @@ namespace audio {
                         AdMelSpectrogram::InverseMelScale(leftMel, useHTKMethod)));
     }
 
+    FixedPointMel::Spectrum AdMelSpectrogram::GetFixedPointSpectrum() const
+    {
+        return FixedPointMel::Spectrum::Power;
+    }
+
+    float AdMelSpectrogram::GetFixedPointLogMultiplier() const
+    {
+        return 10.0 * 0.3010299956639812; /* 10 * log10(2) */
+    }
+
+    FrontEndKind AdMelSpectrogram::GetFrontEndKind() const
+    {
+        return FrontEndKind::AdMelSpectrogram;
+    }
+
 } /* namespace audio */
 } /* namespace app */
 } /* namespace arm */
@@ -71,7 +71,8 @@ AdPreProcess::AdPreProcess(TfLiteTensor* inputTensor,
 
     /* Construct feature calculation function. */
     this->m_featureCalc = GetFeatureCalculator(this->m_melSpec, inputTensor,
-                                               this->m_numReusedFeatureVectors,
+                                               this->m_melWindowSlider.TotalStrides() + 1,
+                                               melSpectrogramFrameLen,
                                                adModelTrainingMean);
     this->m_validInstance = true;
 }
@@ -100,12 +101,9 @@ bool AdPreProcess::DoPreProcess(const void* input, size_t inputSize)
     /* Start calculating features inside one audio sliding window. */
     while (this->m_melWindowSlider.HasNext()) {
         const int16_t* melSpecWindow = this->m_melWindowSlider.Next();
-        std::vector<int16_t> melSpecAudioData = std::vector<int16_t>(
-                melSpecWindow,
-                melSpecWindow + this->m_melSpectrogramFrameLen);
 
         /* Compute features for this window and write them to input tensor. */
-        this->m_featureCalc(melSpecAudioData,
+        this->m_featureCalc(melSpecWindow,
                             this->m_melWindowSlider.Index(),
                             useCache,
                             this->m_numMelSpecVectorsInAudioStride,
@@ -158,15 +156,17 @@ float AdPostProcess::GetOutputValue(uint32_t index)
     return 0.0;
 }
 
-std::function<void (std::vector<int16_t>&, int, bool, size_t, size_t)>
+std::function<void (const int16_t*, size_t, bool, size_t, size_t)>
 GetFeatureCalculator(audio::AdMelSpectrogram& melSpec,
                      TfLiteTensor* inputTensor,
                      size_t cacheSize,
+                     size_t frameLen,
                      float trainingMean)
 {
-    std::function<void (std::vector<int16_t>&, size_t, bool, size_t, size_t)> melSpecFeatureCalc = nullptr;
+    std::function<void (const int16_t*, size_t, bool, size_t, size_t)> melSpecFeatureCalc = nullptr;
 
     TfLiteQuantization quant = inputTensor->quantization;
+    const size_t numFeatures = melSpec.GetNumFbankBins();
 
     if (kTfLiteAffineQuantization == quant.type) {
 
@@ -179,9 +179,12 @@ GetFeatureCalculator(audio::AdMelSpectrogram& melSpec,
                 melSpecFeatureCalc = FeatureCalc<int8_t>(
                         inputTensor,
                         cacheSize,
-                        [=, &melSpec](std::vector<int16_t>& audioDataWindow) {
+                        numFeatures,
+                        [=, &melSpec](const int16_t* audioDataWindow, int8_t* out) {
                             return melSpec.MelSpecComputeQuant<int8_t>(
                                     audioDataWindow,
+                                    frameLen,
+                                    out,
                                     quantScale,
                                     quantOffset,
                                     trainingMean);
@@ -196,10 +199,12 @@ GetFeatureCalculator(audio::AdMelSpectrogram& melSpec,
         melSpecFeatureCalc = FeatureCalc<float>(
                 inputTensor,
                 cacheSize,
-                [=, &melSpec](
-                        std::vector<int16_t>& audioDataWindow) {
+                numFeatures,
+                [=, &melSpec](const int16_t* audioDataWindow, float* out) {
                     return melSpec.ComputeMelSpec(
                             audioDataWindow,
+                            frameLen,
+                            out,
                             trainingMean);
                 });
     }
@@ -32,7 +32,8 @@ namespace audio {
             const float melLoFreq,
             const float melHiFreq,
             const uint32_t frameLen,
-            const bool useHtkMethod):
+            const bool useHtkMethod,
+            const bool useFixedPoint):
             m_samplingFreq(samplingFreq),
             m_numFbankBins(numFbankBins),
             m_melLoFreq(melLoFreq),
@@ -41,7 +42,8 @@ namespace audio {
 
             /* Smallest power of 2 >= frame length. */
             m_frameLenPadded(pow(2, ceil((log(frameLen)/log(2))))),
-            m_useHtkMethod(useHtkMethod)
+            m_useHtkMethod(useHtkMethod),
+            m_useFixedPoint(useFixedPoint)
     {}
 
     std::string MelSpecParams::Str() const
@@ -54,10 +56,12 @@ namespace audio {
             \n\t Mel frequency limit (high): %f\
             \n\t Frame length:               %" PRIu32 "\
             \n\t Padded frame length:        %" PRIu32 "\
-            \n\t Using HTK for Mel scale:    %s\n",
+            \n\t Using HTK for Mel scale:    %s\
+            \n\t Using fixed point:          %s\n",
             this->m_samplingFreq, this->m_numFbankBins, this->m_melLoFreq,
             this->m_melHiFreq, this->m_frameLen,
-            this->m_frameLenPadded, this->m_useHtkMethod ? "yes" : "no");
+            this->m_frameLenPadded, this->m_useHtkMethod ? "yes" : "no",
+            this->m_useFixedPoint ? "yes" : "no");
         return std::string{strC};
     }
 
@@ -72,15 +76,6 @@ namespace audio {
         this->m_melEnergies = std::vector<float>(
                 this->m_params.m_numFbankBins, 0.0);
 
-        this->m_windowFunc = std::vector<float>(this->m_params.m_frameLen);
-        const auto multiplier = static_cast<float>(2 * M_PI / this->m_params.m_frameLen);
-
-        /* Create window function. */
-        for (size_t i = 0; i < this->m_params.m_frameLen; ++i) {
-            this->m_windowFunc[i] = (0.5 - (0.5 *
-                                             math::MathUtils::CosineF32(static_cast<float>(i) * multiplier)));
-        }
-
         math::MathUtils::FftInitF32(this->m_params.m_frameLenPadded, this->m_fftInstance);
         debug("Instantiated Mel Spectrogram object: %s\n", this->m_params.Str().c_str());
     }
@@ -92,64 +87,32 @@ namespace audio {
 
     float MelSpectrogram::MelScale(const float freq, const bool useHTKMethod)
     {
-        if (useHTKMethod) {
-            return 1127.0f * logf (1.0f + freq / 700.0f);
-        } else {
-            /* Slaney formula for mel scale. */
-            float mel = freq / ms_freqStep;
-
-            if (freq >= ms_minLogHz) {
-                mel = ms_minLogMel + logf(freq / ms_minLogHz) / ms_logStep;
-            }
-            return mel;
-        }
+        return MelFilterBank::MelScale(freq, useHTKMethod);
     }
 
     float MelSpectrogram::InverseMelScale(const float melFreq, const bool useHTKMethod)
     {
-        if (useHTKMethod) {
-            return 700.0f * (expf (melFreq / 1127.0f) - 1.0f);
-        } else {
-            /* Slaney formula for inverse mel scale. */
-            float freq = ms_freqStep * melFreq;
-
-            if (melFreq >= ms_minLogMel) {
-                freq = ms_minLogHz * expf(ms_logStep * (melFreq - ms_minLogMel));
-            }
-            return freq;
-        }
+        return MelFilterBank::InverseMelScale(melFreq, useHTKMethod);
     }
 
     bool MelSpectrogram::ApplyMelFilterBank(
-            std::vector<float>&                 fftVec,
-            std::vector<std::vector<float>>&    melFilterBank,
-            std::vector<uint32_t>&               filterBankFilterFirst,
-            std::vector<uint32_t>&               filterBankFilterLast,
-            std::vector<float>&                 melEnergies)
+            std::vector<float>&     fftVec,
+            const MelFilterBank&    melFilterBank,
+            std::vector<float>&     melEnergies)
     {
-        const size_t numBanks = melEnergies.size();
-
-        if (numBanks != filterBankFilterFirst.size() ||
-            numBanks != filterBankFilterLast.size()) {
+        if (melEnergies.size() != melFilterBank.GetNumBanks() ||
+            fftVec.size() < melFilterBank.GetEndBin()) {
             printf_err("unexpected filter bank lengths\n");
             return false;
         }
 
-        for (size_t bin = 0; bin < numBanks; ++bin) {
-            auto filterBankIter = melFilterBank[bin].begin();
-            auto end = melFilterBank[bin].end();
-            float melEnergy = FLT_MIN; /* Avoid log of zero at later stages */
-            const uint32_t firstIndex = filterBankFilterFirst[bin];
-            const uint32_t lastIndex = std::min<int32_t>(filterBankFilterLast[bin], fftVec.size() - 1);
-
-            for (uint32_t i = firstIndex; i <= lastIndex && filterBankIter != end; ++i) {
-                float energyRep = math::MathUtils::SqrtF32(fftVec[i]);
-                melEnergy += (*filterBankIter++ * energyRep);
-            }
-
-            melEnergies[bin] = melEnergy;
+        /* Magnitudes of the bins in use, once per bin rather than once per filter. */
+        for (uint32_t i = melFilterBank.GetFirstBin(); i < melFilterBank.GetEndBin(); ++i) {
+            fftVec[i] = math::MathUtils::SqrtF32(fftVec[i]);
         }
 
+        /* Start from FLT_MIN to avoid log of zero at later stages. */
+        melFilterBank.Apply(fftVec.data(), melEnergies.data(), FLT_MIN);
         return true;
     }
 
@@ -189,10 +152,60 @@ namespace audio {
         return 1.f;
     }
 
+    FixedPointMel::Spectrum MelSpectrogram::GetFixedPointSpectrum() const
+    {
+        return FixedPointMel::Spectrum::Magnitude;
+    }
+
+    float MelSpectrogram::GetFixedPointLogMultiplier() const
+    {
+        /* Natural logarithm. */
+        return 0.6931471805599453;
+    }
+
+    FrontEndKind MelSpectrogram::GetFrontEndKind() const
+    {
+        return FrontEndKind::Custom;
+    }
+
     void MelSpectrogram::InitMelFilterBank()
     {
         if (!this->IsMelFilterBankInited()) {
-            this->m_melFilterBank = this->CreateMelFilterBank();
+            const MelFilterBankParams melParams = this->GetMelFilterBankParams();
+            const FrontEndTables* tables = FindFrontEndTables(
+                    this->GetFrontEndKind(), melParams, this->m_params.m_frameLen, 0);
+
+            if (tables) {
+                /* Tables generated at build time, in read-only memory. */
+                this->m_window = tables->window;
+                this->m_melFilterBank = std::make_shared<const MelFilterBank>(
+                        tables->melParams, tables->melWeights, tables->melOffsets, tables->melFirstBins);
+            } else {
+                this->m_windowFunc = std::vector<float>(this->m_params.m_frameLen);
+                const auto multiplier = static_cast<float>(2 * M_PI / this->m_params.m_frameLen);
+
+                /* Create window function. */
+                for (size_t i = 0; i < this->m_params.m_frameLen; ++i) {
+                    this->m_windowFunc[i] = (0.5 - (0.5 *
+                                                     math::MathUtils::CosineF32(static_cast<float>(i) * multiplier)));
+                }
+
+                this->m_melFilterBank = this->CreateMelFilterBank();
+                this->m_window = this->m_windowFunc.data();
+            }
+
+            if (this->m_params.m_useFixedPoint) {
+                if (this->m_fixedPointMel.Init(this->m_window, this->m_params.m_frameLen,
+                                               this->m_params.m_frameLenPadded,
+                                               *this->m_melFilterBank, this->GetFixedPointSpectrum())) {
+                    this->m_log2MelEnergies.assign(this->m_params.m_numFbankBins, 0);
+                    this->m_quantEnergies.assign(this->m_params.m_numFbankBins, 0);
+                    this->m_requantScale = 0;
+                } else {
+                    printf_err("Failed to initialise fixed point Mel Spectrogram, using floating point\n");
+                    this->m_params.m_useFixedPoint = false;
+                }
+            }
             this->m_filterBankInitialised = true;
         }
     }
@@ -203,22 +216,55 @@ namespace audio {
     }
 
     std::vector<float> MelSpectrogram::ComputeMelSpec(const std::vector<int16_t>& audioData, float trainingMean)
+    {
+        this->ComputeMelEnergies(audioData.data(), audioData.size(), trainingMean);
+        return this->m_melEnergies;
+    }
+
+    bool MelSpectrogram::ComputeMelSpec(const int16_t* audioData, const size_t audioDataLen,
+                                        float* melSpecOut, const float trainingMean)
+    {
+        if (!melSpecOut) {
+            return false;
+        }
+        this->ComputeMelEnergies(audioData, audioDataLen, trainingMean);
+        std::copy(this->m_melEnergies.begin(), this->m_melEnergies.end(), melSpecOut);
+        return true;
+    }
+
+    uint32_t MelSpectrogram::GetNumFbankBins() const
+    {
+        return this->m_params.m_numFbankBins;
+    }
+
+    void MelSpectrogram::ComputeMelEnergies(const int16_t* audioData, const size_t audioDataLen,
+                                            const float trainingMean)
     {
         this->InitMelFilterBank();
 
-        /* TensorFlow way of normalizing .wav data to (-1, 1). */
-        constexpr float normaliser = 1.0/(1<<15);
-        for (size_t i = 0; i < this->m_params.m_frameLen; ++i) {
-            this->m_frame[i] = static_cast<float>(audioData[i]) * normaliser;
+        if (this->m_params.m_useFixedPoint) {
+            this->m_fixedPointMel.ComputeLog2MelEnergies(audioData, audioDataLen,
+                                                         this->m_log2MelEnergies.data());
+            const float multiplier = this->GetFixedPointLogMultiplier() /
+                                     (1 << FixedPointMel::ms_log2FracBits);
+            for (size_t k = 0; k < this->m_params.m_numFbankBins; ++k) {
+                this->m_melEnergies[k] = this->m_log2MelEnergies[k] * multiplier - trainingMean;
+            }
+            return;
         }
 
-        /* Apply window function to input frame. */
-        for(size_t i = 0; i < this->m_params.m_frameLen; ++i) {
-            this->m_frame[i] *= this->m_windowFunc[i];
+        /* Samples beyond what the caller has provided are treated as zeros. */
+        const size_t numSamples = audioData ?
+                std::min<size_t>(audioDataLen, this->m_params.m_frameLen) : 0;
+
+        /* TensorFlow way of normalizing .wav data to (-1, 1) and apply window function. */
+        constexpr float normaliser = 1.0/(1<<15);
+        for (size_t i = 0; i < numSamples; ++i) {
+            this->m_frame[i] = static_cast<float>(audioData[i]) * normaliser * this->m_window[i];
         }
 
         /* Set remaining frame values to 0. */
-        std::fill(this->m_frame.begin() + this->m_params.m_frameLen,this->m_frame.end(), 0);
+        std::fill(this->m_frame.begin() + numSamples, this->m_frame.end(), 0);
 
         /* Compute FFT. */
         math::MathUtils::FftF32(this->m_frame, this->m_buffer, this->m_fftInstance);
@@ -228,9 +274,7 @@ namespace audio {
 
         /* Apply mel filterbanks. */
         if (!this->ApplyMelFilterBank(this->m_buffer,
-                                      this->m_melFilterBank,
-                                      this->m_filterBankFilterFirst,
-                                      this->m_filterBankFilterLast,
+                                      *this->m_melFilterBank,
                                       this->m_melEnergies)) {
             printf_err("Failed to apply MEL filter banks\n");
         }
@@ -242,71 +286,56 @@ namespace audio {
         for (auto& energy:this->m_melEnergies) {
             energy -= trainingMean;
         }
-
-        return this->m_melEnergies;
     }
 
-    std::vector<std::vector<float>> MelSpectrogram::CreateMelFilterBank()
+    bool MelSpectrogram::ComputeQuantFixedPoint(const int16_t* audioData, const size_t audioDataLen,
+                                                const float quantScale, const int quantOffset,
+                                                const float trainingMean)
     {
-        size_t numFftBins = this->m_params.m_frameLenPadded / 2;
-        float fftBinWidth = static_cast<float>(this->m_params.m_samplingFreq) / this->m_params.m_frameLenPadded;
-
-        float melLowFreq = MelSpectrogram::MelScale(this->m_params.m_melLoFreq,
-                                          this->m_params.m_useHtkMethod);
-        float melHighFreq = MelSpectrogram::MelScale(this->m_params.m_melHiFreq,
-                                           this->m_params.m_useHtkMethod);
-        float melFreqDelta = (melHighFreq - melLowFreq) / (this->m_params.m_numFbankBins + 1);
-
-        std::vector<float> thisBin = std::vector<float>(numFftBins);
-        std::vector<std::vector<float>> melFilterBank(
-                this->m_params.m_numFbankBins);
-        this->m_filterBankFilterFirst =
-                std::vector<uint32_t>(this->m_params.m_numFbankBins);
-        this->m_filterBankFilterLast =
-                std::vector<uint32_t>(this->m_params.m_numFbankBins);
-
-        for (size_t bin = 0; bin < this->m_params.m_numFbankBins; bin++) {
-            float leftMel = melLowFreq + bin * melFreqDelta;
-            float centerMel = melLowFreq + (bin + 1) * melFreqDelta;
-            float rightMel = melLowFreq + (bin + 2) * melFreqDelta;
-
-            uint32_t firstIndex = 0;
-            uint32_t lastIndex = 0;
-            bool firstIndexFound = false;
-            const float normaliser = this->GetMelFilterBankNormaliser(leftMel, rightMel, this->m_params.m_useHtkMethod);
-
-            for (size_t i = 0; i < numFftBins; ++i) {
-                float freq = (fftBinWidth * i); /* Center freq of this fft bin. */
-                float mel = MelSpectrogram::MelScale(freq, this->m_params.m_useHtkMethod);
-                thisBin[i] = 0.0;
-
-                if (mel > leftMel && mel < rightMel) {
-                    float weight;
-                    if (mel <= centerMel) {
-                        weight = (mel - leftMel) / (centerMel - leftMel);
-                    } else {
-                        weight = (rightMel - mel) / (rightMel - centerMel);
-                    }
-
-                    thisBin[i] = weight * normaliser;
-                    if (!firstIndexFound) {
-                        firstIndex = i;
-                        firstIndexFound = true;
-                    }
-                    lastIndex = i;
-                }
+        /* From Q16 log2 to the quantised energy: (log * multiplier - mean) / scale + offset. */
+        if (quantScale != this->m_requantScale || quantOffset != this->m_requantOffset ||
+                trainingMean != this->m_requantMean) {
+            const double multiplier = static_cast<double>(this->GetFixedPointLogMultiplier()) /
+                                      ((1 << FixedPointMel::ms_log2FracBits) * static_cast<double>(quantScale));
+            if (!this->m_requantiser.Set(multiplier, quantOffset - trainingMean / quantScale)) {
+                return false;
             }
+            this->m_requantScale = quantScale;
+            this->m_requantOffset = quantOffset;
+            this->m_requantMean = trainingMean;
+        }
 
-            this->m_filterBankFilterFirst[bin] = firstIndex;
-            this->m_filterBankFilterLast[bin] = lastIndex;
+        this->m_fixedPointMel.ComputeLog2MelEnergies(audioData, audioDataLen, this->m_log2MelEnergies.data());
+        for (size_t k = 0; k < this->m_params.m_numFbankBins; ++k) {
+            this->m_quantEnergies[k] = this->m_requantiser.Apply(this->m_log2MelEnergies[k]);
+        }
+        return true;
+    }
 
-            /* Copy the part we care about. */
-            for (uint32_t i = firstIndex; i <= lastIndex; ++i) {
-                melFilterBank[bin].push_back(thisBin[i]);
-            }
+    MelFilterBankParams MelSpectrogram::GetMelFilterBankParams() const
+    {
+        return MelFilterBankParams{
+            this->m_params.m_samplingFreq,
+            this->m_params.m_numFbankBins,
+            this->m_params.m_melLoFreq,
+            this->m_params.m_melHiFreq,
+            this->m_params.m_frameLenPadded,
+            this->m_params.m_useHtkMethod};
+    }
+
+    std::shared_ptr<const MelFilterBank> MelSpectrogram::CreateMelFilterBank()
+    {
+        const MelFilterBankParams params = this->GetMelFilterBankParams();
+
+        /* Normalisers come from the (possibly overridden) virtual, and key the sharing. */
+        const std::vector<float> melPoints = MelFilterBank::GetMelPoints(params);
+        std::vector<float> normalisers(this->m_params.m_numFbankBins);
+        for (size_t bin = 0; bin < this->m_params.m_numFbankBins; ++bin) {
+            normalisers[bin] = this->GetMelFilterBankNormaliser(
+                    melPoints[bin], melPoints[bin + 2], this->m_params.m_useHtkMethod);
         }
 
-        return melFilterBank;
+        return MelFilterBank::GetShared(params, normalisers);
     }
 
 } /* namespace audio */
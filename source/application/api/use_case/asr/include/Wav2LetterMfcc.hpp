@@ -47,22 +47,17 @@ namespace audio {
 
         /**
          * @brief       Overrides base class implementation of this function.
-         * @param[in]   fftVec                  Vector populated with FFT magnitudes
-         * @param[in]   melFilterBank           2D Vector with filter bank weights
-         * @param[in]   filterBankFilterFirst   Vector containing the first indices of filter bank
-         *                                      to be used for each bin.
-         * @param[in]   filterBankFilterLast    Vector containing the last indices of filter bank
-         *                                      to be used for each bin.
-         * @param[out]  melEnergies             Pre-allocated vector of MEL energies to be
-         *                                      populated.
+         *              The filter bank is applied to the power spectrum.
+         * @param[in]   fftVec          Vector populated with the power spectrum
+         * @param[in]   melFilterBank   Packed filter bank weights
+         * @param[out]  melEnergies     Pre-allocated vector of MEL energies to be
+         *                              populated.
          * @return      true if successful, false otherwise
          */
         bool ApplyMelFilterBank(
-            std::vector<float>&                 fftVec,
-            std::vector<std::vector<float>>&    melFilterBank,
-            std::vector<uint32_t>&              filterBankFilterFirst,
-            std::vector<uint32_t>&              filterBankFilterLast,
-            std::vector<float>&                 melEnergies) override;
+            std::vector<float>&     fftVec,
+            const MelFilterBank&    melFilterBank,
+            std::vector<float>&     melEnergies) override;
 
         /**
          * @brief           Override for the base class implementation convert mel
@@ -100,6 +95,12 @@ namespace audio {
         float GetMelFilterBankNormaliser(const float&   leftMel,
                                          const float&   rightMel,
                                          bool     useHTKMethod) override;
+
+        /**
+         * @brief       Override to use the tables generated for this front end.
+         * @return      Wav2LetterMfcc.
+         */
+        FrontEndKind GetFrontEndKind() const override;
     };
 
 } /* namespace audio */
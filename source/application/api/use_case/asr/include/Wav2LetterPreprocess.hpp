@@ -24,6 +24,8 @@
 #include "BaseProcessing.hpp"
 #include "log_macros.h"
 
+#include <vector>
+
 namespace arm {
 namespace app {
 
@@ -41,12 +43,16 @@ namespace app {
          *                                 for an inference.
          * @param[in]   mfccWindowLen      Number of audio elements to calculate MFCC features per window.
          * @param[in]   mfccWindowStride   Stride (in number of elements) for moving the MFCC window.
+         * @param[in]   streaming          If true, MFCC and delta vectors are kept in a ring keyed
+         *                                 by absolute frame index so that consecutive overlapping
+         *                                 windows (see SetStreamOffset) only compute new frames.
          */
         AsrPreProcess(TfLiteTensor* inputTensor,
                       uint32_t  numMfccFeatures,
                       uint32_t  numFeatureFrames,
                       uint32_t  mfccWindowLen,
-                      uint32_t  mfccWindowStride);
+                      uint32_t  mfccWindowStride,
+                      bool      streaming = false);
 
         /**
          * @brief       Calculates the features required from audio data. This
@@ -60,6 +66,29 @@ namespace app {
          */
         bool DoPreProcess(const void* audioData, size_t audioDataLen) override;
 
+        /**
+         * @brief       Sets the position of the next window passed to DoPreProcess within
+         *              the audio stream. In streaming mode, frames already computed for a
+         *              previous window at a lower offset are reused. Offsets that do not
+         *              increase, or are not a multiple of the MFCC stride, restart the stream.
+         *              Has no effect when streaming mode is disabled.
+         * @param[in]   sampleOffset   Offset (in number of elements) of the next window from
+         *                             the start of the stream.
+         */
+        void SetStreamOffset(size_t sampleOffset);
+
+        /**
+         * @brief   Discards all MFCC and delta vectors kept from previous windows.
+         */
+        void ResetStream();
+
+        /**
+         * @brief   Gets the number of MFCC vectors computed from audio data by the last
+         *          call to DoPreProcess, i.e., the vectors that could not be reused.
+         * @return  Number of MFCC vectors computed.
+         */
+        uint32_t GetNumComputedFrames() const;
+
     protected:
          /**
           * @brief Computes the first and second order deltas for the
@@ -81,6 +110,15 @@ namespace app {
          */
         static void StandardizeVecF32(Array2d<float>& vec);
 
+        /**
+         * @brief           Rescales a 2D vector of floats using a precomputed mean and
+         *                  standard deviation.
+         * @param[in,out]   vec      Vector of vector of floats.
+         * @param[in]       mean     Mean of all elements in vec.
+         * @param[in]       stddev   Standard deviation of all elements in vec.
+         */
+        static void StandardizeVecF32(Array2d<float>& vec, float mean, float stddev);
+
         /**
          * @brief   Standardizes all the MFCC and delta buffers to have mean 0 and std. dev 1.
          */
@@ -160,6 +198,37 @@ namespace app {
         }
 
     private:
+        /**
+         * @brief       Populates and standardises the MFCC and delta buffers for the current
+         *              window, computing every MFCC vector from the audio data.
+         * @param[in]   audioData      Pointer to the first element of audio data.
+         * @param[in]   audioDataLen   Number of elements in the audio data.
+         */
+        void ComputeFeatures(const int16_t* audioData, size_t audioDataLen);
+
+        /**
+         * @brief       Populates the MFCC and delta buffers for the current window, reusing
+         *              vectors held in the frame ring, and standardises them using the
+         *              per-frame sums kept alongside.
+         * @param[in]   audioData      Pointer to the first element of audio data.
+         * @param[in]   audioDataLen   Number of elements in the audio data.
+         */
+        void ComputeStreamingFeatures(const int16_t* audioData, size_t audioDataLen);
+
+        /**
+         * @brief       Computes the first and second order deltas for one column of the
+         *              MFCC buffer into the given frame ring slot.
+         * @param[in]   col    Column (frame within the window) to compute deltas for.
+         * @param[in]   slot   Frame ring slot to write the deltas and their sums to.
+         */
+        void ComputeFrameDeltas(size_t col, size_t slot);
+
+        /* Offsets of the per-frame sums held for each frame ring slot. */
+        enum FrameSum {
+            kMfccSum = 0, kMfccSumSq, kDelta1Sum, kDelta1SumSq, kDelta2Sum, kDelta2SumSq,
+            kNumFrameSums
+        };
+
         audio::Wav2LetterMFCC   m_mfcc;          /* MFCC instance. */
         TfLiteTensor*           m_inputTensor;   /* Model input tensor. */
 
@@ -173,6 +242,21 @@ namespace app {
         uint32_t         m_numMfccFeats;         /* Number of MFCC features per window. */
         uint32_t         m_numFeatureFrames;     /* How many sets of m_numMfccFeats. */
         AudioWindow      m_mfccSlidingWindow;    /* Sliding window to calculate MFCCs. */
+        uint32_t         m_numComputedFrames{0}; /* MFCC vectors computed by the last call. */
+
+        /* Streaming mode: ring of m_numFeatureFrames slots, frame n lives in slot n % size. */
+        bool                 m_streaming;          /* Reuse frames across windows. */
+        std::vector<float>   m_ringMfcc;           /* MFCC vector per slot. */
+        std::vector<float>   m_ringDelta1;         /* Delta 1 vector per slot. */
+        std::vector<float>   m_ringDelta2;         /* Delta 2 vector per slot. */
+        std::vector<float>   m_ringSums;           /* kNumFrameSums sums per slot. */
+        std::vector<uint8_t> m_ringDeltaValid;     /* Slot deltas depend on audio frames only. */
+        std::vector<float>   m_padMfcc;            /* MFCC vector for silence (padding). */
+        float                m_padSums[2]{0, 0};   /* Sum and sum of squares of m_padMfcc. */
+        size_t               m_ringBegin{0};       /* First absolute frame held in the ring. */
+        size_t               m_ringEnd{0};         /* One past the last absolute frame held. */
+        size_t               m_streamOffset{0};    /* Offset of the next window in the stream. */
+        bool                 m_offsetPending{false}; /* SetStreamOffset called since last window. */
 
     };
 
@@ -26,36 +26,19 @@ namespace app {
 namespace audio {
 
     bool Wav2LetterMFCC::ApplyMelFilterBank(
-            std::vector<float>&                 fftVec,
-            std::vector<std::vector<float>>&    melFilterBank,
-            std::vector<uint32_t>&               filterBankFilterFirst,
-            std::vector<uint32_t>&               filterBankFilterLast,
-            std::vector<float>&                 melEnergies)
+            std::vector<float>&     fftVec,
+            const MelFilterBank&    melFilterBank,
+            std::vector<float>&     melEnergies)
     {
-        const size_t numBanks = melEnergies.size();
-
-        if (numBanks != filterBankFilterFirst.size() ||
-                numBanks != filterBankFilterLast.size()) {
+        if (melEnergies.size() != melFilterBank.GetNumBanks() ||
+            fftVec.size() < melFilterBank.GetEndBin()) {
             printf_err("Unexpected filter bank lengths\n");
             return false;
         }
 
-        for (size_t bin = 0; bin < numBanks; ++bin) {
-            auto filterBankIter = melFilterBank[bin].begin();
-            auto end = melFilterBank[bin].end();
-            /* Avoid log of zero at later stages, same value used in librosa.
-             * The number was used during our default wav2letter model training. */
-            float melEnergy = 1e-10;
-            const uint32_t firstIndex = filterBankFilterFirst[bin];
-            const uint32_t lastIndex = std::min<uint32_t>(filterBankFilterLast[bin], fftVec.size() - 1);
-
-            for (uint32_t i = firstIndex; i <= lastIndex && filterBankIter != end; ++i) {
-                melEnergy += (*filterBankIter++ * fftVec[i]);
-            }
-
-            melEnergies[bin] = melEnergy;
-        }
-
+        /* Avoid log of zero at later stages, same value used in librosa.
+         * The number was used during our default wav2letter model training. */
+        melFilterBank.Apply(fftVec.data(), melEnergies.data(), 1e-10f);
         return true;
     }
 
@@ -64,26 +47,22 @@ namespace audio {
     {
         float maxMelEnergy = -FLT_MAX;
 
-        /* Container for natural logarithms of mel energies. */
-        std::vector <float> vecLogEnergies(melEnergies.size(), 0.f);
-
         /* Because we are taking natural logs, we need to multiply by log10(e).
          * Also, for wav2letter model, we scale our log10 values by 10. */
         constexpr float multiplier = 10.0 *  /* Default scalar. */
                                       0.4342944819032518;  /* log10f(std::exp(1.0)) */
 
-        /* Take log of the whole vector. */
-        math::MathUtils::VecLogarithmF32(melEnergies, vecLogEnergies);
+        /* Take log of the whole vector (in place). */
+        math::MathUtils::VecLogarithmF32(melEnergies, melEnergies);
 
         /* Scale the log values and get the max. */
-        for (auto iterM = melEnergies.begin(), iterL = vecLogEnergies.begin();
-                  iterM != melEnergies.end() && iterL != vecLogEnergies.end(); ++iterM, ++iterL) {
+        for (float& melEnergy : melEnergies) {
 
-            *iterM = *iterL * multiplier;
+            melEnergy *= multiplier;
 
             /* Save the max mel energy. */
-            if (*iterM > maxMelEnergy) {
-                maxMelEnergy = *iterM;
+            if (melEnergy > maxMelEnergy) {
+                maxMelEnergy = melEnergy;
             }
         }
 
@@ -136,6 +115,11 @@ namespace audio {
                 MFCC::InverseMelScale(leftMel, useHTKMethod)));
     }
 
+    FrontEndKind Wav2LetterMFCC::GetFrontEndKind() const
+    {
+        return FrontEndKind::Wav2LetterMfcc;
+    }
+
 } /* namespace audio */
 } /* namespace app */
 } /* namespace arm */
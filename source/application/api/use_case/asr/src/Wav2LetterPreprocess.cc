@@ -25,9 +25,25 @@
 namespace arm {
 namespace app {
 
+    /* Differential kernels used to compute the first and second order deltas. */
+    static const float delta1Coeffs[] =
+        {6.66666667e-02,  5.00000000e-02,  3.33333333e-02,
+         1.66666667e-02, -3.46944695e-18, -1.66666667e-02,
+        -3.33333333e-02, -5.00000000e-02, -6.66666667e-02};
+
+    static const float delta2Coeffs[] =
+        {0.06060606,      0.01515152,     -0.01731602,
+        -0.03679654,     -0.04329004,     -0.03679654,
+        -0.01731602,      0.01515152,      0.06060606};
+
+    static constexpr size_t deltaCoeffLen = sizeof(delta1Coeffs)/sizeof(delta1Coeffs[0]);
+
+    /* Middle index of the kernels; coeff len should always be odd. */
+    static constexpr size_t deltaMidIdx = (deltaCoeffLen - 1)/2;
+
     AsrPreProcess::AsrPreProcess(TfLiteTensor* inputTensor, const uint32_t numMfccFeatures,
                                  const uint32_t numFeatureFrames, const uint32_t mfccWindowLen,
-                                 const uint32_t mfccWindowStride
+                                 const uint32_t mfccWindowStride, const bool streaming
             ):
             m_mfcc(numMfccFeatures, mfccWindowLen),
             m_inputTensor(inputTensor),
@@ -37,17 +53,98 @@ namespace app {
             m_mfccWindowLen(mfccWindowLen),
             m_mfccWindowStride(mfccWindowStride),
             m_numMfccFeats(numMfccFeatures),
-            m_numFeatureFrames(numFeatureFrames)
+            m_numFeatureFrames(numFeatureFrames),
+            m_streaming(streaming && numFeatureFrames > 2 * deltaMidIdx)
     {
         if (numMfccFeatures > 0 && mfccWindowLen > 0) {
             this->m_mfcc.Init();
         }
+
+        if (this->m_streaming) {
+            const size_t ringSize = numFeatureFrames * numMfccFeatures;
+            this->m_ringMfcc.resize(ringSize);
+            this->m_ringDelta1.resize(ringSize);
+            this->m_ringDelta2.resize(ringSize);
+            this->m_ringSums.resize(numFeatureFrames * kNumFrameSums);
+            this->m_ringDeltaValid.resize(numFeatureFrames);
+
+            /* Padding frames are the same for every window, compute them once. */
+            this->m_padMfcc.resize(numMfccFeatures);
+            this->m_mfcc.MfccCompute(nullptr, 0, this->m_padMfcc.data());
+            for (const float value : this->m_padMfcc) {
+                this->m_padSums[0] += value;
+                this->m_padSums[1] += value * value;
+            }
+        }
+    }
+
+    void AsrPreProcess::SetStreamOffset(const size_t sampleOffset)
+    {
+        if (!this->m_streaming) {
+            return;
+        }
+
+        if (sampleOffset % this->m_mfccWindowStride != 0 || sampleOffset <= this->m_streamOffset) {
+            this->ResetStream();
+        }
+
+        this->m_streamOffset = sampleOffset;
+        this->m_offsetPending = true;
+    }
+
+    void AsrPreProcess::ResetStream()
+    {
+        this->m_ringBegin = 0;
+        this->m_ringEnd = 0;
+        this->m_streamOffset = 0;
+        this->m_offsetPending = false;
+    }
+
+    uint32_t AsrPreProcess::GetNumComputedFrames() const
+    {
+        return this->m_numComputedFrames;
     }
 
     bool AsrPreProcess::DoPreProcess(const void* audioData, const size_t audioDataLen)
+    {
+        if (this->m_streaming && this->m_offsetPending) {
+            this->ComputeStreamingFeatures(static_cast<const int16_t*>(audioData), audioDataLen);
+            this->m_offsetPending = false;
+        } else {
+            /* Window position is unknown so nothing computed here can be reused later. */
+            this->ResetStream();
+            this->ComputeFeatures(static_cast<const int16_t*>(audioData), audioDataLen);
+        }
+
+        /* Quantise. */
+        QuantParams quantParams = GetTensorQuantParams(this->m_inputTensor);
+
+        if (0 == quantParams.scale) {
+            printf_err("Quantisation scale can't be 0\n");
+            return false;
+        }
+
+        switch(this->m_inputTensor->type) {
+            case kTfLiteUInt8:
+                return this->Quantise<uint8_t>(
+                        tflite::GetTensorData<uint8_t>(this->m_inputTensor), this->m_inputTensor->bytes,
+                        quantParams.scale, quantParams.offset);
+            case kTfLiteInt8:
+                return this->Quantise<int8_t>(
+                        tflite::GetTensorData<int8_t>(this->m_inputTensor), this->m_inputTensor->bytes,
+                        quantParams.scale, quantParams.offset);
+            default:
+                printf_err("Unsupported tensor type %s\n",
+                    TfLiteTypeGetName(this->m_inputTensor->type));
+        }
+
+        return false;
+    }
+
+    void AsrPreProcess::ComputeFeatures(const int16_t* audioData, const size_t audioDataLen)
     {
         this->m_mfccSlidingWindow = audio::SlidingWindow<const int16_t>(
-                static_cast<const int16_t*>(audioData), audioDataLen,
+                audioData, audioDataLen,
                 this->m_mfccWindowLen, this->m_mfccWindowStride);
 
         uint32_t mfccBufIdx = 0;
@@ -56,27 +153,28 @@ namespace app {
         std::fill(m_delta1Buf.begin(), m_delta1Buf.end(), 0.f);
         std::fill(m_delta2Buf.begin(), m_delta2Buf.end(), 0.f);
 
+        /* MFCC vectors are laid out along the "time" axis, i.e. down a column. */
+        const size_t mfccBufStride = this->m_mfccBuf.dimSize(1);
+
         /* While we can slide over the audio. */
         while (this->m_mfccSlidingWindow.HasNext()) {
             const int16_t* mfccWindow = this->m_mfccSlidingWindow.Next();
-            auto mfccAudioData = std::vector<int16_t>(
-                                        mfccWindow,
-                                        mfccWindow + this->m_mfccWindowLen);
-            auto mfcc = this->m_mfcc.MfccCompute(mfccAudioData);
-            for (size_t i = 0; i < this->m_mfccBuf.dimSize(0); ++i) {
-                this->m_mfccBuf(i, mfccBufIdx) = mfcc[i];
-            }
+            this->m_mfcc.MfccCompute(mfccWindow, this->m_mfccWindowLen,
+                                     &this->m_mfccBuf(0, mfccBufIdx), mfccBufStride);
             ++mfccBufIdx;
         }
+        this->m_numComputedFrames = mfccBufIdx;
 
         /* Pad MFCC if needed by adding MFCC for zeros. */
         if (mfccBufIdx != this->m_numFeatureFrames) {
-            std::vector<int16_t> zerosWindow = std::vector<int16_t>(this->m_mfccWindowLen, 0);
-            std::vector<float> mfccZeros = this->m_mfcc.MfccCompute(zerosWindow);
+            const uint32_t firstPadIdx = mfccBufIdx;
+            this->m_mfcc.MfccCompute(nullptr, 0, &this->m_mfccBuf(0, firstPadIdx), mfccBufStride);
+            ++mfccBufIdx;
 
             while (mfccBufIdx != this->m_numFeatureFrames) {
-                memcpy(&this->m_mfccBuf(0, mfccBufIdx),
-                       mfccZeros.data(), sizeof(float) * m_numMfccFeats);
+                for (size_t i = 0; i < this->m_numMfccFeats; ++i) {
+                    this->m_mfccBuf(i, mfccBufIdx) = this->m_mfccBuf(i, firstPadIdx);
+                }
                 ++mfccBufIdx;
             }
         }
@@ -86,54 +184,157 @@ namespace app {
 
         /* Standardize calculated features. */
         this->Standarize();
+    }
 
-        /* Quantise. */
-        QuantParams quantParams = GetTensorQuantParams(this->m_inputTensor);
+    void AsrPreProcess::ComputeStreamingFeatures(const int16_t* audioData, const size_t audioDataLen)
+    {
+        const size_t numFeats  = this->m_numMfccFeats;
+        const size_t numFrames = this->m_numFeatureFrames;
+
+        /* Number of frames backed by audio data; the remaining ones are padding. */
+        size_t numAudioFrames = 0;
+        if (audioData && audioDataLen >= this->m_mfccWindowLen) {
+            numAudioFrames = std::min<size_t>(numFrames,
+                (audioDataLen - this->m_mfccWindowLen) / this->m_mfccWindowStride + 1);
+        }
 
-        if (0 == quantParams.scale) {
-            printf_err("Quantisation scale can't be 0\n");
-            return false;
+        /* Absolute index of the first frame in this window. Frames before it are dropped. */
+        const size_t firstFrame = this->m_streamOffset / this->m_mfccWindowStride;
+        if (this->m_ringEnd <= firstFrame) {
+            this->m_ringBegin = this->m_ringEnd = firstFrame;
+        } else {
+            this->m_ringBegin = std::max(this->m_ringBegin, firstFrame);
         }
 
-        switch(this->m_inputTensor->type) {
-            case kTfLiteUInt8:
-                return this->Quantise<uint8_t>(
-                        tflite::GetTensorData<uint8_t>(this->m_inputTensor), this->m_inputTensor->bytes,
-                        quantParams.scale, quantParams.offset);
-            case kTfLiteInt8:
-                return this->Quantise<int8_t>(
-                        tflite::GetTensorData<int8_t>(this->m_inputTensor), this->m_inputTensor->bytes,
-                        quantParams.scale, quantParams.offset);
-            default:
-                printf_err("Unsupported tensor type %s\n",
-                    TfLiteTypeGetName(this->m_inputTensor->type));
+        double mfccSum   = 0;
+        double mfccSumSq = 0;
+        this->m_numComputedFrames = 0;
+
+        /* MFCCs: only frames past the end of the ring are computed. */
+        for (size_t j = 0; j < numAudioFrames; ++j) {
+            const size_t frame = firstFrame + j;
+            const size_t slot = frame % numFrames;
+            float* mfcc = &this->m_ringMfcc[slot * numFeats];
+            float* sums = &this->m_ringSums[slot * kNumFrameSums];
+
+            if (frame >= this->m_ringEnd) {
+                this->m_mfcc.MfccCompute(audioData + j * this->m_mfccWindowStride,
+                                         this->m_mfccWindowLen, mfcc);
+                sums[kMfccSum] = 0;
+                sums[kMfccSumSq] = 0;
+                for (size_t i = 0; i < numFeats; ++i) {
+                    sums[kMfccSum] += mfcc[i];
+                    sums[kMfccSumSq] += mfcc[i] * mfcc[i];
+                }
+                this->m_ringDeltaValid[slot] = 0;
+                this->m_ringEnd = frame + 1;
+                ++this->m_numComputedFrames;
+            }
+
+            for (size_t i = 0; i < numFeats; ++i) {
+                this->m_mfccBuf(i, j) = mfcc[i];
+            }
+            mfccSum += sums[kMfccSum];
+            mfccSumSq += sums[kMfccSumSq];
         }
 
-        return false;
+        for (size_t j = numAudioFrames; j < numFrames; ++j) {
+            for (size_t i = 0; i < numFeats; ++i) {
+                this->m_mfccBuf(i, j) = this->m_padMfcc[i];
+            }
+            mfccSum += this->m_padSums[0];
+            mfccSumSq += this->m_padSums[1];
+        }
+
+        /* Deltas: edges stay zero as for ComputeDeltas. Deltas whose kernel spans audio
+         * frames only are kept in the ring; those touching padding are recomputed. */
+        std::fill(this->m_delta1Buf.begin(), this->m_delta1Buf.end(), 0.f);
+        std::fill(this->m_delta2Buf.begin(), this->m_delta2Buf.end(), 0.f);
+
+        double delta1Sum   = 0;
+        double delta1SumSq = 0;
+        double delta2Sum   = 0;
+        double delta2SumSq = 0;
+
+        for (size_t j = deltaMidIdx; j < numFrames - deltaMidIdx; ++j) {
+            const size_t slot = (firstFrame + j) % numFrames;
+            const bool cacheable = j + deltaMidIdx < numAudioFrames;
+
+            if (!cacheable || !this->m_ringDeltaValid[slot]) {
+                this->ComputeFrameDeltas(j, slot);
+                this->m_ringDeltaValid[slot] = cacheable;
+            }
+
+            const float* delta1 = &this->m_ringDelta1[slot * numFeats];
+            const float* delta2 = &this->m_ringDelta2[slot * numFeats];
+            for (size_t i = 0; i < numFeats; ++i) {
+                this->m_delta1Buf(i, j) = delta1[i];
+                this->m_delta2Buf(i, j) = delta2[i];
+            }
+
+            const float* sums = &this->m_ringSums[slot * kNumFrameSums];
+            delta1Sum += sums[kDelta1Sum];
+            delta1SumSq += sums[kDelta1SumSq];
+            delta2Sum += sums[kDelta2Sum];
+            delta2SumSq += sums[kDelta2SumSq];
+        }
+
+        /* Standardise using statistics accumulated from the per-frame sums, with the
+         * same estimator as StandardizeVecF32. */
+        const auto numElements = static_cast<uint32_t>(numFeats * numFrames);
+
+        AsrPreProcess::StandardizeVecF32(this->m_mfccBuf,
+            static_cast<float>(mfccSum / numElements),
+            math::MathUtils::StdDevFromSumsF32(mfccSum, mfccSumSq, numElements));
+        AsrPreProcess::StandardizeVecF32(this->m_delta1Buf,
+            static_cast<float>(delta1Sum / numElements),
+            math::MathUtils::StdDevFromSumsF32(delta1Sum, delta1SumSq, numElements));
+        AsrPreProcess::StandardizeVecF32(this->m_delta2Buf,
+            static_cast<float>(delta2Sum / numElements),
+            math::MathUtils::StdDevFromSumsF32(delta2Sum, delta2SumSq, numElements));
+    }
+
+    void AsrPreProcess::ComputeFrameDeltas(const size_t col, const size_t slot)
+    {
+        const size_t numFeats = this->m_numMfccFeats;
+        const size_t mfccStIdx = col - deltaMidIdx;
+        float* delta1 = &this->m_ringDelta1[slot * numFeats];
+        float* delta2 = &this->m_ringDelta2[slot * numFeats];
+        float* sums = &this->m_ringSums[slot * kNumFrameSums];
+
+        sums[kDelta1Sum] = sums[kDelta1SumSq] = 0;
+        sums[kDelta2Sum] = sums[kDelta2SumSq] = 0;
+
+        /* Same accumulation order as ComputeDeltas so that results match exactly. */
+        for (size_t i = 0; i < numFeats; ++i) {
+            float d1 = 0;
+            float d2 = 0;
+
+            for (size_t k = 0, m = deltaCoeffLen - 1; k < deltaCoeffLen; ++k, --m) {
+                d1 += this->m_mfccBuf(i, mfccStIdx + k) * delta1Coeffs[m];
+                d2 += this->m_mfccBuf(i, mfccStIdx + k) * delta2Coeffs[m];
+            }
+
+            delta1[i] = d1;
+            delta2[i] = d2;
+            sums[kDelta1Sum] += d1;
+            sums[kDelta1SumSq] += d1 * d1;
+            sums[kDelta2Sum] += d2;
+            sums[kDelta2SumSq] += d2 * d2;
+        }
     }
 
     bool AsrPreProcess::ComputeDeltas(Array2d<float>& mfcc,
                                       Array2d<float>& delta1,
                                       Array2d<float>& delta2)
     {
-        const std::vector <float> delta1Coeffs =
-            {6.66666667e-02,  5.00000000e-02,  3.33333333e-02,
-             1.66666667e-02, -3.46944695e-18, -1.66666667e-02,
-            -3.33333333e-02, -5.00000000e-02, -6.66666667e-02};
-
-        const std::vector <float> delta2Coeffs =
-            {0.06060606,      0.01515152,     -0.01731602,
-            -0.03679654,     -0.04329004,     -0.03679654,
-            -0.01731602,      0.01515152,      0.06060606};
-
         if (delta1.dimSize(0) == 0 || delta2.dimSize(0) != delta1.dimSize(0) ||
             mfcc.dimSize(0) == 0 || mfcc.dimSize(1) == 0) {
             return false;
         }
 
-        /* Get the middle index; coeff vec len should always be odd. */
-        const size_t coeffLen = delta1Coeffs.size();
-        const size_t fMidIdx = (coeffLen - 1)/2;
+        const size_t coeffLen = deltaCoeffLen;
+        const size_t fMidIdx = deltaMidIdx;
         const size_t numFeatures    = mfcc.dimSize(0);
         const size_t numFeatVectors = mfcc.dimSize(1);
 
@@ -171,7 +372,11 @@ namespace app {
     {
         auto mean   = math::MathUtils::MeanF32(vec.begin(), vec.totalSize());
         auto stddev = math::MathUtils::StdDevF32(vec.begin(), vec.totalSize(), mean);
+        AsrPreProcess::StandardizeVecF32(vec, mean, stddev);
+    }
 
+    void AsrPreProcess::StandardizeVecF32(Array2d<float>& vec, const float mean, const float stddev)
+    {
         debug("Mean: %f, Stddev: %f\n", mean, stddev);
         if (stddev == 0) {
             std::fill(vec.begin(), vec.end(), 0);
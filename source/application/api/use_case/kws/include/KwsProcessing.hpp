@@ -19,6 +19,7 @@
 
 #include "AudioUtils.hpp"
 #include "BaseProcessing.hpp"
+#include "DataStructures.hpp"
 #include "KwsClassifier.hpp"
 #include "MicroNetKwsMfcc.hpp"
 
@@ -57,6 +58,16 @@ namespace app {
          **/
         bool DoPreProcess(const void* input, size_t inferenceIndex = 0) override;
 
+        /**
+         * @brief       Sets the ring buffer that audio passed to DoPreProcess lives in. Windows
+         *              running past the end of the ring continue from its start, so they can be
+         *              read in place. The ring storage must be followed by (MFCC frame length - 1)
+         *              samples mirroring its start.
+         * @param[in]   ringStart   Pointer to the first sample of the ring.
+         * @param[in]   ringSize    Ring size in samples, 0 for contiguous input.
+         **/
+        void SetAudioRing(const int16_t* ringStart, size_t ringSize);
+
         size_t m_audioDataWindowSize;   /* Amount of audio needed for 1 inference. */
         size_t m_audioDataStride;       /* Amount of audio to stride across if doing >1 inference in longer clips. */
 
@@ -67,10 +78,10 @@ namespace app {
         const size_t m_numMfccFrames;   /* How many sets of m_numMfccFeats. */
 
         audio::MicroNetKwsMFCC m_mfcc;
-        audio::SlidingWindow<const int16_t> m_mfccSlidingWindow;
+        audio::WrappedSlidingWindow<const int16_t> m_mfccSlidingWindow;
         size_t m_numMfccVectorsInAudioStride;
         size_t m_numReusedMfccVectors;
-        std::function<void (std::vector<int16_t>&, int, bool, size_t)> m_mfccFeatureCalculator;
+        std::function<void (const int16_t*, size_t, bool, size_t)> m_mfccFeatureCalculator;
 
         /**
          * @brief Returns a function to perform feature calculation and populates input tensor data with
@@ -83,18 +94,20 @@ namespace app {
          *
          * @param[in]       mfcc          MFCC feature calculator.
          * @param[in,out]   inputTensor   Input tensor pointer to store calculated features.
-         * @param[in]       cacheSize     Size of the feature vectors cache (number of feature vectors).
-         * @return          Function to be called providing audio sample and sliding window index.
+         * @param[in]       cacheSize     Size of the feature vectors cache (number of feature vectors
+         *                                in one sliding window).
+         * @return          Function to be called providing a pointer to the audio window, the sliding
+         *                  window index, whether the cache can be used and the cache overlap index.
          */
-        std::function<void (std::vector<int16_t>&, int, bool, size_t)>
+        std::function<void (const int16_t*, size_t, bool, size_t)>
         GetFeatureCalculator(audio::MicroNetKwsMFCC&  mfcc,
                              TfLiteTensor*            inputTensor,
                              size_t                   cacheSize);
 
         template<class T>
-        std::function<void (std::vector<int16_t>&, size_t, bool, size_t)>
-        FeatureCalc(TfLiteTensor* inputTensor, size_t cacheSize,
-                    std::function<std::vector<T> (std::vector<int16_t>& )> compute);
+        std::function<void (const int16_t*, size_t, bool, size_t)>
+        FeatureCalc(TfLiteTensor* inputTensor, size_t cacheSize, size_t numFeatures,
+                    std::function<bool (const int16_t*, T*)> compute);
     };
 
     /**
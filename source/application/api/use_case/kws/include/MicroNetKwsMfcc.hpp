@@ -33,14 +33,23 @@ namespace audio {
         static constexpr uint32_t  ms_defaultMelHiFreq    =  4000;
         static constexpr bool      ms_defaultUseHtkMethod =  true;
 
-        explicit MicroNetKwsMFCC(const size_t numFeats, const size_t frameLen)
+        explicit MicroNetKwsMFCC(const size_t numFeats, const size_t frameLen,
+                                 const bool useFixedPoint = false)
             :  MFCC(MfccParams(
                         ms_defaultSamplingFreq, ms_defaultNumFbankBins,
                         ms_defaultMelLoFreq, ms_defaultMelHiFreq,
-                        numFeats, frameLen, ms_defaultUseHtkMethod))
+                        numFeats, frameLen, ms_defaultUseHtkMethod,
+                        useFixedPoint))
         {}
         MicroNetKwsMFCC()  = delete;
         ~MicroNetKwsMFCC() = default;
+
+    protected:
+        /* Uses the tables generated for the default MFCC front end. */
+        FrontEndKind GetFrontEndKind() const override
+        {
+            return FrontEndKind::Mfcc;
+        }
     };
 
 } /* namespace audio */
@@ -18,6 +18,8 @@
 #include "log_macros.h"
 #include "MicroNetKwsModel.hpp"
 
+#include <algorithm>
+
 namespace arm {
 namespace app {
 
@@ -37,7 +39,7 @@ namespace app {
                 (this->m_mfccFrameLength - this->m_mfccFrameStride);
 
         /* Creating an MFCC feature sliding window for the data required for 1 inference. */
-        this->m_mfccSlidingWindow = audio::SlidingWindow<const int16_t>(nullptr, this->m_audioDataWindowSize,
+        this->m_mfccSlidingWindow = audio::WrappedSlidingWindow<const int16_t>(nullptr, this->m_audioDataWindowSize,
                 this->m_mfccFrameLength, this->m_mfccFrameStride);
 
         /* For longer audio clips we choose to move by half the audio window size
@@ -59,7 +61,7 @@ namespace app {
 
         /* Construct feature calculation function. */
         this->m_mfccFeatureCalculator = GetFeatureCalculator(this->m_mfcc, this->m_inputTensor,
-                                                             this->m_numReusedMfccVectors);
+                                                             this->m_mfccSlidingWindow.TotalStrides() + 1);
 
         if (!this->m_mfccFeatureCalculator) {
             printf_err("Feature calculator not initialized.");
@@ -83,11 +85,8 @@ namespace app {
         while (this->m_mfccSlidingWindow.HasNext()) {
             const int16_t* mfccWindow = this->m_mfccSlidingWindow.Next();
 
-            std::vector<int16_t> mfccFrameAudioData = std::vector<int16_t>(mfccWindow,
-                    mfccWindow + this->m_mfccFrameLength);
-
             /* Compute features for this window and write them to input tensor. */
-            this->m_mfccFeatureCalculator(mfccFrameAudioData, this->m_mfccSlidingWindow.Index(),
+            this->m_mfccFeatureCalculator(mfccWindow, this->m_mfccSlidingWindow.Index(),
                                           useCache, this->m_numMfccVectorsInAudioStride);
         }
 
@@ -96,70 +95,86 @@ namespace app {
         return true;
     }
 
+    void KwsPreProcess::SetAudioRing(const int16_t* ringStart, const size_t ringSize)
+    {
+        this->m_mfccSlidingWindow.SetWrapRegion(ringStart, ringSize);
+    }
+
     /**
      * @brief Generic feature calculator factory.
      *
      * Returns lambda function to compute features using features cache.
      * Real features math is done by a lambda function provided as a parameter.
-     * Features are written to input tensor memory.
+     * Features are written straight to input tensor memory.
      *
      * @tparam T                Feature vector type.
      * @param[in] inputTensor   Model input tensor pointer.
-     * @param[in] cacheSize     Number of feature vectors to cache. Defined by the sliding window overlap.
+     * @param[in] cacheSize     Number of feature vectors to cache. Defined by the number of
+     *                          feature vectors in one sliding window.
+     * @param[in] numFeatures   Number of features in one feature vector.
      * @param[in] compute       Features calculator function.
      * @return                  Lambda function to compute features.
      */
     template<class T>
-    std::function<void (std::vector<int16_t>&, size_t, bool, size_t)>
-    KwsPreProcess::FeatureCalc(TfLiteTensor* inputTensor, size_t cacheSize,
-                               std::function<std::vector<T> (std::vector<int16_t>& )> compute)
+    std::function<void (const int16_t*, size_t, bool, size_t)>
+    KwsPreProcess::FeatureCalc(TfLiteTensor* inputTensor, size_t cacheSize, size_t numFeatures,
+                               std::function<bool (const int16_t*, T*)> compute)
     {
-        /* Feature cache to be captured by lambda function. */
-        static std::vector<std::vector<T>> featureCache = std::vector<std::vector<T>>(cacheSize);
+        /* Feature cache owned by the returned function object, allocated once. */
+        FeatureRing<T> featureCache(cacheSize, numFeatures);
 
-        return [=](std::vector<int16_t>& audioDataWindow,
+        return [=](const int16_t* audioDataWindow,
                    size_t index,
                    bool useCache,
-                   size_t featuresOverlapIndex)
+                   size_t featuresOverlapIndex) mutable
         {
-            T* tensorData = tflite::GetTensorData<T>(inputTensor);
-            std::vector<T> features;
+            /* On a new window, drop the features that are not overlapping anymore.
+             * The remaining ones are now at the beginning of the cache. */
+            if (0 == index) {
+                if (useCache) {
+                    featureCache.Advance(featuresOverlapIndex);
+                } else {
+                    featureCache.Reset();
+                }
+            }
+
+            T* features = tflite::GetTensorData<T>(inputTensor) + (index * numFeatures);
 
-            /* Reuse features from cache if cache is ready and sliding windows overlap.
-             * Overlap is in the beginning of sliding window with a size of a feature cache. */
-            if (useCache && index < featureCache.size()) {
-                features = std::move(featureCache[index]);
+            /* Reuse features from cache if computed for the previous window. */
+            if (featureCache.IsValid(index)) {
+                const T* cached = featureCache.Row(index);
+                std::copy(cached, cached + numFeatures, features);
             } else {
-                features = std::move(compute(audioDataWindow));
-            }
-            auto size = features.size();
-            auto sizeBytes = sizeof(T) * size;
-            std::memcpy(tensorData + (index * size), features.data(), sizeBytes);
+                compute(audioDataWindow, features);
 
-            /* Start renewing cache as soon iteration goes out of the windows overlap. */
-            if (index >= featuresOverlapIndex) {
-                featureCache[index - featuresOverlapIndex] = std::move(features);
+                T* cacheRow = featureCache.Row(index);
+                if (cacheRow) {
+                    std::copy(features, features + numFeatures, cacheRow);
+                    featureCache.Commit(index);
+                }
             }
         };
     }
 
-    template std::function<void (std::vector<int16_t>&, size_t , bool, size_t)>
+    template std::function<void (const int16_t*, size_t, bool, size_t)>
     KwsPreProcess::FeatureCalc<int8_t>(TfLiteTensor* inputTensor,
-                                       size_t cacheSize,
-                                       std::function<std::vector<int8_t> (std::vector<int16_t>&)> compute);
+                                       size_t cacheSize, size_t numFeatures,
+                                       std::function<bool (const int16_t*, int8_t*)> compute);
 
-    template std::function<void(std::vector<int16_t>&, size_t, bool, size_t)>
+    template std::function<void (const int16_t*, size_t, bool, size_t)>
     KwsPreProcess::FeatureCalc<float>(TfLiteTensor* inputTensor,
-                                      size_t cacheSize,
-                                      std::function<std::vector<float>(std::vector<int16_t>&)> compute);
+                                      size_t cacheSize, size_t numFeatures,
+                                      std::function<bool (const int16_t*, float*)> compute);
 
 
-    std::function<void (std::vector<int16_t>&, int, bool, size_t)>
+    std::function<void (const int16_t*, size_t, bool, size_t)>
     KwsPreProcess::GetFeatureCalculator(audio::MicroNetKwsMFCC& mfcc, TfLiteTensor* inputTensor, size_t cacheSize)
     {
-        std::function<void (std::vector<int16_t>&, size_t, bool, size_t)> mfccFeatureCalc = nullptr;
+        std::function<void (const int16_t*, size_t, bool, size_t)> mfccFeatureCalc = nullptr;
 
         TfLiteQuantization quant = inputTensor->quantization;
+        const size_t frameLen = this->m_mfccFrameLength;
+        const size_t numFeatures = mfcc.GetNumMfccFeatures();
 
         if (kTfLiteAffineQuantization == quant.type) {
             auto* quantParams = (TfLiteAffineQuantization*) quant.params;
@@ -169,9 +184,11 @@ namespace app {
             switch (inputTensor->type) {
                 case kTfLiteInt8: {
                     mfccFeatureCalc = this->FeatureCalc<int8_t>(inputTensor,
-                                                          cacheSize,
-                                                          [=, &mfcc](std::vector<int16_t>& audioDataWindow) {
+                                                          cacheSize, numFeatures,
+                                                          [=, &mfcc](const int16_t* audioDataWindow, int8_t* out) {
                                                               return mfcc.MfccComputeQuant<int8_t>(audioDataWindow,
+                                                                                                   frameLen,
+                                                                                                   out,
                                                                                                    quantScale,
                                                                                                    quantOffset);
                                                           }
@@ -182,9 +199,9 @@ namespace app {
                 printf_err("Tensor type %s not supported\n", TfLiteTypeGetName(inputTensor->type));
             }
         } else {
-            mfccFeatureCalc = this->FeatureCalc<float>(inputTensor, cacheSize,
-                    [&mfcc](std::vector<int16_t>& audioDataWindow) {
-                return mfcc.MfccCompute(audioDataWindow); }
+            mfccFeatureCalc = this->FeatureCalc<float>(inputTensor, cacheSize, numFeatures,
+                    [=, &mfcc](const int16_t* audioDataWindow, float* out) {
+                return mfcc.MfccCompute(audioDataWindow, frameLen, out); }
                 );
         }
         return mfccFeatureCalc;
@@ -33,22 +33,16 @@ namespace rnn {
     using math::FftInstance;
     using math::FftType;
 
-    class FrameFeatures {
-    public:
-        bool m_silence{false};        /* If frame contains silence or not. */
-        vec1D32F m_featuresVec{};     /* Calculated feature vector to feed to model. */
-        vec1D32F m_fftX{};            /* Vector of floats arranged to represent complex numbers. */
-        vec1D32F m_fftP{};            /* Vector of floats arranged to represent complex numbers. */
-        vec1D32F m_Ex{};              /* Spectral band energy for audio x. */
-        vec1D32F m_Ep{};              /* Spectral band energy for pitch p. */
-        vec1D32F m_Exp{};             /* Correlated spectral energy between x and p. */
-    };
+    class FrameFeatures;
 
     /**
      * @brief   RNNoise pre and post processing class based on the 2018 paper from
      *          Jan-Marc Valin. Recommended reading:
      *          - https://jmvalin.ca/demo/rnnoise/
      *          - https://arxiv.org/abs/1709.08243
+     *
+     *          All buffers are sized at compile time and held by the instance (or
+     *          by FrameFeatures), so processing a frame does not use the heap.
      **/
     class RNNoiseFeatureProcessor {
     /* Public interface */
@@ -61,7 +55,8 @@ namespace rnn {
          * @param[in]    audioData   Pointer to the floating point vector
          *                           with audio data (within the numerical
          *                           limits of int16_t type).
-         * @param[in]    audioLen    Number of elements in the audio window.
+         * @param[in]    audioLen    Number of elements in the audio window,
+         *                           at least FRAME_SIZE.
          * @param[out]   features    FrameFeatures object reference.
          **/
         void PreprocessFrame(const float*   audioData,
@@ -71,9 +66,9 @@ namespace rnn {
         /**
          * @brief        Use the RNNoise model output gain values with pre-processing features
          *               to generate audio with noise suppressed.
-         * @param[in]    modelOutput   Output gain values from model.
+         * @param[in]    modelOutput   Output gain values from model, at least NB_BANDS.
          * @param[in]    features      Calculated features from pre-processing step.
-         * @param[out]   outFrame      Output frame to be populated.
+         * @param[out]   outFrame      Output frame to be populated, at least FRAME_SIZE.
          **/
         void PostProcessFrame(vec1D32F& modelOutput, FrameFeatures& features,  vec1D32F& outFrame);
 
@@ -96,139 +91,165 @@ namespace rnn {
 
         static constexpr uint32_t NB_FEATURES{NB_BANDS + 3*NB_DELTA_CEPS + 2};
 
+    /* Public types */
+    public:
+        using arrBands = std::array<float, NB_BANDS>;           /* One value per band. */
+        using arrFeatures = std::array<float, NB_FEATURES>;     /* Model input features. */
+        using arrSpectrum = std::array<float, 2 * FREQ_SIZE>;   /* Interleaved complex spectrum. */
+
+    /* Private constants */
+    private:
+        /* Longest pitch period searched for, and sizes of the pitch search buffers. */
+        static constexpr uint32_t PITCH_SEARCH_MAX{PITCH_MAX_PERIOD - 3 * PITCH_MIN_PERIOD};
+        static constexpr uint32_t PITCH_BUF_DOWN_SIZE{PITCH_BUF_SIZE >> 1};
+        static constexpr uint32_t PITCH_X_LP4_SIZE{PITCH_FRAME_SIZE >> 2};
+        static constexpr uint32_t PITCH_Y_LP4_SIZE{(PITCH_FRAME_SIZE + PITCH_SEARCH_MAX) >> 2};
+        static constexpr uint32_t PITCH_XCORR_SIZE{PITCH_SEARCH_MAX >> 1};
+        static constexpr uint32_t PITCH_YY_SIZE{(PITCH_MAX_PERIOD >> 1) + 1};
+        static constexpr uint32_t LPC_ORDER{4};
+
+        using arrWindow = std::array<float, WINDOW_SIZE>;
+        using arrFreq = std::array<float, FREQ_SIZE>;
+
     /* Private functions */
     private:
 
         /**
-         * @brief   Initialises the half window and DCT tables.
+         * @brief   Initialises the half window and DCT tables, from the tables
+         *          generated at build time if there are any.
          */
         void InitTables();
 
         /**
-         * @brief           Applies a bi-quadratic filter over the audio window.
+         * @brief           Applies a bi-quadratic filter over the audio, keeping the
+         *                  first FRAME_SIZE filtered samples.
          * @param[in]       bHp           Constant coefficient set b (arrHp type).
          * @param[in]       aHp           Constant coefficient set a (arrHp type).
          * @param[in,out]   memHpX        Coefficients populated by this function.
-         * @param[in,out]   audioWindow   Floating point vector with audio data.
+         * @param[in]       audioData     Floating point audio data.
+         * @param[in]       audioLen      Number of audio samples.
+         * @param[out]      audioWindow   Filtered audio frame.
          **/
         void BiQuad(
             const arrHp& bHp,
             const arrHp& aHp,
             arrHp& memHpX,
-            vec1D32F& audioWindow);
+            const float* audioData,
+            size_t audioLen,
+            float* audioWindow);
 
         /**
          * @brief        Computes features from the "filtered" audio window.
-         * @param[in]    audioWindow   Floating point vector with audio data.
+         * @param[in]    audioWindow   FRAME_SIZE filtered audio samples.
          * @param[out]   features      FrameFeatures object reference.
          **/
-        void ComputeFrameFeatures(vec1D32F& audioWindow, FrameFeatures& features);
+        void ComputeFrameFeatures(const float* audioWindow, FrameFeatures& features);
 
         /**
          * @brief        Runs analysis on the audio buffer.
-         * @param[in]    audioWindow   Floating point vector with audio data.
+         * @param[in]    audioWindow   FRAME_SIZE filtered audio samples.
          * @param[out]   fft           Floating point FFT vector containing real and
          *                             imaginary pairs of elements. NOTE: this vector
          *                             does not contain the mirror image (conjugates)
          *                             part of the spectrum.
          * @param[out]   energy        Computed energy for each band in the Bark scale.
-         * @param[out]   analysisMem   Buffer sequentially, but partially,
+         * @param[in,out] analysisMem  Buffer sequentially, but partially,
          *                             populated with new audio data.
          **/
         void FrameAnalysis(
-            const vec1D32F& audioWindow,
-            vec1D32F& fft,
-            vec1D32F& energy,
-            vec1D32F& analysisMem);
+            const float* audioWindow,
+            arrSpectrum& fft,
+            arrBands& energy,
+            std::array<float, FRAME_SIZE>& analysisMem);
 
         /**
          * @brief               Applies the window function, in-place, over the given
          *                      floating point buffer.
          * @param[in,out]   x   Buffer the window will be applied to.
          **/
-        void ApplyWindow(vec1D32F& x);
+        void ApplyWindow(arrWindow& x);
 
         /**
          * @brief        Computes the FFT for a given vector.
-         * @param[in]    x     Vector to compute the FFT from.
+         * @param[in]    x     Vector to compute the FFT from; modified.
          * @param[out]   fft   Floating point FFT vector containing real and
          *                     imaginary pairs of elements. NOTE: this vector
          *                     does not contain the mirror image (conjugates)
          *                     part of the spectrum.
          **/
         void ForwardTransform(
-            vec1D32F& x,
-            vec1D32F& fft);
+            arrWindow& x,
+            arrSpectrum& fft);
 
         /**
          * @brief        Computes band energy for each of the 22 Bark scale bands.
          * @param[in]    fft_X   FFT spectrum (as computed by ForwardTransform).
-         * @param[out]   bandE   Vector with 22 elements populated with energy for
+         * @param[out]   bandE   Array with 22 elements populated with energy for
          *                       each band.
          **/
-        void ComputeBandEnergy(const vec1D32F& fft_X, vec1D32F& bandE);
+        void ComputeBandEnergy(const arrSpectrum& fft_X, arrBands& bandE);
 
         /**
          * @brief        Computes band energy correlation.
          * @param[in]    X       FFT vector X.
          * @param[in]    P       FFT vector P.
-         * @param[out]   bandC   Vector with 22 elements populated with band energy
+         * @param[out]   bandC   Array with 22 elements populated with band energy
          *                       correlation for the two input FFT vectors.
          **/
-        void ComputeBandCorr(const vec1D32F& X, const vec1D32F& P, vec1D32F& bandC);
+        void ComputeBandCorr(const arrSpectrum& X, const arrSpectrum& P, arrBands& bandC);
 
         /**
          * @brief        Performs pitch auto-correlation for a given vector for
          *               given lag.
          * @param[in]    x     Input vector.
-         * @param[out]   ac    Auto-correlation output vector.
+         * @param[out]   ac    Auto-correlation output, lag + 1 elements.
          * @param[in]    lag   Lag value.
          * @param[in]    n     Number of elements to consider for correlation
          *                     computation.
          **/
-        void AutoCorr(const vec1D32F &x,
-                     vec1D32F &ac,
+        void AutoCorr(const float* x,
+                     float* ac,
                      size_t lag,
                      size_t n);
 
         /**
          * @brief       Computes pitch cross-correlation.
-         * @param[in]   x          Input vector 1.
-         * @param[in]   y          Input vector 2.
-         * @param[out]  xCorr         Cross-correlation output vector.
+         * @param[in]   x          Input vector 1, len elements.
+         * @param[in]   y          Input vector 2, len + maxPitch - 1 elements.
+         * @param[out]  xCorr      Cross-correlation output, maxPitch elements.
          * @param[in]   len        Number of elements to consider for correlation.
          *                         computation.
          * @param[in]   maxPitch   Maximum pitch.
          **/
         void PitchXCorr(
-            const vec1D32F& x,
-            const vec1D32F& y,
-            vec1D32F& xCorr,
+            const float* x,
+            const float* y,
+            float* xCorr,
             size_t len,
             size_t maxPitch);
 
         /**
          * @brief        Computes "Linear Predictor Coefficients".
-         * @param[in]    ac    Correlation vector.
-         * @param[in]    p     Number of elements of input vector to consider.
-         * @param[out]   lpc   Output coefficients vector.
+         * @param[in]    ac    Correlation vector, p + 1 elements.
+         * @param[in]    p     Number of coefficients.
+         * @param[out]   lpc   Output coefficients, p elements.
          **/
-        void LPC(const vec1D32F& ac, int32_t p, vec1D32F& lpc);
+        void LPC(const float* ac, int32_t p, float* lpc);
 
         /**
          * @brief        Custom FIR implementation.
-         * @param[in]    num   FIR coefficient vector.
+         * @param[in]    num   5 FIR coefficients.
          * @param[in]    N     Number of elements.
-         * @param[out]   x     Vector to be be processed.
+         * @param[out]   x     Buffer to be be processed.
          **/
-        void Fir5(const vec1D32F& num, uint32_t N, vec1D32F& x);
+        void Fir5(const float* num, uint32_t N, float* x);
 
         /**
          * @brief           Down-sample the pitch buffer.
-         * @param[in,out]   pitchBuf     Pitch buffer.
+         * @param[out]      pitchBuf     Down-sampled pitch buffer.
          * @param[in]       pitchBufSz   Buffer size.
          **/
-        void PitchDownsample(vec1D32F& pitchBuf, size_t pitchBufSz);
+        void PitchDownsample(float* pitchBuf, size_t pitchBufSz);
 
         /**
          * @brief       Pitch search function.
@@ -238,7 +259,7 @@ namespace rnn {
          * @param[in]   maxPitch   Maximum pitch.
          * @return      pitch index.
          **/
-        int PitchSearch(vec1D32F& xLp, vec1D32F& y, uint32_t len, uint32_t maxPitch);
+        int PitchSearch(const float* xLp, const float* y, uint32_t len, uint32_t maxPitch);
 
         /**
          * @brief       Finds the "best" pitch from the buffer.
@@ -248,11 +269,11 @@ namespace rnn {
          * @param[in]   maxPitch   Maximum pitch.
          * @return      pitch array (2 elements).
          **/
-        arrHp FindBestPitch(vec1D32F& xCorr, vec1D32F& y, uint32_t len, uint32_t maxPitch);
+        arrHp FindBestPitch(const float* xCorr, const float* y, uint32_t len, uint32_t maxPitch);
 
         /**
          * @brief           Remove pitch period doubling errors.
-         * @param[in,out]   pitchBuf     Pitch buffer vector.
+         * @param[in]       pitchBuf     Pitch buffer.
          * @param[in]       maxPeriod    Maximum period.
          * @param[in]       minPeriod    Minimum period.
          * @param[in]       frameSize    Frame size.
@@ -260,7 +281,7 @@ namespace rnn {
          * @return          pitch index.
          **/
         int RemoveDoubling(
-                vec1D32F& pitchBuf,
+                const float* pitchBuf,
                 uint32_t maxPeriod,
                 uint32_t minPeriod,
                 uint32_t frameSize,
@@ -277,55 +298,69 @@ namespace rnn {
 
         /**
          * @brief        Computes DCT vector from the given input.
-         * @param[in]    input    Input vector.
-         * @param[out]   output   Output vector with DCT coefficients.
+         * @param[in]    input    NB_BANDS input values.
+         * @param[out]   output   Output with NB_BANDS DCT coefficients.
          **/
-        void DCT(vec1D32F& input, vec1D32F& output);
+        void DCT(const float* input, float* output);
 
         /**
          * @brief        Perform inverse fourier transform on complex spectral vector.
          * @param[out]   out      Output vector.
          * @param[in]    fftXIn   Vector of floats arranged to represent complex numbers interleaved.
          **/
-        void InverseTransform(vec1D32F& out, vec1D32F& fftXIn);
+        void InverseTransform(arrWindow& out, const arrSpectrum& fftXIn);
 
         /**
          * @brief       Perform pitch filtering.
          * @param[in]   features   Object with pre-processing calculated frame features.
          * @param[in]   g          Gain values.
          **/
-        void PitchFilter(FrameFeatures& features, vec1D32F& g);
+        void PitchFilter(FrameFeatures& features, const arrBands& g);
 
         /**
          * @brief        Interpolate the band gain values.
          * @param[out]   g       Gain values.
-         * @param[in]    bandE   Vector with 22 elements populated with energy for
+         * @param[in]    bandE   Array with 22 elements populated with energy for
          *                       each band.
          **/
-        void InterpBandGain(vec1D32F& g, vec1D32F& bandE);
+        void InterpBandGain(arrFreq& g, const arrBands& bandE);
 
         /**
          * @brief        Create de-noised frame.
-         * @param[out]   outFrame   Output vector for storing the created audio frame.
+         * @param[out]   outFrame   Output buffer for storing the created audio frame.
          * @param[in]    fftY       Gain adjusted complex spectral vector.
          */
-        void FrameSynthesis(vec1D32F& outFrame, vec1D32F& fftY);
+        void FrameSynthesis(float* outFrame, const arrSpectrum& fftY);
 
     /* Private objects */
     private:
         FftInstance m_fftInstReal;  /* FFT instance for real numbers */
         FftInstance m_fftInstCmplx; /* FFT instance for complex numbers */
-        vec1D32F m_halfWindow;      /* Window coefficients */
-        vec1D32F m_dctTable;        /* DCT table */
-        vec1D32F m_analysisMem;     /* Buffer used for frame analysis */
-        vec2D32F m_cepstralMem;     /* Cepstral coefficients */
+        vec1D32F m_halfWindow;      /* Window coefficients, if built at run time */
+        vec1D32F m_dctTable;        /* DCT table, if built at run time */
+        const float* m_halfWindowData{nullptr};   /* Window coefficients in use */
+        const float* m_dctTableData{nullptr};     /* DCT table in use */
+        std::array<float, FRAME_SIZE> m_analysisMem{};          /* Buffer used for frame analysis */
+        std::array<arrBands, CEPS_MEM> m_cepstralMem{};         /* Cepstral coefficients */
         size_t m_memId;             /* memory ID */
-        vec1D32F m_synthesisMem;    /* Synthesis mem (used by post-processing) */
-        vec1D32F m_pitchBuf;        /* Pitch buffer */
+        std::array<float, FRAME_SIZE> m_synthesisMem{};         /* Synthesis mem (used by post-processing) */
+        std::array<float, PITCH_BUF_SIZE> m_pitchBuf{};         /* Pitch buffer */
         float m_lastGain;           /* Last gain calculated */
         int m_lastPeriod;           /* Last period calculated */
         arrHp m_memHpX;             /* HpX coefficients. */
-        vec1D32F m_lastGVec;        /* Last gain vector (used by post-processing) */
+        arrBands m_lastGVec{};      /* Last gain vector (used by post-processing) */
+
+        /* Scratch buffers, reused by every frame. */
+        std::array<float, FRAME_SIZE> m_audioWindow{};          /* Filtered audio frame */
+        arrWindow m_window{};                                   /* Windowed frame, time domain */
+        std::array<float, PITCH_BUF_DOWN_SIZE> m_pitchBufDown{};    /* Down-sampled pitch buffer */
+        std::array<float, PITCH_X_LP4_SIZE> m_xLp4{};           /* Pitch search input, 4x decimated */
+        std::array<float, PITCH_Y_LP4_SIZE> m_yLp4{};           /* Pitch buffer, 4x decimated */
+        std::array<float, PITCH_XCORR_SIZE> m_xCorr{};          /* Pitch cross-correlation */
+        std::array<float, PITCH_YY_SIZE> m_yyLookup{};          /* Pitch buffer energies */
+        arrFreq m_gain{};           /* Interpolated gains; only bands' bins are written */
+        std::array<float, 2 * WINDOW_SIZE> m_ifftIn{};          /* Full complex spectrum */
+        std::array<float, 2 * WINDOW_SIZE> m_ifftOut{};         /* Inverse transform output */
 
         /* Constants */
         const std::array <uint32_t, NB_BANDS> m_eband5ms {
@@ -333,6 +368,17 @@ namespace rnn {
             14, 16, 20, 24, 28, 34, 40, 48, 60, 78, 100};
     };
 
+    class FrameFeatures {
+    public:
+        bool m_silence{false};                                  /* If frame contains silence or not. */
+        RNNoiseFeatureProcessor::arrFeatures m_featuresVec{};   /* Calculated feature vector to feed to model. */
+        RNNoiseFeatureProcessor::arrSpectrum m_fftX{};          /* Vector of floats arranged to represent complex numbers. */
+        RNNoiseFeatureProcessor::arrSpectrum m_fftP{};          /* Vector of floats arranged to represent complex numbers. */
+        RNNoiseFeatureProcessor::arrBands m_Ex{};               /* Spectral band energy for audio x. */
+        RNNoiseFeatureProcessor::arrBands m_Ep{};               /* Spectral band energy for pitch p. */
+        RNNoiseFeatureProcessor::arrBands m_Exp{};              /* Correlated spectral energy between x and p. */
+    };
+
 
 } /* namespace rnn */
 } /* namespace app */
@@ -47,6 +47,8 @@ namespace app {
         /**
         * @brief Copy current GRU output states to input states.
         * Call this method before starting processing the next sequence of logically related data.
+        * States are copied directly when no input state overlaps an output state in the tensor
+        * arena, otherwise they are staged through a scratch buffer allocated on the first call.
          */
         bool CopyGruStates();
 
@@ -66,6 +68,24 @@ namespace app {
         */
         const std::vector<std::pair<size_t, size_t>> m_gruStateMap = {{0,3}, {2, 2}, {3, 1}};
     private:
+        /* GRU state output to copy to an input, resolved from m_gruStateMap. */
+        struct GruStateBinding {
+            const int8_t*   src{nullptr};   /* Output state data. */
+            int8_t*         dst{nullptr};   /* Input state data. */
+            size_t          bytes{0};       /* State size. */
+        };
+
+        /**
+         * @brief   Resolves the GRU state tensors and sizes the scratch buffer if any
+         *          input state overlaps an output state.
+         * @return  true if the input and output states match in size, false otherwise.
+         */
+        bool BindGruStates();
+
+        std::vector<GruStateBinding> m_gruStateBindings{};  /* One per m_gruStateMap entry. */
+        std::vector<int8_t> m_gruStateScratch{};             /* Staging buffer for overlapping states. */
+        bool m_gruStatesOverlap{false};                      /* Whether states go through the scratch. */
+
         /* Maximum number of individual operations that can be enlisted. */
         static constexpr int ms_maxOpCnt = 15;
 
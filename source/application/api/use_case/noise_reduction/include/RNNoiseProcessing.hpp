@@ -60,12 +60,12 @@ namespace app {
 
         /**
          * @brief            Quantize the given features and populate the input Tensor.
-         * @param[in]        inputFeatures   Vector of floating point features to quantize.
+         * @param[in]        inputFeatures   Floating point features to quantize.
          * @param[in]        quantScale      Quantization scale for the inputTensor.
          * @param[in]        quantOffset     Quantization offset for the inputTensor.
          * @param[in,out]    inputTensor     TFLite micro tensor to populate.
          **/
-        static void QuantizeAndPopulateInput(rnn::vec1D32F& inputFeatures,
+        static void QuantizeAndPopulateInput(const rnn::RNNoiseFeatureProcessor::arrFeatures& inputFeatures,
                 float quantScale, int quantOffset,
                 TfLiteTensor* inputTensor);
     };
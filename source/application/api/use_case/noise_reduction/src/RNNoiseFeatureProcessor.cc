@@ -15,6 +15,7 @@
  * limitations under the License.
  */
 #include "RNNoiseFeatureProcessor.hpp"
+#include "DspTables.hpp"
 #include "log_macros.h"
 
 #include <algorithm>
@@ -34,17 +35,10 @@ do {                                                \
 } while(0)
 
 RNNoiseFeatureProcessor::RNNoiseFeatureProcessor() :
-        m_halfWindow(FRAME_SIZE, 0),
-        m_dctTable(NB_BANDS * NB_BANDS),
-        m_analysisMem(FRAME_SIZE, 0),
-        m_cepstralMem(CEPS_MEM, vec1D32F(NB_BANDS, 0)),
         m_memId{0},
-        m_synthesisMem(FRAME_SIZE, 0),
-        m_pitchBuf(PITCH_BUF_SIZE, 0),
         m_lastGain{0.0},
         m_lastPeriod{0},
-        m_memHpX{},
-        m_lastGVec(NB_BANDS, 0)
+        m_memHpX{}
 {
     constexpr uint32_t numFFt = 2 * FRAME_SIZE;
     static_assert(numFFt != 0, "Num FFT can't be 0");
@@ -62,16 +56,18 @@ void RNNoiseFeatureProcessor::PreprocessFrame(const float*   audioData,
     const arrHp aHp {-1.99599, 0.99600 };
     const arrHp bHp {-2.00000, 1.00000 };
 
-    vec1D32F audioWindow{audioData, audioData + audioLen};
+    VERIFY(audioData != nullptr && audioLen >= FRAME_SIZE);
 
-    this->BiQuad(bHp, aHp, this->m_memHpX, audioWindow);
-    this->ComputeFrameFeatures(audioWindow, features);
+    this->BiQuad(bHp, aHp, this->m_memHpX, audioData, audioLen, this->m_audioWindow.data());
+    this->ComputeFrameFeatures(this->m_audioWindow.data(), features);
 }
 
 void RNNoiseFeatureProcessor::PostProcessFrame(vec1D32F& modelOutput, FrameFeatures& features, vec1D32F& outFrame)
 {
-    std::vector<float> outputBands = modelOutput;
-    std::vector<float> gain(FREQ_SIZE, 0);
+    VERIFY(modelOutput.size() >= NB_BANDS && outFrame.size() >= FRAME_SIZE);
+
+    arrBands outputBands;
+    std::copy_n(modelOutput.begin(), NB_BANDS, outputBands.begin());
 
     if (!features.m_silence) {
         PitchFilter(features, outputBands);
@@ -80,20 +76,31 @@ void RNNoiseFeatureProcessor::PostProcessFrame(vec1D32F& modelOutput, FrameFeatu
             outputBands[i] = std::max(outputBands[i], alpha * m_lastGVec[i]);
             m_lastGVec[i] = outputBands[i];
         }
-        InterpBandGain(gain, outputBands);
+        InterpBandGain(this->m_gain, outputBands);
         for (size_t i = 0; i < FREQ_SIZE; i++) {
-            features.m_fftX[2 * i] *= gain[i];  /* Real. */
-            features.m_fftX[2 * i + 1] *= gain[i];  /*imaginary. */
+            features.m_fftX[2 * i] *= this->m_gain[i];  /* Real. */
+            features.m_fftX[2 * i + 1] *= this->m_gain[i];  /*imaginary. */
 
         }
 
     }
 
-    FrameSynthesis(outFrame, features.m_fftX);
+    FrameSynthesis(outFrame.data(), features.m_fftX);
 }
 
 void RNNoiseFeatureProcessor::InitTables()
 {
+    const audio::RNNoiseTables* tables = audio::FindRNNoiseTables(FRAME_SIZE, NB_BANDS);
+    if (tables) {
+        /* Tables generated at build time, in read-only memory. */
+        this->m_halfWindowData = tables->halfWindow;
+        this->m_dctTableData = tables->dctTable;
+        return;
+    }
+
+    m_halfWindow.assign(FRAME_SIZE, 0);
+    m_dctTable.assign(NB_BANDS * NB_BANDS, 0);
+
     constexpr float pi = M_PI;
     constexpr float halfPi = M_PI / 2;
     constexpr float halfPiOverFrameSz = halfPi/FRAME_SIZE;
@@ -109,24 +116,32 @@ void RNNoiseFeatureProcessor::InitTables()
         }
         m_dctTable[i * NB_BANDS] *= math::MathUtils::SqrtF32(0.5f);
     }
+
+    this->m_halfWindowData = m_halfWindow.data();
+    this->m_dctTableData = m_dctTable.data();
 }
 
 void RNNoiseFeatureProcessor::BiQuad(
         const arrHp& bHp,
         const arrHp& aHp,
         arrHp& memHpX,
-        vec1D32F& audioWindow)
+        const float* audioData,
+        const size_t audioLen,
+        float* audioWindow)
 {
-    for (float& audioElement : audioWindow) {
-        const auto xi = audioElement;
-        const auto yi = audioElement + memHpX[0];
+    /* The filter state follows all of the audio; only the frame is kept. */
+    for (size_t i = 0; i < audioLen; ++i) {
+        const auto xi = audioData[i];
+        const auto yi = audioData[i] + memHpX[0];
         memHpX[0] = memHpX[1] + (bHp[0] * xi - aHp[0] * yi);
         memHpX[1] = (bHp[1] * xi - aHp[1] * yi);
-        audioElement = yi;
+        if (i < FRAME_SIZE) {
+            audioWindow[i] = yi;
+        }
     }
 }
 
-void RNNoiseFeatureProcessor::ComputeFrameFeatures(vec1D32F& audioWindow,
+void RNNoiseFeatureProcessor::ComputeFrameFeatures(const float* audioWindow,
                                                    FrameFeatures& features)
 {
     this->FrameAnalysis(audioWindow,
@@ -136,28 +151,26 @@ void RNNoiseFeatureProcessor::ComputeFrameFeatures(vec1D32F& audioWindow,
 
     float energy = 0.0;
 
-    vec1D32F Ly(NB_BANDS, 0);
-    vec1D32F p(WINDOW_SIZE, 0);
-    vec1D32F pitchBuf(PITCH_BUF_SIZE >> 1, 0);
+    arrBands Ly{};
+    float* pitchBuf = this->m_pitchBufDown.data();
 
-    VERIFY(PITCH_BUF_SIZE >= this->m_pitchBuf.size());
+    static_assert(PITCH_BUF_SIZE > FRAME_SIZE, "Pitch buffer must hold more than a frame");
     std::copy_n(this->m_pitchBuf.begin() + FRAME_SIZE,
                 PITCH_BUF_SIZE - FRAME_SIZE,
                 this->m_pitchBuf.begin());
 
-    VERIFY(FRAME_SIZE <= audioWindow.size() && PITCH_BUF_SIZE > FRAME_SIZE);
-    std::copy_n(audioWindow.begin(),
+    std::copy_n(audioWindow,
                 FRAME_SIZE,
                 this->m_pitchBuf.begin() + PITCH_BUF_SIZE - FRAME_SIZE);
 
     this->PitchDownsample(pitchBuf, PITCH_BUF_SIZE);
 
-    VERIFY(pitchBuf.size() > PITCH_MAX_PERIOD/2);
-    vec1D32F xLp(pitchBuf.size() - PITCH_MAX_PERIOD/2, 0);
-    std::copy_n(pitchBuf.begin() + PITCH_MAX_PERIOD/2, xLp.size(), xLp.begin());
+    /* The search input is the down-sampled buffer past the longest period. */
+    static_assert(PITCH_BUF_DOWN_SIZE > PITCH_MAX_PERIOD/2, "Pitch buffer shorter than the longest period");
+    const float* xLp = pitchBuf + PITCH_MAX_PERIOD/2;
 
     int pitchIdx = this->PitchSearch(xLp, pitchBuf,
-            PITCH_FRAME_SIZE, (PITCH_MAX_PERIOD - (3*PITCH_MIN_PERIOD)));
+            PITCH_FRAME_SIZE, PITCH_SEARCH_MAX);
 
     pitchIdx = this->RemoveDoubling(
                 pitchBuf,
@@ -168,10 +181,10 @@ void RNNoiseFeatureProcessor::ComputeFrameFeatures(vec1D32F& audioWindow,
 
     size_t stIdx = PITCH_BUF_SIZE - WINDOW_SIZE - pitchIdx;
     VERIFY((static_cast<int>(PITCH_BUF_SIZE) - static_cast<int>(WINDOW_SIZE) - pitchIdx) >= 0);
-    std::copy_n(this->m_pitchBuf.begin() + stIdx, WINDOW_SIZE, p.begin());
+    std::copy_n(this->m_pitchBuf.begin() + stIdx, WINDOW_SIZE, this->m_window.begin());
 
-    this->ApplyWindow(p);
-    this->ForwardTransform(p, features.m_fftP);
+    this->ApplyWindow(this->m_window);
+    this->ForwardTransform(this->m_window, features.m_fftP);
     this->ComputeBandEnergy(features.m_fftP, features.m_Ep);
     this->ComputeBandCorr(features.m_fftX, features.m_fftP, features.m_Exp);
 
@@ -180,10 +193,10 @@ void RNNoiseFeatureProcessor::ComputeFrameFeatures(vec1D32F& audioWindow,
             0.001f + features.m_Ex[i] * features.m_Ep[i]);
     }
 
-    vec1D32F dctVec(NB_BANDS, 0);
-    this->DCT(features.m_Exp, dctVec);
+    arrBands dctVec{};
+    this->DCT(features.m_Exp.data(), dctVec.data());
 
-    features.m_featuresVec = vec1D32F (NB_FEATURES, 0);
+    features.m_featuresVec.fill(0);
     for (uint32_t i = 0; i < NB_DELTA_CEPS; ++i) {
         features.m_featuresVec[NB_BANDS + 2*NB_DELTA_CEPS + i] = dctVec[i];
     }
@@ -210,7 +223,7 @@ void RNNoiseFeatureProcessor::ComputeFrameFeatures(vec1D32F& audioWindow,
         features.m_silence = false;
     }
 
-    this->DCT(Ly, features.m_featuresVec);
+    this->DCT(Ly.data(), features.m_featuresVec.data());
     features.m_featuresVec[0] -= 12.0;
     features.m_featuresVec[1] -= 4.0;
 
@@ -219,8 +232,8 @@ void RNNoiseFeatureProcessor::ComputeFrameFeatures(vec1D32F& audioWindow,
     uint32_t stIdx2 = this->m_memId < 2 ? CEPS_MEM + this->m_memId - 2 : this->m_memId - 2;
     VERIFY(stIdx1 < this->m_cepstralMem.size());
     VERIFY(stIdx2 < this->m_cepstralMem.size());
-    auto ceps1 = this->m_cepstralMem[stIdx1];
-    auto ceps2 = this->m_cepstralMem[stIdx2];
+    const arrBands& ceps1 = this->m_cepstralMem[stIdx1];
+    const arrBands& ceps2 = this->m_cepstralMem[stIdx2];
 
     /* Ceps 0 */
     for (uint32_t i = 0; i < NB_BANDS; ++i) {
@@ -265,20 +278,17 @@ void RNNoiseFeatureProcessor::ComputeFrameFeatures(vec1D32F& audioWindow,
 }
 
 void RNNoiseFeatureProcessor::FrameAnalysis(
-    const vec1D32F& audioWindow,
-    vec1D32F& fft,
-    vec1D32F& energy,
-    vec1D32F& analysisMem)
+    const float* audioWindow,
+    arrSpectrum& fft,
+    arrBands& energy,
+    std::array<float, FRAME_SIZE>& analysisMem)
 {
-    vec1D32F x(WINDOW_SIZE, 0);
+    arrWindow& x = this->m_window;
 
     /* Move old audio down and populate end with latest audio window. */
-    VERIFY(x.size() >= FRAME_SIZE && analysisMem.size() >= FRAME_SIZE);
-    VERIFY(audioWindow.size() >= FRAME_SIZE);
-
     std::copy_n(analysisMem.begin(), FRAME_SIZE, x.begin());
-    std::copy_n(audioWindow.begin(), x.size() - FRAME_SIZE, x.begin() + FRAME_SIZE);
-    std::copy_n(audioWindow.begin(), FRAME_SIZE, analysisMem.begin());
+    std::copy_n(audioWindow, x.size() - FRAME_SIZE, x.begin() + FRAME_SIZE);
+    std::copy_n(audioWindow, FRAME_SIZE, analysisMem.begin());
 
     this->ApplyWindow(x);
 
@@ -289,30 +299,23 @@ void RNNoiseFeatureProcessor::FrameAnalysis(
     ComputeBandEnergy(fft, energy);
 }
 
-void RNNoiseFeatureProcessor::ApplyWindow(vec1D32F& x)
+void RNNoiseFeatureProcessor::ApplyWindow(arrWindow& x)
 {
-    if (WINDOW_SIZE != x.size()) {
-        printf_err("Invalid size for vector to be windowed\n");
-        return;
-    }
-
-    VERIFY(this->m_halfWindow.size() >= FRAME_SIZE);
+    VERIFY(this->m_halfWindowData != nullptr);
 
     /* Multiply input by sinusoidal function. */
     for (size_t i = 0; i < FRAME_SIZE; i++) {
-        x[i] *= this->m_halfWindow[i];
-        x[WINDOW_SIZE - 1 - i] *= this->m_halfWindow[i];
+        x[i] *= this->m_halfWindowData[i];
+        x[WINDOW_SIZE - 1 - i] *= this->m_halfWindowData[i];
     }
 }
 
 void RNNoiseFeatureProcessor::ForwardTransform(
-    vec1D32F& x,
-    vec1D32F& fft)
+    arrWindow& x,
+    arrSpectrum& fft)
 {
     /* The input vector can be modified by the fft function. */
-    fft.reserve(x.size() + 2);
-    fft.resize(x.size() + 2, 0);
-    math::MathUtils::FftF32(x, fft, this->m_fftInstReal);
+    math::MathUtils::FftF32(x.data(), x.size(), fft.data(), fft.size(), this->m_fftInstReal);
 
     /* Normalise. */
     for (auto& f : fft) {
@@ -327,9 +330,9 @@ void RNNoiseFeatureProcessor::ForwardTransform(
      * first half of the FFT's. The conjugates are not present. */
 }
 
-void RNNoiseFeatureProcessor::ComputeBandEnergy(const vec1D32F& fftX, vec1D32F& bandE)
+void RNNoiseFeatureProcessor::ComputeBandEnergy(const arrSpectrum& fftX, arrBands& bandE)
 {
-    bandE = vec1D32F(NB_BANDS, 0);
+    bandE.fill(0);
 
     VERIFY(this->m_eband5ms.size() >= NB_BANDS);
     for (uint32_t i = 0; i < NB_BANDS - 1; i++) {
@@ -351,9 +354,9 @@ void RNNoiseFeatureProcessor::ComputeBandEnergy(const vec1D32F& fftX, vec1D32F&
     bandE[NB_BANDS - 1] *= 2;
 }
 
-void RNNoiseFeatureProcessor::ComputeBandCorr(const vec1D32F& X, const vec1D32F& P, vec1D32F& bandC)
+void RNNoiseFeatureProcessor::ComputeBandCorr(const arrSpectrum& X, const arrSpectrum& P, arrBands& bandC)
 {
-    bandC = vec1D32F(NB_BANDS, 0);
+    bandC.fill(0);
     VERIFY(this->m_eband5ms.size() >= NB_BANDS);
 
     for (uint32_t i = 0; i < NB_BANDS - 1; i++) {
@@ -374,20 +377,20 @@ void RNNoiseFeatureProcessor::ComputeBandCorr(const vec1D32F& X, const vec1D32F&
     bandC[NB_BANDS - 1] *= 2;
 }
 
-void RNNoiseFeatureProcessor::DCT(vec1D32F& input, vec1D32F& output)
+void RNNoiseFeatureProcessor::DCT(const float* input, float* output)
 {
-    VERIFY(this->m_dctTable.size() >= NB_BANDS * NB_BANDS);
+    VERIFY(this->m_dctTableData != nullptr);
     for (uint32_t i = 0; i < NB_BANDS; ++i) {
         float sum = 0;
 
         for (uint32_t j = 0, k = 0; j < NB_BANDS; ++j, k += NB_BANDS) {
-            sum += input[j] * this->m_dctTable[k + i];
+            sum += input[j] * this->m_dctTableData[k + i];
         }
         output[i] = sum * math::MathUtils::SqrtF32(2.0/22);
     }
 }
 
-void RNNoiseFeatureProcessor::PitchDownsample(vec1D32F& pitchBuf, size_t pitchBufSz) {
+void RNNoiseFeatureProcessor::PitchDownsample(float* pitchBuf, size_t pitchBufSz) {
     for (size_t i = 1; i < (pitchBufSz >> 1); ++i) {
         pitchBuf[i] = 0.5 * (
                         0.5 * (this->m_pitchBuf[2 * i - 1] + this->m_pitchBuf[2 * i + 1])
@@ -396,10 +399,10 @@ void RNNoiseFeatureProcessor::PitchDownsample(vec1D32F& pitchBuf, size_t pitchBu
 
     pitchBuf[0] = 0.5*(0.5*(this->m_pitchBuf[1]) + this->m_pitchBuf[0]);
 
-    vec1D32F ac(5, 0);
-    size_t numLags = 4;
+    std::array<float, LPC_ORDER + 1> ac{};
+    size_t numLags = LPC_ORDER;
 
-    this->AutoCorr(pitchBuf, ac, numLags, pitchBufSz >> 1);
+    this->AutoCorr(pitchBuf, ac.data(), numLags, pitchBufSz >> 1);
 
     /* Noise floor -40db */
     ac[0] *= 1.0001;
@@ -409,8 +412,8 @@ void RNNoiseFeatureProcessor::PitchDownsample(vec1D32F& pitchBuf, size_t pitchBu
         ac[i] -= ac[i] * (0.008 * i) * (0.008 * i);
     }
 
-    vec1D32F lpc(numLags, 0);
-    this->LPC(ac, numLags, lpc);
+    std::array<float, LPC_ORDER> lpc{};
+    this->LPC(ac.data(), numLags, lpc.data());
 
     float tmp = 1.0;
     for (size_t i = 0; i < numLags; ++i) {
@@ -418,7 +421,7 @@ void RNNoiseFeatureProcessor::PitchDownsample(vec1D32F& pitchBuf, size_t pitchBu
         lpc[i] = lpc[i] * tmp;
     }
 
-    vec1D32F lpc2(numLags + 1, 0);
+    std::array<float, LPC_ORDER + 1> lpc2{};
     float c1 = 0.8;
 
     /* Add a zero. */
@@ -428,14 +431,16 @@ void RNNoiseFeatureProcessor::PitchDownsample(vec1D32F& pitchBuf, size_t pitchBu
     lpc2[3] = lpc[3] + (c1 * lpc[2]);
     lpc2[4] = (c1 * lpc[3]);
 
-    this->Fir5(lpc2, pitchBufSz >> 1, pitchBuf);
+    this->Fir5(lpc2.data(), pitchBufSz >> 1, pitchBuf);
 }
 
-int RNNoiseFeatureProcessor::PitchSearch(vec1D32F& xLp, vec1D32F& y, uint32_t len, uint32_t maxPitch) {
+int RNNoiseFeatureProcessor::PitchSearch(const float* xLp, const float* y, uint32_t len, uint32_t maxPitch) {
     uint32_t lag = len + maxPitch;
-    vec1D32F xLp4(len >> 2, 0);
-    vec1D32F yLp4(lag >> 2, 0);
-    vec1D32F xCorr(maxPitch >> 1, 0);
+    VERIFY((len >> 2) <= this->m_xLp4.size() && (lag >> 2) <= this->m_yLp4.size() &&
+           (maxPitch >> 1) <= this->m_xCorr.size());
+    float* xLp4 = this->m_xLp4.data();
+    float* yLp4 = this->m_yLp4.data();
+    float* xCorr = this->m_xCorr.data();
 
     /* Downsample by 2 again. */
     for (size_t j = 0; j < (len >> 2); ++j) {
@@ -452,17 +457,17 @@ int RNNoiseFeatureProcessor::PitchSearch(vec1D32F& xLp, vec1D32F& y, uint32_t le
 
     /* Finer search with 2x decimation. */
     const int maxIdx = (maxPitch >> 1);
-    for (int i = 0; i < maxIdx; ++i) {
-        xCorr[i] = 0;
-        if (std::abs(i - 2*bestPitch[0]) > 2 and std::abs(i - 2*bestPitch[1]) > 2) {
-            continue;
-        }
-        float sum = 0;
-        for (size_t j = 0; j < len >> 1; ++j) {
-            sum += xLp[j] * y[i+j];
+    std::fill_n(xCorr, maxIdx, 0.f);
+    for (const float coarsePitch : bestPitch) {
+        /* Only the lags within 2 of each coarse candidate. */
+        const int first = std::max(0, 2 * static_cast<int>(coarsePitch) - 2);
+        const int end = std::min(maxIdx, 2 * static_cast<int>(coarsePitch) + 3);
+        if (first < end) {
+            this->PitchXCorr(xLp, y + first, xCorr + first, len >> 1, end - first);
         }
-
-        xCorr[i] = std::max(-1.0f, sum);
+    }
+    for (int i = 0; i < maxIdx; ++i) {
+        xCorr[i] = std::max(-1.0f, xCorr[i]);
     }
 
     bestPitch = this->FindBestPitch(xCorr, y, len >> 1, maxPitch >> 1);
@@ -470,9 +475,10 @@ int RNNoiseFeatureProcessor::PitchSearch(vec1D32F& xLp, vec1D32F& y, uint32_t le
     int offset;
     /* Refine by pseudo-interpolation. */
     if ( 0 < bestPitch[0] && bestPitch[0] < ((maxPitch >> 1) - 1)) {
-        float a = xCorr[bestPitch[0] - 1];
-        float b = xCorr[bestPitch[0]];
-        float c = xCorr[bestPitch[0] + 1];
+        const auto idx = static_cast<int>(bestPitch[0]);
+        float a = xCorr[idx - 1];
+        float b = xCorr[idx];
+        float c = xCorr[idx + 1];
 
         if ( (c-a) > 0.7*(b-a) ) {
             offset = 1;
@@ -488,7 +494,7 @@ int RNNoiseFeatureProcessor::PitchSearch(vec1D32F& xLp, vec1D32F& y, uint32_t le
     return 2*bestPitch[0] - offset;
 }
 
-arrHp RNNoiseFeatureProcessor::FindBestPitch(vec1D32F& xCorr, vec1D32F& y, uint32_t len, uint32_t maxPitch)
+arrHp RNNoiseFeatureProcessor::FindBestPitch(const float* xCorr, const float* y, uint32_t len, uint32_t maxPitch)
 {
     float Syy = 1;
     arrHp bestNum {-1, -1};
@@ -528,7 +534,7 @@ arrHp RNNoiseFeatureProcessor::FindBestPitch(vec1D32F& xCorr, vec1D32F& y, uint3
 }
 
 int RNNoiseFeatureProcessor::RemoveDoubling(
-    vec1D32F& pitchBuf,
+    const float* pitchBuf,
     uint32_t maxPeriod,
     uint32_t minPeriod,
     uint32_t frameSize,
@@ -552,21 +558,20 @@ int RNNoiseFeatureProcessor::RemoveDoubling(
     size_t pitchIdx  = pitchIdx0_;
     const size_t pitchIdx0 = pitchIdx0_;
 
+    const float* x = pitchBuf + xStart;
+
     float xx = 0;
-    for ( size_t i = xStart; i < xStart+frameSize; ++i) {
-        xx += (pitchBuf[i] * pitchBuf[i]);
-    }
+    this->PitchXCorr(x, x, &xx, frameSize, 1);
 
     float xy = 0;
-    for ( size_t i = xStart; i < xStart+frameSize; ++i) {
-        xy += (pitchBuf[i] * pitchBuf[i-pitchIdx0]);
-    }
+    this->PitchXCorr(x, x - pitchIdx0, &xy, frameSize, 1);
 
-    vec1D32F yyLookup (maxPeriod+1, 0);
+    VERIFY(maxPeriod + 1 <= this->m_yyLookup.size());
+    float* yyLookup = this->m_yyLookup.data();
     yyLookup[0] = xx;
     float yy = xx;
 
-    for ( size_t i = 1; i < yyLookup.size(); ++i) {
+    for ( size_t i = 1; i < maxPeriod + 1; ++i) {
         yy = yy + (pitchBuf[xStart-i] * pitchBuf[xStart-i]) -
                 (pitchBuf[xStart+frameSize-i] * pitchBuf[xStart+frameSize-i]);
         yyLookup[i] = std::max(0.0f, yy);
@@ -598,15 +603,10 @@ int RNNoiseFeatureProcessor::RemoveDoubling(
             pitchIdx1b = (2*(secondCheck[k])*pitchIdx0 + k) / (2*k);
         }
 
-        xy = 0;
-        for ( size_t i = xStart; i < xStart+frameSize; ++i) {
-            xy += (pitchBuf[i] * pitchBuf[i-pitchIdx1]);
-        }
+        this->PitchXCorr(x, x - pitchIdx1, &xy, frameSize, 1);
 
         float xy2 = 0;
-        for ( size_t i = xStart; i < xStart+frameSize; ++i) {
-            xy2 += (pitchBuf[i] * pitchBuf[i-pitchIdx1b]);
-        }
+        this->PitchXCorr(x, x - pitchIdx1b, &xy2, frameSize, 1);
         xy = 0.5f * (xy + xy2);
         VERIFY(pitchIdx1b < maxPeriod+1);
         yy = 0.5f * (yyLookup[pitchIdx1] + yyLookup[pitchIdx1b]);
@@ -647,12 +647,10 @@ int RNNoiseFeatureProcessor::RemoveDoubling(
         pg = bestXy/(bestYy+1);
     }
 
-    std::array<float, 3> xCorr {0};
-    for ( size_t k = 0; k < 3; ++k ) {
-        for ( size_t i = xStart; i < xStart+frameSize; ++i) {
-            xCorr[k] += (pitchBuf[i] * pitchBuf[i-(pitchIdx+k-1)]);
-        }
-    }
+    /* Correlation at periods pitchIdx - 1, pitchIdx and pitchIdx + 1, longest first. */
+    std::array<float, 3> xCorrRev {0};
+    this->PitchXCorr(x, x - (pitchIdx + 1), xCorrRev.data(), frameSize, xCorrRev.size());
+    const std::array<float, 3> xCorr {xCorrRev[2], xCorrRev[1], xCorrRev[0]};
 
     size_t offset;
     if ((xCorr[2]-xCorr[0]) > 0.7*(xCorr[1]-xCorr[0])) {
@@ -685,8 +683,8 @@ float RNNoiseFeatureProcessor::ComputePitchGain(float xy, float xx, float yy)
 }
 
 void RNNoiseFeatureProcessor::AutoCorr(
-    const vec1D32F& x,
-    vec1D32F& ac,
+    const float* x,
+    float* ac,
     size_t lag,
     size_t n)
 {
@@ -712,26 +710,20 @@ void RNNoiseFeatureProcessor::AutoCorr(
 
 
 void RNNoiseFeatureProcessor::PitchXCorr(
-    const vec1D32F& x,
-    const vec1D32F& y,
-    vec1D32F& xCorr,
+    const float* x,
+    const float* y,
+    float* xCorr,
     size_t len,
     size_t maxPitch)
 {
-    for (size_t i = 0; i < maxPitch; i++) {
-        float sum = 0;
-        for (size_t j = 0; j < len; j++) {
-            sum += x[j] * y[i + j];
-        }
-        xCorr[i] = sum;
-    }
+    math::MathUtils::CrossCorrelationF32(x, y, len, xCorr, maxPitch);
 }
 
 /* Linear predictor coefficients */
 void RNNoiseFeatureProcessor::LPC(
-    const vec1D32F& correlation,
+    const float* correlation,
     int32_t p,
-    vec1D32F& lpc)
+    float* lpc)
 {
     auto error = correlation[0];
 
@@ -767,9 +759,9 @@ void RNNoiseFeatureProcessor::LPC(
 }
 
 void RNNoiseFeatureProcessor::Fir5(
-    const vec1D32F &num,
+    const float* num,
     uint32_t N,
-    vec1D32F &x)
+    float* x)
 {
     auto num0 = num[0];
     auto num1 = num[1];
@@ -794,10 +786,12 @@ void RNNoiseFeatureProcessor::Fir5(
     }
 }
 
-void RNNoiseFeatureProcessor::PitchFilter(FrameFeatures &features, vec1D32F &gain) {
-    std::vector<float> r(NB_BANDS, 0);
-    std::vector<float> rf(FREQ_SIZE, 0);
-    std::vector<float> newE(NB_BANDS);
+void RNNoiseFeatureProcessor::PitchFilter(FrameFeatures &features, const arrBands &gain) {
+    arrBands r{};
+    arrBands newE{};
+
+    /* Interpolation only writes the bins covered by the bands; the rest stay zero. */
+    arrFreq& rf = this->m_gain;
 
     for (size_t i = 0; i < NB_BANDS; i++) {
         if (features.m_Exp[i] > gain[i]) {
@@ -821,8 +815,8 @@ void RNNoiseFeatureProcessor::PitchFilter(FrameFeatures &features, vec1D32F &gai
 
     }
     ComputeBandEnergy(features.m_fftX, newE);
-    std::vector<float> norm(NB_BANDS);
-    std::vector<float> normf(FRAME_SIZE, 0);
+    arrBands norm{};
+    arrFreq& normf = this->m_gain;
     for (size_t i = 0; i < NB_BANDS; i++) {
         norm[i] = math::MathUtils::SqrtF32(features.m_Ex[i] / (1e-8f + newE[i]));
     }
@@ -835,8 +829,8 @@ void RNNoiseFeatureProcessor::PitchFilter(FrameFeatures &features, vec1D32F &gai
     }
 }
 
-void RNNoiseFeatureProcessor::FrameSynthesis(vec1D32F& outFrame, vec1D32F& fftY) {
-    std::vector<float> x(WINDOW_SIZE, 0);
+void RNNoiseFeatureProcessor::FrameSynthesis(float* outFrame, const arrSpectrum& fftY) {
+    arrWindow& x = this->m_window;
     InverseTransform(x, fftY);
     ApplyWindow(x);
     for (size_t i = 0; i < FRAME_SIZE; i++) {
@@ -845,7 +839,7 @@ void RNNoiseFeatureProcessor::FrameSynthesis(vec1D32F& outFrame, vec1D32F& fftY)
     memcpy((m_synthesisMem.data()), &x[FRAME_SIZE], FRAME_SIZE*sizeof(float));
 }
 
-void RNNoiseFeatureProcessor::InterpBandGain(vec1D32F& g, vec1D32F& bandE) {
+void RNNoiseFeatureProcessor::InterpBandGain(arrFreq& g, const arrBands& bandE) {
     for (size_t i = 0; i < NB_BANDS - 1; i++) {
         int bandSize = (m_eband5ms[i + 1] - m_eband5ms[i]) << FRAME_SIZE_SHIFT;
         for (int j = 0; j < bandSize; j++) {
@@ -855,10 +849,9 @@ void RNNoiseFeatureProcessor::InterpBandGain(vec1D32F& g, vec1D32F& bandE) {
     }
 }
 
-void RNNoiseFeatureProcessor::InverseTransform(vec1D32F& out, vec1D32F& fftXIn) {
+void RNNoiseFeatureProcessor::InverseTransform(arrWindow& out, const arrSpectrum& fftXIn) {
 
-    std::vector<float> x(WINDOW_SIZE * 2);  /* This is complex. */
-    vec1D32F newFFT;  /* This is complex. */
+    std::array<float, 2 * WINDOW_SIZE>& x = this->m_ifftIn;  /* This is complex. */
 
     size_t i;
     for (i = 0; i < FREQ_SIZE * 2; i++) {
@@ -872,8 +865,8 @@ void RNNoiseFeatureProcessor::InverseTransform(vec1D32F& out, vec1D32F& fftXIn)
     constexpr uint32_t numFFt = 2 * FRAME_SIZE;
     static_assert(numFFt != 0, "numFFt cannot be 0!");
 
-    vec1D32F fftOut = vec1D32F(x.size(), 0);
-    math::MathUtils::FftF32(x,fftOut, m_fftInstCmplx);
+    std::array<float, 2 * WINDOW_SIZE>& fftOut = this->m_ifftOut;
+    math::MathUtils::FftF32(x.data(), x.size(), fftOut.data(), fftOut.size(), m_fftInstCmplx);
 
     /* Normalize. */
     for (auto &f: fftOut) {
@@ -67,32 +67,69 @@ void arm::app::RNNoiseModel::ResetGruState()
     }
 }
 
-bool arm::app::RNNoiseModel::CopyGruStates()
+bool arm::app::RNNoiseModel::BindGruStates()
 {
-    std::vector<std::pair<size_t, std::vector<int8_t>>> tempOutGruStates;
-    /* Saving output states before copying them to input states to avoid output states modification in the tensor.
-     * tflu shares input and output tensors memory, thus writing to input tensor can change output tensor values. */
-    for (auto& stateMapping: this->m_gruStateMap) {
-        TfLiteTensor* outputGruStateTensor = this->GetOutputTensor(stateMapping.first);
-        std::vector<int8_t> tempOutGruState(outputGruStateTensor->bytes);
-        auto* outGruState = tflite::GetTensorData<int8_t>(outputGruStateTensor);
-        memcpy(tempOutGruState.data(), outGruState, outputGruStateTensor->bytes);
-        /* Index of the input tensor and the data to copy. */
-        tempOutGruStates.emplace_back(stateMapping.second, std::move(tempOutGruState));
-    }
-    /* Updating input GRU states with saved GRU output states. */
-    for (auto& stateMapping: tempOutGruStates) {
-        auto outputGruStateTensorData = stateMapping.second;
-        TfLiteTensor* inputGruStateTensor = this->GetInputTensor(stateMapping.first);
-        if (outputGruStateTensorData.size() != inputGruStateTensor->bytes) {
-            printf_err("Unexpected number of bytes for GRU state mapping. Input = %zuz, output = %zuz.\n",
+    /* Tensor data pointers only change when the model is initialised again, but resolving
+     * them is cheap and keeps this independent of the initialisation order. */
+    this->m_gruStateBindings.resize(this->m_gruStateMap.size());
+    size_t totalBytes = 0;
+    for (size_t i = 0; i < this->m_gruStateMap.size(); ++i) {
+        TfLiteTensor* outputGruStateTensor = this->GetOutputTensor(this->m_gruStateMap[i].first);
+        TfLiteTensor* inputGruStateTensor = this->GetInputTensor(this->m_gruStateMap[i].second);
+        if (outputGruStateTensor->bytes != inputGruStateTensor->bytes) {
+            printf_err("Unexpected number of bytes for GRU state mapping. Input = %zu, output = %zu.\n",
                        inputGruStateTensor->bytes,
-                       outputGruStateTensorData.size());
+                       outputGruStateTensor->bytes);
             return false;
         }
-        auto* inputGruState = tflite::GetTensorData<int8_t>(inputGruStateTensor);
-        auto* outGruState = outputGruStateTensorData.data();
-        memcpy(inputGruState, outGruState, inputGruStateTensor->bytes);
+        auto& binding = this->m_gruStateBindings[i];
+        binding.src = tflite::GetTensorData<int8_t>(outputGruStateTensor);
+        binding.dst = tflite::GetTensorData<int8_t>(inputGruStateTensor);
+        binding.bytes = inputGruStateTensor->bytes;
+        totalBytes += binding.bytes;
+    }
+
+    /* tflu can share input and output tensor memory, so writing an input state may change
+     * an output state that has not been copied yet. */
+    this->m_gruStatesOverlap = false;
+    for (const auto& dstBinding : this->m_gruStateBindings) {
+        for (const auto& srcBinding : this->m_gruStateBindings) {
+            if (dstBinding.dst < srcBinding.src + srcBinding.bytes &&
+                    srcBinding.src < dstBinding.dst + dstBinding.bytes) {
+                this->m_gruStatesOverlap = true;
+            }
+        }
+    }
+
+    if (this->m_gruStatesOverlap && this->m_gruStateScratch.size() < totalBytes) {
+        this->m_gruStateScratch.resize(totalBytes);
+    }
+    return true;
+}
+
+bool arm::app::RNNoiseModel::CopyGruStates()
+{
+    if (!this->BindGruStates()) {
+        return false;
+    }
+
+    if (!this->m_gruStatesOverlap) {
+        for (const auto& binding : this->m_gruStateBindings) {
+            memcpy(binding.dst, binding.src, binding.bytes);
+        }
+        return true;
+    }
+
+    /* Saving all output states before updating any input state. */
+    int8_t* scratch = this->m_gruStateScratch.data();
+    for (const auto& binding : this->m_gruStateBindings) {
+        memcpy(scratch, binding.src, binding.bytes);
+        scratch += binding.bytes;
+    }
+    scratch = this->m_gruStateScratch.data();
+    for (const auto& binding : this->m_gruStateBindings) {
+        memcpy(binding.dst, scratch, binding.bytes);
+        scratch += binding.bytes;
     }
     return true;
 }
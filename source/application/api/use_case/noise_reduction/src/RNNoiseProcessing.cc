@@ -35,7 +35,7 @@ namespace app {
         }
 
         auto input = static_cast<const int16_t*>(data);
-        this->m_audioFrame = rnn::vec1D32F(input, input + inputSize);
+        this->m_audioFrame.assign(input, input + inputSize);
         m_featureProcessor->PreprocessFrame(this->m_audioFrame.data(), inputSize, *this->m_frameFeatures);
 
         QuantizeAndPopulateInput(this->m_frameFeatures->m_featuresVec,
@@ -47,7 +47,7 @@ namespace app {
         return true;
     }
 
-    void RNNoisePreProcess::QuantizeAndPopulateInput(rnn::vec1D32F& inputFeatures,
+    void RNNoisePreProcess::QuantizeAndPopulateInput(const rnn::RNNoiseFeatureProcessor::arrFeatures& inputFeatures,
             const float quantScale, const int quantOffset,
             TfLiteTensor* inputTensor)
     {
@@ -71,7 +71,7 @@ namespace app {
         m_featureProcessor{featureProcessor},
         m_frameFeatures{frameFeatures}
         {
-            this->m_denoisedAudioFrameFloat.reserve(denoisedAudioFrame.size());
+            this->m_denoisedAudioFrameFloat.resize(denoisedAudioFrame.size());
             this->m_modelOutputFloat.resize(outputTensor->bytes);
         }
 
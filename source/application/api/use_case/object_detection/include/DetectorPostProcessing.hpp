@@ -18,6 +18,7 @@
 #define DETECTOR_POST_PROCESSING_HPP
 
 #include "ImageUtils.hpp"
+#include "Nms.hpp"
 #include "DetectionResult.hpp"
 #include "YoloFastestModel.hpp"
 #include "BaseProcessing.hpp"
@@ -38,6 +39,9 @@ namespace object_detection {
         float nms = 0.45f;
         int numClasses = 1;
         int topN = 0;
+        image::NmsMode nmsMode = image::NmsMode::PerClass;
+        size_t maxDetections = 0;   /* Maximum number of results, 0 for no limit. */
+        bool softNms = false;       /* Decay overlapping scores rather than suppress the boxes. */
     };
 
     struct Branch {
@@ -58,6 +62,89 @@ namespace object_detection {
         int topN;
     };
 
+    /**
+     * @brief   Decodes the boxes of a YOLO network from its quantised output grids.
+     *          The detection threshold is turned into an int8 objectness cutoff once
+     *          per branch, so cells are rejected without any float maths. Candidates
+     *          passing the cutoff are kept in a fixed-size binary heap ordered on
+     *          their quantised objectness, which orders them like its sigmoid; boxes
+     *          and class scores are only dequantised for the candidates kept.
+     */
+    class YoloDecoder {
+    public:
+        /**
+         * @brief       Constructor. Allocates room for every anchor of the network,
+         *              or for topN candidates if the network limits them.
+         * @param[in]   net         Network to decode.
+         * @param[in]   threshold   Detections threshold.
+         **/
+        YoloDecoder(const Network& net, float threshold);
+
+        /**
+         * @brief       Decodes the detection boxes from the current network outputs.
+         *              With topN set, the candidates with the highest objectness are
+         *              kept, later ones winning ties. Detections are added to the list
+         *              in the reverse of the order their cells appear in the outputs.
+         * @param[in]   net           Network given at construction.
+         * @param[in]   imageWidth    Original image width.
+         * @param[in]   imageHeight   Original image height.
+         * @param[out]  detections    Detection boxes.
+         **/
+        void Decode(const Network& net, int imageWidth, int imageHeight,
+                    std::forward_list<image::Detection>& detections);
+
+        /**
+         * @brief       Decodes the detection boxes from the current network outputs
+         *              into a box buffer for non-maxima suppression, as Decode above
+         *              does, with one box per class scoring above the threshold.
+         * @param[in]   net           Network given at construction.
+         * @param[in]   imageWidth    Original image width.
+         * @param[in]   imageHeight   Original image height.
+         * @param[out]  boxes         Box buffer, cleared first.
+         **/
+        void Decode(const Network& net, int imageWidth, int imageHeight, image::NmsBoxes& boxes);
+
+        /**
+         * @brief   Gets the number of cells that passed the objectness cutoff in the
+         *          last call to Decode, including those that did not make the top N.
+         * @return  Number of candidates.
+         */
+        size_t GetNumCandidates() const;
+
+    private:
+        /* Anchor cell that passed the objectness cutoff. */
+        struct Candidate {
+            const int8_t*   output;      /* Box, objectness and class scores in the output grid. */
+            uint32_t        order;       /* Position in decoding order, breaks ties. */
+            uint16_t        cellX;       /* Grid column. */
+            uint16_t        cellY;       /* Grid row. */
+            uint8_t         branch;      /* Index of the network branch. */
+            uint8_t         anchor;      /* Index of the anchor box. */
+            int8_t          objectness;  /* Quantised objectness. */
+        };
+
+        /* Heap order: the root is the weakest candidate. */
+        static bool IsStronger(const Candidate& a, const Candidate& b);
+
+        /* Fills the candidate heap from the network outputs, in decoding order. */
+        void SelectCandidates(const Network& net);
+
+        /* Dequantises a candidate's box, in original image coordinates, and returns
+         * its objectness. */
+        float DecodeBox(const Network& net, const Candidate& candidate,
+                        int imageWidth, int imageHeight, image::Box& box) const;
+
+        /* Class score of a candidate, 0 if not above the threshold. */
+        float GetClassScore(const Network& net, const Candidate& candidate,
+                            float objectness, int classIdx) const;
+
+        float                   m_threshold;        /* Detections threshold. */
+        std::vector<int16_t>    m_cutoffs;          /* Lowest passing objectness per branch. */
+        std::vector<Candidate>  m_candidates;       /* Candidate heap. */
+        size_t                  m_maxCandidates;    /* Heap capacity. */
+        size_t                  m_numCandidates{0}; /* Candidates seen in the last decode. */
+    };
+
 } /* namespace object_detection */
 
     /**
@@ -92,27 +179,21 @@ namespace object_detection {
         std::vector<object_detection::DetectionResult>& m_results;       /* Single inference results. */
         const object_detection::PostProcessParams& m_postProcessParams;  /* Post processing param struct. */
         object_detection::Network m_net;                                 /* YOLO network object. */
+        object_detection::YoloDecoder m_decoder;                         /* Decoder of the network boxes. */
+        image::NonMaxSuppression m_nms;                                  /* Non-maxima suppression. */
+        image::NmsBoxes m_boxes;                                         /* Decoded boxes. */
+        std::vector<uint32_t> m_keep;                                    /* Boxes kept by the suppression. */
 
         /**
-         * @brief       Insert the given Detection in the list.
-         * @param[in]   detections   List of detections.
-         * @param[in]   det          Detection to be inserted.
-         **/
-        void InsertTopNDetections(std::forward_list<image::Detection>& detections, image::Detection& det);
-
-        /**
-         * @brief        Given a Network calculate the detection boxes.
-         * @param[in]    net           Network.
-         * @param[in]    imageWidth    Original image width.
-         * @param[in]    imageHeight   Original image height.
-         * @param[in]    threshold     Detections threshold.
-         * @param[out]   detections    Detection boxes.
+         * @brief       Describes the YOLO network behind the given output tensors.
+         * @param[in]   outputTensor0       Pointer to the TFLite Micro output Tensor at index 0.
+         * @param[in]   outputTensor1       Pointer to the TFLite Micro output Tensor at index 1.
+         * @param[in]   postProcessParams   Struct of various parameters used in post-processing.
+         * @return      YOLO network object.
          **/
-        void GetNetworkBoxes(object_detection::Network& net,
-                             int imageWidth,
-                             int imageHeight,
-                             float threshold,
-                             std::forward_list<image::Detection>& detections);
+        static object_detection::Network GetNetwork(TfLiteTensor* outputTensor0,
+                                                    TfLiteTensor* outputTensor1,
+                                                    const object_detection::PostProcessParams& postProcessParams);
     };
 
 } /* namespace app */
@@ -17,6 +17,7 @@
 #include "DetectorPostProcessing.hpp"
 #include "PlatformMath.hpp"
 
+#include <algorithm>
 #include <cmath>
 
 namespace arm {
@@ -30,10 +31,23 @@ namespace app {
         :   m_outputTensor0{modelOutput0},
             m_outputTensor1{modelOutput1},
             m_results{results},
-            m_postProcessParams{postProcessParams}
+            m_postProcessParams{postProcessParams},
+            m_net{GetNetwork(modelOutput0, modelOutput1, postProcessParams)},
+            m_decoder{this->m_net, postProcessParams.threshold},
+            m_nms{image::NmsParams{
+                .mode           = postProcessParams.nmsMode,
+                .iouThreshold   = postProcessParams.nms,
+                .maxDetections  = postProcessParams.maxDetections,
+                .softNms        = postProcessParams.softNms,
+                .scoreThreshold = postProcessParams.threshold}}
+{}
+
+object_detection::Network DetectorPostProcess::GetNetwork(
+        TfLiteTensor* outputTensor0,
+        TfLiteTensor* outputTensor1,
+        const object_detection::PostProcessParams& postProcessParams)
 {
-    /* Init PostProcessing */
-    this->m_net = object_detection::Network{
+    return object_detection::Network{
         .inputWidth  = postProcessParams.inputImgCols,
         .inputHeight = postProcessParams.inputImgRows,
         .numClasses  = postProcessParams.numClasses,
@@ -41,27 +55,26 @@ namespace app {
             {object_detection::Branch{.resolution  = postProcessParams.inputImgCols / 32,
                                       .numBox      = 3,
                                       .anchor      = postProcessParams.anchor1,
-                                      .modelOutput = this->m_outputTensor0->data.int8,
+                                      .modelOutput = outputTensor0->data.int8,
                                       .scale       = (static_cast<TfLiteAffineQuantization*>(
-                                                    this->m_outputTensor0->quantization.params))
+                                                    outputTensor0->quantization.params))
                                                    ->scale->data[0],
                                       .zeroPoint = (static_cast<TfLiteAffineQuantization*>(
-                                                        this->m_outputTensor0->quantization.params))
+                                                        outputTensor0->quantization.params))
                                                        ->zero_point->data[0],
-                                      .size = this->m_outputTensor0->bytes},
+                                      .size = outputTensor0->bytes},
              object_detection::Branch{.resolution  = postProcessParams.inputImgCols / 16,
                                       .numBox      = 3,
                                       .anchor      = postProcessParams.anchor2,
-                                      .modelOutput = this->m_outputTensor1->data.int8,
+                                      .modelOutput = outputTensor1->data.int8,
                                       .scale       = (static_cast<TfLiteAffineQuantization*>(
-                                                    this->m_outputTensor1->quantization.params))
+                                                    outputTensor1->quantization.params))
                                                    ->scale->data[0],
                                       .zeroPoint = (static_cast<TfLiteAffineQuantization*>(
-                                                        this->m_outputTensor1->quantization.params))
+                                                        outputTensor1->quantization.params))
                                                        ->zero_point->data[0],
-                                      .size = this->m_outputTensor1->bytes}},
+                                      .size = outputTensor1->bytes}},
         .topN = postProcessParams.topN};
-    /* End init */
 }
 
 bool DetectorPostProcess::DoPostProcess()
@@ -70,17 +83,16 @@ bool DetectorPostProcess::DoPostProcess()
     int originalImageWidth  = m_postProcessParams.originalImageSize;
     int originalImageHeight = m_postProcessParams.originalImageSize;
 
-    std::forward_list<image::Detection> detections;
-    GetNetworkBoxes(this->m_net, originalImageWidth, originalImageHeight, m_postProcessParams.threshold, detections);
+    this->m_decoder.Decode(this->m_net, originalImageWidth, originalImageHeight, this->m_boxes);
 
     /* Do nms */
-    CalculateNMS(detections, this->m_net.numClasses, this->m_postProcessParams.nms);
+    this->m_nms.Run(this->m_boxes, this->m_keep);
 
-    for (auto& it: detections) {
-        float xMin = it.bbox.x - it.bbox.w / 2.0f;
-        float xMax = it.bbox.x + it.bbox.w / 2.0f;
-        float yMin = it.bbox.y - it.bbox.h / 2.0f;
-        float yMax = it.bbox.y + it.bbox.h / 2.0f;
+    for (const uint32_t idx : this->m_keep) {
+        float xMin = this->m_boxes.x0[idx];
+        float xMax = this->m_boxes.x1[idx];
+        float yMin = this->m_boxes.y0[idx];
+        float yMax = this->m_boxes.y1[idx];
 
         if (xMin < 0) {
             xMin = 0;
@@ -95,133 +107,184 @@ bool DetectorPostProcess::DoPostProcess()
             yMax = originalImageHeight;
         }
 
-        float boxX = xMin;
-        float boxY = yMin;
-        float boxWidth = xMax - xMin;
-        float boxHeight = yMax - yMin;
+        object_detection::DetectionResult tmpResult = {};
+        tmpResult.m_normalisedVal = this->m_boxes.score[idx];
+        tmpResult.m_x0 = xMin;
+        tmpResult.m_y0 = yMin;
+        tmpResult.m_w = xMax - xMin;
+        tmpResult.m_h = yMax - yMin;
 
-        for (int j = 0; j < this->m_net.numClasses; ++j) {
-            if (it.prob[j] > 0) {
+        this->m_results.push_back(tmpResult);
+    }
+    return true;
+}
 
-                object_detection::DetectionResult tmpResult = {};
-                tmpResult.m_normalisedVal = it.prob[j];
-                tmpResult.m_x0 = boxX;
-                tmpResult.m_y0 = boxY;
-                tmpResult.m_w = boxWidth;
-                tmpResult.m_h = boxHeight;
+namespace object_detection {
 
-                this->m_results.push_back(tmpResult);
+YoloDecoder::YoloDecoder(const Network& net, const float threshold)
+    :   m_threshold{threshold}
+{
+    size_t numAnchors = 0;
+    for (const auto& branch : net.branches) {
+        /* Objectness is monotonic in the quantised value: find the lowest one
+         * passing the threshold, or INT8_MAX + 1 if none does. */
+        int low = INT8_MIN;
+        int high = INT8_MAX + 1;
+        while (low < high) {
+            const int mid = low + (high - low) / 2;
+            const float objectness = math::MathUtils::SigmoidF32(
+                    (static_cast<float>(mid) - branch.zeroPoint) * branch.scale);
+            if (objectness > threshold) {
+                high = mid;
+            } else {
+                low = mid + 1;
             }
         }
+        this->m_cutoffs.push_back(static_cast<int16_t>(low));
+        numAnchors += branch.resolution * branch.resolution * branch.numBox;
     }
-    return true;
+
+    this->m_maxCandidates = net.topN > 0 ?
+                            std::min<size_t>(net.topN, numAnchors) : numAnchors;
+    this->m_candidates.reserve(this->m_maxCandidates);
 }
 
-void DetectorPostProcess::InsertTopNDetections(std::forward_list<image::Detection>& detections, image::Detection& det)
+bool YoloDecoder::IsStronger(const Candidate& a, const Candidate& b)
 {
-    std::forward_list<image::Detection>::iterator it;
-    std::forward_list<image::Detection>::iterator last_it;
-    for ( it = detections.begin(); it != detections.end(); ++it ) {
-        if(it->objectness > det.objectness)
-            break;
-        last_it = it;
-    }
-    if(it != detections.begin()) {
-        detections.emplace_after(last_it, det);
-        detections.pop_front();
-    }
+    return a.objectness > b.objectness || (a.objectness == b.objectness && a.order > b.order);
 }
 
-void DetectorPostProcess::GetNetworkBoxes(
-        object_detection::Network& net,
-        int imageWidth,
-        int imageHeight,
-        float threshold,
-        std::forward_list<image::Detection>& detections)
+void YoloDecoder::SelectCandidates(const Network& net)
 {
-    int numClasses = net.numClasses;
-    int num = 0;
-    auto det_objectness_comparator = [](image::Detection& pa, image::Detection& pb) {
-        return pa.objectness < pb.objectness;
-    };
+    const int anchorStride = net.numClasses + 5;
+    const bool limited = net.topN > 0;
+
+    this->m_candidates.clear();
+    this->m_numCandidates = 0;
+
+    uint32_t order = 0;
     for (size_t i = 0; i < net.branches.size(); ++i) {
-        int height   = net.branches[i].resolution;
-        int width    = net.branches[i].resolution;
-        int channel  = net.branches[i].numBox*(5+numClasses);
-
-        for (int h = 0; h < net.branches[i].resolution; h++) {
-            for (int w = 0; w < net.branches[i].resolution; w++) {
-                for (int anc = 0; anc < net.branches[i].numBox; anc++) {
-
-                    /* Objectness score */
-                    int bbox_obj_offset = h * width * channel + w * channel + anc * (numClasses + 5) + 4;
-                    float objectness = math::MathUtils::SigmoidF32(
-                            (static_cast<float>(net.branches[i].modelOutput[bbox_obj_offset])
-                            - net.branches[i].zeroPoint
-                            ) * net.branches[i].scale);
-
-                    if(objectness > threshold) {
-                        image::Detection det;
-                        det.objectness = objectness;
-                        /* Get bbox prediction data for each anchor, each feature point */
-                        int bbox_x_offset = bbox_obj_offset -4;
-                        int bbox_y_offset = bbox_x_offset + 1;
-                        int bbox_w_offset = bbox_x_offset + 2;
-                        int bbox_h_offset = bbox_x_offset + 3;
-                        int bbox_scores_offset = bbox_x_offset + 5;
-
-                        det.bbox.x = (static_cast<float>(net.branches[i].modelOutput[bbox_x_offset])
-                                - net.branches[i].zeroPoint) * net.branches[i].scale;
-                        det.bbox.y = (static_cast<float>(net.branches[i].modelOutput[bbox_y_offset])
-                                - net.branches[i].zeroPoint) * net.branches[i].scale;
-                        det.bbox.w = (static_cast<float>(net.branches[i].modelOutput[bbox_w_offset])
-                                - net.branches[i].zeroPoint) * net.branches[i].scale;
-                        det.bbox.h = (static_cast<float>(net.branches[i].modelOutput[bbox_h_offset])
-                                - net.branches[i].zeroPoint) * net.branches[i].scale;
-
-                        float bbox_x, bbox_y;
-
-                        /* Eliminate grid sensitivity trick involved in YOLOv4 */
-                        bbox_x = math::MathUtils::SigmoidF32(det.bbox.x);
-                        bbox_y = math::MathUtils::SigmoidF32(det.bbox.y);
-                        det.bbox.x = (bbox_x + w) / width;
-                        det.bbox.y = (bbox_y + h) / height;
-
-                        det.bbox.w = std::exp(det.bbox.w) * net.branches[i].anchor[anc*2] / net.inputWidth;
-                        det.bbox.h = std::exp(det.bbox.h) * net.branches[i].anchor[anc*2+1] / net.inputHeight;
-
-                        for (int s = 0; s < numClasses; s++) {
-                            float sig = math::MathUtils::SigmoidF32(
-                                    (static_cast<float>(net.branches[i].modelOutput[bbox_scores_offset + s]) -
-                                    net.branches[i].zeroPoint) * net.branches[i].scale
-                                    ) * objectness;
-                            det.prob.emplace_back((sig > threshold) ? sig : 0);
-                        }
+        const Branch& branch = net.branches[i];
+        const int16_t cutoff = this->m_cutoffs[i];
+        const int8_t* anchorOutput = branch.modelOutput;
+
+        for (int h = 0; h < branch.resolution; h++) {
+            for (int w = 0; w < branch.resolution; w++) {
+                for (int anc = 0; anc < branch.numBox; anc++, anchorOutput += anchorStride, ++order) {
+                    if (anchorOutput[4] < cutoff) {
+                        continue;
+                    }
+                    ++this->m_numCandidates;
+
+                    const Candidate candidate{anchorOutput, order,
+                                              static_cast<uint16_t>(w), static_cast<uint16_t>(h),
+                                              static_cast<uint8_t>(i), static_cast<uint8_t>(anc),
+                                              anchorOutput[4]};
 
-                        /* Correct_YOLO_boxes */
-                        det.bbox.x *= imageWidth;
-                        det.bbox.w *= imageWidth;
-                        det.bbox.y *= imageHeight;
-                        det.bbox.h *= imageHeight;
-
-                        if (num < net.topN || net.topN <=0) {
-                            detections.emplace_front(det);
-                            num += 1;
-                        } else if (num == net.topN) {
-                            detections.sort(det_objectness_comparator);
-                            InsertTopNDetections(detections, det);
-                            num += 1;
-                        } else {
-                            InsertTopNDetections(detections, det);
+                    if (this->m_candidates.size() < this->m_maxCandidates) {
+                        this->m_candidates.push_back(candidate);
+                        if (limited) {
+                            std::push_heap(this->m_candidates.begin(), this->m_candidates.end(), IsStronger);
                         }
+                    } else if (IsStronger(candidate, this->m_candidates.front())) {
+                        /* Replace the weakest candidate. */
+                        std::pop_heap(this->m_candidates.begin(), this->m_candidates.end(), IsStronger);
+                        this->m_candidates.back() = candidate;
+                        std::push_heap(this->m_candidates.begin(), this->m_candidates.end(), IsStronger);
                     }
                 }
             }
         }
     }
-    if(num > net.topN)
-        num -=1;
+
+    if (limited) {
+        std::sort(this->m_candidates.begin(), this->m_candidates.end(),
+                  [](const Candidate& a, const Candidate& b) { return a.order < b.order; });
+    }
 }
 
+float YoloDecoder::DecodeBox(const Network& net, const Candidate& candidate,
+                             int imageWidth, int imageHeight, image::Box& box) const
+{
+    const Branch& branch = net.branches[candidate.branch];
+    const int8_t* output = candidate.output;
+    const int width = branch.resolution;
+    const int height = branch.resolution;
+    const int anc = candidate.anchor;
+
+    auto dequantise = [&branch](int8_t value) {
+        return (static_cast<float>(value) - branch.zeroPoint) * branch.scale;
+    };
+
+    /* Eliminate grid sensitivity trick involved in YOLOv4 */
+    box.x = (math::MathUtils::SigmoidF32(dequantise(output[0])) + candidate.cellX) / width;
+    box.y = (math::MathUtils::SigmoidF32(dequantise(output[1])) + candidate.cellY) / height;
+    box.w = std::exp(dequantise(output[2])) * branch.anchor[anc*2] / net.inputWidth;
+    box.h = std::exp(dequantise(output[3])) * branch.anchor[anc*2+1] / net.inputHeight;
+
+    /* Correct_YOLO_boxes */
+    box.x *= imageWidth;
+    box.w *= imageWidth;
+    box.y *= imageHeight;
+    box.h *= imageHeight;
+
+    return math::MathUtils::SigmoidF32(dequantise(candidate.objectness));
+}
+
+float YoloDecoder::GetClassScore(const Network& net, const Candidate& candidate,
+                                 float objectness, int classIdx) const
+{
+    const Branch& branch = net.branches[candidate.branch];
+    float sig = math::MathUtils::SigmoidF32(
+            (static_cast<float>(candidate.output[5 + classIdx]) - branch.zeroPoint) * branch.scale
+            ) * objectness;
+    return (sig > this->m_threshold) ? sig : 0;
+}
+
+void YoloDecoder::Decode(const Network& net, int imageWidth, int imageHeight,
+                         std::forward_list<image::Detection>& detections)
+{
+    this->SelectCandidates(net);
+
+    for (const Candidate& candidate : this->m_candidates) {
+        image::Detection det;
+        det.objectness = this->DecodeBox(net, candidate, imageWidth, imageHeight, det.bbox);
+
+        det.prob.reserve(net.numClasses);
+        for (int s = 0; s < net.numClasses; s++) {
+            det.prob.emplace_back(this->GetClassScore(net, candidate, det.objectness, s));
+        }
+
+        detections.emplace_front(std::move(det));
+    }
+}
+
+void YoloDecoder::Decode(const Network& net, int imageWidth, int imageHeight, image::NmsBoxes& boxes)
+{
+    this->SelectCandidates(net);
+
+    boxes.Clear();
+    boxes.Reserve(this->m_maxCandidates * net.numClasses);
+
+    for (auto it = this->m_candidates.rbegin(); it != this->m_candidates.rend(); ++it) {
+        image::Box box;
+        const float objectness = this->DecodeBox(net, *it, imageWidth, imageHeight, box);
+
+        for (int s = 0; s < net.numClasses; s++) {
+            const float score = this->GetClassScore(net, *it, objectness, s);
+            if (score > 0) {
+                boxes.Add(box, score, s);
+            }
+        }
+    }
+}
+
+size_t YoloDecoder::GetNumCandidates() const
+{
+    return this->m_numCandidates;
+}
+
+} /* namespace object_detection */
+
 } /* namespace app */
 } /* namespace arm */
@@ -34,17 +34,17 @@ namespace app {
 
         auto input = static_cast<const uint8_t*>(data);
 
-        if (this->m_rgb2Gray) {
+        if (this->m_rgb2Gray && this->m_convertToInt8) {
+            image::RgbToGrayscaleInt8(input, this->m_inputTensor->data.int8, this->m_inputTensor->bytes);
+        } else if (this->m_rgb2Gray) {
             image::RgbToGrayscale(input, this->m_inputTensor->data.uint8, this->m_inputTensor->bytes);
+        } else if (this->m_convertToInt8) {
+            image::ConvertImgToInt8(input, this->m_inputTensor->data.int8, inputSize);
         } else {
             std::memcpy(this->m_inputTensor->data.data, input, inputSize);
         }
         debug("Input tensor populated \n");
 
-        if (this->m_convertToInt8) {
-            image::ConvertImgToInt8(this->m_inputTensor->data.data, this->m_inputTensor->bytes);
-        }
-
         return true;
     }
 
@@ -20,6 +20,7 @@
 #include "BaseProcessing.hpp"
 #include "Model.hpp"
 #include "Classifier.hpp"
+#include "ImageUtils.hpp"
 
 namespace arm {
 namespace app {
@@ -51,6 +52,7 @@ namespace app {
     private:
         TfLiteTensor* m_inputTensor;
         bool m_rgb2Gray;
+        int8_t m_quantLut[image::PixelLutSize]; /* Pixel value to quantised input value. */
     };
 
     /**
@@ -26,7 +26,13 @@ namespace app {
     VisualWakeWordPreProcess::VisualWakeWordPreProcess(TfLiteTensor* inputTensor, bool rgb2Gray)
     :m_inputTensor{inputTensor},
      m_rgb2Gray{rgb2Gray}
-    {}
+    {
+        /* VWW model pre-processing is image conversion from uint8 to [0,1] float values,
+         * then quantize them with input quantization info. Every pixel value maps to a
+         * fixed int8 value, so the conversion is tabulated once. */
+        QuantParams inQuantParams = GetTensorQuantParams(this->m_inputTensor);
+        image::GetNormalisedInt8Lut(inQuantParams.scale, inQuantParams.offset, this->m_quantLut);
+    }
 
     bool VisualWakeWordPreProcess::DoPreProcess(const void* data, size_t inputSize)
     {
@@ -35,25 +41,13 @@ namespace app {
         }
 
         auto input = static_cast<const uint8_t*>(data);
-
-        uint8_t* unsignedDstPtr = this->m_inputTensor->data.uint8;
+        int8_t* signedDstPtr = this->m_inputTensor->data.int8;
 
         if (this->m_rgb2Gray) {
-            image::RgbToGrayscale(input, unsignedDstPtr, inputSize);
+            image::RgbToGrayscaleInt8(input, signedDstPtr, this->m_inputTensor->bytes, this->m_quantLut);
         } else {
-            std::memcpy(unsignedDstPtr, input, inputSize);
-        }
-
-        /* VWW model pre-processing is image conversion from uint8 to [0,1] float values,
-         * then quantize them with input quantization info. */
-        QuantParams inQuantParams = GetTensorQuantParams(this->m_inputTensor);
-
-        int8_t* signedDstPtr = this->m_inputTensor->data.int8;
-        for (size_t i = 0; i < this->m_inputTensor->bytes; i++) {
-            auto i_data_int8 = static_cast<int8_t>(
-                    ((static_cast<float>(unsignedDstPtr[i]) / 255.0f) / inQuantParams.scale) + inQuantParams.offset
-                    );
-            signedDstPtr[i] = std::min<int8_t>(INT8_MAX, std::max<int8_t>(i_data_int8, INT8_MIN));
+            image::ConvertImgToInt8(input, signedDstPtr,
+                                    std::min(inputSize, this->m_inputTensor->bytes), this->m_quantLut);
         }
 
         debug("Input tensor populated \n");
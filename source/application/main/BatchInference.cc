@@ -0,0 +1,166 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "BatchInference.hpp"
+#include "log_macros.h"
+
+#include <cinttypes>
+#include <cstring>
+
+namespace arm {
+namespace app {
+
+    BatchInference::BatchInference(Model& model)
+    :   m_model{model}
+    {}
+
+    bool BatchInference::Run(const size_t numWindows, const WindowFunction& preProcess,
+                             const WindowFunction& postProcess)
+    {
+        if (!this->m_model.IsInited()) {
+            printf_err("Model is not initialised\n");
+            return false;
+        }
+
+        const size_t inputBytes = this->GetInputBytes();
+        const size_t outputBytes = this->GetOutputBytes();
+        this->m_inputs.resize(numWindows * inputBytes);
+        this->m_outputs.resize(numWindows * outputBytes);
+        this->m_stageResults.clear();
+        this->m_numWindows = numWindows;
+
+        /* Pre-process all windows, saving the input tensors of each. */
+        this->m_profiler.StartProfiling("Batch pre-processing");
+        for (size_t i = 0; i < numWindows; ++i) {
+            if (!preProcess(i)) {
+                printf_err("Pre-processing failed for window %zu\n", i);
+                this->m_profiler.StopProfilingAndReset();
+                return false;
+            }
+            uint8_t* saved = this->m_inputs.data() + i * inputBytes;
+            for (size_t t = 0; t < this->m_model.GetNumInputs(); ++t) {
+                const TfLiteTensor* tensor = this->m_model.GetInputTensor(t);
+                std::memcpy(saved, tensor->data.data, tensor->bytes);
+                saved += tensor->bytes;
+            }
+        }
+        this->m_profiler.StopProfiling();
+        this->m_profiler.GetAllResultsAndReset(this->m_stageResults);
+
+        /* Run inference on all windows back to back, saving the output tensors of each. */
+        this->m_profiler.StartProfiling("Batch inference");
+        for (size_t i = 0; i < numWindows; ++i) {
+            const uint8_t* saved = this->m_inputs.data() + i * inputBytes;
+            for (size_t t = 0; t < this->m_model.GetNumInputs(); ++t) {
+                TfLiteTensor* tensor = this->m_model.GetInputTensor(t);
+                std::memcpy(tensor->data.data, saved, tensor->bytes);
+                saved += tensor->bytes;
+            }
+
+            if (!this->m_model.RunInference()) {
+                printf_err("Inference failed for window %zu\n", i);
+                this->m_profiler.StopProfilingAndReset();
+                return false;
+            }
+
+            uint8_t* out = this->m_outputs.data() + i * outputBytes;
+            for (size_t t = 0; t < this->m_model.GetNumOutputs(); ++t) {
+                const TfLiteTensor* tensor = this->m_model.GetOutputTensor(t);
+                std::memcpy(out, tensor->data.data, tensor->bytes);
+                out += tensor->bytes;
+            }
+        }
+        this->m_profiler.StopProfiling();
+        this->m_profiler.GetAllResultsAndReset(this->m_stageResults);
+
+        /* Post-process all windows from their saved output tensors. */
+        this->m_profiler.StartProfiling("Batch post-processing");
+        for (size_t i = 0; i < numWindows; ++i) {
+            const uint8_t* out = this->m_outputs.data() + i * outputBytes;
+            for (size_t t = 0; t < this->m_model.GetNumOutputs(); ++t) {
+                TfLiteTensor* tensor = this->m_model.GetOutputTensor(t);
+                std::memcpy(tensor->data.data, out, tensor->bytes);
+                out += tensor->bytes;
+            }
+
+            if (!postProcess(i)) {
+                printf_err("Post-processing failed for window %zu\n", i);
+                this->m_profiler.StopProfilingAndReset();
+                return false;
+            }
+        }
+        this->m_profiler.StopProfiling();
+        this->m_profiler.GetAllResultsAndReset(this->m_stageResults);
+
+        return true;
+    }
+
+    void BatchInference::PrintStats() const
+    {
+        if (this->m_numWindows == 0 || this->m_stageResults.empty()) {
+            return;
+        }
+
+        info("Batch of %zu windows:\n", this->m_numWindows);
+        std::vector<uint64_t> totals(this->m_stageResults[0].data.size(), 0);
+        for (const auto& result : this->m_stageResults) {
+            info("Profile for %s:\n", result.name.c_str());
+            for (size_t i = 0; i < result.data.size(); ++i) {
+                const Statistics& stat = result.data[i];
+                info("%s: %" PRIu64 " %s, %.0f %s per window\n",
+                     stat.name.c_str(), stat.total, stat.unit.c_str(),
+                     static_cast<double>(stat.total) / this->m_numWindows, stat.unit.c_str());
+                if (i < totals.size()) {
+                    totals[i] += stat.total;
+                }
+            }
+        }
+
+        /* Throughput over all passes, in windows per second where the counter is a time. */
+        const std::vector<Statistics>& counters = this->m_stageResults[0].data;
+        for (size_t i = 0; i < totals.size(); ++i) {
+            if (totals[i] == 0) {
+                continue;
+            }
+            if (counters[i].unit == "microseconds") {
+                info("Throughput: %.1f windows/s\n", this->m_numWindows * 1e6 / totals[i]);
+            } else {
+                info("Throughput (%s): %.0f %s per window\n", counters[i].name.c_str(),
+                     static_cast<double>(totals[i]) / this->m_numWindows, counters[i].unit.c_str());
+            }
+        }
+    }
+
+    size_t BatchInference::GetInputBytes() const
+    {
+        size_t bytes = 0;
+        for (size_t t = 0; t < this->m_model.GetNumInputs(); ++t) {
+            bytes += this->m_model.GetInputTensor(t)->bytes;
+        }
+        return bytes;
+    }
+
+    size_t BatchInference::GetOutputBytes() const
+    {
+        size_t bytes = 0;
+        for (size_t t = 0; t < this->m_model.GetNumOutputs(); ++t) {
+            bytes += this->m_model.GetOutputTensor(t)->bytes;
+        }
+        return bytes;
+    }
+
+} /* namespace app */
+} /* namespace arm */
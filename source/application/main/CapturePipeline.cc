@@ -0,0 +1,275 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "CapturePipeline.hpp"
+#include "hal.h"
+#include "log_macros.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+
+namespace arm {
+namespace app {
+
+    HalCameraSource::HalCameraSource(uint8_t* buffer0, uint8_t* buffer1, uint32_t bufferSize):
+        m_buffers{buffer0, buffer1},
+        m_bufferSize{bufferSize}
+    {}
+
+    bool HalCameraSource::StartCapture(uint32_t slot)
+    {
+        (void)slot;
+        return hal_camera_start();
+    }
+
+    const uint8_t* HalCameraSource::WaitCapture(uint32_t slot, uint32_t& size)
+    {
+        size = 0;
+        if (slot > 1) {
+            printf_err("Invalid buffer slot %" PRIu32 "\n", slot);
+            return nullptr;
+        }
+
+        /* The raw frame is converted into the output buffer while collecting it. */
+        if (this->m_buffers[slot] &&
+                !hal_camera_set_buffer(this->m_buffers[slot], this->m_bufferSize)) {
+            printf_err("Failed to set camera buffer for slot %" PRIu32 "\n", slot);
+            return nullptr;
+        }
+
+        const uint8_t* frame = hal_camera_get_captured_frame(&size);
+        if (!frame || !size) {
+            size = 0;
+            return nullptr;
+        }
+        return frame;
+    }
+
+    StaticImageSource::StaticImageSource(const uint8_t* const* images, size_t numImages,
+                                         uint32_t imageSize, bool loop):
+        m_images{images},
+        m_numImages{numImages},
+        m_imageSize{imageSize},
+        m_loop{loop},
+        m_buffers{std::vector<uint8_t>(imageSize), std::vector<uint8_t>(imageSize)}
+    {}
+
+    bool StaticImageSource::StartCapture(uint32_t slot)
+    {
+        if (slot > 1) {
+            printf_err("Invalid buffer slot %" PRIu32 "\n", slot);
+            return false;
+        }
+
+        if (this->m_captured[slot]) {
+            ++this->m_dropped;
+        }
+
+        if (this->m_nextImage >= this->m_numImages && this->m_loop) {
+            this->m_nextImage = 0;
+        }
+
+        /* Past the last image the capture succeeds but yields no frame. */
+        this->m_valid[slot] = this->m_nextImage < this->m_numImages;
+        if (this->m_valid[slot]) {
+            std::memcpy(this->m_buffers[slot].data(),
+                        this->m_images[this->m_nextImage++], this->m_imageSize);
+        }
+        this->m_captured[slot] = true;
+        ++this->m_numCaptures;
+        return true;
+    }
+
+    const uint8_t* StaticImageSource::WaitCapture(uint32_t slot, uint32_t& size)
+    {
+        size = 0;
+        if (slot > 1 || !this->m_captured[slot]) {
+            printf_err("No capture started for slot %" PRIu32 "\n", slot);
+            return nullptr;
+        }
+
+        this->m_captured[slot] = false;
+        if (!this->m_valid[slot]) {
+            return nullptr;
+        }
+        size = this->m_imageSize;
+        return this->m_buffers[slot].data();
+    }
+
+    uint32_t StaticImageSource::GetDroppedFrames() const
+    {
+        return this->m_dropped;
+    }
+
+    uint32_t StaticImageSource::GetNumCaptures() const
+    {
+        return this->m_numCaptures;
+    }
+
+    CapturePipeline::CapturePipeline(FrameSource& source):
+        m_source{source},
+        m_sourceDropBase{source.GetDroppedFrames()}
+    {}
+
+    bool CapturePipeline::Step(const ProcessStage& process)
+    {
+        if (!this->m_inFlight) {
+            if (!this->m_source.StartCapture(this->m_slot)) {
+                printf_err("Failed to start capture\n");
+                return false;
+            }
+            this->m_inFlight = true;
+        }
+
+        uint64_t start = 0;
+        uint64_t end = 0;
+        bool timed = this->GetTime(start);
+
+        uint32_t frameSize = 0;
+        const uint8_t* frame = this->m_source.WaitCapture(this->m_slot, frameSize);
+        this->m_inFlight = false;
+
+        if (timed && this->GetTime(end) && end >= start) {
+            this->m_stats.captureWaitTotal += end - start;
+            this->m_stats.captureWaitMax = std::max(this->m_stats.captureWaitMax, end - start);
+        }
+
+        if (!frame) {
+            return false;
+        }
+
+        /* Frame N+1 is captured into the other slot while frame N is processed. */
+        this->m_slot ^= 1;
+        if (this->m_source.StartCapture(this->m_slot)) {
+            this->m_inFlight = true;
+        } else {
+            printf_err("Failed to start capture\n");
+        }
+
+        timed = this->GetTime(start);
+        const bool processed = process(frame, frameSize);
+        timed = timed && this->GetTime(end) && end >= start;
+
+        /* Failed frames usually stop early, so they are kept out of the timings. */
+        if (!processed) {
+            ++this->m_stats.framesFailed;
+            return false;
+        }
+
+        if (timed) {
+            this->m_stats.processTotal += end - start;
+            this->m_stats.processMax = std::max(this->m_stats.processMax, end - start);
+        }
+        ++this->m_stats.framesProcessed;
+        return true;
+    }
+
+    uint32_t CapturePipeline::Run(const ProcessStage& process, uint32_t numFrames)
+    {
+        uint32_t numProcessed = 0;
+        while (0 == numFrames || numProcessed < numFrames) {
+            if (!this->Step(process)) {
+                break;
+            }
+            ++numProcessed;
+        }
+        this->Stop();
+        return numProcessed;
+    }
+
+    void CapturePipeline::Stop()
+    {
+        if (this->m_inFlight) {
+            uint32_t frameSize = 0;
+            if (this->m_source.WaitCapture(this->m_slot, frameSize)) {
+                ++this->m_stats.framesDropped;
+            }
+            this->m_inFlight = false;
+        }
+        this->m_slot = 0;
+    }
+
+    CapturePipelineStats CapturePipeline::GetStats() const
+    {
+        CapturePipelineStats stats = this->m_stats;
+        stats.framesDropped += this->m_source.GetDroppedFrames() - this->m_sourceDropBase;
+        return stats;
+    }
+
+    void CapturePipeline::ResetStats()
+    {
+        const char* unit = this->m_stats.unit;
+        this->m_stats = CapturePipelineStats{};
+        this->m_stats.unit = unit;
+        this->m_sourceDropBase = this->m_source.GetDroppedFrames();
+    }
+
+    void CapturePipeline::PrintStats() const
+    {
+        const CapturePipelineStats stats = this->GetStats();
+        info("Capture pipeline: %" PRIu32 " frames processed, %" PRIu32 " failed, %" PRIu32
+             " dropped\n", stats.framesProcessed, stats.framesFailed, stats.framesDropped);
+
+        /* Every frame handed to the processing stage was waited for. */
+        const uint32_t framesCaptured = stats.framesProcessed + stats.framesFailed;
+        if (!stats.unit || !framesCaptured) {
+            return;
+        }
+        info("\tCapture wait: avg %" PRIu64 " max %" PRIu64 " %s\n",
+             stats.captureWaitTotal / framesCaptured, stats.captureWaitMax, stats.unit);
+        if (stats.framesProcessed) {
+            info("\tProcessing:   avg %" PRIu64 " max %" PRIu64 " %s\n",
+                 stats.processTotal / stats.framesProcessed, stats.processMax, stats.unit);
+        }
+    }
+
+    bool CapturePipeline::GetTime(uint64_t& time)
+    {
+        /* Read the counters without (re)initialising them, as profilers used by the
+         * processing stage may be running. Prefer a wall-clock duration counter;
+         * the CPU cycle counter is only monotonic on some platforms. */
+        pmu_counters counters{};
+        hal_pmu_get_counters(&counters);
+        if (!counters.initialised) {
+            return false;
+        }
+
+        const pmu_counter_unit* timeCounter = nullptr;
+        for (uint32_t i = 0; i < counters.num_counters; ++i) {
+            const char* name = counters.counters[i].name;
+            if (!name) {
+                continue;
+            }
+            if (0 == strcmp(name, "Duration") || 0 == strcmp(name, "DURATION")) {
+                timeCounter = &counters.counters[i];
+                break;
+            }
+            if (0 == strcmp(name, "CPU TOTAL")) {
+                timeCounter = &counters.counters[i];
+            }
+        }
+
+        if (!timeCounter) {
+            return false;
+        }
+        time = timeCounter->value;
+        this->m_stats.unit = timeCounter->unit;
+        return true;
+    }
+
+} /* namespace app */
+} /* namespace arm */
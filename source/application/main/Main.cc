@@ -85,6 +85,7 @@ int main ()
 
     /* This is unreachable without errors. */
     info("program terminating...\n");
+    log_flush();
 
     /* Release platform. */
     hal_platform_release();
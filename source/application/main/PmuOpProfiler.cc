@@ -0,0 +1,59 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "PmuOpProfiler.hpp"
+#include "hal.h"
+#include "log_macros.h"
+
+namespace arm {
+namespace app {
+
+    PmuOpProfiler::PmuOpProfiler()
+    {
+        /* The NPU cycle counter only runs while an Ethos-U operator does, so it
+         * would cost every operator that fell back to the CPU at nothing. */
+        pmu_counter_unit clock{};
+        this->m_hasClock = hal_pmu_get_cpu_clock(&clock);
+        if (!this->m_hasClock) {
+            printf_err("No CPU-side clock available for operator profiling\n");
+            return;
+        }
+
+        this->m_unit = clock.unit;
+        info("Operator profiling with clock \"%s\"\n", clock.name);
+    }
+
+    uint64_t PmuOpProfiler::GetTimestamp()
+    {
+        pmu_counter_unit clock;
+        if (!this->m_hasClock || !hal_pmu_get_cpu_clock(&clock)) {
+            return 0;
+        }
+        return clock.value;
+    }
+
+    const char* PmuOpProfiler::GetUnit() const
+    {
+        return this->m_unit;
+    }
+
+    bool PmuOpProfiler::HasClock() const
+    {
+        return this->m_hasClock;
+    }
+
+} /* namespace app */
+} /* namespace arm */
@@ -17,16 +17,69 @@
 #ifndef APP_CTX_HPP
 #define APP_CTX_HPP
 
+#include "log_macros.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
 #include <map>
 #include <memory>
 #include <string>
+#include <type_traits>
+#include <vector>
+
 namespace arm {
 namespace app {
 
+    /**
+     * @brief   Type tag of attributes saved as T. Each type has its own tag address,
+     *          so attribute types are checked without RTTI.
+     */
+    template<typename T>
+    struct AttributeTag {
+        static constexpr char ms_id{0};
+    };
+
+    /**
+     * @brief   Type an attribute is stored and checked as. References and values are
+     *          told apart; const is kept on referenced types and dropped from values,
+     *          which are copied out.
+     */
+    template<typename T>
+    using AttributeKind = typename std::conditional<std::is_reference<T>::value,
+        typename std::remove_reference<T>::type&,
+        typename std::remove_cv<T>::type>::type;
+
+    /**
+     * @brief   Kind an attribute read as T may also have been saved as: const T& can
+     *          read a T& attribute, as adding const is safe. Removing it is not.
+     */
+    template<typename T>
+    using AttributeMutableKind = typename std::conditional<std::is_reference<T>::value,
+        typename std::remove_const<typename std::remove_reference<T>::type>::type&,
+        AttributeKind<T>>::type;
+
+    template<typename T>
+    constexpr const void* GetAttributeTag()
+    {
+        return &AttributeTag<AttributeKind<T>>::ms_id;
+    }
+
     class IAttribute
     {
     public:
+        explicit IAttribute(const void* tag): m_tag(tag){}
+
         virtual ~IAttribute() = default;
+
+        const void* GetTag() const
+        {
+            return m_tag;
+        }
+    private:
+        const void* m_tag;
     };
 
     template<typename T>
@@ -35,7 +88,7 @@ namespace app {
     public:
         ~Attribute() override = default;
 
-        explicit Attribute(const T value): m_value(value){}
+        explicit Attribute(const T value): IAttribute(GetAttributeTag<T>()), m_value(value){}
 
         T Get()
         {
@@ -45,10 +98,106 @@ namespace app {
         T m_value;
     };
 
+    /**
+     * @brief   Handle to an attribute of type T in an application context. Resolving
+     *          the name once gives constant time, type checked access afterwards.
+     */
+    template<typename T>
+    class ContextKey {
+    public:
+        ContextKey() = default;
+
+        /** @brief  Whether the key was resolved by a context. */
+        bool IsValid() const
+        {
+            return m_slot != ms_invalidSlot;
+        }
+
+    private:
+        friend class ApplicationContext;
+
+        explicit ContextKey(const size_t slot): m_slot(slot){}
+
+        static constexpr size_t ms_invalidSlot = SIZE_MAX;
+        size_t m_slot{ms_invalidSlot};
+    };
+
     /* Application context class */
     class ApplicationContext {
     public:
 
+        /**
+         * @brief     Resolves an attribute name to a key. The attribute does not need
+         *            to be set yet; the key stays valid for the lifetime of the context.
+         * @tparam    T value type.
+         * @param[in] name   Context attribute name.
+         * @return    Key to the attribute.
+         */
+        template<typename T>
+        ContextKey<T> GetKey(const std::string& name)
+        {
+            auto it = this->m_slotIndex.find(name);
+            if (it == this->m_slotIndex.end()) {
+                it = this->m_slotIndex.emplace(name, this->m_attributes.size()).first;
+                this->m_attributes.emplace_back();
+            }
+            return ContextKey<T>{it->second};
+        }
+
+        /**
+         * @brief     Saves given value as the attribute of the given key.
+         * @tparam    T value type.
+         * @param[in] key      Key resolved by this context.
+         * @param[in] object   Value to save in the context.
+         */
+        template<typename T>
+        void Set(const ContextKey<T> key, T object)
+        {
+            assert(key.m_slot < this->m_attributes.size());
+            this->m_attributes[key.m_slot] =
+                std::make_unique<Attribute<AttributeKind<T>>>(object);
+        }
+
+        /**
+         * @brief      Gets the saved attribute of the given key. The attribute must
+         *             have been set with the same type, or T must add const to a
+         *             saved reference. Otherwise the error is reported and the
+         *             application aborts, in all builds.
+         * @tparam     T value type.
+         * @param[in]  key   Key resolved by this context.
+         * @return     Value saved in the context.
+         */
+        template<typename T>
+        T Get(const ContextKey<T> key)
+        {
+            if (!this->Has(key)) {
+                printf_err("Context attribute in slot %zu is not set as the requested type\n",
+                           key.m_slot);
+                Fail();
+            }
+            IAttribute* attribute = this->m_attributes[key.m_slot].get();
+            if (attribute->GetTag() == GetAttributeTag<T>()) {
+                return static_cast<Attribute<AttributeKind<T>>*>(attribute)->Get();
+            }
+            return static_cast<Attribute<AttributeMutableKind<T>>*>(attribute)->Get();
+        }
+
+        /**
+         * @brief      Checks if the attribute of the given key can be read as type T.
+         * @param[in]  key   Key resolved by this context.
+         * @return     true if attribute exists with type T, false otherwise
+         */
+        template<typename T>
+        bool Has(const ContextKey<T> key) const
+        {
+            if (key.m_slot >= this->m_attributes.size() || !this->m_attributes[key.m_slot]) {
+                return false;
+            }
+            const void* tag = this->m_attributes[key.m_slot]->GetTag();
+            return tag == GetAttributeTag<T>() ||
+                   tag == &AttributeTag<AttributeMutableKind<T>>::ms_id;
+        }
+
         /**
          * @brief     Saves given value as a named attribute in the context.
          * @tparam    T value type.
@@ -58,26 +207,25 @@ namespace app {
         template<typename T>
         void Set(const std::string &name, T object)
         {
-            /* Attribute exists; reset the smart pointer */
-            if (this->Has(name)) {
-              this->m_attributes.at(name).reset();
-            }
-            this->m_attributes[name] = std::make_unique<Attribute<T>>(object);
+            this->Set<T>(this->GetKey<T>(name), object);
         }
 
         /**
          * @brief      Gets the saved attribute from the context by the given name.
+         *             Prefer a key from GetKey where the attribute is read repeatedly.
          * @tparam     T value type.
          * @param[in]  name   Context attribute name.
          * @return     Value saved in the context.
          */
-
         template <typename T>
         T Get(const std::string& name)
         {
-            //TODO Add logic to handle access of non-existent attribute
-            auto attributeValue = (Attribute<T>*)m_attributes.at(name).get();
-            return attributeValue->Get(); 
+            auto it = this->m_slotIndex.find(name);
+            if (it == this->m_slotIndex.end()) {
+                printf_err("Context attribute %s is not set\n", name.c_str());
+                Fail();
+            }
+            return this->Get<T>(ContextKey<T>{it->second});
         }
 
         /**
@@ -85,9 +233,10 @@ namespace app {
          * @param[in]  name   Attribute name.
          * @return     true if attribute exists, false otherwise
          */
-        bool Has(const std::string& name)
+        bool Has(const std::string& name) const
         {
-            return m_attributes.find(name) != m_attributes.end();
+            auto it = this->m_slotIndex.find(name);
+            return it != this->m_slotIndex.end() && this->m_attributes[it->second];
         }
 
         ApplicationContext() = default;
@@ -95,7 +244,16 @@ namespace app {
         ~ApplicationContext() = default;
 
     private:
-        std::map<std::string, std::unique_ptr<IAttribute>> m_attributes;
+        /** @brief  Failure path of a bad Get: flushes the log and aborts. */
+        [[noreturn]] static void Fail()
+        {
+            log_flush();
+            fflush(stdout);
+            std::abort();
+        }
+
+        std::map<std::string, size_t> m_slotIndex;                 /* Attribute name to slot. */
+        std::vector<std::unique_ptr<IAttribute>> m_attributes;     /* Attribute of each slot. */
     };
 
 } /* namespace app */
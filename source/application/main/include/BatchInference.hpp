@@ -0,0 +1,89 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef BATCH_INFERENCE_HPP
+#define BATCH_INFERENCE_HPP
+
+#include "Model.hpp"
+#include "Profiler.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace arm {
+namespace app {
+
+    /**
+     * @brief   Runs inference over all the windows of a stored clip in three passes:
+     *          pre-processing of every window, inference of every window back to back,
+     *          then post-processing of every window. The model input and output tensors
+     *          of each window are kept between passes. Pre-processing runs over the
+     *          windows in order, so overlapping features are still taken from the
+     *          pre-processing's own cache, and nothing else runs between inferences.
+     *          Each pass is profiled; PrintStats reports the per-stage breakdown and
+     *          the throughput.
+     */
+    class BatchInference {
+    public:
+        /**
+         * @brief   Function processing one window, given its index.
+         *          Returns true if successful, false otherwise.
+         */
+        using WindowFunction = std::function<bool (size_t windowIdx)>;
+
+        /**
+         * @brief       Constructor.
+         * @param[in]   model   Initialised model to run.
+         **/
+        explicit BatchInference(Model& model);
+
+        /**
+         * @brief       Runs the three passes over a clip.
+         * @param[in]   numWindows    Number of windows in the clip.
+         * @param[in]   preProcess    Populates the model input tensors for a window.
+         * @param[in]   postProcess   Consumes the model output tensors of a window.
+         * @return      true if all windows were processed, false otherwise.
+         **/
+        bool Run(size_t numWindows, const WindowFunction& preProcess,
+                 const WindowFunction& postProcess);
+
+        /**
+         * @brief   Logs the profiling results of each pass of the last run, per
+         *          window, and the throughput.
+         **/
+        void PrintStats() const;
+
+    private:
+        Model&                      m_model;
+        Profiler                    m_profiler{"batch"};
+        std::vector<uint8_t>        m_inputs{};         /* Input tensors of all windows. */
+        std::vector<uint8_t>        m_outputs{};        /* Output tensors of all windows. */
+        std::vector<ProfileResult>  m_stageResults{};   /* One result per pass of the last run. */
+        size_t                      m_numWindows{0};    /* Windows of the last run. */
+
+        /** @brief  Sum of the byte sizes of the model input tensors. */
+        size_t GetInputBytes() const;
+
+        /** @brief  Sum of the byte sizes of the model output tensors. */
+        size_t GetOutputBytes() const;
+    };
+
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* BATCH_INFERENCE_HPP */
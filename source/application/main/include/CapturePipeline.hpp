@@ -0,0 +1,230 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CAPTURE_PIPELINE_HPP
+#define CAPTURE_PIPELINE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace arm {
+namespace app {
+
+    /**
+     * @brief   Source of frames for a CapturePipeline. Capturing a frame is split
+     *          in two calls so that the capture of the next frame can be started
+     *          while the current one is still being processed. Frames are written
+     *          to one of two buffer slots; the pipeline never starts a capture into
+     *          the slot holding the frame being processed.
+     */
+    class FrameSource {
+    public:
+        virtual ~FrameSource() = default;
+
+        /**
+         * @brief       Starts capturing a frame into a buffer slot. Must not block
+         *              for the duration of the capture.
+         * @param[in]   slot   Buffer slot, 0 or 1.
+         * @return      true if the capture was started, false otherwise.
+         */
+        virtual bool StartCapture(uint32_t slot) = 0;
+
+        /**
+         * @brief       Waits for the capture started into a buffer slot to complete.
+         * @param[in]   slot   Buffer slot, 0 or 1.
+         * @param[out]  size   Size of the captured frame in bytes.
+         * @return      Pointer to the captured frame, nullptr if no frame could be
+         *              captured (end of stream or error).
+         */
+        virtual const uint8_t* WaitCapture(uint32_t slot, uint32_t& size) = 0;
+
+        /**
+         * @brief   Gets the number of frames the source itself had to drop, for
+         *          example because the sensor overwrote a frame nobody collected.
+         * @return  Number of frames dropped by the source.
+         */
+        virtual uint32_t GetDroppedFrames() const
+        {
+            return 0;
+        }
+    };
+
+    /**
+     * @brief   Frame source backed by the HAL camera. The HAL starts the sensor
+     *          transfer in hal_camera_start and converts the captured raw frame in
+     *          hal_camera_get_captured_frame, so the conversion of frame N+1 only
+     *          happens once frame N has been processed. A single output buffer is
+     *          therefore enough; two distinct buffers can be given if the frame
+     *          has to outlive the next capture (e.g. while it is being displayed).
+     */
+    class HalCameraSource : public FrameSource {
+    public:
+        /** @brief  Constructor using the buffer configured in the HAL. */
+        HalCameraSource() = default;
+
+        /**
+         * @brief       Constructor using one caller-owned output buffer per slot.
+         * @param[in]   buffer0      Output buffer for slot 0.
+         * @param[in]   buffer1      Output buffer for slot 1.
+         * @param[in]   bufferSize   Size of each buffer in bytes.
+         */
+        HalCameraSource(uint8_t* buffer0, uint8_t* buffer1, uint32_t bufferSize);
+
+        bool StartCapture(uint32_t slot) override;
+
+        const uint8_t* WaitCapture(uint32_t slot, uint32_t& size) override;
+
+    private:
+        uint8_t*    m_buffers[2]{nullptr, nullptr};   /* Optional output buffers per slot. */
+        uint32_t    m_bufferSize{0};                  /* Size of each output buffer. */
+    };
+
+    /**
+     * @brief   Frame source serving a list of static images; stands in for a camera
+     *          where none is available, for example in native tests. Each capture
+     *          copies the next image into the buffer of its slot, like a camera
+     *          writing to memory would. Starting a capture into a slot whose
+     *          previous frame was never collected counts as a dropped frame.
+     */
+    class StaticImageSource : public FrameSource {
+    public:
+        /**
+         * @brief       Constructor.
+         * @param[in]   images      Array of pointers to the images to serve.
+         * @param[in]   numImages   Number of images in the array.
+         * @param[in]   imageSize   Size of each image in bytes.
+         * @param[in]   loop        If true, restarts from the first image once the last
+         *                          one has been served, otherwise ends the stream.
+         */
+        StaticImageSource(const uint8_t* const* images, size_t numImages,
+                          uint32_t imageSize, bool loop = false);
+
+        bool StartCapture(uint32_t slot) override;
+
+        const uint8_t* WaitCapture(uint32_t slot, uint32_t& size) override;
+
+        uint32_t GetDroppedFrames() const override;
+
+        /**
+         * @brief   Gets the number of captures started so far.
+         * @return  Number of captures started.
+         */
+        uint32_t GetNumCaptures() const;
+
+    private:
+        const uint8_t* const*   m_images;                   /* Images to serve. */
+        size_t                  m_numImages;                /* Number of images. */
+        uint32_t                m_imageSize;                /* Size of each image. */
+        bool                    m_loop;                     /* Restart after the last image. */
+        size_t                  m_nextImage{0};             /* Index of the next image to serve. */
+        std::vector<uint8_t>    m_buffers[2];               /* Buffer per slot. */
+        bool                    m_captured[2]{false, false};/* Slot holds an uncollected frame. */
+        bool                    m_valid[2]{false, false};   /* Slot capture produced a frame. */
+        uint32_t                m_numCaptures{0};           /* Captures started. */
+        uint32_t                m_dropped{0};               /* Frames overwritten uncollected. */
+    };
+
+    /** Statistics kept by a CapturePipeline. */
+    struct CapturePipelineStats {
+        uint32_t    framesProcessed{0};     /* Frames the processing stage succeeded on. */
+        uint32_t    framesFailed{0};        /* Frames the processing stage failed on. */
+        uint32_t    framesDropped{0};       /* Frames captured but never processed. */
+        uint64_t    captureWaitTotal{0};    /* Time spent waiting for captures to complete. */
+        uint64_t    captureWaitMax{0};      /* Longest wait for a capture. */
+        uint64_t    processTotal{0};        /* Time spent processing the successful frames. */
+        uint64_t    processMax{0};          /* Longest successful run of the processing stage. */
+        const char* unit{nullptr};          /* Unit of the times, nullptr if not measured. */
+    };
+
+    /**
+     * @brief   Two-stage capture/processing pipeline. While frame N is being
+     *          processed (pre-processing, inference, post-processing) by the
+     *          caller, frame N+1 is already being captured into the other buffer
+     *          slot of the frame source. Keeps per-stage timings, taken from the
+     *          platform counters, and the number of frames dropped.
+     */
+    class CapturePipeline {
+    public:
+        /**
+         * Processing stage: given the captured frame and its size in bytes, returns
+         * false to stop the pipeline. The frame remains valid until the stage returns.
+         */
+        using ProcessStage = std::function<bool(const uint8_t* frame, uint32_t size)>;
+
+        /**
+         * @brief       Constructor.
+         * @param[in]   source   Frame source to capture from.
+         */
+        explicit CapturePipeline(FrameSource& source);
+
+        /**
+         * @brief       Collects the frame in flight, starts capturing the next one and
+         *              runs the processing stage over the collected frame. The first
+         *              call also starts the first capture.
+         * @param[in]   process   Processing stage.
+         * @return      true if a frame was processed successfully, false at the end of
+         *              the stream, on capture error or if the processing stage failed.
+         */
+        bool Step(const ProcessStage& process);
+
+        /**
+         * @brief       Runs Step until the stream ends, the processing stage fails or
+         *              the given number of frames has been processed, then stops.
+         * @param[in]   process     Processing stage.
+         * @param[in]   numFrames   Maximum number of frames to process, 0 for no limit.
+         * @return      Number of frames processed successfully.
+         */
+        uint32_t Run(const ProcessStage& process, uint32_t numFrames = 0);
+
+        /**
+         * @brief   Stops the pipeline. A capture still in flight is collected and
+         *          counted as dropped. The next Step starts over.
+         */
+        void Stop();
+
+        /**
+         * @brief   Gets the pipeline statistics, including frames dropped by the source.
+         * @return  Pipeline statistics.
+         */
+        CapturePipelineStats GetStats() const;
+
+        /** @brief  Clears the pipeline statistics. */
+        void ResetStats();
+
+        /** @brief  Prints the pipeline statistics. */
+        void PrintStats() const;
+
+    private:
+        /**
+         * @brief       Reads the time counter from the platform counters.
+         * @param[out]  time   Current time.
+         * @return      true if the platform provides a time counter.
+         */
+        bool GetTime(uint64_t& time);
+
+        FrameSource&            m_source;               /* Source of the frames. */
+        uint32_t                m_slot{0};              /* Slot of the capture in flight. */
+        bool                    m_inFlight{false};      /* A capture has been started. */
+        CapturePipelineStats    m_stats;                /* Statistics. */
+        uint32_t                m_sourceDropBase{0};    /* Source drops at last reset. */
+    };
+
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* CAPTURE_PIPELINE_HPP */
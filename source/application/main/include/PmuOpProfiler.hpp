@@ -0,0 +1,51 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef PMU_OP_PROFILER_HPP
+#define PMU_OP_PROFILER_HPP
+
+#include "OpProfiler.hpp"
+
+#include <cstdint>
+
+namespace arm {
+namespace app {
+
+    /**
+     * @brief   Per-operator profiler costing operators with the platform's CPU-side
+     *          clock (the SysTick cycle count on Arm targets, the duration in
+     *          microseconds on the native platform). Unlike the NPU cycle counter,
+     *          it runs for operators that fell back to the CPU too. Without such a
+     *          clock, no results are printed.
+     */
+    class PmuOpProfiler : public OpProfiler {
+    public:
+        PmuOpProfiler();
+
+    protected:
+        uint64_t GetTimestamp() override;
+        const char* GetUnit() const override;
+        bool HasClock() const override;
+
+    private:
+        bool m_hasClock = false;            /* The platform has a CPU-side clock. */
+        const char* m_unit = "";            /* Unit of that clock. */
+    };
+
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* PMU_OP_PROFILER_HPP */
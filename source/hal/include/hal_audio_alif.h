@@ -15,6 +15,7 @@
  **/
 
 #include "audio_data.h"
+#include "audio_ring.h"
 
 #include <stdint.h>
 #include <stddef.h>
@@ -46,4 +47,23 @@
 
 #define hal_set_audio_gain(gain_db) set_audio_gain(gain_db)
 
+/**
+ * @brief Ring buffer audio source: capture blocks are written in place at
+ *        hal_audio_ring_write_ptr and inference windows are read in place
+ *        with hal_audio_ring_peek, so no samples are moved between strides.
+ */
+#define hal_audio_ring_init(ring, buf, capacity, guard) audio_ring_init(ring, buf, capacity, guard)
+
+#define hal_audio_ring_write_ptr(ring, len)     audio_ring_write_ptr(ring, len)
+
+#define hal_audio_ring_commit(ring, len)        audio_ring_commit(ring, len)
+
+#define hal_audio_ring_write(ring, data, len)   audio_ring_write(ring, data, len)
+
+#define hal_audio_ring_peek(ring, len)          audio_ring_peek(ring, len)
+
+#define hal_audio_ring_consume(ring, len)       audio_ring_consume(ring, len)
+
+#define hal_audio_ring_get_stats(ring)          audio_ring_get_stats(ring)
+
 #endif // HAL_DATA_H
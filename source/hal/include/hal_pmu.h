@@ -34,10 +34,25 @@ void hal_pmu_final(void);
  */
 void hal_pmu_reset(void);
 
+/**
+ * @brief   Clears the counters' overflow status, without changing their values.
+ *          Wrapped counters are otherwise reported as overflown on every read.
+ */
+void hal_pmu_clear_overflow(void);
+
 /**
  * @brief       Gets the current counter values.
  * @param[out]  Pointer to a pmu_counters object.
  **/
 void hal_pmu_get_counters(pmu_counters* counters);
 
+/**
+ * @brief       Gets a CPU-side clock that always runs, unlike the NPU cycle counter
+ *              which only counts while the NPU is active, and without needing
+ *              CPU_PROFILE_ENABLED.
+ * @param[out]  clock   Current value, name, unit and width of the clock.
+ * @return      true if the platform has such a clock, false otherwise.
+ **/
+bool hal_pmu_get_cpu_clock(pmu_counter_unit* clock);
+
 #endif /* HAL_PMU_H */
@@ -0,0 +1,81 @@
+/* Copyright (C) 2024 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ *
+ */
+
+#ifndef AUDIO_RING_H
+#define AUDIO_RING_H
+
+#if defined(__cplusplus)
+extern "C" {
+#endif // defined(__cplusplus)
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * Ring buffer of audio samples shared by a capture producer (DMA or a static
+ * source) and a windowed consumer. Positions are absolute sample counts, so
+ * samples are never moved: the consumer reads windows in place and advances
+ * by its stride.
+ *
+ * The storage holds `capacity` samples followed by `guard` samples that mirror
+ * the start of the ring. When a window wraps, the mirror is refreshed so that
+ * any frame of up to guard + 1 samples starting inside the ring is contiguous.
+ */
+typedef struct audio_ring_stats_ {
+    uint32_t blocks_committed;  /* Number of commits by the producer. */
+    uint32_t samples_written;   /* Total samples committed by the producer. */
+    uint32_t overruns;          /* Times the producer caught up with the consumer. */
+    uint32_t samples_dropped;   /* Unread samples overwritten because of overruns. */
+} audio_ring_stats;
+
+typedef struct audio_ring_ {
+    int16_t *buffer;            /* Storage of capacity + guard samples. */
+    uint32_t capacity;          /* Ring size in samples. */
+    uint32_t guard;             /* Mirrored samples past the end of the ring. */
+    uint32_t write_pos;         /* Absolute position of the next sample to commit. */
+    uint32_t read_pos;          /* Absolute position of the oldest unread sample. */
+    audio_ring_stats stats;     /* Producer/consumer counters. */
+} audio_ring;
+
+/* Initialises the ring over the given storage (capacity + guard samples), which is cleared.
+ * Returns 0 for success. */
+int audio_ring_init(audio_ring *ring, int16_t *buffer, uint32_t capacity, uint32_t guard);
+
+/* Returns where the producer should write the next `len` samples, or NULL if they would
+ * not be contiguous (capacity should be a multiple of the capture block size). Unread
+ * samples that will be overwritten are dropped and counted as an overrun. */
+int16_t *audio_ring_write_ptr(audio_ring *ring, uint32_t len);
+
+/* Marks `len` samples at the write pointer as written. */
+void audio_ring_commit(audio_ring *ring, uint32_t len);
+
+/* Copies samples into the ring, wrapping as needed - used by static and native sources.
+ * Returns the number of samples written. */
+uint32_t audio_ring_write(audio_ring *ring, const int16_t *data, uint32_t len);
+
+/* Returns the number of committed samples not consumed yet. */
+uint32_t audio_ring_available(const audio_ring *ring);
+
+/* Returns a pointer to the oldest unread sample if at least `len` samples are available,
+ * NULL otherwise. The window may wrap: sample i is at ring->buffer[(offset + i) % capacity]. */
+const int16_t *audio_ring_peek(audio_ring *ring, uint32_t len);
+
+/* Releases the oldest `len` samples. */
+void audio_ring_consume(audio_ring *ring, uint32_t len);
+
+/* Returns producer and consumer counters. */
+audio_ring_stats audio_ring_get_stats(const audio_ring *ring);
+
+#if defined(__cplusplus)
+}
+#endif // defined(__cplusplus)
+
+#endif // AUDIO_RING_H
@@ -0,0 +1,121 @@
+/* Copyright (C) 2024 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ *
+ */
+
+#include "audio_ring.h"
+
+#include <string.h>
+
+int audio_ring_init(audio_ring *ring, int16_t *buffer, uint32_t capacity, uint32_t guard)
+{
+    if (!ring || !buffer || capacity == 0 || guard > capacity) {
+        return -1;
+    }
+
+    memset(ring, 0, sizeof(*ring));
+    ring->buffer = buffer;
+    ring->capacity = capacity;
+    ring->guard = guard;
+    memset(buffer, 0, (capacity + guard) * sizeof(*buffer));
+    return 0;
+}
+
+/* Makes room for len samples at the write position, dropping the oldest unread ones if needed. */
+static void audio_ring_reserve(audio_ring *ring, uint32_t len)
+{
+    const uint32_t pending = ring->write_pos - ring->read_pos;
+
+    if (pending + len > ring->capacity) {
+        const uint32_t excess = pending + len - ring->capacity;
+        ring->read_pos += excess;
+        ring->stats.overruns++;
+        ring->stats.samples_dropped += excess;
+    }
+}
+
+int16_t *audio_ring_write_ptr(audio_ring *ring, uint32_t len)
+{
+    if (!ring || !ring->buffer || len == 0) {
+        return NULL;
+    }
+
+    const uint32_t offset = ring->write_pos % ring->capacity;
+    if (offset + len > ring->capacity) {
+        return NULL;
+    }
+
+    audio_ring_reserve(ring, len);
+    return ring->buffer + offset;
+}
+
+void audio_ring_commit(audio_ring *ring, uint32_t len)
+{
+    ring->write_pos += len;
+    ring->stats.blocks_committed++;
+    ring->stats.samples_written += len;
+}
+
+uint32_t audio_ring_write(audio_ring *ring, const int16_t *data, uint32_t len)
+{
+    uint32_t written = 0;
+
+    while (written < len) {
+        const uint32_t offset = ring->write_pos % ring->capacity;
+        uint32_t chunk = ring->capacity - offset;
+        if (chunk > len - written) {
+            chunk = len - written;
+        }
+
+        int16_t *dst = audio_ring_write_ptr(ring, chunk);
+        if (!dst) {
+            break;
+        }
+        memcpy(dst, data + written, chunk * sizeof(*data));
+        audio_ring_commit(ring, chunk);
+        written += chunk;
+    }
+
+    return written;
+}
+
+uint32_t audio_ring_available(const audio_ring *ring)
+{
+    return ring->write_pos - ring->read_pos;
+}
+
+const int16_t *audio_ring_peek(audio_ring *ring, uint32_t len)
+{
+    if (!ring || !ring->buffer || len > ring->capacity || audio_ring_available(ring) < len) {
+        return NULL;
+    }
+
+    const uint32_t offset = ring->read_pos % ring->capacity;
+
+    /* Refresh the mirror of the wrapped part so frames crossing the end are contiguous. */
+    if (offset + len > ring->capacity && ring->guard > 0) {
+        uint32_t mirror = offset + len - ring->capacity;
+        if (mirror > ring->guard) {
+            mirror = ring->guard;
+        }
+        memcpy(ring->buffer + ring->capacity, ring->buffer, mirror * sizeof(*ring->buffer));
+    }
+
+    return ring->buffer + offset;
+}
+
+void audio_ring_consume(audio_ring *ring, uint32_t len)
+{
+    const uint32_t available = audio_ring_available(ring);
+    ring->read_pos += (len < available) ? len : available;
+}
+
+audio_ring_stats audio_ring_get_stats(const audio_ring *ring)
+{
+    return ring->stats;
+}
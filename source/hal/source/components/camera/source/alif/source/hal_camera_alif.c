@@ -201,7 +201,9 @@ const uint8_t* hal_camera_get_captured_frame(uint32_t* size)
         }
         SCB_CleanInvalidateDCache();
         buffer = get_image_data(s_cam_dev.frame_width, s_cam_dev.frame_height, rgb_image.tiff_header, s_cam_dev.output_buffer, s_cam_dev.output_buffer_size, raw_image);
-        *size = s_cam_dev.bytes_per_frame;
+        if (buffer) {
+            *size = s_cam_dev.bytes_per_frame;
+        }
     }
     return buffer;
 }
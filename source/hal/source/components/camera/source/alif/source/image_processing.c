@@ -452,17 +452,19 @@ int crop_and_interpolate( uint8_t *image,
 }
 
 
-static float current_log_gain = 0.0;
 static int32_t current_api_gain = 0;
-static int32_t last_requested_api_gain = 0;
-static float minimum_log_gain = -INFINITY;
-static float maximum_log_gain = +INFINITY;
 
 float get_image_gain(void)
 {
     return current_api_gain * 0x1p-16f;
 }
 
+#if CIMAGE_SW_GAIN_CONTROL && !defined(USE_FAKE_CAMERA)
+static float current_log_gain = 0.0;
+static int32_t last_requested_api_gain = 0;
+static float minimum_log_gain = -INFINITY;
+static float maximum_log_gain = +INFINITY;
+
 static float api_gain_to_log(int32_t api)
 {
     return logf(api * 0x1p-16f);
@@ -473,7 +475,6 @@ static int32_t log_gain_to_api(float gain)
     return expf(gain) * 0x1p16f;
 }
 
-#if CIMAGE_SW_GAIN_CONTROL
 static void process_autogain(void)
 {
     /* Simple "auto-exposure" algorithm. We work a single "gain" value
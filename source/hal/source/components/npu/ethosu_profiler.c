@@ -166,6 +166,15 @@ void ethosu_pmu_reset_counters(void)
     /* Reset all cycle and event counters. */
     ETHOSU_PMU_CYCCNT_Reset(&ethosu_drv);
     ETHOSU_PMU_EVCNTR_ALL_Reset(&ethosu_drv);
+    ethosu_pmu_clear_overflow();
+}
+
+/**
+ * @brief  Clears the Arm Ethos-U NPU PMU counters' overflow status.
+ */
+void ethosu_pmu_clear_overflow(void)
+{
+    ETHOSU_PMU_Set_CNTR_OVS(&ethosu_drv, get_event_mask());
 }
 
 /**
@@ -32,6 +32,9 @@
     #error "NPU PMU expects a minimum of 4 available event triggered counters!"
 #endif /* ETHOSU_PMU_COUNTERS < ETHOSU_USED_PMU_NCOUNTERS */
 
+#define ETHOSU_PMU_EVCNT_BITS       (32U)   /**< Width of the event counters, and of counters derived from them */
+#define ETHOSU_PMU_CCNT_BITS        (48U)   /**< Width of the total cycle counter */
+
 #define ETHOSU_PROFILER_NUM_COUNTERS (      \
             ETHOSU_DERIVED_NCOUNTERS +      \
             ETHOSU_USED_PMU_NCOUNTERS +     \
@@ -73,6 +76,11 @@ void ethosu_pmu_final(void);
  */
 void ethosu_pmu_reset_counters(void);
 
+/**
+ * @brief  Clears the Arm Ethos-U NPU PMU counters' overflow status.
+ */
+void ethosu_pmu_clear_overflow(void);
+
 /**
  * @brief Get the Arm Ethos-U NPU PMU counters
  * @return ethosu_pmu_counters
@@ -25,6 +25,7 @@ extern "C" {
 #include <stdbool.h>
 
 #define NUM_PMU_COUNTERS     (12)     /**< Maximum number of available counters. */
+#define PMU_COUNTER_MAX_BITS (64)     /**< Width of a counter that does not wrap. */
 
 /**
  * @brief   Container for a single unit for a PMU counter.
@@ -33,6 +34,8 @@ typedef struct _pmu_counter_unit {
     uint64_t value;     /**< Value of the counter expressed as 64 bits unsigned integer. */
     const char* name;   /**< Name for the counter. */
     const char* unit;   /**< Unit that the counter value represents (like cycles, beats, or milliseconds). */
+    uint8_t bits;       /**< Width of the counter in bits: differences between two readings
+                             are valid modulo 2^bits, even if the counter wrapped in between. */
 } pmu_counter_unit;
 
 /**
@@ -49,6 +52,19 @@ typedef struct _pmu_counters {
  */
 void platform_reset_counters(void);
 
+/**
+ * @brief   Clears the counters' overflow status, without changing their values.
+ */
+void platform_clear_counter_overflow(void);
+
+/**
+ * @brief       Gets a CPU-side clock that runs regardless of CPU_PROFILE_ENABLED and
+ *              of the NPU.
+ * @param[out]  clock   Current value, name, unit and width of the clock.
+ * @return      true if the platform has such a clock, false otherwise.
+ **/
+bool platform_get_cpu_clock(pmu_counter_unit* clock);
+
 /**
  * @brief       Gets the current counter values.
  * @param[out]  Pointer to a pmu_counters object.
@@ -32,7 +32,17 @@ void hal_pmu_reset(void)
     platform_reset_counters();
 }
 
+void hal_pmu_clear_overflow(void)
+{
+    platform_clear_counter_overflow();
+}
+
 void hal_pmu_get_counters(pmu_counters* counters)
 {
     platform_get_counters(counters);
 }
+
+bool hal_pmu_get_cpu_clock(pmu_counter_unit* clock)
+{
+    return platform_get_cpu_clock(clock);
+}
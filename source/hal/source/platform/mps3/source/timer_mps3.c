@@ -39,6 +39,7 @@ static int Init_SysTick(void);
  * @param value Value of the counter
  * @param name  Name for the given counter
  * @param unit  Unit for the "value"
+ * @param bits  Width of the counter in bits
  * @param counters Pointer to the counter struct - the one to be populated.
  * @return true if successfully added, false otherwise
  */
@@ -46,6 +47,7 @@ static bool add_pmu_counter(
         uint64_t value,
         const char* name,
         const char* unit,
+        uint8_t bits,
         pmu_counters* counters);
 
 /**
@@ -71,6 +73,22 @@ void platform_reset_counters(void)
 #endif /* defined (ARM_NPU) */
 }
 
+void platform_clear_counter_overflow(void)
+{
+#if defined (ARM_NPU)
+    ethosu_pmu_clear_overflow();
+#endif /* defined (ARM_NPU) */
+}
+
+bool platform_get_cpu_clock(pmu_counter_unit* clock)
+{
+    clock->value = Get_SysTick_Cycle_Count();
+    clock->name = "CPU CYCLES";
+    clock->unit = unit_cycles;
+    clock->bits = PMU_COUNTER_MAX_BITS;
+    return true;
+}
+
 void platform_get_counters(pmu_counters* counters)
 {
     counters->num_counters = 0;
@@ -84,6 +102,7 @@ void platform_get_counters(pmu_counters* counters)
             npu_counters.npu_evt_counters[i].counter_value,
             npu_counters.npu_evt_counters[i].name,
             npu_counters.npu_evt_counters[i].unit,
+            ETHOSU_PMU_EVCNT_BITS,
             counters);
     }
     for (i = 0; i < ETHOSU_DERIVED_NCOUNTERS; ++i) {
@@ -91,12 +110,14 @@ void platform_get_counters(pmu_counters* counters)
             npu_counters.npu_derived_counters[i].counter_value,
             npu_counters.npu_derived_counters[i].name,
             npu_counters.npu_derived_counters[i].unit,
+            ETHOSU_PMU_EVCNT_BITS,
             counters);
     }
     add_pmu_counter(
         npu_counters.npu_total_ccnt,
         "NPU TOTAL",
         unit_cycles,
+        ETHOSU_PMU_CCNT_BITS,
         counters);
 #else
     UNUSED(i);
@@ -114,21 +135,21 @@ void platform_get_counters(pmu_counters* counters)
             mps3_counters.counter_systick,
             "CPU TOTAL",
             unit_cycles,
+            PMU_COUNTER_MAX_BITS,
             counters);
 
     add_pmu_counter(
             get_tstamp_milliseconds(&mps3_counters),
             "DURATION",
             unit_ms,
+            32,
             counters);
 #endif /* defined(CPU_PROFILE_ENABLED) */
 
 #if !defined(CPU_PROFILE_ENABLED)
     UNUSED(get_tstamp_milliseconds);
-    UNUSED(Get_SysTick_Cycle_Count);
     UNUSED(unit_ms);
 #if !defined(ARM_NPU)
-    UNUSED(unit_cycles);
     UNUSED(add_pmu_counter);
 #endif /* !defined(ARM_NPU) */
 #endif /* !defined(CPU_PROFILE_ENABLED) */
@@ -203,6 +224,7 @@ static int Init_SysTick(void)
 static bool add_pmu_counter(uint64_t value,
                             const char* name,
                             const char* unit,
+                            uint8_t bits,
                             pmu_counters* counters)
 {
     const uint32_t idx = counters->num_counters;
@@ -210,6 +232,7 @@ static bool add_pmu_counter(uint64_t value,
         counters->counters[idx].value = value;
         counters->counters[idx].name = name;
         counters->counters[idx].unit = unit;
+        counters->counters[idx].bits = bits;
         ++counters->num_counters;
 
         debug("%s: %" PRIu64 " %s\n", name, value, unit);
@@ -44,6 +44,19 @@ typedef struct mps4_pmu_counters_ {
  */
 void platform_reset_counters(void);
 
+/**
+ * @brief   Clears the counters' overflow status, without changing their values.
+ */
+void platform_clear_counter_overflow(void);
+
+/**
+ * @brief       Gets a CPU-side clock that runs regardless of CPU_PROFILE_ENABLED and
+ *              of the NPU.
+ * @param[out]  clock   Current value, name, unit and width of the clock.
+ * @return      true if the platform has such a clock, false otherwise.
+ **/
+bool platform_get_cpu_clock(pmu_counter_unit* clock);
+
 /**
  * @brief       Gets the current counter values.
  * @param[out]  Pointer to a pmu_counters object.
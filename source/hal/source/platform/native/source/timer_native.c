@@ -30,19 +30,28 @@ extern "C" {
 
 void platform_reset_counters() { /* Nothing to do */ }
 
-void platform_get_counters(pmu_counters* counters)
+void platform_clear_counter_overflow(void) { /* Nothing to do */ }
+
+bool platform_get_cpu_clock(pmu_counter_unit* clock)
 {
     struct timespec current_time;
+    clock_gettime(1, &current_time);
+
+    clock->value = (current_time.tv_sec * MICROSECONDS_IN_SECOND) +
+                   (current_time.tv_nsec / NANOSECONDS_IN_MICROSECOND);
+    clock->name = "Duration";
+    clock->unit = "microseconds";
+    clock->bits = PMU_COUNTER_MAX_BITS;
+    return true;
+}
+
+void platform_get_counters(pmu_counters* counters)
+{
     counters->num_counters = 0;
     counters->initialised = true;
-    clock_gettime(1, &current_time);
-    uint64_t microseconds = (current_time.tv_sec * MICROSECONDS_IN_SECOND) +
-                            (current_time.tv_nsec / NANOSECONDS_IN_MICROSECOND);
 
 #if NUM_PMU_COUNTERS > 0
-    counters->counters[0].value = microseconds;
-    counters->counters[0].name = "Duration";
-    counters->counters[0].unit = "microseconds";
+    platform_get_cpu_clock(&counters->counters[0]);
     ++counters->num_counters;
 #endif /* NUM_PMU_COUNTERS > 0 */
 }
@@ -40,6 +40,7 @@ static int Init_SysTick(void);
  * @param value Value of the counter
  * @param name  Name for the given counter
  * @param unit  Unit for the "value"
+ * @param bits  Width of the counter in bits
  * @param counters Pointer to the counter struct - the one to be populated.
  * @return true if successfully added, false otherwise
  */
@@ -47,6 +48,7 @@ static bool add_pmu_counter(
         uint64_t value,
         const char* name,
         const char* unit,
+        uint8_t bits,
         pmu_counters* counters);
 
 void platform_reset_counters(void)
@@ -63,6 +65,22 @@ void platform_reset_counters(void)
     debug("system tick config ready\n");
 }
 
+void platform_clear_counter_overflow(void)
+{
+#if defined (ARM_NPU)
+    ethosu_pmu_clear_overflow();
+#endif /* defined (ARM_NPU) */
+}
+
+bool platform_get_cpu_clock(pmu_counter_unit* clock)
+{
+    clock->value = Get_SysTick_Cycle_Count();
+    clock->name = "CPU CYCLES";
+    clock->unit = "cycles";
+    clock->bits = PMU_COUNTER_MAX_BITS;
+    return true;
+}
+
 void platform_get_counters(pmu_counters* counters)
 {
     counters->num_counters = 0;
@@ -76,6 +94,7 @@ void platform_get_counters(pmu_counters* counters)
                 npu_counters.npu_evt_counters[i].counter_value,
                 npu_counters.npu_evt_counters[i].name,
                 npu_counters.npu_evt_counters[i].unit,
+                ETHOSU_PMU_EVCNT_BITS,
                 counters);
     }
     for (i = 0; i < ETHOSU_DERIVED_NCOUNTERS; ++i) {
@@ -83,12 +102,14 @@ void platform_get_counters(pmu_counters* counters)
                 npu_counters.npu_derived_counters[i].counter_value,
                 npu_counters.npu_derived_counters[i].name,
                 npu_counters.npu_derived_counters[i].unit,
+                ETHOSU_PMU_EVCNT_BITS,
                 counters);
     }
     add_pmu_counter(
             npu_counters.npu_total_ccnt,
             "NPU TOTAL",
             "cycles",
+            ETHOSU_PMU_CCNT_BITS,
             counters);
 #else  /* defined (ARM_NPU) */
     UNUSED(i);
@@ -99,11 +120,11 @@ void platform_get_counters(pmu_counters* counters)
             Get_SysTick_Cycle_Count(),
             "CPU TOTAL",
             "cycles",
+            PMU_COUNTER_MAX_BITS,
             counters);
 #endif /* defined(CPU_PROFILE_ENABLED) */
 
 #if !defined(CPU_PROFILE_ENABLED)
-    UNUSED(Get_SysTick_Cycle_Count);
 #if !defined(ARM_NPU)
     UNUSED(add_pmu_counter);
 #endif /* !defined(ARM_NPU) */
@@ -162,6 +183,7 @@ static int Init_SysTick(void)
 static bool add_pmu_counter(uint64_t value,
                             const char* name,
                             const char* unit,
+                            uint8_t bits,
                             pmu_counters* counters)
 {
     const uint32_t idx = counters->num_counters;
@@ -169,6 +191,7 @@ static bool add_pmu_counter(uint64_t value,
         counters->counters[idx].value = value;
         counters->counters[idx].name = name;
         counters->counters[idx].unit = unit;
+        counters->counters[idx].bits = bits;
         ++counters->num_counters;
         return true;
     }
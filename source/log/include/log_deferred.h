@@ -0,0 +1,101 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ML_EMBEDDED_CORE_LOG_DEFERRED_H
+#define ML_EMBEDDED_CORE_LOG_DEFERRED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/**
+ * Deferred logging: a log call records the format string pointer and its
+ * arguments, packed in binary form, into a fixed ring of slots. Formatting and
+ * output happen later, when log_deferred_drain is called at idle time or from a
+ * lower priority context.
+ *
+ * Any number of producers (including interrupt handlers) may record, lock-free;
+ * only one context may drain. When the ring is full, new messages are dropped
+ * and counted; the drain reports the count once the ring has been emptied.
+ *
+ * Format strings must outlive the drain (string literals). Arguments for %s are
+ * copied, so they may be temporaries.
+ */
+
+#ifndef LOG_DEFERRED_SLOTS
+#define LOG_DEFERRED_SLOTS      32      /* Ring size in messages, a power of two. */
+#endif /* LOG_DEFERRED_SLOTS */
+
+#ifndef LOG_DEFERRED_ARG_BYTES
+#define LOG_DEFERRED_ARG_BYTES  48      /* Packed arguments per message. */
+#endif /* LOG_DEFERRED_ARG_BYTES */
+
+#ifndef LOG_DEFERRED_LINE_MAX
+#define LOG_DEFERRED_LINE_MAX   160     /* Longest formatted message, longer ones are cut. */
+#endif /* LOG_DEFERRED_LINE_MAX */
+
+typedef struct log_deferred_entry_ {
+    uint32_t seq;               /* Slot sequence number, relative to the slot index. */
+    const char *prefix;         /* Level prefix, printed before the message. */
+    const char *fmt;            /* printf format string. */
+    uint8_t truncated;          /* Arguments did not all fit in args. */
+    uint8_t args[LOG_DEFERRED_ARG_BYTES]; /* Arguments, packed in format order. */
+} log_deferred_entry;
+
+/* A zero-initialised ring is empty and ready to use. */
+typedef struct log_ring_ {
+    log_deferred_entry slots[LOG_DEFERRED_SLOTS];
+    uint32_t write_pos;         /* Absolute position of the next message to record. */
+    uint32_t read_pos;          /* Absolute position of the oldest unread message. */
+    uint32_t dropped;           /* Messages dropped because the ring was full. */
+    uint32_t dropped_reported;  /* Dropped messages already reported by the drain. */
+} log_ring;
+
+/* Receives each formatted, NUL terminated message. */
+typedef void (*log_deferred_sink)(const char *line, void *user);
+
+/* Empties the ring and clears its counters. Must not race with other calls. */
+void log_deferred_init(log_ring *ring);
+
+/* Records a message without formatting it. Returns 0 for success, -1 if the ring is
+ * full and the message was dropped. */
+int log_deferred_record(log_ring *ring, const char *prefix, const char *fmt, ...)
+#if defined(__GNUC__)
+    __attribute__((format(printf, 3, 4)))
+#endif /* defined(__GNUC__) */
+    ;
+
+/* Formats and passes to the sink up to `max_messages` recorded messages, oldest first.
+ * Returns the number of messages emitted. Only one context may drain a ring. */
+uint32_t log_deferred_drain(log_ring *ring, uint32_t max_messages,
+                            log_deferred_sink sink, void *user);
+
+/* Returns the total number of dropped messages. */
+uint32_t log_deferred_dropped(const log_ring *ring);
+
+/* Returns the ring used by the logging macros. */
+log_ring *log_deferred_default(void);
+
+/* Drains all messages of the default ring to stdout. */
+void log_deferred_flush(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ML_EMBEDDED_CORE_LOG_DEFERRED_H */
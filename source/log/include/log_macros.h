@@ -38,42 +38,45 @@ extern "C" {
 #define UNUSED(x) ((void)(x))
 #endif /* #if !defined(UNUSED) */
 
-#if (LOG_LEVEL == LOG_LEVEL_TRACE)
-#define trace(...)      \
-    printf("TRACE - "); \
+/* With LOG_DEFERRED, messages are recorded into a ring and printed by log_flush(),
+ * to be called at idle time or from a lower priority context. */
+#if defined(LOG_DEFERRED) && LOG_DEFERRED
+#include "log_deferred.h"
+#define LOG_EMIT(prefix, ...) log_deferred_record(log_deferred_default(), prefix, __VA_ARGS__)
+#define log_flush()           log_deferred_flush()
+#else
+#define LOG_EMIT(prefix, ...) \
+    printf(prefix);           \
     printf(__VA_ARGS__)
+#define log_flush()
+#endif /* LOG_DEFERRED */
+
+#if (LOG_LEVEL == LOG_LEVEL_TRACE)
+#define trace(...) LOG_EMIT("TRACE - ", __VA_ARGS__)
 #else
 #define trace(...)
 #endif /* LOG_LEVEL == LOG_LEVEL_TRACE */
 
 #if (LOG_LEVEL <= LOG_LEVEL_DEBUG)
-#define debug(...)      \
-    printf("DEBUG - "); \
-    printf(__VA_ARGS__)
+#define debug(...) LOG_EMIT("DEBUG - ", __VA_ARGS__)
 #else
 #define debug(...)
 #endif /* LOG_LEVEL > LOG_LEVEL_TRACE */
 
 #if (LOG_LEVEL <= LOG_LEVEL_INFO)
-#define info(...)      \
-    printf("INFO - "); \
-    printf(__VA_ARGS__)
+#define info(...) LOG_EMIT("INFO - ", __VA_ARGS__)
 #else
 #define info(...)
 #endif /* LOG_LEVEL > LOG_LEVEL_DEBUG */
 
 #if (LOG_LEVEL <= LOG_LEVEL_WARN)
-#define warn(...)      \
-    printf("WARN - "); \
-    printf(__VA_ARGS__)
+#define warn(...) LOG_EMIT("WARN - ", __VA_ARGS__)
 #else
 #define warn(...)
 #endif /* LOG_LEVEL > LOG_LEVEL_INFO */
 
 #if (LOG_LEVEL <= LOG_LEVEL_ERROR)
-#define printf_err(...) \
-    printf("ERROR - "); \
-    printf(__VA_ARGS__)
+#define printf_err(...) LOG_EMIT("ERROR - ", __VA_ARGS__)
 #else
 #define printf_err(...)
 #endif /* LOG_LEVEL > LOG_LEVEL_INFO */
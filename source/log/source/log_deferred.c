@@ -0,0 +1,469 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "log_deferred.h"
+
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+_Static_assert((LOG_DEFERRED_SLOTS & (LOG_DEFERRED_SLOTS - 1)) == 0,
+               "LOG_DEFERRED_SLOTS must be a power of two");
+
+#define LOG_SLOT_MASK   (LOG_DEFERRED_SLOTS - 1u)
+
+/* The ring is a bounded queue in which each slot carries a sequence number
+ * (D. Vyukov's MPMC queue, here with a single consumer). Slot i is free for
+ * the producer at position pos when its sequence is pos, and holds a message
+ * for the consumer when it is pos + 1. Sequences are stored minus the slot
+ * index, so that a zero-initialised ring is empty. */
+
+typedef enum log_arg_type_ {
+    LOG_ARG_NONE,       /* %%, no argument. */
+    LOG_ARG_COUNT,      /* %n, consumed but not stored. */
+    LOG_ARG_INT,
+    LOG_ARG_LONG,
+    LOG_ARG_LLONG,
+    LOG_ARG_SIZE,
+    LOG_ARG_INTMAX,
+    LOG_ARG_PTRDIFF,
+    LOG_ARG_DOUBLE,
+    LOG_ARG_LDOUBLE,
+    LOG_ARG_PTR,
+    LOG_ARG_STR,
+    LOG_ARG_INVALID     /* Not supported, the rest of the message is dropped. */
+} log_arg_type;
+
+typedef struct log_spec_ {
+    const char *end;            /* One past the conversion character. */
+    log_arg_type type;
+    uint8_t star_width;         /* Width is an int argument. */
+    uint8_t star_precision;     /* Precision is an int argument. */
+} log_spec;
+
+static log_ring s_log_ring;
+
+static int log_is_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+/* Parses the conversion specification that follows a '%' at p. */
+static void log_parse_spec(const char *p, log_spec *spec)
+{
+    enum { LEN_NONE, LEN_HH, LEN_H, LEN_L, LEN_LL, LEN_Z, LEN_J, LEN_T, LEN_BIG_L } length = LEN_NONE;
+
+    spec->star_width = 0;
+    spec->star_precision = 0;
+
+    while (*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0') {
+        p++;
+    }
+    if (*p == '*') {
+        spec->star_width = 1;
+        p++;
+    }
+    while (log_is_digit(*p)) {
+        p++;
+    }
+    if (*p == '.') {
+        p++;
+        if (*p == '*') {
+            spec->star_precision = 1;
+            p++;
+        }
+        while (log_is_digit(*p)) {
+            p++;
+        }
+    }
+
+    switch (*p) {
+        case 'h':
+            p++;
+            length = LEN_H;
+            if (*p == 'h') {
+                p++;
+                length = LEN_HH;
+            }
+            break;
+        case 'l':
+            p++;
+            length = LEN_L;
+            if (*p == 'l') {
+                p++;
+                length = LEN_LL;
+            }
+            break;
+        case 'z': p++; length = LEN_Z; break;
+        case 'j': p++; length = LEN_J; break;
+        case 't': p++; length = LEN_T; break;
+        case 'L': p++; length = LEN_BIG_L; break;
+        default: break;
+    }
+
+    spec->end = *p ? p + 1 : p;
+    switch (*p) {
+        case '%':
+            spec->type = LOG_ARG_NONE;
+            break;
+        case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+            switch (length) {
+                case LEN_L:     spec->type = LOG_ARG_LONG; break;
+                case LEN_LL:    spec->type = LOG_ARG_LLONG; break;
+                case LEN_Z:     spec->type = LOG_ARG_SIZE; break;
+                case LEN_J:     spec->type = LOG_ARG_INTMAX; break;
+                case LEN_T:     spec->type = LOG_ARG_PTRDIFF; break;
+                case LEN_BIG_L: spec->type = LOG_ARG_INVALID; break;
+                default:        spec->type = LOG_ARG_INT; break;
+            }
+            break;
+        case 'c':
+            spec->type = LOG_ARG_INT;
+            break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            spec->type = length == LEN_BIG_L ? LOG_ARG_LDOUBLE : LOG_ARG_DOUBLE;
+            break;
+        case 'p':
+            spec->type = LOG_ARG_PTR;
+            break;
+        case 's':
+            /* Wide strings are not copied. */
+            spec->type = length == LEN_L ? LOG_ARG_INVALID : LOG_ARG_STR;
+            break;
+        case 'n':
+            spec->type = LOG_ARG_COUNT;
+            break;
+        default:
+            spec->type = LOG_ARG_INVALID;
+            break;
+    }
+}
+
+static int log_pack(log_deferred_entry *entry, size_t *used, const void *value, size_t size)
+{
+    if (*used + size > LOG_DEFERRED_ARG_BYTES) {
+        return -1;
+    }
+    memcpy(entry->args + *used, value, size);
+    *used += size;
+    return 0;
+}
+
+static int log_pack_str(log_deferred_entry *entry, size_t *used, const char *str)
+{
+    const size_t available = LOG_DEFERRED_ARG_BYTES - *used;
+    size_t len = 0;
+
+    if (available == 0) {
+        return -1;
+    }
+    if (!str) {
+        str = "(null)";
+    }
+
+    /* Long strings are cut to the space left, and the arguments after them dropped. */
+    while (len < available - 1 && str[len] != '\0') {
+        len++;
+    }
+    memcpy(entry->args + *used, str, len);
+    entry->args[*used + len] = '\0';
+    *used += len + 1;
+    return str[len] != '\0' ? -1 : 0;
+}
+
+#define LOG_PACK_VALUE(type)                                            \
+    do {                                                                \
+        type value = va_arg(args, type);                                \
+        failed = log_pack(entry, &used, &value, sizeof(value));         \
+    } while (0)
+
+/* Packs the arguments of entry->fmt. Returns 0 if they all fit. */
+static int log_pack_args(log_deferred_entry *entry, va_list args)
+{
+    const char *p = entry->fmt;
+    size_t used = 0;
+
+    while ((p = strchr(p, '%')) != NULL) {
+        log_spec spec;
+        int failed = 0;
+
+        log_parse_spec(p + 1, &spec);
+        p = spec.end;
+
+        if (spec.star_width) {
+            LOG_PACK_VALUE(int);
+        }
+        if (!failed && spec.star_precision) {
+            LOG_PACK_VALUE(int);
+        }
+        if (failed) {
+            return -1;
+        }
+
+        switch (spec.type) {
+            case LOG_ARG_NONE:      break;
+            case LOG_ARG_COUNT:     (void)va_arg(args, void *); break;
+            case LOG_ARG_INT:       LOG_PACK_VALUE(int); break;
+            case LOG_ARG_LONG:      LOG_PACK_VALUE(long); break;
+            case LOG_ARG_LLONG:     LOG_PACK_VALUE(long long); break;
+            case LOG_ARG_SIZE:      LOG_PACK_VALUE(size_t); break;
+            case LOG_ARG_INTMAX:    LOG_PACK_VALUE(intmax_t); break;
+            case LOG_ARG_PTRDIFF:   LOG_PACK_VALUE(ptrdiff_t); break;
+            case LOG_ARG_DOUBLE:    LOG_PACK_VALUE(double); break;
+            case LOG_ARG_LDOUBLE:   LOG_PACK_VALUE(long double); break;
+            case LOG_ARG_PTR:       LOG_PACK_VALUE(void *); break;
+            case LOG_ARG_STR:       failed = log_pack_str(entry, &used, va_arg(args, const char *)); break;
+            case LOG_ARG_INVALID:   failed = -1; break;
+        }
+        if (failed) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void log_deferred_init(log_ring *ring)
+{
+    memset(ring, 0, sizeof(*ring));
+}
+
+int log_deferred_record(log_ring *ring, const char *prefix, const char *fmt, ...)
+{
+    uint32_t pos = __atomic_load_n(&ring->write_pos, __ATOMIC_RELAXED);
+    log_deferred_entry *entry;
+
+    /* Claim the slot at the write position. */
+    for (;;) {
+        entry = &ring->slots[pos & LOG_SLOT_MASK];
+        const uint32_t seq = __atomic_load_n(&entry->seq, __ATOMIC_ACQUIRE) + (pos & LOG_SLOT_MASK);
+        const int32_t diff = (int32_t)(seq - pos);
+
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&ring->write_pos, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            /* The slot still holds a message from the previous lap: full. */
+            __atomic_fetch_add(&ring->dropped, 1, __ATOMIC_RELAXED);
+            return -1;
+        } else {
+            pos = __atomic_load_n(&ring->write_pos, __ATOMIC_RELAXED);
+        }
+    }
+
+    va_list args;
+    va_start(args, fmt);
+    entry->prefix = prefix ? prefix : "";
+    entry->fmt = fmt;
+    entry->truncated = log_pack_args(entry, args) != 0;
+    va_end(args);
+
+    /* Publish the message. */
+    __atomic_store_n(&entry->seq, pos + 1 - (pos & LOG_SLOT_MASK), __ATOMIC_RELEASE);
+    return 0;
+}
+
+/* Appends len characters of str to the line, returning the new line length. */
+static size_t log_append(char *line, size_t used, const char *str, size_t len)
+{
+    const size_t space = LOG_DEFERRED_LINE_MAX - 1 - used;
+
+    if (len > space) {
+        len = space;
+    }
+    memcpy(line + used, str, len);
+    line[used + len] = '\0';
+    return used + len;
+}
+
+/* Returns the line length after snprintf wrote `written` characters at `used`. */
+static size_t log_advance(size_t used, int written)
+{
+    if (written < 0) {
+        return used;
+    }
+    used += (size_t)written;
+    return used < LOG_DEFERRED_LINE_MAX - 1 ? used : LOG_DEFERRED_LINE_MAX - 1;
+}
+
+static int log_unpack(const log_deferred_entry *entry, size_t *used, void *value, size_t size)
+{
+    if (*used + size > LOG_DEFERRED_ARG_BYTES) {
+        return -1;
+    }
+    memcpy(value, entry->args + *used, size);
+    *used += size;
+    return 0;
+}
+
+#define LOG_FORMAT_VALUE(type)                                                  \
+    do {                                                                        \
+        type value;                                                             \
+        if (log_unpack(entry, &used, &value, sizeof(value)) != 0) {             \
+            return log_append(line, len, "...\n", 4);                           \
+        }                                                                       \
+        len = log_advance(len, snprintf(line + len, LOG_DEFERRED_LINE_MAX - len, \
+                                        conv, value));                          \
+    } while (0)
+
+/* Formats a message into the line, returning its length. */
+static size_t log_format(const log_deferred_entry *entry, char *line)
+{
+    const char *p = entry->fmt;
+    size_t used = 0;
+    size_t len = log_append(line, 0, entry->prefix, strlen(entry->prefix));
+
+    while (*p) {
+        const char *pct = strchr(p, '%');
+        const char *literal_end = pct ? pct : p + strlen(p);
+        log_spec spec;
+        char conv[48];
+        size_t conv_len = 0;
+
+        len = log_append(line, len, p, (size_t)(literal_end - p));
+        if (!pct) {
+            break;
+        }
+
+        log_parse_spec(pct + 1, &spec);
+        p = spec.end;
+        if (spec.type == LOG_ARG_NONE) {
+            len = log_append(line, len, "%", 1);
+            continue;
+        }
+        if (spec.type == LOG_ARG_COUNT) {
+            continue;
+        }
+        if (spec.type == LOG_ARG_INVALID || (size_t)(spec.end - pct) >= sizeof(conv) - 24) {
+            return log_append(line, len, "...\n", 4);
+        }
+
+        /* Rebuild the specification with '*' replaced by the recorded values. */
+        for (const char *q = pct; q < spec.end; q++) {
+            if (*q != '*') {
+                conv[conv_len++] = *q;
+                continue;
+            }
+            int value;
+            if (log_unpack(entry, &used, &value, sizeof(value)) != 0) {
+                return log_append(line, len, "...\n", 4);
+            }
+            if (q[-1] == '.' && value < 0) {
+                /* A negative precision is taken as if it was omitted. */
+                conv_len--;
+                continue;
+            }
+            conv_len += (size_t)snprintf(conv + conv_len, sizeof(conv) - conv_len, "%d", value);
+        }
+        conv[conv_len] = '\0';
+
+        switch (spec.type) {
+            case LOG_ARG_INT:       LOG_FORMAT_VALUE(int); break;
+            case LOG_ARG_LONG:      LOG_FORMAT_VALUE(long); break;
+            case LOG_ARG_LLONG:     LOG_FORMAT_VALUE(long long); break;
+            case LOG_ARG_SIZE:      LOG_FORMAT_VALUE(size_t); break;
+            case LOG_ARG_INTMAX:    LOG_FORMAT_VALUE(intmax_t); break;
+            case LOG_ARG_PTRDIFF:   LOG_FORMAT_VALUE(ptrdiff_t); break;
+            case LOG_ARG_DOUBLE:    LOG_FORMAT_VALUE(double); break;
+            case LOG_ARG_LDOUBLE:   LOG_FORMAT_VALUE(long double); break;
+            case LOG_ARG_PTR:       LOG_FORMAT_VALUE(void *); break;
+            case LOG_ARG_STR: {
+                if (used >= LOG_DEFERRED_ARG_BYTES) {
+                    return log_append(line, len, "...\n", 4);
+                }
+                const char *str = (const char *)entry->args + used;
+                used += strlen(str) + 1;
+                len = log_advance(len, snprintf(line + len, LOG_DEFERRED_LINE_MAX - len, conv, str));
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    if (entry->truncated) {
+        /* The last argument was cut: mark it before the line end. */
+        if (len > 0 && line[len - 1] == '\n') {
+            len--;
+        }
+        return log_append(line, len, "...\n", 4);
+    }
+    return len;
+}
+
+uint32_t log_deferred_drain(log_ring *ring, uint32_t max_messages,
+                            log_deferred_sink sink, void *user)
+{
+    char line[LOG_DEFERRED_LINE_MAX];
+    uint32_t emitted = 0;
+
+    while (emitted < max_messages) {
+        const uint32_t pos = ring->read_pos;
+        log_deferred_entry *slot = &ring->slots[pos & LOG_SLOT_MASK];
+        const uint32_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) + (pos & LOG_SLOT_MASK);
+
+        if ((int32_t)(seq - (pos + 1)) < 0) {
+            /* Empty: report what was dropped since the last report. */
+            const uint32_t dropped = __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+            if (dropped != ring->dropped_reported) {
+                snprintf(line, sizeof(line), "WARN - %" PRIu32 " log messages dropped\n",
+                         dropped - ring->dropped_reported);
+                ring->dropped_reported = dropped;
+                sink(line, user);
+            }
+            break;
+        }
+
+        /* Copy the message out so the slot is released before formatting. */
+        const log_deferred_entry entry = *slot;
+        __atomic_store_n(&slot->seq, pos + LOG_DEFERRED_SLOTS - (pos & LOG_SLOT_MASK), __ATOMIC_RELEASE);
+        ring->read_pos = pos + 1;
+
+        const size_t len = log_format(&entry, line);
+        if (len == LOG_DEFERRED_LINE_MAX - 1 && line[len - 1] != '\n') {
+            /* Cut messages still end their line. */
+            line[len - 1] = '\n';
+        }
+        sink(line, user);
+        emitted++;
+    }
+    return emitted;
+}
+
+uint32_t log_deferred_dropped(const log_ring *ring)
+{
+    return __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+}
+
+log_ring *log_deferred_default(void)
+{
+    return &s_log_ring;
+}
+
+static void log_deferred_stdout(const char *line, void *user)
+{
+    (void)user;
+    fputs(line, stdout);
+}
+
+void log_deferred_flush(void)
+{
+    log_deferred_drain(&s_log_ring, UINT32_MAX, log_deferred_stdout, NULL);
+}
@@ -17,6 +17,7 @@
 #include "PlatformMath.hpp"
 #include "log_macros.h"
 #include <algorithm>
+#include <cmath>
 
 namespace arm {
 namespace app {
@@ -84,6 +85,44 @@ namespace math {
 #endif /* __ARM_FEATURE_DSP */
     }
 
+    float MathUtils::StdDevFromSumsF32(const double sum, const double sumSq,
+                                       const uint32_t count)
+    {
+        if (!count) {
+            return 0.f;
+        }
+
+        const double m2 = std::max(0.0, sumSq - (sum * sum) / count);
+#if (defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1))
+        /* arm_std_f32 gives the sample standard deviation. */
+        if (count < 2) {
+            return 0.f;
+        }
+        return static_cast<float>(std::sqrt(m2 / (count - 1)));
+#else  /* __ARM_FEATURE_DSP */
+        return static_cast<float>(std::sqrt(m2 / count));
+#endif /* __ARM_FEATURE_DSP */
+    }
+
+    /* Bit reversed indices for a complex FFT of a power of two length. */
+    static std::vector<uint16_t> GetBitReverseTable(const uint32_t fftLen)
+    {
+        uint32_t numBits = 0;
+        while ((1u << numBits) < fftLen) {
+            ++numBits;
+        }
+
+        std::vector<uint16_t> table(fftLen);
+        for (uint32_t i = 0; i < fftLen; ++i) {
+            uint32_t reversed = 0;
+            for (uint32_t bit = 0; bit < numBits; ++bit) {
+                reversed |= ((i >> bit) & 1u) << (numBits - 1 - bit);
+            }
+            table[i] = static_cast<uint16_t>(reversed);
+        }
+        return table;
+    }
+
     void MathUtils::FftInitF32(const uint16_t fftLen,
                                FftInstance& fftInstance,
                                const FftType type)
@@ -114,6 +153,23 @@ namespace math {
         } else {
             fftInstance.m_optimisedOptionAvailable = true;
         }
+#else  /* __ARM_FEATURE_DSP */
+        /* A real FFT is computed as a complex FFT of half the length. */
+        const uint32_t complexLen = (type == FftType::real) ? fftLen / 2 : fftLen;
+        fftInstance.m_twiddles.clear();
+        fftInstance.m_bitReverse.clear();
+
+        if (complexLen && !(complexLen & (complexLen - 1))) {
+            fftInstance.m_twiddles.resize(fftLen);
+            for (uint32_t k = 0; k < fftLen / 2u; ++k) {
+                const double angle = 2 * M_PI * k / fftLen;
+                fftInstance.m_twiddles[k * 2] = static_cast<float>(cos(angle));
+                fftInstance.m_twiddles[k * 2 + 1] = static_cast<float>(-sin(angle));
+            }
+
+            fftInstance.m_bitReverse = GetBitReverseTable(complexLen);
+            fftInstance.m_optimisedOptionAvailable = true;
+        }
 #endif /* __ARM_FEATURE_DSP */
 
         debug("Optimised FFT will be used: %s.\n", fftInstance.m_optimisedOptionAvailable? "yes": "no");
@@ -121,11 +177,9 @@ namespace math {
         fftInstance.m_initialised = true;
     }
 
-    static void FftRealF32(std::vector<float>& input,
-                           std::vector<float>& fftOutput)
+    static void FftRealF32(const float* input, const size_t inputLength, float* fftOutput)
     {
-        const size_t inputLength = input.size();
-        const size_t halfLength = input.size() / 2;
+        const size_t halfLength = inputLength / 2;
 
         fftOutput[0] = 0;
         fftOutput[1] = 0;
@@ -153,10 +207,9 @@ namespace math {
         }
     }
 
-    static void FftComplexF32(std::vector<float>& input,
-                           std::vector<float>& fftOutput)
+    static void FftComplexF32(const float* input, const size_t inputLength, float* fftOutput)
     {
-        const size_t fftLen = input.size() / 2;
+        const size_t fftLen = inputLength / 2;
         for (size_t k = 0; k < fftLen; k++) {
             float sumReal = 0;
             float sumImag = 0;
@@ -173,18 +226,111 @@ namespace math {
         }
     }
 
+#if !(defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1))
+    /**
+     * @brief       In-place radix-2 decimation in time FFT of interleaved complex data.
+     * @param[in,out]   data         fftLen complex values as [re, im] pairs.
+     * @param[in]       fftLen       Number of complex values, a power of two.
+     * @param[in]       bitReverse   Bit reversed index of each value.
+     * @param[in]       twiddles     Twiddle table; exp(-2*pi*i*k/fftLen) is entry k * stride.
+     * @param[in]       stride       Twiddle table stride.
+     */
+    static void FftRadix2F32(float* data, const uint32_t fftLen, const uint16_t* bitReverse,
+                             const float* twiddles, const uint32_t stride)
+    {
+        for (uint32_t i = 0; i < fftLen; ++i) {
+            const uint32_t j = bitReverse[i];
+            if (i < j) {
+                std::swap(data[i * 2], data[j * 2]);
+                std::swap(data[i * 2 + 1], data[j * 2 + 1]);
+            }
+        }
+
+        for (uint32_t half = 1, twStep = fftLen / 2 * stride; half < fftLen; half *= 2, twStep /= 2) {
+            for (uint32_t k = 0; k < half; ++k) {
+                const float wRe = twiddles[k * twStep * 2];
+                const float wIm = twiddles[k * twStep * 2 + 1];
+
+                for (uint32_t start = k; start < fftLen; start += half * 2) {
+                    float* a = data + start * 2;
+                    float* b = a + half * 2;
+                    const float tRe = b[0] * wRe - b[1] * wIm;
+                    const float tIm = b[0] * wIm + b[1] * wRe;
+                    b[0] = a[0] - tRe;
+                    b[1] = a[1] - tIm;
+                    a[0] += tRe;
+                    a[1] += tIm;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief       Real FFT: the even and odd samples form the real and imaginary parts
+     *              of a complex FFT of half the length, which is then split into the
+     *              spectrum of the real input.
+     */
+    static void FftRealRadix2F32(const float* input,
+                                 float* fftOutput,
+                                 const FftInstance& fftInstance)
+    {
+        const uint32_t fftLen = fftInstance.m_fftLen;
+        const uint32_t halfLen = fftLen / 2;
+        const float* twiddles = fftInstance.m_twiddles.data();
+        float* out = fftOutput;
+
+        std::copy(input, input + fftLen, fftOutput);
+        FftRadix2F32(out, halfLen, fftInstance.m_bitReverse.data(), twiddles, 2);
+
+        /* Bins 0 and N/2 are both real. */
+        const float re0 = out[0];
+        const float im0 = out[1];
+        out[0] = re0 + im0;
+        out[1] = re0 - im0;
+
+        /* Bins k and N/2 - k are computed together from Z[k] and Z[N/2 - k]. */
+        for (uint32_t k = 1; k <= halfLen / 2; ++k) {
+            float* zk = out + k * 2;
+            float* zm = out + (halfLen - k) * 2;
+
+            /* Even part (Z[k] + conj(Z[N/2 - k]))/2, odd part -i(Z[k] - conj(Z[N/2 - k]))/2. */
+            const float evenRe = 0.5f * (zk[0] + zm[0]);
+            const float evenIm = 0.5f * (zk[1] - zm[1]);
+            const float oddRe = 0.5f * (zk[1] + zm[1]);
+            const float oddIm = -0.5f * (zk[0] - zm[0]);
+
+            const float wRe = twiddles[k * 2];
+            const float wIm = twiddles[k * 2 + 1];
+            const float tRe = oddRe * wRe - oddIm * wIm;
+            const float tIm = oddRe * wIm + oddIm * wRe;
+
+            zk[0] = evenRe + tRe;
+            zk[1] = evenIm + tIm;
+            zm[0] = evenRe - tRe;
+            zm[1] = tIm - evenIm;
+        }
+    }
+#endif /* __ARM_FEATURE_DSP */
+
     void MathUtils::FftF32(std::vector<float>& input,
                            std::vector<float>& fftOutput,
                            arm::app::math::FftInstance& fftInstance)
+    {
+        MathUtils::FftF32(input.data(), input.size(), fftOutput.data(), fftOutput.size(), fftInstance);
+    }
+
+    void MathUtils::FftF32(float* input, const size_t inputLen,
+                           float* fftOutput, const size_t fftOutputLen,
+                           arm::app::math::FftInstance& fftInstance)
     {
         if (!fftInstance.m_initialised) {
             printf_err("FFT uninitialised\n");
             return;
-        } else if (input.size() < fftInstance.m_fftLen) {
+        } else if (inputLen < fftInstance.m_fftLen) {
             printf_err("FFT len: %" PRIu16 "; input len: %zu\n",
-                fftInstance.m_fftLen, input.size());
+                fftInstance.m_fftLen, inputLen);
             return;
-        } else if (fftOutput.size() < input.size()) {
+        } else if (fftOutputLen < inputLen) {
             printf_err("Output vector len insufficient to hold FFTs\n");
             return;
         }
@@ -194,26 +340,38 @@ namespace math {
 
 #if (defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1))
             if (fftInstance.m_optimisedOptionAvailable) {
-                arm_rfft_fast_f32(&fftInstance.m_instanceReal, input.data(), fftOutput.data(), 0);
+                arm_rfft_fast_f32(&fftInstance.m_instanceReal, input, fftOutput, 0);
+                return;
+            }
+#else  /* __ARM_FEATURE_DSP */
+            if (fftInstance.m_optimisedOptionAvailable) {
+                FftRealRadix2F32(input, fftOutput, fftInstance);
                 return;
             }
 #endif /* __ARM_FEATURE_DSP */
-            FftRealF32(input, fftOutput);
+            FftRealF32(input, inputLen, fftOutput);
             return;
 
         case FftType::complex:
-            if (input.size() < fftInstance.m_fftLen * 2) {
+            if (inputLen < fftInstance.m_fftLen * 2u) {
                 printf_err("Complex FFT instance should have input size >= (FFT len x 2)");
                 return;
             }
 #if (defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1))
             if (fftInstance.m_optimisedOptionAvailable) {
-                fftOutput = input; /* Complex function works in-place */
-                arm_cfft_f32(&fftInstance.m_instanceComplex, fftOutput.data(), 0, 1);
+                std::copy(input, input + inputLen, fftOutput); /* Complex function works in-place */
+                arm_cfft_f32(&fftInstance.m_instanceComplex, fftOutput, 0, 1);
+                return;
+            }
+#else  /* __ARM_FEATURE_DSP */
+            if (fftInstance.m_optimisedOptionAvailable) {
+                std::copy(input, input + fftInstance.m_fftLen * 2, fftOutput);
+                FftRadix2F32(fftOutput, fftInstance.m_fftLen, fftInstance.m_bitReverse.data(),
+                             fftInstance.m_twiddles.data(), 1);
                 return;
             }
 #endif /* __ARM_FEATURE_DSP */
-            FftComplexF32(input, fftOutput);
+            FftComplexF32(input, inputLen, fftOutput);
             return;
 
         default:
@@ -222,6 +380,108 @@ namespace math {
         }
     }
 
+    bool MathUtils::FftInitQ31(const uint16_t fftLen, FftInstanceQ31& fftInstance)
+    {
+        fftInstance.m_fftLen = fftLen;
+        fftInstance.m_initialised = false;
+
+        if (fftLen < 2 || (fftLen & (fftLen - 1))) {
+            printf_err("Fixed point FFT len %" PRIu16 " is not a power of two\n", fftLen);
+            return false;
+        }
+
+        fftInstance.m_twiddles.resize(fftLen);
+        for (uint32_t k = 0; k < fftLen / 2u; ++k) {
+            const double angle = 2 * M_PI * k / fftLen;
+            const double scale = static_cast<double>(1u << 31);
+            fftInstance.m_twiddles[k * 2] = static_cast<int32_t>(
+                std::min(std::round(cos(angle) * scale), scale - 1));
+            fftInstance.m_twiddles[k * 2 + 1] = static_cast<int32_t>(
+                std::min(std::round(-sin(angle) * scale), scale - 1));
+        }
+        fftInstance.m_bitReverse = GetBitReverseTable(fftLen / 2);
+        fftInstance.m_initialised = true;
+        return true;
+    }
+
+    /* Q31 product of a complex value and a Q31 twiddle factor. */
+    static inline void MultiplyTwiddleQ31(const int64_t re, const int64_t im,
+                                          const int64_t wRe, const int64_t wIm,
+                                          int64_t& outRe, int64_t& outIm)
+    {
+        constexpr int64_t round = int64_t{1} << 30;
+        outRe = (re * wRe - im * wIm + round) >> 31;
+        outIm = (re * wIm + im * wRe + round) >> 31;
+    }
+
+    void MathUtils::FftRealQ31(const int32_t* input,
+                               int32_t* fftOutput,
+                               const FftInstanceQ31& fftInstance)
+    {
+        if (!fftInstance.m_initialised) {
+            printf_err("FFT uninitialised\n");
+            return;
+        }
+
+        const uint32_t fftLen = fftInstance.m_fftLen;
+        const uint32_t halfLen = fftLen / 2;
+        const int32_t* twiddles = fftInstance.m_twiddles.data();
+
+        /* The even and odd samples form a complex sequence of half the length. It is
+         * halved on the way in, so that the complex values stay in range. */
+        for (uint32_t i = 0; i < halfLen; ++i) {
+            const uint32_t j = fftInstance.m_bitReverse[i];
+            fftOutput[j * 2] = input[i * 2] >> 1;
+            fftOutput[j * 2 + 1] = input[i * 2 + 1] >> 1;
+        }
+
+        /* Radix-2 stages, each halving its output. */
+        for (uint32_t half = 1, twStep = halfLen; half < halfLen; half *= 2, twStep /= 2) {
+            for (uint32_t k = 0; k < half; ++k) {
+                const int64_t wRe = twiddles[k * twStep * 2];
+                const int64_t wIm = twiddles[k * twStep * 2 + 1];
+
+                for (uint32_t start = k; start < halfLen; start += half * 2) {
+                    int32_t* a = fftOutput + start * 2;
+                    int32_t* b = a + half * 2;
+                    int64_t tRe;
+                    int64_t tIm;
+                    MultiplyTwiddleQ31(b[0], b[1], wRe, wIm, tRe, tIm);
+                    b[0] = static_cast<int32_t>((a[0] - tRe + 1) >> 1);
+                    b[1] = static_cast<int32_t>((a[1] - tIm + 1) >> 1);
+                    a[0] = static_cast<int32_t>((a[0] + tRe + 1) >> 1);
+                    a[1] = static_cast<int32_t>((a[1] + tIm + 1) >> 1);
+                }
+            }
+        }
+
+        /* Split into the spectrum of the real input, as in the floating point FFT. */
+        const int64_t re0 = fftOutput[0];
+        const int64_t im0 = fftOutput[1];
+        fftOutput[0] = static_cast<int32_t>(re0 + im0);
+        fftOutput[1] = static_cast<int32_t>(re0 - im0);
+
+        for (uint32_t k = 1; k <= halfLen / 2; ++k) {
+            int32_t* zk = fftOutput + k * 2;
+            int32_t* zm = fftOutput + (halfLen - k) * 2;
+
+            /* Twice the even part; the odd part rounded to keep the product in range. */
+            const int64_t evenRe2 = int64_t{zk[0]} + zm[0];
+            const int64_t evenIm2 = int64_t{zk[1]} - zm[1];
+            const int64_t oddRe = (int64_t{zk[1]} + zm[1] + 1) >> 1;
+            const int64_t oddIm = (int64_t{zm[0]} - zk[0] + 1) >> 1;
+
+            int64_t tRe;
+            int64_t tIm;
+            MultiplyTwiddleQ31(oddRe, oddIm, twiddles[k * 2], twiddles[k * 2 + 1], tRe, tIm);
+
+            zk[0] = static_cast<int32_t>((evenRe2 + tRe * 2 + 1) >> 1);
+            zk[1] = static_cast<int32_t>((evenIm2 + tIm * 2 + 1) >> 1);
+            zm[0] = static_cast<int32_t>((evenRe2 - tRe * 2 + 1) >> 1);
+            zm[1] = static_cast<int32_t>((tIm * 2 - evenIm2 + 1) >> 1);
+        }
+    }
+
     void MathUtils::VecLogarithmF32(std::vector <float>& input,
                                     std::vector <float>& output)
     {
@@ -252,6 +512,48 @@ namespace math {
         return output;
     }
 
+    void MathUtils::CrossCorrelationF32(const float* x, const float* y, const size_t len,
+                                        float* xCorr, const size_t numLags)
+    {
+#if (defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1))
+        for (size_t k = 0; k < numLags; ++k) {
+            arm_dot_prod_f32(const_cast<float*>(x), const_cast<float*>(y + k), len, &xCorr[k]);
+        }
+#else  /* __ARM_FEATURE_DSP */
+        size_t k = 0;
+
+        /* Four lags per pass share each x load and a sliding window of y; each lag
+         * keeps its own sequential sum so results match a lag at a time. */
+        for (; k + 4 <= numLags; k += 4) {
+            const float* yk = y + k;
+            float sum0 = 0.f;
+            float sum1 = 0.f;
+            float sum2 = 0.f;
+            float sum3 = 0.f;
+            for (size_t j = 0; j < len; ++j) {
+                const float xj = x[j];
+                sum0 += xj * yk[j];
+                sum1 += xj * yk[j + 1];
+                sum2 += xj * yk[j + 2];
+                sum3 += xj * yk[j + 3];
+            }
+            xCorr[k] = sum0;
+            xCorr[k + 1] = sum1;
+            xCorr[k + 2] = sum2;
+            xCorr[k + 3] = sum3;
+        }
+
+        for (; k < numLags; ++k) {
+            const float* yk = y + k;
+            float sum = 0.f;
+            for (size_t j = 0; j < len; ++j) {
+                sum += x[j] * yk[j];
+            }
+            xCorr[k] = sum;
+        }
+#endif /* __ARM_FEATURE_DSP */
+    }
+
     bool MathUtils::ComplexMagnitudeSquaredF32(float* ptrSrc,
                                                const uint32_t srcLen,
                                                float* ptrDst,
@@ -42,6 +42,9 @@ namespace math {
 #if (defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1))
         arm_rfft_fast_instance_f32  m_instanceReal;
         arm_cfft_instance_f32       m_instanceComplex;
+#else /* (defined (__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)) */
+        std::vector<float>          m_twiddles;     /* exp(-2*pi*i*k/fftLen), k < fftLen/2, as [re, im] pairs. */
+        std::vector<uint16_t>       m_bitReverse;   /* Bit reversed indices for the complex stage. */
 #endif /* (defined (__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)) */
         uint16_t                    m_fftLen{0};
         FftType                     m_type{FftType::real};
@@ -49,6 +52,15 @@ namespace math {
         bool                        m_initialised{false};
     };
 
+    /* Fixed point real FFT instance. The same portable implementation is used
+     * on every target so that results are bit exact. */
+    struct FftInstanceQ31 {
+        std::vector<int32_t>        m_twiddles;     /* exp(-2*pi*i*k/fftLen) in Q31, k < fftLen/2, as [re, im] pairs. */
+        std::vector<uint16_t>       m_bitReverse;   /* Bit reversed indices for the complex stage. */
+        uint16_t                    m_fftLen{0};
+        bool                        m_initialised{false};
+    };
+
     /* Class to provide Math functions like FFT, mean, stddev etc.
      * This will allow other classes, functions to be independent of
      * #if definition checks and provide a cleaner API. Also, it will
@@ -98,9 +110,20 @@ namespace math {
                                float mean);
 
         /**
-         * @brief       Initialises the internal FFT structures (if available
-         *              for the platform). This function should be called
-         *              prior to Fft32 function call if built with ARM DSP functions.
+         * @brief       Gets the standard deviation of elements from their sum and
+         *              sum of squares, with the same estimator as StdDevF32.
+         * @param[in]   sum      Sum of the elements.
+         * @param[in]   sumSq    Sum of the squares of the elements.
+         * @param[in]   count    Number of elements.
+         * @return      Standard deviation value.
+         */
+        static float StdDevFromSumsF32(double sum, double sumSq, uint32_t count);
+
+        /**
+         * @brief       Initialises the internal FFT structures. This function should
+         *              be called prior to Fft32 function call. Without ARM DSP functions,
+         *              power of two lengths use a portable radix-2 FFT whose twiddle
+         *              factors are computed here; other lengths fall back to a DFT.
          * @param[in]   fftLen        Requested length of the FFT.
          * @param[in]   fftInstance   FFT instance struct to use.
          * @param[in]   type          FFT type (real or complex)
@@ -119,6 +142,40 @@ namespace math {
                            std::vector<float>& fftOutput,
                            FftInstance& fftInstance);
 
+        /**
+         * @brief       Computes the FFT for the input buffer, as the vector overload,
+         *              for callers with fixed size storage.
+         * @param[in]   input          Input elements; may be modified.
+         * @param[in]   inputLen       Number of input elements.
+         * @param[out]  fftOutput      Output buffer to be populated by computed FFTs.
+         * @param[in]   fftOutputLen   Number of elements available at fftOutput.
+         * @param[in]   fftInstance    FFT instance struct to use.
+         */
+        static void FftF32(float* input, size_t inputLen,
+                           float* fftOutput, size_t fftOutputLen,
+                           FftInstance& fftInstance);
+
+        /**
+         * @brief       Initialises a fixed point real FFT instance.
+         * @param[in]   fftLen        Requested length of the FFT, a power of two.
+         * @param[in]   fftInstance   FFT instance struct to use.
+         * @return      true if successful, false otherwise.
+         */
+        static bool FftInitQ31(uint16_t fftLen, FftInstanceQ31& fftInstance);
+
+        /**
+         * @brief       Computes the real FFT of Q31 input. Each radix-2 stage halves its
+         *              output, so the result is the spectrum divided by the FFT length
+         *              and cannot overflow.
+         * @param[in]   input         fftLen Q31 input elements.
+         * @param[out]  fftOutput     fftLen Q31 output elements, in the same layout
+         *                            as FftF32: [real0, realN/2, real1, im1, ...].
+         * @param[in]   fftInstance   Initialised FFT instance struct to use.
+         */
+        static void FftRealQ31(const int32_t* input,
+                               int32_t* fftOutput,
+                               const FftInstanceQ31& fftInstance);
+
         /**
          * @brief       Computes the natural logarithms of input floating point
          *              vector
@@ -143,6 +200,20 @@ namespace math {
         static float DotProductF32(float* srcPtrA, float* srcPtrB,
                                    uint32_t srcLen);
 
+        /**
+         * @brief       Computes the cross-correlation of two floating point
+         *              vectors over a range of lags.
+         *              xCorr[k] = sum(x[0]*y[k] + x[1]*y[k+1] + .. + x[len-1]*y[k+len-1])
+         * @param[in]   x         Pointer to the first vector, len elements.
+         * @param[in]   y         Pointer to the second vector, len + numLags - 1
+         *                        elements.
+         * @param[in]   len       Number of elements correlated per lag.
+         * @param[out]  xCorr     Output buffer, numLags elements.
+         * @param[in]   numLags   Number of lags to compute.
+         */
+        static void CrossCorrelationF32(const float* x, const float* y, size_t len,
+                                        float* xCorr, size_t numLags);
+
         /**
          * @brief       Computes the squared magnitude of floating point
          *              complex number array.
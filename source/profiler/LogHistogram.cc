@@ -0,0 +1,111 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "LogHistogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace arm {
+namespace app {
+
+    void LogHistogram::Add(uint64_t value)
+    {
+        const uint32_t index = BucketIndex(value);
+        if (this->m_counts[index] == UINT16_MAX) {
+            /* Round up, so that no bucket with samples is emptied. */
+            for (uint16_t& count : this->m_counts) {
+                count = static_cast<uint16_t>((count + 1u) / 2);
+            }
+        }
+        ++this->m_counts[index];
+        ++this->m_count;
+        this->m_min = std::min(this->m_min, value);
+        this->m_max = std::max(this->m_max, value);
+    }
+
+    void LogHistogram::Clear()
+    {
+        this->m_counts.fill(0);
+        this->m_count = 0;
+        this->m_min = UINT64_MAX;
+        this->m_max = 0;
+    }
+
+    uint64_t LogHistogram::Percentile(double percent) const
+    {
+        if (this->m_count == 0) {
+            return 0;
+        }
+
+        /* Counts may have been halved, so rank against their sum rather than m_count. */
+        uint32_t total = 0;
+        for (uint16_t count : this->m_counts) {
+            total += count;
+        }
+
+        /* Rank of the sample at the percentile, from 1. */
+        const double rank = std::ceil(std::min(std::max(percent, 0.0), 100.0) / 100.0 * total);
+        const uint32_t target = std::max<uint32_t>(1, static_cast<uint32_t>(rank));
+
+        uint32_t seen = 0;
+        for (uint32_t i = 0; i < this->m_counts.size(); ++i) {
+            seen += this->m_counts[i];
+            if (seen >= target) {
+                return std::min(std::max(BucketUpperBound(i), this->m_min), this->m_max);
+            }
+        }
+        return this->m_max;
+    }
+
+    uint32_t LogHistogram::Count() const
+    {
+        return this->m_count;
+    }
+
+    uint32_t LogHistogram::BucketIndex(uint64_t value)
+    {
+        if (value < ms_subBuckets) {
+            return static_cast<uint32_t>(value);
+        }
+
+        const uint32_t exponent = 63 - __builtin_clzll(value);
+        if (exponent >= ms_maxExponent) {
+            return ms_overflowBucket;
+        }
+
+        /* The top ms_subBucketBits bits below the leading one pick the sub-bucket. */
+        const uint32_t shift = exponent - ms_subBucketBits;
+        const uint32_t sub = static_cast<uint32_t>(value >> shift) & (ms_subBuckets - 1);
+        return (shift + 1) * ms_subBuckets + sub;
+    }
+
+    uint64_t LogHistogram::BucketUpperBound(uint32_t index)
+    {
+        if (index < ms_subBuckets) {
+            return index;
+        }
+        if (index >= ms_overflowBucket) {
+            return UINT64_MAX;
+        }
+
+        const uint32_t shift = index / ms_subBuckets - 1;
+        const uint64_t lower = static_cast<uint64_t>(ms_subBuckets + index % ms_subBuckets) << shift;
+        return lower + (uint64_t{1} << shift) - 1;
+    }
+
+} /* namespace app */
+} /* namespace arm */
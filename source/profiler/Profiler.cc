@@ -17,7 +17,12 @@
 #include "Profiler.hpp"
 #include "log_macros.h"
 
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
 #include <cstring>
+#include <utility>
 
 namespace arm {
 namespace app {
@@ -29,6 +34,13 @@ namespace app {
         : m_name(name)
     {}
 
+    Profiler::~Profiler()
+    {
+        if (this->m_pmuConfigured) {
+            hal_pmu_final();
+        }
+    }
+
     bool Profiler::StartProfiling(const char* name)
     {
         if (name) {
@@ -36,14 +48,16 @@ namespace app {
         }
 
         if (!this->m_started) {
-            hal_pmu_init();
+            if (!this->m_pmuConfigured) {
+                hal_pmu_init();
+            }
             this->m_tstampSt.initialised = false;
-            hal_pmu_get_counters(&this->m_tstampSt);
+            this->GetCounters(this->m_tstampSt);
             if (this->m_tstampSt.initialised) {
                 if (this->m_profStats.count(this->m_name) == 0) {
                     this->m_profStats.insert(
-                            std::pair<std::string, std::vector<Statistics>>(
-                                    this->m_name, std::vector<Statistics>(this->m_tstampSt.num_counters))
+                            std::pair<std::string, std::vector<RunningStatistics>>(
+                                    this->m_name, std::vector<RunningStatistics>(this->m_tstampSt.num_counters))
                                     );
                 }
                 this->m_started = true;
@@ -58,8 +72,10 @@ namespace app {
     {
         if (this->m_started) {
             this->m_tstampEnd.initialised = false;
-            hal_pmu_get_counters(&this->m_tstampEnd);
-            hal_pmu_final();
+            this->GetCounters(this->m_tstampEnd);
+            if (!this->m_pmuConfigured) {
+                hal_pmu_final();
+            }
             this->m_started = false;
             if (this->m_tstampEnd.initialised) {
                 this->UpdateRunningStats(
@@ -87,33 +103,71 @@ namespace app {
     {
         this->m_started = false;
         this->m_profStats.clear();
+        for (RegionStats& region : this->m_regions) {
+            region.inclusive.clear();
+            region.exclusive.clear();
+            region.hasNested = false;
+        }
         memset(&this->m_tstampSt, 0, sizeof(this->m_tstampSt));
         memset(&this->m_tstampEnd, 0, sizeof(this->m_tstampEnd));
     }
 
     void calcProfilingStat(uint64_t currentValue,
-                           Statistics& data)
+                           RunningStatistics& running)
     {
+        Statistics& data = running.stat;
+        const double previousAvrg = data.samplesNum > 1 ? data.avrg : 0;
+
         data.total += currentValue;
-        data.min = std::min(data.min, currentValue);
-        data.max = std::max(data.max, currentValue);
+        if (data.samplesNum == 1) {
+            data.min = currentValue;
+            data.max = currentValue;
+        } else {
+            data.min = std::min(data.min, currentValue);
+            data.max = std::max(data.max, currentValue);
+        }
         data.avrg = (static_cast<double>(data.total) / data.samplesNum);
+
+        /* Welford's update, for the jitter. */
+        data.sqDiffSum += (currentValue - previousAvrg) * (currentValue - data.avrg);
+        running.histogram.Add(currentValue);
     }
 
-    void Profiler::GetAllResultsAndReset(std::vector<ProfileResult>& results)
+    /* Fills in the percentiles and jitter of a series of statistics and moves them into a result. */
+    static ProfileResult collectResult(const std::string& name, std::vector<RunningStatistics>& series)
     {
-        for (const auto& item: this->m_profStats) {
-            auto name = item.first;
-            std::vector<Statistics> series = item.second;
-            ProfileResult result{};
-            result.name = item.first;
+        ProfileResult result{};
+        result.name = name;
+        result.data.reserve(series.size());
 
-            for (Statistics& stat : series) {
-                result.samplesNum = stat.samplesNum;
-                result.data.emplace_back(stat);
+        for (RunningStatistics& running : series) {
+            Statistics& stat = running.stat;
+            stat.p50 = running.histogram.Percentile(50);
+            stat.p90 = running.histogram.Percentile(90);
+            stat.p99 = running.histogram.Percentile(99);
+            if (stat.samplesNum > 0) {
+                stat.jitter = std::sqrt(stat.sqDiffSum / stat.samplesNum);
             }
+            result.samplesNum = stat.samplesNum;
+            result.data.emplace_back(std::move(stat));
+        }
+        return result;
+    }
 
-            results.emplace_back(result);
+    void Profiler::GetAllResultsAndReset(std::vector<ProfileResult>& results)
+    {
+        for (auto& item: this->m_profStats) {
+            results.emplace_back(collectResult(item.first, item.second));
+        }
+
+        for (RegionStats& region : this->m_regions) {
+            if (region.inclusive.empty()) {
+                continue;
+            }
+            results.emplace_back(collectResult(region.name, region.inclusive));
+            if (!region.exclusive.empty()) {
+                results.emplace_back(collectResult(region.name + " (exclusive)", region.exclusive));
+            }
         }
 
         this->Reset();
@@ -121,7 +175,7 @@ namespace app {
 
     void printStatisticsHeader(uint32_t samplesNum) {
         info("Number of samples: %" PRIu32 "\n", samplesNum);
-        info("%s\n", "Total / Avg./ Min / Max");
+        info("%s\n", "Total / Avg./ Min / Max / P50 / P90 / P99 / Jitter");
     }
 
     void Profiler::PrintProfilingResult(bool printFullStat) {
@@ -137,9 +191,11 @@ namespace app {
 
             for (Statistics &stat: result.data) {
                 if (printFullStat) {
-                    info("%s %s: %" PRIu64 "/ %.0f / %" PRIu64 " / %" PRIu64 " \n",
+                    info("%s %s: %" PRIu64 "/ %.0f / %" PRIu64 " / %" PRIu64
+                         " / %" PRIu64 " / %" PRIu64 " / %" PRIu64 " / %.0f \n",
                          stat.name.c_str(), stat.unit.c_str(),
-                         stat.total, stat.avrg, stat.min, stat.max);
+                         stat.total, stat.avrg, stat.min, stat.max,
+                         stat.p50, stat.p90, stat.p99, stat.jitter);
                 } else {
                     info("%s: %.0f %s\n", stat.name.c_str(), stat.avrg, stat.unit.c_str());
                 }
@@ -147,11 +203,223 @@ namespace app {
         }
     }
 
+    /* Quotes a CSV field if it needs it. */
+    static std::string csvField(const std::string& str)
+    {
+        if (str.find_first_of(",\"\n") == std::string::npos) {
+            return str;
+        }
+        std::string quoted = "\"";
+        for (char c : str) {
+            quoted += c;
+            if (c == '"') {
+                quoted += '"';
+            }
+        }
+        return quoted + "\"";
+    }
+
+    /* Quotes and escapes a JSON string. */
+    static std::string jsonString(const std::string& str)
+    {
+        std::string quoted = "\"";
+        for (char c : str) {
+            if (c == '"' || c == '\\') {
+                quoted += '\\';
+                quoted += c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                char escaped[8];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                quoted += escaped;
+            } else {
+                quoted += c;
+            }
+        }
+        return quoted + "\"";
+    }
+
+    void Profiler::FormatProfilingResult(const std::vector<ProfileResult>& results,
+                                         ProfilingExportFormat format,
+                                         std::vector<std::string>& lines)
+    {
+        if (format == ProfilingExportFormat::Csv) {
+            lines.emplace_back("region,counter,unit,samples,total,avg,min,p50,p90,p99,max,jitter");
+        }
+
+        char numbers[256];
+        for (const ProfileResult& result : results) {
+            for (const Statistics& stat : result.data) {
+                if (format == ProfilingExportFormat::Csv) {
+                    snprintf(numbers, sizeof(numbers),
+                             "%" PRIu32 ",%" PRIu64 ",%.1f,%" PRIu64 ",%" PRIu64 ",%" PRIu64
+                             ",%" PRIu64 ",%" PRIu64 ",%.1f",
+                             stat.samplesNum, stat.total, stat.avrg, stat.min,
+                             stat.p50, stat.p90, stat.p99, stat.max, stat.jitter);
+                    lines.emplace_back(csvField(result.name) + "," + csvField(stat.name) + "," +
+                                       csvField(stat.unit) + "," + numbers);
+                } else {
+                    snprintf(numbers, sizeof(numbers),
+                             "\"samples\":%" PRIu32 ",\"total\":%" PRIu64 ",\"avg\":%.1f"
+                             ",\"min\":%" PRIu64 ",\"p50\":%" PRIu64 ",\"p90\":%" PRIu64
+                             ",\"p99\":%" PRIu64 ",\"max\":%" PRIu64 ",\"jitter\":%.1f}",
+                             stat.samplesNum, stat.total, stat.avrg, stat.min,
+                             stat.p50, stat.p90, stat.p99, stat.max, stat.jitter);
+                    lines.emplace_back("{\"region\":" + jsonString(result.name) +
+                                       ",\"counter\":" + jsonString(stat.name) +
+                                       ",\"unit\":" + jsonString(stat.unit) + "," + numbers);
+                }
+            }
+        }
+    }
+
+    void Profiler::ExportProfilingResult(ProfilingExportFormat format)
+    {
+        std::vector<ProfileResult> results{};
+        std::vector<std::string> lines{};
+        GetAllResultsAndReset(results);
+        FormatProfilingResult(results, format, lines);
+
+        /* Records bypass the logging macros, so that they are never filtered,
+         * prefixed or cut. Pending log messages are printed first. */
+        log_flush();
+        for (const std::string& line : lines) {
+            printf("%s\n", line.c_str());
+        }
+        fflush(stdout);
+    }
+
     void Profiler::SetName(const char* str)
     {
         this->m_name = std::string(str);
     }
 
+    ProfileRegionId Profiler::RegisterRegion(const char* name)
+    {
+        for (size_t i = 0; i < this->m_regions.size(); ++i) {
+            if (this->m_regions[i].name == name) {
+                return static_cast<ProfileRegionId>(i);
+            }
+        }
+
+        /* The stack never grows past this, so entering a region does not allocate. */
+        this->m_regionStack.reserve(ms_maxRegionDepth);
+
+        RegionStats region{};
+        region.name = name;
+        this->m_regions.emplace_back(std::move(region));
+        return static_cast<ProfileRegionId>(this->m_regions.size() - 1);
+    }
+
+    bool Profiler::EnterRegion(ProfileRegionId id)
+    {
+        if (id >= this->m_regions.size() || this->m_regionStack.size() == ms_maxRegionDepth) {
+            printf_err("Failed to enter profiling region %" PRIu32 "\n", id);
+            return false;
+        }
+
+        if (!this->m_pmuConfigured) {
+            hal_pmu_init();
+            this->m_pmuConfigured = true;
+        }
+
+        if (this->m_regionStack.empty()) {
+            /* The counters wrap between frames; deltas allow for that, but a stale
+             * overflow status would be reported on every read. */
+            this->ClearCounterOverflow();
+        }
+
+        this->m_regionStack.emplace_back();
+        RegionFrame& frame = this->m_regionStack.back();
+        frame.id = id;
+        memset(frame.nested, 0, sizeof(frame.nested));
+
+        /* Read the counters last, to leave the bookkeeping out of the region. */
+        this->m_regionCounters.initialised = false;
+        this->GetCounters(this->m_regionCounters);
+        for (size_t i = 0; i < this->m_regionCounters.num_counters; ++i) {
+            frame.start[i] = this->m_regionCounters.counters[i];
+        }
+        return true;
+    }
+
+    bool Profiler::ExitRegion(ProfileRegionId id)
+    {
+        /* Read the counters first, to leave the bookkeeping out of the region. */
+        this->m_regionCounters.initialised = false;
+        this->GetCounters(this->m_regionCounters);
+
+        if (this->m_regionStack.empty() || this->m_regionStack.back().id != id) {
+            printf_err("Profiling region %" PRIu32 " is not the innermost one\n", id);
+            return false;
+        }
+
+        const RegionFrame& frame = this->m_regionStack.back();
+        RegionFrame* parent = this->m_regionStack.size() > 1 ?
+                              &this->m_regionStack[this->m_regionStack.size() - 2] : nullptr;
+        RegionStats& region = this->m_regions[id];
+        const pmu_counters& counters = this->m_regionCounters;
+
+        if (!counters.initialised) {
+            this->m_regionStack.pop_back();
+            printf_err("Invalid counters\n");
+            return false;
+        }
+
+        if (region.inclusive.size() != counters.num_counters) {
+            region.inclusive.assign(counters.num_counters, RunningStatistics{});
+            region.exclusive.clear();
+            for (size_t i = 0; i < counters.num_counters; ++i) {
+                region.inclusive[i].stat.name = counters.counters[i].name;
+                region.inclusive[i].stat.unit = counters.counters[i].unit;
+            }
+        }
+
+        /* Until a region has nested regions, its exclusive statistics are its inclusive ones. */
+        if (region.hasNested && region.exclusive.empty()) {
+            region.exclusive = region.inclusive;
+        }
+
+        for (size_t i = 0; i < counters.num_counters; ++i) {
+            const uint64_t inclusive = CounterDelta(frame.start[i], counters.counters[i]);
+
+            ++region.inclusive[i].stat.samplesNum;
+            calcProfilingStat(inclusive, region.inclusive[i]);
+            if (!region.exclusive.empty()) {
+                ++region.exclusive[i].stat.samplesNum;
+                calcProfilingStat(inclusive - std::min(inclusive, frame.nested[i]), region.exclusive[i]);
+            }
+
+            if (parent) {
+                parent->nested[i] += inclusive;
+            }
+        }
+
+        if (parent) {
+            this->m_regions[parent->id].hasNested = true;
+        }
+        this->m_regionStack.pop_back();
+        return true;
+    }
+
+    uint64_t Profiler::CounterDelta(const pmu_counter_unit& start, const pmu_counter_unit& end)
+    {
+        const uint64_t delta = end.value - start.value;
+        if (end.bits == 0 || end.bits >= PMU_COUNTER_MAX_BITS) {
+            return delta;
+        }
+        return delta & ((uint64_t{1} << end.bits) - 1);
+    }
+
+    void Profiler::GetCounters(pmu_counters& counters)
+    {
+        hal_pmu_get_counters(&counters);
+    }
+
+    void Profiler::ClearCounterOverflow()
+    {
+        hal_pmu_clear_overflow();
+    }
+
     void Profiler::UpdateRunningStats(pmu_counters start, pmu_counters end,
                                       const std::string& name)
     {
@@ -166,32 +434,18 @@ namespace app {
         }
 
         for (size_t i = 0; i < unit.counters.num_counters; ++i) {
-            if (unit.counters.counters[i].value < start.counters[i].value) {
-                warn("Overflow detected for %s\n", unit.counters.counters[i].name);
-                unit.counters.counters[i].value = 0;
-            } else {
-                unit.counters.counters[i].value -= start.counters[i].value;
-            }
+            unit.counters.counters[i].value = CounterDelta(start.counters[i], end.counters[i]);
         }
 
         for (size_t i = 0; i < this->m_profStats[name].size(); ++i) {
-            this->m_profStats[name][i].name = unit.counters.counters[i].name;
-            this->m_profStats[name][i].unit = unit.counters.counters[i].unit;
-            ++this->m_profStats[name][i].samplesNum;
+            Statistics& stat = this->m_profStats[name][i].stat;
+            stat.name = unit.counters.counters[i].name;
+            stat.unit = unit.counters.counters[i].unit;
+            ++stat.samplesNum;
             calcProfilingStat(
                     unit.counters.counters[i].value,
                     this->m_profStats[name][i]);
         }
-
-        ProfileResult result{};
-        result.name = this->m_name;
-        if (!this->m_profStats[name].empty()) {
-            result.samplesNum = this->m_profStats[name][0].samplesNum;
-        }
-
-        for (Statistics& stat : this->m_profStats[name]) {
-            result.data.emplace_back(stat);
-        }
     }
 
 } /* namespace app */
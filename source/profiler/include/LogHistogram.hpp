@@ -0,0 +1,94 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef APP_LOG_HISTOGRAM_HPP
+#define APP_LOG_HISTOGRAM_HPP
+
+#include <array>
+#include <cstdint>
+
+namespace arm {
+namespace app {
+
+    /**
+     * @brief   Streaming histogram of 64-bit samples in fixed memory, used to
+     *          estimate percentiles.
+     *
+     *          Buckets are log-linear: values below 2^ms_subBucketBits have a
+     *          bucket each, and every power of two above is split into
+     *          2^ms_subBucketBits equal buckets. A percentile is therefore known
+     *          to within 1/2^ms_subBucketBits of its value (12.5%). Values of
+     *          2^ms_maxExponent and above go to a separate overflow bucket,
+     *          ms_overflowBucket.
+     *
+     *          Counts are 16-bit to keep the histogram small, as the profiler
+     *          holds one per counter and region. When a bucket is full, all
+     *          counts are halved: percentiles then describe the samples with
+     *          the older ones weighted down, to within one sample per bucket.
+     */
+    class LogHistogram {
+    public:
+        static constexpr uint32_t ms_subBucketBits = 3;
+        static constexpr uint32_t ms_subBuckets = 1u << ms_subBucketBits;
+        static constexpr uint32_t ms_maxExponent = 48;
+        static constexpr uint32_t ms_numBuckets = ms_subBuckets * (ms_maxExponent - ms_subBucketBits + 1);
+        static constexpr uint32_t ms_overflowBucket = ms_numBuckets;   /* Values of 2^ms_maxExponent and above. */
+
+        /**
+         * @brief       Adds a sample.
+         * @param[in]   value   Sample value.
+         **/
+        void Add(uint64_t value);
+
+        /** @brief  Removes all samples. */
+        void Clear();
+
+        /**
+         * @brief       Estimates a percentile of the samples.
+         * @param[in]   percent   Percentile, between 0 and 100.
+         * @return      Highest value of the bucket holding the percentile, bounded by the
+         *              smallest and largest samples; 0 if there are no samples.
+         **/
+        uint64_t Percentile(double percent) const;
+
+        /** @brief  Gets the number of samples added since the last Clear. */
+        uint32_t Count() const;
+
+        /**
+         * @brief       Gets the bucket a value is counted in.
+         * @param[in]   value   Sample value.
+         * @return      Bucket index.
+         **/
+        static uint32_t BucketIndex(uint64_t value);
+
+        /**
+         * @brief       Gets the highest value counted in a bucket.
+         * @param[in]   index   Bucket index.
+         * @return      Highest value of the bucket, UINT64_MAX for the overflow bucket.
+         **/
+        static uint64_t BucketUpperBound(uint32_t index);
+
+    private:
+        std::array<uint16_t, ms_numBuckets + 1> m_counts{}; /* Samples per bucket, then the overflow bucket. */
+        uint32_t m_count = 0;                               /* Total number of samples. */
+        uint64_t m_min = UINT64_MAX;                        /* Smallest sample. */
+        uint64_t m_max = 0;                                 /* Largest sample. */
+    };
+
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* APP_LOG_HISTOGRAM_HPP */
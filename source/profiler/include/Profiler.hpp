@@ -18,7 +18,9 @@
 #define APP_PROFILER_HPP
 
 #include "hal.h"
+#include "LogHistogram.hpp"
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <map>
@@ -36,6 +38,19 @@ namespace app {
         std::uint64_t min;
         std::uint64_t max;
         std::uint32_t samplesNum = 0;
+        double sqDiffSum = 0;           /* Sum of squared differences from the mean. */
+
+        /* Filled in when results are collected. */
+        std::uint64_t p50 = 0;
+        std::uint64_t p90 = 0;
+        std::uint64_t p99 = 0;
+        double jitter = 0;              /* Standard deviation. */
+    };
+
+    /** Statistics being gathered for a profiling metric, with the distribution of its samples. */
+    struct RunningStatistics {
+        Statistics stat;
+        LogHistogram histogram;         /* Kept out of the results, for the percentiles only. */
     };
 
     /** Profiling results with calculated statistics. */
@@ -50,8 +65,32 @@ namespace app {
         pmu_counters counters;
     };
 
+    /** Machine readable formats for profiling results. */
+    enum class ProfilingExportFormat {
+        Csv,        /* Header line, then one line per region and counter. */
+        JsonLines   /* One JSON object per region and counter. */
+    };
+
     /* A map for string identifiable profiling statistics. */
-    using ProfilingStats = std::map<std::string, std::vector<Statistics>>;
+    using ProfilingStats = std::map<std::string, std::vector<RunningStatistics>>;
+
+    /** Identifies a region registered for scoped profiling. */
+    using ProfileRegionId = std::uint32_t;
+
+    /** Statistics of a region profiled with scopes, one entry per counter. */
+    struct RegionStats {
+        std::string name;
+        std::vector<RunningStatistics> inclusive;   /* Including nested regions. */
+        std::vector<RunningStatistics> exclusive;   /* Excluding nested regions, once there are any. */
+        bool hasNested = false;                 /* A region was ever nested in this one. */
+    };
+
+    /** An entered region: counters at entry and the totals of nested regions. */
+    struct RegionFrame {
+        ProfileRegionId id;
+        pmu_counter_unit start[NUM_PMU_COUNTERS];
+        std::uint64_t nested[NUM_PMU_COUNTERS];
+    };
 
     /**
      * @brief   A very simple profiler example using the platform timer
@@ -68,8 +107,11 @@ namespace app {
         /** Default constructor. */
         Profiler();
 
-        /** Default destructor. */
-        ~Profiler() = default;
+        /** Destructor, releases the PMU if scoped profiling configured it. */
+        virtual ~Profiler();
+
+        Profiler(const Profiler&) = delete;
+        Profiler& operator=(const Profiler&) = delete;
 
         /** @brief  Start profiling => get starting time-stamp. */
         bool StartProfiling(const char* name = nullptr);
@@ -94,15 +136,84 @@ namespace app {
          **/
         void PrintProfilingResult(bool printFullStat = false);
 
+        /**
+         * @brief       Prints collected profiling results in a machine readable format,
+         *              one record per line on stdout, and resets the profiler. The
+         *              records do not go through the logging macros, so they are
+         *              printed whatever the log level.
+         * @param[in]   format   Output format.
+         **/
+        void ExportProfilingResult(ProfilingExportFormat format);
+
+        /**
+         * @brief       Formats profiling results, one record per line.
+         * @param[in]   results   Results from GetAllResultsAndReset.
+         * @param[in]   format    Output format.
+         * @param[out]  lines     Formatted lines, without line endings, are appended here.
+         **/
+        static void FormatProfilingResult(const std::vector<ProfileResult>& results,
+                                          ProfilingExportFormat format,
+                                          std::vector<std::string>& lines);
+
         /** @brief Set the profiler name. */
         void SetName(const char* str);
 
+        /**
+         * @brief       Registers a region for scoped profiling, see ProfileScope.
+         *              Registering a name again returns the same id.
+         * @param[in]   name   Region name, used in the results.
+         * @return      Region id.
+         **/
+        ProfileRegionId RegisterRegion(const char* name);
+
+        /**
+         * @brief       Enters a registered region, nested in the current one if any.
+         *              The PMU is configured on first use and then only read, at
+         *              region boundaries; its overflow status is cleared whenever no
+         *              region is open, as the counters are left to wrap.
+         * @param[in]   id   Region id.
+         * @return      true if successful, false if the id is invalid or nesting is too deep.
+         **/
+        bool EnterRegion(ProfileRegionId id);
+
+        /**
+         * @brief       Exits the innermost region, updating its inclusive and exclusive
+         *              statistics. Results are collected with the other profiling results;
+         *              exclusive statistics appear as "<name> (exclusive)" for regions
+         *              that had nested regions.
+         * @param[in]   id   Region id, must be that of the innermost region.
+         * @return      true if successful, false otherwise.
+         **/
+        bool ExitRegion(ProfileRegionId id);
+
+        static constexpr size_t ms_maxRegionDepth = 8;  /* Deepest region nesting. */
+
+        /**
+         * @brief       Difference between two readings of a counter, modulo its width,
+         *              so it stays valid if the counter wrapped in between.
+         * @param[in]   start   Earlier reading.
+         * @param[in]   end     Later reading.
+         * @return      Counter increment from start to end.
+         **/
+        static uint64_t CounterDelta(const pmu_counter_unit& start, const pmu_counter_unit& end);
+
+    protected:
+        /** @brief  Reads the current counter values, from the platform PMU. */
+        virtual void GetCounters(pmu_counters& counters);
+
+        /** @brief  Clears the overflow status of the platform PMU counters. */
+        virtual void ClearCounterOverflow();
+
     private:
         ProfilingStats     m_profStats;             /* Profiling stats map. */
         pmu_counters       m_tstampSt{};            /* Container for a current starting timestamp. */
         pmu_counters       m_tstampEnd{};           /* Container for a current ending timestamp. */
         bool               m_started = false;       /* Indicates profiler has been started. */
         std::string        m_name;                  /* Name given to this profiler. */
+        std::vector<RegionStats> m_regions;         /* Registered regions, by id. */
+        std::vector<RegionFrame> m_regionStack;     /* Entered regions, innermost last. */
+        pmu_counters       m_regionCounters{};      /* Counters read at a region boundary. */
+        bool               m_pmuConfigured = false; /* PMU is kept initialised for regions. */
 
 
         /**
@@ -118,6 +229,40 @@ namespace app {
                                 const std::string& name);
     };
 
+    /**
+     * @brief   Profiles the enclosing scope as a region registered with
+     *          Profiler::RegisterRegion. Scopes can be nested.
+     */
+    class ProfileScope {
+    public:
+        /**
+         * @brief       Enters the region.
+         * @param[in]   profiler   Profiler the region is registered with.
+         * @param[in]   id         Region id.
+         **/
+        ProfileScope(Profiler& profiler, ProfileRegionId id)
+        :   m_profiler(profiler),
+            m_id(id),
+            m_entered(profiler.EnterRegion(id))
+        {}
+
+        /** @brief  Exits the region. */
+        ~ProfileScope()
+        {
+            if (this->m_entered) {
+                this->m_profiler.ExitRegion(this->m_id);
+            }
+        }
+
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+
+    private:
+        Profiler&       m_profiler;
+        ProfileRegionId m_id;
+        bool            m_entered;
+    };
+
 } /* namespace app */
 } /* namespace arm */
 
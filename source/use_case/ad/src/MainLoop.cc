@@ -49,6 +49,9 @@ void MainLoop()
 
     arm::app::Profiler profiler{"ad"};
     caseContext.Set<arm::app::Profiler&>("profiler", profiler);
+#if BATCH_INFERENCE
+    caseContext.Set<bool>("batchInference", true);
+#endif /* BATCH_INFERENCE */
     caseContext.Set<arm::app::Model&>("model", model);
     caseContext.Set<uint32_t>("frameLength", arm::app::ad::g_FrameLength);
     caseContext.Set<uint32_t>("frameStride", arm::app::ad::g_FrameStride);
@@ -20,6 +20,7 @@
 #include "AdMelSpectrogram.hpp"
 #include "AdProcessing.hpp"
 #include "AudioUtils.hpp"
+#include "BatchInference.hpp"
 #include "UseCaseCommonUtils.hpp"
 #include "ImageUtils.hpp"
 #include "hal.h"
@@ -54,6 +55,7 @@ namespace app {
         const auto melSpecFrameStride = ctx.Get<uint32_t>("frameStride");
         const auto scoreThreshold     = ctx.Get<float>("scoreThreshold");
         const auto trainingMean       = ctx.Get<float>("trainingMean");
+        const bool batchInference     = ctx.Has("batchInference") && ctx.Get<bool>("batchInference");
 
         TfLiteTensor* outputTensor = model.GetOutputTensor(0);
         TfLiteTensor* inputTensor  = model.GetInputTensor(0);
@@ -66,6 +68,7 @@ namespace app {
         AdPreProcess preProcess{inputTensor, melSpecFrameLength, melSpecFrameStride, trainingMean};
         AdPostProcess postProcess{outputTensor};
         uint32_t machineOutputIndex = 0; /* default sample */
+        BatchInference batch{model};
 
         hal_audio_init();
         if (!hal_audio_configure(HAL_AUDIO_MODE_SINGLE_BURST,
@@ -99,29 +102,56 @@ namespace app {
             hal_lcd_display_text(
                 str_inf.c_str(), str_inf.size(), dataPsnTxtInfStartX, dataPsnTxtInfStartY, 0);
 
-            /* Start sliding through audio clip. */
-            while (audioDataSlider.HasNext()) {
-                const int16_t* inferenceWindow = audioDataSlider.Next();
-
-                preProcess.SetAudioWindowIndex(audioDataSlider.Index());
-                preProcess.DoPreProcess(inferenceWindow, preProcess.GetAudioWindowSize());
-
-                info("Inference %zu/%zu\n",
-                     audioDataSlider.Index() + 1,
-                     audioDataSlider.TotalStrides() + 1);
-
-                /* Run inference over this audio clip sliding window */
-                if (!RunInference(model, profiler)) {
-                    return false;
-                }
-
+            /* Post-processes the output tensor of a window and adds it to the score. */
+            auto accumulateResult = [&]() {
                 postProcess.DoPostProcess();
                 result += 0 - postProcess.GetOutputValue(machineOutputIndex);
 
 #if VERIFY_TEST_OUTPUT
                 DumpTensor(outputTensor);
 #endif        /* VERIFY_TEST_OUTPUT */
-            } /* while (audioDataSlider.HasNext()) */
+            };
+
+            if (batchInference) {
+                /* Whole clip at once: features, then inferences, then scores. */
+                std::vector<const int16_t*> windows;
+                while (audioDataSlider.HasNext()) {
+                    windows.push_back(audioDataSlider.Next());
+                }
+
+                if (!batch.Run(windows.size(),
+                               [&](size_t windowIdx) {
+                                   preProcess.SetAudioWindowIndex(windowIdx);
+                                   return preProcess.DoPreProcess(windows[windowIdx],
+                                                                  preProcess.GetAudioWindowSize());
+                               },
+                               [&](size_t) {
+                                   accumulateResult();
+                                   return true;
+                               })) {
+                    return false;
+                }
+                batch.PrintStats();
+            } else {
+                /* Start sliding through audio clip. */
+                while (audioDataSlider.HasNext()) {
+                    const int16_t* inferenceWindow = audioDataSlider.Next();
+
+                    preProcess.SetAudioWindowIndex(audioDataSlider.Index());
+                    preProcess.DoPreProcess(inferenceWindow, preProcess.GetAudioWindowSize());
+
+                    info("Inference %zu/%zu\n",
+                         audioDataSlider.Index() + 1,
+                         audioDataSlider.TotalStrides() + 1);
+
+                    /* Run inference over this audio clip sliding window */
+                    if (!RunInference(model, profiler)) {
+                        return false;
+                    }
+
+                    accumulateResult();
+                } /* while (audioDataSlider.HasNext()) */
+            }
 
             /* Use average over whole clip as final score. */
             result /= (audioDataSlider.TotalStrides() + 1);
@@ -51,8 +51,8 @@ void MainLoop()
     arm::app::Profiler profiler{"ad"};
     caseContext.Set<arm::app::Profiler&>("profiler", profiler);
     caseContext.Set<arm::app::Model&>("model", model);
-    caseContext.Set<uint32_t>("index", 0);
-    caseContext.Set<uint32_t>("result", 0);
+    caseContext.Set<int>("index", 0);
+    caseContext.Set<float>("result", 0);
     caseContext.Set<uint32_t>("frameLength", arm::app::ad::g_FrameLength);
     caseContext.Set<uint32_t>("frameStride", arm::app::ad::g_FrameStride);
     caseContext.Set<float>("scoreThreshold", arm::app::ad::g_ScoreThreshold);
@@ -64,5 +64,6 @@ void MainLoop()
      /* Loop. */
     do {
         alif::app::ClassifyVibrationHandler(caseContext);
+        log_flush();
     } while (1);
 }
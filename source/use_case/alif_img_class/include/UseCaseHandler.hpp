@@ -30,11 +30,36 @@
 #define ALIF_IMG_CLASS_EVT_HANDLER_HPP
 
 #include "AppContext.hpp"
+#include "Classifier.hpp"
+#include "ImgClassProcessing.hpp"
 #include "MobileNetModel.hpp"
 
+#include <string>
+#include <vector>
+
 namespace alif {
 namespace app {
 
+    /**
+     * @brief   Pre- and post-processing objects of the image classification handler.
+     *          Built once by MainLoop and reused for every frame.
+     */
+    class ImgClassSession {
+    public:
+        /**
+         * @brief       Constructor.
+         * @param[in]   model        Initialised MobileNet model.
+         * @param[in]   classifier   Classifier used to get the top results.
+         * @param[in]   labels       Labels of the model outputs.
+         **/
+        ImgClassSession(arm::app::Model& model, arm::app::Classifier& classifier,
+                        const std::vector<std::string>& labels);
+
+        std::vector<arm::app::ClassificationResult> m_results;  /* Results of the last frame. */
+        arm::app::ImgClassPreProcess m_preProcess;
+        arm::app::ImgClassPostProcess m_postProcess;
+    };
+
     bool ClassifyImageInit(arm::app::MobileNetModel& model);
 
     /**
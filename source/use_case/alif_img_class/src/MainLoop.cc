@@ -33,6 +33,7 @@
 #include "UseCaseHandler.hpp"       /* Handlers for different user options. */
 #include "UseCaseCommonUtils.hpp"   /* Utils functions. */
 #include "BufAttributes.hpp"        /* Buffer attributes to be applied */
+#include "CapturePipeline.hpp"      /* Overlapped camera capture. */
 
 namespace arm {
 namespace app {
@@ -81,8 +82,22 @@ void MainLoop()
     GetLabelsVector(labels);
     caseContext.Set<const std::vector <std::string>&>("labels", labels);
 
+#if !SKIP_MODEL
+    alif::app::ImgClassSession session{model, classifier, labels};
+    caseContext.Set<alif::app::ImgClassSession&>("session", session);
+
+    /* Results of the last frame, for access outside the handler. */
+    caseContext.Set<std::vector<arm::app::ClassificationResult>&>("results", session.m_results);
+#endif
+
+    /* Frames are captured from the camera while the previous one is processed. */
+    arm::app::HalCameraSource cameraSource;
+    arm::app::CapturePipeline capturePipeline{cameraSource};
+    caseContext.Set<arm::app::CapturePipeline&>("capturePipeline", capturePipeline);
+
     /* Loop. */
     do {
         alif::app::ClassifyImageHandler(caseContext);
+        log_flush();
     } while (1);
 }
@@ -36,6 +36,7 @@
 #include "hal.h"
 #include "log_macros.h"
 #include "ImgClassProcessing.hpp"
+#include "CapturePipeline.hpp"
 
 
 #include <cinttypes>
@@ -83,6 +84,15 @@ namespace app {
         return s.substr(0, comma);
     }
 
+    ImgClassSession::ImgClassSession(Model& model, Classifier& classifier,
+                                     const std::vector<std::string>& labels)
+    :   m_preProcess{model.GetInputTensor(0), model.IsDataSigned()},
+        m_postProcess{model.GetOutputTensor(0), classifier, labels, m_results}
+    {
+        /* Post-processing keeps the top 5 results. */
+        this->m_results.reserve(5);
+    }
+
     bool ClassifyImageInit(arm::app::MobileNetModel& model)
     {
         ScreenLayoutInit(lvgl_image, sizeof lvgl_image, LIMAGE_X, LIMAGE_Y, LV_ZOOM);
@@ -120,6 +130,7 @@ namespace app {
 #if !SKIP_MODEL
         auto& profiler = ctx.Get<Profiler&>("profiler");
         auto& model = ctx.Get<Model&>("model");
+        auto& session = ctx.Get<ImgClassSession&>("session");
 
         if (!model.IsInited()) {
             printf_err("Model is not initialised! Terminating processing.\n");
@@ -127,7 +138,6 @@ namespace app {
         }
 
         TfLiteTensor* inputTensor = model.GetInputTensor(0);
-        TfLiteTensor* outputTensor = model.GetOutputTensor(0);
         if (!inputTensor->dims) {
             printf_err("Invalid input tensor dims\n");
             return false;
@@ -141,118 +151,122 @@ namespace app {
         const uint32_t nCols       = inputShape->data[arm::app::MobileNetModel::ms_inputColsIdx];
         const uint32_t nRows       = inputShape->data[arm::app::MobileNetModel::ms_inputRowsIdx];
 
-        /* Set up pre and post-processing. */
-        ImgClassPreProcess preProcess = ImgClassPreProcess(inputTensor, model.IsDataSigned());
-
-        std::vector<ClassificationResult> results;
-        ImgClassPostProcess postProcess = ImgClassPostProcess(outputTensor,
-                ctx.Get<ImgClassClassifier&>("classifier"), ctx.Get<std::vector<std::string>&>("labels"),
-                results);
+        /* Pre and post-processing are set up once, in the session. */
+        ImgClassPreProcess& preProcess = session.m_preProcess;
+        ImgClassPostProcess& postProcess = session.m_postProcess;
+        std::vector<ClassificationResult>& results = session.m_results;
 #else
         const uint32_t nCols       = MIMAGE_X;
         const uint32_t nRows       = MIMAGE_Y;
 #endif
 
-        hal_camera_start();
+        auto& capturePipeline = ctx.Get<CapturePipeline&>("capturePipeline");
+        bool inferred = false;
 
-        uint32_t capturedFrameSize = 0;
-        const uint8_t* image_data = hal_camera_get_captured_frame(&capturedFrameSize);
-        if (!image_data || !capturedFrameSize) {
-            printf_err("hal_camera_get_captured_frame failed");
-            return false;
-        }
-
-        uint32_t lv_lock_state = lv_port_lock();
-        tprof5 = Get_SysTick_Cycle_Count32();
-        /* Display this image on the LCD. */
+        /* The next frame is captured while this one is being processed. */
+        const bool processed = capturePipeline.Step([&](const uint8_t* image_data, uint32_t) {
+            uint32_t lv_lock_state = lv_port_lock();
+            tprof5 = Get_SysTick_Cycle_Count32();
+            /* Display this image on the LCD. */
 #ifdef USE_LVGL_ZOOM
-        write_to_lvgl_buf(
+            write_to_lvgl_buf(
 #else
-        write_to_lvgl_buf_doubled(
+            write_to_lvgl_buf_doubled(
 #endif
-                MIMAGE_X, MIMAGE_Y, image_data, &lvgl_image[0][0]);
-        tprof5 = Get_SysTick_Cycle_Count32() - tprof5;
+                    MIMAGE_X, MIMAGE_Y, image_data, &lvgl_image[0][0]);
+            tprof5 = Get_SysTick_Cycle_Count32() - tprof5;
 
-        lv_obj_invalidate(ScreenLayoutImageObject());
+            lv_obj_invalidate(ScreenLayoutImageObject());
 
-        if (SKIP_MODEL || !run_requested()) {
+            if (SKIP_MODEL || !run_requested()) {
 #if SHOW_PROFILING
-            lv_label_set_text_fmt(ScreenLayoutLabelObject(0), "tprof1=%.3f ms", (double)tprof1 / SystemCoreClock * 1000);
-            lv_label_set_text_fmt(ScreenLayoutLabelObject(1), "tprof2=%.3f ms", (double)tprof2 / SystemCoreClock * 1000);
-            lv_label_set_text_fmt(ScreenLayoutLabelObject(2), "tprof3=%.3f ms", (double)tprof3 / SystemCoreClock * 1000);
-            lv_label_set_text_fmt(ScreenLayoutLabelObject(3), "tprof4=%.3f ms", (double)tprof4 / SystemCoreClock * 1000);
-            lv_label_set_text_fmt(ScreenLayoutLabelObject(4), "tprof5=%.3f ms", (double)tprof5 / SystemCoreClock * 1000);
+                lv_label_set_text_fmt(ScreenLayoutLabelObject(0), "tprof1=%.3f ms", (double)tprof1 / SystemCoreClock * 1000);
+                lv_label_set_text_fmt(ScreenLayoutLabelObject(1), "tprof2=%.3f ms", (double)tprof2 / SystemCoreClock * 1000);
+                lv_label_set_text_fmt(ScreenLayoutLabelObject(2), "tprof3=%.3f ms", (double)tprof3 / SystemCoreClock * 1000);
+                lv_label_set_text_fmt(ScreenLayoutLabelObject(3), "tprof4=%.3f ms", (double)tprof4 / SystemCoreClock * 1000);
+                lv_label_set_text_fmt(ScreenLayoutLabelObject(4), "tprof5=%.3f ms", (double)tprof5 / SystemCoreClock * 1000);
 #endif
 #if SHOW_EXPOSURE
-            lv_label_set_text_fmt(ScreenLayoutLabelObject(1), "low=%" PRIu32, exposure_low_count);
-            lv_label_set_text_fmt(ScreenLayoutLabelObject(2), "high=%" PRIu32, exposure_high_count);
-            lv_label_set_text_fmt(ScreenLayoutLabelObject(3), "gain=%.3f", get_image_gain());
+                lv_label_set_text_fmt(ScreenLayoutLabelObject(1), "low=%" PRIu32, exposure_low_count);
+                lv_label_set_text_fmt(ScreenLayoutLabelObject(2), "high=%" PRIu32, exposure_high_count);
+                lv_label_set_text_fmt(ScreenLayoutLabelObject(3), "gain=%.3f", get_image_gain());
 #endif
-            lv_led_off(ScreenLayoutLEDObject());
-            lv_port_unlock(lv_lock_state);
-            return true;
-        }
+                lv_led_off(ScreenLayoutLEDObject());
+                lv_port_unlock(lv_lock_state);
+                return true;
+            }
 
-        lv_led_on(ScreenLayoutLEDObject());
-        lv_port_unlock(lv_lock_state);
+            lv_led_on(ScreenLayoutLEDObject());
+            lv_port_unlock(lv_lock_state);
 
 #if !SKIP_MODEL
-        const size_t imgSz = inputTensor->bytes;
+            const size_t imgSz = inputTensor->bytes;
 
 #if SHOW_INF_TIME
-        uint32_t inf_prof = Get_SysTick_Cycle_Count32();
+            uint32_t inf_prof = Get_SysTick_Cycle_Count32();
 #endif
 
-        /* Run the pre-processing, inference and post-processing. */
-        if (!preProcess.DoPreProcess(image_data, imgSz)) {
-            printf_err("Pre-processing failed.");
-            return false;
-        }
+            /* Run the pre-processing, inference and post-processing. */
+            if (!preProcess.DoPreProcess(image_data, imgSz)) {
+                printf_err("Pre-processing failed.");
+                return false;
+            }
 
-        if (!RunInference(model, profiler)) {
-            printf_err("Inference failed.");
-            return false;
-        }
+            if (!RunInference(model, profiler)) {
+                printf_err("Inference failed.");
+                return false;
+            }
 
-        if (!postProcess.DoPostProcess()) {
-            printf_err("Post-processing failed.");
-            return false;
-        }
+            if (!postProcess.DoPostProcess()) {
+                printf_err("Post-processing failed.");
+                return false;
+            }
 
 #if SHOW_INF_TIME
-        inf_prof = Get_SysTick_Cycle_Count32() - inf_prof;
+            inf_prof = Get_SysTick_Cycle_Count32() - inf_prof;
 #endif
 
-        /* Add results to context for access outside handler. */
-        ctx.Set<std::vector<ClassificationResult>>("results", results);
-
-        lv_lock_state = lv_port_lock();
-        for (int r = 0; r < 3; r++) {
-            lv_obj_t *label = ScreenLayoutLabelObject(r);
-            lv_label_set_text_fmt(label, "%s (%d%%)", first_bit(results[r].m_label).c_str(), (int)(results[r].m_normalisedVal * 100));
-            if (results[r].m_normalisedVal >= 0.7) {
-                lv_obj_add_state(label, LV_STATE_USER_1);
-            } else {
-                lv_obj_remove_state(label, LV_STATE_USER_1);
+            lv_lock_state = lv_port_lock();
+            for (int r = 0; r < 3; r++) {
+                lv_obj_t *label = ScreenLayoutLabelObject(r);
+                lv_label_set_text_fmt(label, "%s (%d%%)", first_bit(results[r].m_label).c_str(), (int)(results[r].m_normalisedVal * 100));
+                if (results[r].m_normalisedVal >= 0.7) {
+                    lv_obj_add_state(label, LV_STATE_USER_1);
+                } else {
+                    lv_obj_remove_state(label, LV_STATE_USER_1);
+                }
+                if (results[r].m_normalisedVal < 0.2) {
+                    lv_obj_add_state(label, LV_STATE_USER_2);
+                } else {
+                    lv_obj_remove_state(label, LV_STATE_USER_2);
+                }
             }
-            if (results[r].m_normalisedVal < 0.2) {
-                lv_obj_add_state(label, LV_STATE_USER_2);
-            } else {
-                lv_obj_remove_state(label, LV_STATE_USER_2);
-            }
-        }
 
 #if SHOW_INF_TIME
-        lv_label_set_text_fmt(ScreenLayoutHeaderObject(), "%s - %.2f FPS", "Image Classifier", (double) SystemCoreClock / inf_prof);
-        lv_label_set_text_fmt(ScreenLayoutTimeObject(), "%.3f ms", (double)inf_prof / SystemCoreClock * 1000);
+            lv_label_set_text_fmt(ScreenLayoutHeaderObject(), "%s - %.2f FPS", "Image Classifier", (double) SystemCoreClock / inf_prof);
+            lv_label_set_text_fmt(ScreenLayoutTimeObject(), "%.3f ms", (double)inf_prof / SystemCoreClock * 1000);
 #endif
-        lv_port_unlock(lv_lock_state);
+            lv_port_unlock(lv_lock_state);
+            inferred = true;
+#endif /* !SKIP_MODEL */
+            return true;
+        });
 
-        if (!PresentInferenceResult(results)) {
+        if (!processed) {
             return false;
         }
 
-        profiler.PrintProfilingResult();
+#if !SKIP_MODEL
+        if (inferred) {
+            if (!PresentInferenceResult(results)) {
+                return false;
+            }
+
+            profiler.PrintProfilingResult();
+            capturePipeline.PrintStats();
+        }
+#else
+        UNUSED(inferred);
 #endif
 
         return true;
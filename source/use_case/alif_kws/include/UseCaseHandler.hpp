@@ -30,10 +30,52 @@
 #define ALIF_KWS_EVT_HANDLER_HPP
 
 #include "AppContext.hpp"
+#include "KwsClassifier.hpp"
+#include "KwsProcessing.hpp"
+#include "KwsResult.hpp"
+#include "Model.hpp"
+#include "Profiler.hpp"
+
+#include <string>
+#include <vector>
 
 namespace alif {
 namespace app {
 
+    /**
+     * @brief   Pre- and post-processing objects of the KWS handler. Built once by
+     *          MainLoop, so the MFCC tables are not rebuilt, the result buffers
+     *          are not reallocated and the context attributes are not looked up
+     *          by name on each handler call.
+     */
+    class KwsSession {
+    public:
+        /**
+         * @brief       Constructor.
+         * @param[in]   ctx               Application context the handler is called with.
+         * @param[in]   model             Initialised MicroNet KWS model.
+         * @param[in]   mfccFrameLength   Number of audio samples in an MFCC frame.
+         * @param[in]   mfccFrameStride   Number of audio samples between MFCC frames.
+         * @param[in]   classifier        Classifier used to get the top results.
+         * @param[in]   labels            Labels of the model outputs.
+         **/
+        KwsSession(arm::app::ApplicationContext& ctx, arm::app::Model& model,
+                   int mfccFrameLength, int mfccFrameStride,
+                   arm::app::KwsClassifier& classifier, const std::vector<std::string>& labels);
+
+        /* Context attributes read by the handler. */
+        const arm::app::ContextKey<arm::app::Profiler&> m_profilerKey;
+        const arm::app::ContextKey<arm::app::Model&> m_modelKey;
+        const arm::app::ContextKey<int> m_frameLengthKey;
+        const arm::app::ContextKey<int> m_audioRateKey;
+        const arm::app::ContextKey<float> m_scoreThresholdKey;
+
+        std::vector<arm::app::ClassificationResult> m_singleInfResult;  /* Results of the last window. */
+        std::vector<arm::app::kws::KwsResult> m_infResults;             /* Results of the latest windows. */
+        arm::app::KwsPreProcess m_preProcess;
+        arm::app::KwsPostProcess m_postProcess;
+    };
+
     /**
      * @brief       Handles the inference event.
      * @param[in]   ctx         Pointer to the application context.
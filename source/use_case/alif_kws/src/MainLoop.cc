@@ -97,6 +97,11 @@ void MainLoop()
 
     caseContext.Set<const std::vector <std::string>&>("labels", labels);
 
+    alif::app::KwsSession session{caseContext, model,
+                                  arm::app::kws::g_FrameLength, arm::app::kws::g_FrameStride,
+                                  classifier, labels};
+    caseContext.Set<alif::app::KwsSession&>("session", session);
+
     bool executionSuccessful = true;
 
 #if USE_APP_MENU
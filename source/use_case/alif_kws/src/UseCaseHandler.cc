@@ -66,9 +66,12 @@ using arm::app::MicroNetKwsModel;
 
 #define AUDIO_SAMPLES 16000 // 16k samples/sec, 1sec sample
 #define AUDIO_STRIDE 8000 // 0.5 seconds
+#define AUDIO_RING_GUARD 1024 // mirrored samples, must be at least MFCC frame length - 1
 #define RESULTS_MEMORY 8
 
-static int16_t audio_inf[AUDIO_SAMPLES + AUDIO_STRIDE];
+// Ring holds the inference window plus the stride being captured, followed by the guard
+static int16_t audio_ring_buf[AUDIO_SAMPLES + AUDIO_STRIDE + AUDIO_RING_GUARD];
+static audio_ring audio_inf;
 
 namespace alif {
 namespace app {
@@ -88,6 +91,23 @@ using namespace arm::app::kws;
  **/
 static bool PresentInferenceResult(const std::vector<arm::app::kws::KwsResult>& results);
 
+    KwsSession::KwsSession(ApplicationContext& ctx, Model& model,
+                           const int mfccFrameLength, const int mfccFrameStride,
+                           KwsClassifier& classifier, const std::vector<std::string>& labels)
+    :   m_profilerKey{ctx.GetKey<Profiler&>("profiler")},
+        m_modelKey{ctx.GetKey<Model&>("model")},
+        m_frameLengthKey{ctx.GetKey<int>("frameLength")},
+        m_audioRateKey{ctx.GetKey<int>("audioRate")},
+        m_scoreThresholdKey{ctx.GetKey<float>("scoreThreshold")},
+        m_preProcess{model.GetInputTensor(0),
+                     static_cast<size_t>(model.GetInputShape(0)->data[MicroNetKwsModel::ms_inputColsIdx]),
+                     static_cast<size_t>(model.GetInputShape(0)->data[MicroNetKwsModel::ms_inputRowsIdx]),
+                     mfccFrameLength, mfccFrameStride},
+        m_postProcess{model.GetOutputTensor(0), classifier, labels, m_singleInfResult}
+    {
+        this->m_infResults.reserve(RESULTS_MEMORY);
+    }
+
 #ifdef SE_SERVICES_SUPPORT
 static std::string last_label;
 
@@ -120,12 +140,12 @@ static void send_msg_if_needed(arm::app::kws::KwsResult &result)
     /* KWS inference handler. */
     bool ClassifyAudioHandler(ApplicationContext& ctx, bool oneshot)
     {
-        auto& profiler = ctx.Get<Profiler&>("profiler");
-        auto& model = ctx.Get<Model&>("model");
-        const auto mfccFrameLength = ctx.Get<int>("frameLength");
-        const auto mfccFrameStride = ctx.Get<int>("frameStride");
-        const auto audioRate = ctx.Get<int>("audioRate");
-        const auto scoreThreshold = ctx.Get<float>("scoreThreshold");
+        auto& session = ctx.Get<KwsSession&>("session");
+        auto& profiler = ctx.Get(session.m_profilerKey);
+        auto& model = ctx.Get(session.m_modelKey);
+        const auto mfccFrameLength = ctx.Get(session.m_frameLengthKey);
+        const auto audioRate = ctx.Get(session.m_audioRateKey);
+        const auto scoreThreshold = ctx.Get(session.m_scoreThresholdKey);
 
         constexpr int minTensorDims = static_cast<int>(
             (MicroNetKwsModel::ms_inputRowsIdx > MicroNetKwsModel::ms_inputColsIdx)?
@@ -138,7 +158,6 @@ static void send_msg_if_needed(arm::app::kws::KwsResult &result)
 
         /* Get Input and Output tensors for pre/post processing. */
         TfLiteTensor* inputTensor = model.GetInputTensor(0);
-        TfLiteTensor* outputTensor = model.GetOutputTensor(0);
         if (!inputTensor->dims) {
             printf_err("Invalid input tensor dims\n");
             return false;
@@ -147,26 +166,18 @@ static void send_msg_if_needed(arm::app::kws::KwsResult &result)
             return false;
         }
 
-        /* Get input shape for feature extraction. */
-        TfLiteIntArray* inputShape = model.GetInputShape(0);
-        const uint32_t numMfccFeatures = inputShape->data[MicroNetKwsModel::ms_inputColsIdx];
-        const uint32_t numMfccFrames = inputShape->data[arm::app::MicroNetKwsModel::ms_inputRowsIdx];
-
         /* We expect to be sampling 1 second worth of data at a time.
         *  NOTE: This is only used for time stamp calculation. */
         const float secondsPerSample = 1.0f / audioRate;
 
-        /* Set up pre and post-processing. */
-        KwsPreProcess preProcess = KwsPreProcess(inputTensor, numMfccFeatures, numMfccFrames,
-                                                 mfccFrameLength, mfccFrameStride);
-
-        std::vector<ClassificationResult> singleInfResult;
-        KwsPostProcess postProcess = KwsPostProcess(outputTensor, ctx.Get<KwsClassifier &>("classifier"),
-                                                    ctx.Get<std::vector<std::string>&>("labels"),
-                                                    singleInfResult);
+        /* Pre and post-processing are set up once, in the session. */
+        KwsPreProcess& preProcess = session.m_preProcess;
+        KwsPostProcess& postProcess = session.m_postProcess;
+        std::vector<ClassificationResult>& singleInfResult = session.m_singleInfResult;
 
         int index = 0;
-        std::vector<kws::KwsResult> infResults;
+        std::vector<kws::KwsResult>& infResults = session.m_infResults;
+        infResults.clear();
         static bool audio_inited;
         if (!audio_inited) {
             int err = hal_audio_alif_init(audioRate);
@@ -177,8 +188,22 @@ static void send_msg_if_needed(arm::app::kws::KwsResult &result)
             audio_inited = true;
         }
 
+        if (mfccFrameLength > AUDIO_RING_GUARD + 1) {
+            printf_err("MFCC frame length %d exceeds audio ring guard\n", mfccFrameLength);
+            return false;
+        }
+
+        // Windows are read in place from the ring, wrapping at its end
+        hal_audio_ring_init(&audio_inf, audio_ring_buf, AUDIO_SAMPLES + AUDIO_STRIDE, AUDIO_RING_GUARD);
+        preProcess.SetAudioRing(audio_ring_buf, AUDIO_SAMPLES + AUDIO_STRIDE);
+
+        // First window starts with silence, as only one stride has been captured
+        hal_audio_ring_commit(&audio_inf, AUDIO_SAMPLES - AUDIO_STRIDE);
+
         // Start first fill of final stride section of buffer
-        hal_get_audio_data(audio_inf + AUDIO_SAMPLES, AUDIO_STRIDE);
+        int16_t *capture_block = hal_audio_ring_write_ptr(&audio_inf, AUDIO_STRIDE);
+        hal_get_audio_data(capture_block, AUDIO_STRIDE);
+        uint32_t reported_overruns = 0;
 
         do {
             // Wait until stride buffer is full - initiated above or by previous interation of loop
@@ -188,15 +213,20 @@ static void send_msg_if_needed(arm::app::kws::KwsResult &result)
                 return false;
             }
 
-            // move buffer down by one stride, clearing space at the end for the next stride
-            std::copy(audio_inf + AUDIO_STRIDE, audio_inf + AUDIO_STRIDE + AUDIO_SAMPLES, audio_inf);
+            int16_t *captured_block = capture_block;
+            hal_audio_ring_commit(&audio_inf, AUDIO_STRIDE);
 
             // start receiving the next stride immediately before we start heavy processing, so as not to lose anything
-            hal_get_audio_data(audio_inf + AUDIO_SAMPLES, AUDIO_STRIDE);
+            capture_block = hal_audio_ring_write_ptr(&audio_inf, AUDIO_STRIDE);
+            hal_get_audio_data(capture_block, AUDIO_STRIDE);
 
-            hal_audio_alif_preprocessing(audio_inf + AUDIO_SAMPLES - AUDIO_STRIDE, AUDIO_STRIDE);
+            hal_audio_alif_preprocessing(captured_block, AUDIO_STRIDE);
 
-            const int16_t* inferenceWindow = audio_inf;
+            const int16_t* inferenceWindow = hal_audio_ring_peek(&audio_inf, AUDIO_SAMPLES);
+            if (!inferenceWindow) {
+                printf_err("Not enough audio captured for inference\n");
+                return false;
+            }
 
             uint32_t start = Get_SysTick_Cycle_Count32();
             /* Run the pre-processing, inference and post-processing. */
@@ -220,6 +250,15 @@ static void send_msg_if_needed(arm::app::kws::KwsResult &result)
             }
             printf("Postprocessing time = %.3f ms\n", (double) (Get_SysTick_Cycle_Count32() - start) / SystemCoreClock * 1000);
 
+            // Oldest stride is no longer needed, the next capture block may reuse it
+            hal_audio_ring_consume(&audio_inf, AUDIO_STRIDE);
+            const audio_ring_stats ring_stats = hal_audio_ring_get_stats(&audio_inf);
+            if (ring_stats.overruns != reported_overruns) {
+                warn("Audio ring overruns: %" PRIu32 ", samples dropped: %" PRIu32 "\n",
+                     ring_stats.overruns, ring_stats.samples_dropped);
+                reported_overruns = ring_stats.overruns;
+            }
+
             /* Add results from this window to our final results vector. */
             if (infResults.size() == RESULTS_MEMORY) {
                 infResults.erase(infResults.begin());
@@ -232,7 +271,7 @@ static void send_msg_if_needed(arm::app::kws::KwsResult &result)
 #endif
 
 #if VERIFY_TEST_OUTPUT
-            DumpTensor(outputTensor);
+            DumpTensor(model.GetOutputTensor(0));
 #endif /* VERIFY_TEST_OUTPUT */
 
             hal_lcd_clear(COLOR_BLACK);
@@ -242,6 +281,7 @@ static void send_msg_if_needed(arm::app::kws::KwsResult &result)
             }
 
             profiler.PrintProfilingResult();
+            log_flush();
 
             ++index;
         } while (!oneshot);
@@ -114,6 +114,7 @@ void MainLoop()
     do {
         executionSuccessful = alif::app::ClassifyAudioHandler(caseContext, false);
         info("Going to chip STOP mode...\n");
+        log_flush();
         __disable_irq();
         while(1) {
             pm_core_enter_deep_sleep_request_subsys_off();
@@ -121,6 +122,7 @@ void MainLoop()
             __ISB();
             __disable_irq();
             info("Waiting for all IRQ are handled...\n");
+            log_flush();
         }
 
     } while (1);
@@ -124,7 +124,7 @@ static std::string last_label;
 
         std::vector<ClassificationResult> singleInfResult;
         KwsPostProcess postProcess = KwsPostProcess(outputTensor, ctx.Get<KwsClassifier &>("classifier"),
-                                                    ctx.Get<std::vector<std::string>&>("labels"),
+                                                    ctx.Get<const std::vector<std::string>&>("labels"),
                                                     singleInfResult);
 
         int index = 0;
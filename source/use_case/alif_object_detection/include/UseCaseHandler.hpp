@@ -30,11 +30,58 @@
 #define ALIF_OBJ_DET_HANDLER_HPP
 
 #include "AppContext.hpp"
+#include "CapturePipeline.hpp"
+#include "DetectorPostProcessing.hpp"
+#include "DetectorPreProcessing.hpp"
+#include "Profiler.hpp"
 #include "YoloFastestModel.hpp"
 
+#include <cstdint>
+#include <vector>
+
 namespace alif {
 namespace app {
 
+    /**
+     * @brief   Pre- and post-processing objects of the object detection handler.
+     *          Built once by MainLoop and reused for every frame, so the handler
+     *          neither rebuilds them, reallocates the results nor looks up the
+     *          context attributes by name.
+     */
+    class ObjectDetectionSession {
+    public:
+        /**
+         * @brief       Constructor.
+         * @param[in]   ctx        Application context the handler is called with.
+         * @param[in]   model      Initialised YOLO Fastest model.
+         * @param[in]   profiler   Profiler the processing stages are registered with.
+         **/
+        ObjectDetectionSession(arm::app::ApplicationContext& ctx, arm::app::Model& model,
+                               arm::app::Profiler& profiler);
+
+        /* Context attributes read by the handler. */
+        const arm::app::ContextKey<arm::app::Profiler&> m_profilerKey;
+        const arm::app::ContextKey<arm::app::Model&> m_modelKey;
+        const arm::app::ContextKey<arm::app::CapturePipeline&> m_capturePipelineKey;
+
+        std::vector<arm::app::object_detection::DetectionResult> m_results;  /* Detections of the last frame. */
+        const arm::app::object_detection::PostProcessParams m_postProcessParams;
+        arm::app::DetectorPreProcess m_preProcess;
+        arm::app::DetectorPostProcess m_postProcess;
+
+        /* Profiling regions: a frame, and the stages nested in it. */
+        const arm::app::ProfileRegionId m_frameRegion;
+        const arm::app::ProfileRegionId m_preProcessRegion;
+        const arm::app::ProfileRegionId m_invokeRegion;
+        const arm::app::ProfileRegionId m_postProcessRegion;
+        const arm::app::ProfileRegionId m_displayRegion;
+
+        /* Profiling results are printed once every ms_profilingInterval frames,
+         * so that the percentiles and jitter cover more than one sample. */
+        static constexpr uint32_t ms_profilingInterval = 100;
+        uint32_t m_framesSinceProfiling = 0;
+    };
+
     bool ObjectDetectionInit(arm::app::YoloFastestModel& model);
 
     /**
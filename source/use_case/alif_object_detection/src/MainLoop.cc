@@ -32,6 +32,7 @@
 #include "UseCaseCommonUtils.hpp"     /* Utils functions. */
 #include "log_macros.h"             /* Logging functions */
 #include "BufAttributes.hpp"        /* Buffer attributes to be applied */
+#include "CapturePipeline.hpp"      /* Overlapped camera capture. */
 
 namespace arm {
 namespace app {
@@ -70,8 +71,17 @@ void MainLoop()
     caseContext.Set<arm::app::Profiler&>("profiler", profiler);
     caseContext.Set<arm::app::Model&>("model", model);
 
+    alif::app::ObjectDetectionSession session{caseContext, model, profiler};
+    caseContext.Set<alif::app::ObjectDetectionSession&>("session", session);
+
+    /* Frames are captured from the camera while the previous one is processed. */
+    arm::app::HalCameraSource cameraSource;
+    arm::app::CapturePipeline capturePipeline{cameraSource};
+    caseContext.Set<arm::app::CapturePipeline&>("capturePipeline", capturePipeline);
+
     /* Loop. */
     do {
         alif::app::ObjectDetectionHandler(caseContext);
+        log_flush();
     } while (1);
 }
@@ -29,6 +29,7 @@
 #include "UseCaseHandler.hpp"
 #include "YoloFastestModel.hpp"
 #include "UseCaseCommonUtils.hpp"
+#include "CapturePipeline.hpp"
 #include "DetectorPostProcessing.hpp"
 #include "DetectorPreProcessing.hpp"
 #include "ScreenLayout.hpp"
@@ -65,6 +66,28 @@ namespace object_detection {
 using namespace arm::app::object_detection;
 }
 
+    ObjectDetectionSession::ObjectDetectionSession(ApplicationContext& ctx, Model& model, Profiler& profiler)
+    :   m_profilerKey{ctx.GetKey<Profiler&>("profiler")},
+        m_modelKey{ctx.GetKey<Model&>("model")},
+        m_capturePipelineKey{ctx.GetKey<arm::app::CapturePipeline&>("capturePipeline")},
+        m_postProcessParams{model.GetInputShape(0)->data[YoloFastestModel::ms_inputRowsIdx],
+                            model.GetInputShape(0)->data[YoloFastestModel::ms_inputColsIdx],
+                            object_detection::originalImageSize,
+                            object_detection::anchor1, object_detection::anchor2},
+        m_preProcess{model.GetInputTensor(0), true, model.IsDataSigned()},
+        m_postProcess{model.GetOutputTensor(0), model.GetOutputTensor(1),
+                      m_results, m_postProcessParams},
+        m_frameRegion{profiler.RegisterRegion("Frame")},
+        m_preProcessRegion{profiler.RegisterRegion("Pre-processing")},
+        m_invokeRegion{profiler.RegisterRegion("Invoke")},
+        m_postProcessRegion{profiler.RegisterRegion("Post-processing")},
+        m_displayRegion{profiler.RegisterRegion("Display")}
+    {
+        /* The number of detections is not limited: room for the faces of a typical
+         * frame, the vector keeps any larger capacity it grows to. */
+        this->m_results.reserve(16);
+    }
+
     bool ObjectDetectionInit(YoloFastestModel& model)
     {
 
@@ -124,8 +147,10 @@ using namespace arm::app::object_detection;
     /* Object detection inference handler. */
     bool ObjectDetectionHandler(ApplicationContext& ctx)
     {
-        auto& profiler = ctx.Get<Profiler&>("profiler");
-        auto& model = ctx.Get<Model&>("model");
+        auto& session = ctx.Get<ObjectDetectionSession&>("session");
+        auto& profiler = ctx.Get(session.m_profilerKey);
+        auto& model = ctx.Get(session.m_modelKey);
+        auto& capturePipeline = ctx.Get(session.m_capturePipelineKey);
 
         if (!model.IsInited()) {
             printf_err("Model is not initialised! Terminating processing.\n");
@@ -133,8 +158,6 @@ using namespace arm::app::object_detection;
         }
 
         TfLiteTensor* inputTensor = model.GetInputTensor(0);
-        TfLiteTensor* outputTensor0 = model.GetOutputTensor(0);
-        TfLiteTensor* outputTensor1 = model.GetOutputTensor(1);
 
         if (!inputTensor->dims) {
             printf_err("Invalid input tensor dims\n");
@@ -149,30 +172,18 @@ using namespace arm::app::object_detection;
         const int inputImgCols = inputShape->data[YoloFastestModel::ms_inputColsIdx];
         const int inputImgRows = inputShape->data[YoloFastestModel::ms_inputRowsIdx];
 
-        /* Set up pre and post-processing. */
-        DetectorPreProcess preProcess = DetectorPreProcess(inputTensor, true, model.IsDataSigned());
-
-        std::vector<object_detection::DetectionResult> results;
-        const object_detection::PostProcessParams postProcessParams {
-            inputImgRows, inputImgCols, object_detection::originalImageSize,
-            object_detection::anchor1, object_detection::anchor2
-        };
-        DetectorPostProcess postProcess = DetectorPostProcess(outputTensor0, outputTensor1,
-                results, postProcessParams);
+        /* Pre and post-processing are set up once, in the session. */
+        DetectorPreProcess& preProcess = session.m_preProcess;
+        DetectorPostProcess& postProcess = session.m_postProcess;
+        std::vector<object_detection::DetectionResult>& results = session.m_results;
 
-        /* Ensure there are no results leftover from previous inference when running all. */
+        /* Ensure there are no results leftover from the previous frame. */
         results.clear();
 
-        hal_camera_start();
-
-        uint32_t capturedFrameSize = 0;
-        const uint8_t* currImage = hal_camera_get_captured_frame(&capturedFrameSize);
-        if (!currImage || !capturedFrameSize) {
-            printf_err("hal_camera_get_captured_frame failed");
-            return false;
-        }
-
-        {
+        /* The next frame is captured while this one is being processed. The HAL
+         * converts a captured frame into its output buffer only when it is
+         * collected, so the frame stays valid for the whole processing stage. */
+        const bool processed = capturePipeline.Step([&](const uint8_t* currImage, uint32_t) {
             ScopedLVGLLock lv_lock;
 
             /* Display this image on the LCD. */
@@ -187,6 +198,7 @@ using namespace arm::app::object_detection;
 
             lv_led_on(ScreenLayoutLEDObject());
 
+            ProfileScope frameScope{profiler, session.m_frameRegion};
             const size_t copySz = inputTensor->bytes;
 
 #if SHOW_INF_TIME
@@ -194,23 +206,33 @@ using namespace arm::app::object_detection;
 #endif
 
             /* Run the pre-processing, inference and post-processing. */
-            if (!preProcess.DoPreProcess(currImage, copySz)) {
-                printf_err("Pre-processing failed.");
-                return false;
+            {
+                ProfileScope scope{profiler, session.m_preProcessRegion};
+                if (!preProcess.DoPreProcess(currImage, copySz)) {
+                    printf_err("Pre-processing failed.");
+                    return false;
+                }
             }
 
             /* Run inference over this image. */
-
-            if (!RunInference(model, profiler)) {
-                printf_err("Inference failed.");
-                return false;
+            {
+                ProfileScope scope{profiler, session.m_invokeRegion};
+                if (!model.RunInference()) {
+                    printf_err("Inference failed.");
+                    return false;
+                }
             }
 
-            if (!postProcess.DoPostProcess()) {
-                printf_err("Post-processing failed.");
-                return false;
+            {
+                ProfileScope scope{profiler, session.m_postProcessRegion};
+                if (!postProcess.DoPostProcess()) {
+                    printf_err("Post-processing failed.");
+                    return false;
+                }
             }
 
+            ProfileScope displayScope{profiler, session.m_displayRegion};
+
 #if SHOW_INF_TIME
             inf_prof = Get_SysTick_Cycle_Count32() - inf_prof;
             lv_label_set_text_fmt(ScreenLayoutLabelObject(2), "Inference time: %.3f ms", (double)inf_prof / SystemCoreClock * 1000);
@@ -223,7 +245,12 @@ using namespace arm::app::object_detection;
             /* Draw boxes. */
             DrawDetectionBoxes(results, inputImgCols, inputImgRows);
 
-        } // ScopedLVGLLock
+            return true;
+        }); // ScopedLVGLLock
+
+        if (!processed) {
+            return false;
+        }
 
 #if VERIFY_TEST_OUTPUT
         DumpTensor(modelOutput0);
@@ -234,7 +261,11 @@ using namespace arm::app::object_detection;
             return false;
         }
 
-        profiler.PrintProfilingResult();
+        if (++session.m_framesSinceProfiling == ObjectDetectionSession::ms_profilingInterval) {
+            session.m_framesSinceProfiling = 0;
+            profiler.PrintProfilingResult(true);
+        }
+        capturePipeline.PrintStats();
 
         return true;
     }
@@ -112,11 +112,13 @@ void MainLoop()
         __disable_irq();
         while (obj_button_pressed) {
             info("Going to chip STOP mode...\n");
+            log_flush();
             pm_core_enter_deep_sleep_request_subsys_off();
             __enable_irq();
             __ISB();
             __disable_irq();
             info("Waiting for all IRQ are handled...\n");
+            log_flush();
         }
         __enable_irq();
 
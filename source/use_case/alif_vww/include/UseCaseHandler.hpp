@@ -18,10 +18,35 @@
 #define VISUAL_WAKE_WORD_HANDLER_HPP
 
 #include "AppContext.hpp"
+#include "Classifier.hpp"
+#include "Model.hpp"
+#include "VisualWakeWordProcessing.hpp"
+
+#include <string>
+#include <vector>
 
 namespace alif {
 namespace app {
 
+    /**
+     * @brief   Pre- and post-processing objects of the visual wake word handler.
+     *          Built once by MainLoop and reused for every frame.
+     */
+    class VisualWakeWordSession {
+    public:
+        /**
+         * @brief       Constructor.
+         * @param[in]   model        Initialised visual wake word model.
+         * @param[in]   classifier   Classifier used to get the top result.
+         * @param[in]   labels       Labels of the model outputs.
+         **/
+        VisualWakeWordSession(arm::app::Model& model, arm::app::Classifier& classifier,
+                              const std::vector<std::string>& labels);
+
+        std::vector<arm::app::ClassificationResult> m_results;  /* Results of the last frame. */
+        arm::app::VisualWakeWordPreProcess m_preProcess;
+        arm::app::VisualWakeWordPostProcess m_postProcess;
+    };
 
     bool ClassifyImageInit();
     /**
@@ -22,6 +22,7 @@
 #include "UseCaseCommonUtils.hpp"   /* Utils functions. */
 #include "log_macros.h"             /* Logging functions */
 #include "BufAttributes.hpp"        /* Buffer attributes to be applied */
+#include "CapturePipeline.hpp"      /* Overlapped camera capture. */
 
 namespace arm {
 namespace app {
@@ -69,9 +70,21 @@ void MainLoop()
     GetLabelsVector(labels);
     caseContext.Set<const std::vector <std::string>&>("labels", labels);
 
+    alif::app::VisualWakeWordSession session{model, classifier, labels};
+    caseContext.Set<alif::app::VisualWakeWordSession&>("session", session);
+
+    /* Results of the last frame, for access outside the handler. */
+    caseContext.Set<std::vector<arm::app::ClassificationResult>&>("results", session.m_results);
+
+    /* Frames are captured from the camera while the previous one is processed. */
+    arm::app::HalCameraSource cameraSource;
+    arm::app::CapturePipeline capturePipeline{cameraSource};
+    caseContext.Set<arm::app::CapturePipeline&>("capturePipeline", capturePipeline);
+
     /* Loop. */
     do {
         alif::app::ClassifyImageHandler(caseContext);
+        log_flush();
     } while (1);
 
 }
@@ -78,13 +78,14 @@ namespace app {
                                                  Wav2LetterModel::ms_numMfccFeatures,
                                                  inputShape->data[Wav2LetterModel::ms_inputRowsIdx],
                                                  mfccFrameLen,
-                                                 mfccFrameStride);
+                                                 mfccFrameStride,
+                                                 true);
 
         std::vector<ClassificationResult> singleInfResult;
         const uint32_t outputCtxLen = AsrPostProcess::GetOutputContextLen(model, inputCtxLen);
         AsrPostProcess postProcess  = AsrPostProcess(outputTensor,
                                                     ctx.Get<AsrClassifier&>("classifier"),
-                                                    ctx.Get<std::vector<std::string>&>("labels"),
+                                                    ctx.Get<const std::vector<std::string>&>("labels"),
                                                     singleInfResult,
                                                     outputCtxLen,
                                                     Wav2LetterModel::ms_blankTokenIdx,
@@ -131,6 +132,9 @@ namespace app {
 
             size_t inferenceWindowLen = audioDataWindowLen;
 
+            /* MFCC vectors from a previous clip must not be reused. */
+            preProcess.ResetStream();
+
             /* Start sliding through audio clip. */
             while (audioDataSlider.HasNext()) {
 
@@ -140,6 +144,8 @@ namespace app {
                     inferenceWindowLen = audioArrSize - nextStartIndex;
                 }
 
+                /* Overlapping MFCC vectors of consecutive windows are only computed once. */
+                preProcess.SetStreamOffset(nextStartIndex);
                 const int16_t* inferenceWindow = audioDataSlider.Next();
 
                 info("Inference %zu/%zu\n",
@@ -73,7 +73,7 @@ namespace app {
         ImgClassPostProcess postProcess =
             ImgClassPostProcess(outputTensor,
                                 ctx.Get<ImgClassClassifier&>("classifier"),
-                                ctx.Get<std::vector<std::string>&>("labels"),
+                                ctx.Get<const std::vector<std::string>&>("labels"),
                                 results);
         hal_camera_init();
         auto bCamera = hal_camera_configure(nCols,
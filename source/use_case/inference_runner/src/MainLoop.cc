@@ -21,6 +21,9 @@
 #include "UseCaseCommonUtils.hpp"   /* Utils functions. */
 #include "log_macros.h"             /* Logging functions */
 #include "BufAttributes.hpp"        /* Buffer attributes to be applied */
+#if defined(OP_PROFILE_ENABLED)
+#include "PmuOpProfiler.hpp"        /* Per-operator profiling. */
+#endif /* defined(OP_PROFILE_ENABLED) */
 
 namespace arm {
 namespace app {
@@ -56,11 +59,20 @@ void MainLoop()
 {
     arm::app::TestModel model;  /* Model wrapper object. */
 
+#if defined(OP_PROFILE_ENABLED)
+    arm::app::PmuOpProfiler opProfiler;
+    arm::app::OpProfiler* pOpProfiler = &opProfiler;
+#else /* defined(OP_PROFILE_ENABLED) */
+    arm::app::OpProfiler* pOpProfiler = nullptr;
+#endif /* defined(OP_PROFILE_ENABLED) */
+
     /* Load the model. */
     if (!model.Init(arm::app::tensorArena,
                     sizeof(arm::app::tensorArena),
                     arm::app::inference_runner::GetModelPointer(),
-                    arm::app::inference_runner::GetModelLen())) {
+                    arm::app::inference_runner::GetModelLen(),
+                    nullptr,
+                    pOpProfiler)) {
         printf_err("Failed to initialise model\n");
         return;
     }
@@ -78,4 +90,8 @@ void MainLoop()
     } else {
         printf_err("Inference failed.\n");
     }
+
+#if defined(OP_PROFILE_ENABLED)
+    opProfiler.PrintResults();
+#endif /* defined(OP_PROFILE_ENABLED) */
 }
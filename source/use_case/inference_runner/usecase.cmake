@@ -22,6 +22,14 @@ USER_OPTION(${use_case}_ACTIVATION_BUF_SZ "Activation buffer size for the chosen
     0x00200000
     STRING)
 
+USER_OPTION(${use_case}_OP_PROFILE_ENABLED "Report the cost of each operator of the model, and the NPU/CPU split"
+    OFF
+    BOOL)
+
+if (${use_case}_OP_PROFILE_ENABLED)
+    list(APPEND ${use_case}_COMPILE_DEFS "OP_PROFILE_ENABLED=1")
+endif()
+
 if (ETHOS_U_NPU_ENABLED)
     set(DEFAULT_MODEL_PATH      ${DEFAULT_MODEL_DIR}/dnn_s_quantized_vela_${ETHOS_U_NPU_CONFIG_ID}.tflite)
 else()
@@ -44,8 +52,9 @@ if (${${use_case}_DYNAMIC_MEM_LOAD_ENABLED})
     if (NOT DEFINED DYNAMIC_MODEL_BASE AND DEFINED DYNAMIC_MODEL_SIZE)
         message(FATAL_ERROR "${TARGET_PLATFORM} does not support dynamic load for model files.")
     else()
-        set(${use_case}_COMPILE_DEFS
-            "DYNAMIC_MODEL_BASE=${DYNAMIC_MODEL_BASE};DYNAMIC_MODEL_SIZE=${DYNAMIC_MODEL_SIZE}")
+        list(APPEND ${use_case}_COMPILE_DEFS
+            "DYNAMIC_MODEL_BASE=${DYNAMIC_MODEL_BASE}"
+            "DYNAMIC_MODEL_SIZE=${DYNAMIC_MODEL_SIZE}")
     endif()
 
     if (DEFINED DYNAMIC_IFM_BASE AND DEFINED DYNAMIC_IFM_SIZE)
@@ -52,6 +52,9 @@ void MainLoop()
 
     arm::app::Profiler profiler{"kws"};
     caseContext.Set<arm::app::Profiler&>("profiler", profiler);
+#if BATCH_INFERENCE
+    caseContext.Set<bool>("batchInference", true);
+#endif /* BATCH_INFERENCE */
     caseContext.Set<arm::app::Model&>("model", model);
     caseContext.Set<int>("frameLength", arm::app::kws::g_FrameLength);
     caseContext.Set<int>("frameStride", arm::app::kws::g_FrameStride);
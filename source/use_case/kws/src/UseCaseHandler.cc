@@ -18,6 +18,7 @@
 #include "UseCaseHandler.hpp"
 
 #include "AudioUtils.hpp"
+#include "BatchInference.hpp"
 #include "ImageUtils.hpp"
 #include "KwsClassifier.hpp"
 #include "KwsProcessing.hpp"
@@ -47,6 +48,7 @@ namespace app {
         const auto mfccFrameLength = ctx.Get<int>("frameLength");
         const auto mfccFrameStride = ctx.Get<int>("frameStride");
         const auto scoreThreshold  = ctx.Get<float>("scoreThreshold");
+        const bool batchInference  = ctx.Has("batchInference") && ctx.Get<bool>("batchInference");
 
         constexpr uint32_t dataPsnTxtInfStartX = 20;
         constexpr uint32_t dataPsnTxtInfStartY = 40;
@@ -88,9 +90,11 @@ namespace app {
         std::vector<ClassificationResult> singleInfResult;
         KwsPostProcess postProcess = KwsPostProcess(outputTensor,
                                                     ctx.Get<KwsClassifier&>("classifier"),
-                                                    ctx.Get<std::vector<std::string>&>("labels"),
+                                                    ctx.Get<const std::vector<std::string>&>("labels"),
                                                     singleInfResult);
 
+        BatchInference batch{model};
+
         hal_audio_init();
         if (!hal_audio_configure(HAL_AUDIO_MODE_SINGLE_BURST,
                                  HAL_AUDIO_FORMAT_16KHZ_MONO_16BIT)) {
@@ -125,25 +129,8 @@ namespace app {
             hal_lcd_display_text(
                 str_inf.c_str(), str_inf.size(), dataPsnTxtInfStartX, dataPsnTxtInfStartY, 0);
 
-            /* Start sliding through audio clip. */
-            while (audioDataSlider.HasNext()) {
-                const int16_t* inferenceWindow = audioDataSlider.Next();
-
-                info("Inference %zu/%zu\n",
-                     audioDataSlider.Index() + 1,
-                     audioDataSlider.TotalStrides() + 1);
-
-                /* Run the pre-processing, inference and post-processing. */
-                if (!preProcess.DoPreProcess(inferenceWindow, audioDataSlider.Index())) {
-                    printf_err("Pre-processing failed.");
-                    return false;
-                }
-
-                if (!RunInference(model, profiler)) {
-                    printf_err("Inference failed.");
-                    return false;
-                }
-
+            /* Post-processes the output tensor of a window and keeps its result. */
+            auto collectResult = [&](size_t windowIdx) {
                 if (!postProcess.DoPostProcess()) {
                     printf_err("Post-processing failed.");
                     return false;
@@ -152,14 +139,56 @@ namespace app {
                 /* Add results from this window to our final results vector. */
                 finalResults.emplace_back(kws::KwsResult(
                     singleInfResult,
-                    audioDataSlider.Index() * secondsPerSample * preProcess.m_audioDataStride,
-                    audioDataSlider.Index(),
+                    windowIdx * secondsPerSample * preProcess.m_audioDataStride,
+                    windowIdx,
                     scoreThreshold));
 
 #if VERIFY_TEST_OUTPUT
                 DumpTensor(outputTensor);
 #endif        /* VERIFY_TEST_OUTPUT */
-            } /* while (audioDataSlider.HasNext()) */
+                return true;
+            };
+
+            if (batchInference) {
+                /* Whole clip at once: features, then inferences, then results. */
+                std::vector<const int16_t*> windows;
+                while (audioDataSlider.HasNext()) {
+                    windows.push_back(audioDataSlider.Next());
+                }
+
+                if (!batch.Run(windows.size(),
+                               [&](size_t windowIdx) {
+                                   return preProcess.DoPreProcess(windows[windowIdx], windowIdx);
+                               },
+                               collectResult)) {
+                    return false;
+                }
+                batch.PrintStats();
+            } else {
+                /* Start sliding through audio clip. */
+                while (audioDataSlider.HasNext()) {
+                    const int16_t* inferenceWindow = audioDataSlider.Next();
+
+                    info("Inference %zu/%zu\n",
+                         audioDataSlider.Index() + 1,
+                         audioDataSlider.TotalStrides() + 1);
+
+                    /* Run the pre-processing, inference and post-processing. */
+                    if (!preProcess.DoPreProcess(inferenceWindow, audioDataSlider.Index())) {
+                        printf_err("Pre-processing failed.");
+                        return false;
+                    }
+
+                    if (!RunInference(model, profiler)) {
+                        printf_err("Inference failed.");
+                        return false;
+                    }
+
+                    if (!collectResult(audioDataSlider.Index())) {
+                        return false;
+                    }
+                } /* while (audioDataSlider.HasNext()) */
+            }
 
             /* Erase. */
             str_inf = std::string(str_inf.size(), ' ');
@@ -52,6 +52,14 @@ USER_OPTION(${use_case}_MODEL_SCORE_THRESHOLD "Specify the score threshold [0.0,
     0.7
     STRING)
 
+USER_OPTION(${use_case}_BATCH_INFERENCE "Pre-process all windows of a clip first, then run the inferences back to back, then post-process."
+    OFF
+    BOOL)
+
+set(${use_case}_COMPILE_DEFS
+    BATCH_INFERENCE=$<BOOL:${${use_case}_BATCH_INFERENCE}>
+)
+
 # Generate input files
 generate_audio_code(${${use_case}_FILE_PATH} ${SAMPLES_GEN_DIR}
     ${${use_case}_AUDIO_RATE}
@@ -22,6 +22,7 @@
 #include "MicroNetKwsModel.hpp"     /* KWS model class for running inference. */
 #include "Wav2LetterModel.hpp"      /* ASR model class for running inference. */
 #include "UseCaseCommonUtils.hpp"   /* Utils functions. */
+#include "ArenaPlanner.hpp"         /* Tensor arena shared by the models. */
 #include "UseCaseHandler.hpp"       /* Handlers for different user options. */
 #include "log_macros.h"             /* Logging functions */
 #include "BufAttributes.hpp"        /* Buffer attributes to be applied */
@@ -51,22 +52,20 @@ void MainLoop()
     arm::app::MicroNetKwsModel kwsModel;
     arm::app::Wav2LetterModel asrModel;
 
-    /* Load the models. */
-    if (!kwsModel.Init(arm::app::tensorArena,
-                       sizeof(arm::app::tensorArena),
-                       arm::app::kws::GetModelPointer(),
-                       arm::app::kws::GetModelLen())) {
+    /* Load the models. Both share the tensor arena: their persistent
+     * allocations stack up while the scratch area is shared. */
+    arm::app::ArenaPlanner arenaPlanner{arm::app::tensorArena, sizeof(arm::app::tensorArena)};
+
+    if (!arenaPlanner.Register(kwsModel, "KWS",
+                               arm::app::kws::GetModelPointer(),
+                               arm::app::kws::GetModelLen())) {
         printf_err("Failed to initialise KWS model\n");
         return;
     }
 
-    /* Initialise the asr model using the same allocator from KWS
-     * to re-use the tensor arena. */
-    if (!asrModel.Init(arm::app::tensorArena,
-                       sizeof(arm::app::tensorArena),
-                       arm::app::asr::GetModelPointer(),
-                       arm::app::asr::GetModelLen(),
-                       kwsModel.GetAllocator())) {
+    if (!arenaPlanner.Register(asrModel, "ASR",
+                               arm::app::asr::GetModelPointer(),
+                               arm::app::asr::GetModelLen())) {
         printf_err("Failed to initialise ASR model\n");
         return;
     } else if (!VerifyTensorDimensions(asrModel)) {
@@ -74,11 +73,16 @@ void MainLoop()
         return;
     }
 
+    arenaPlanner.PrintReport();
+
     /* Instantiate application context. */
     arm::app::ApplicationContext caseContext;
 
     arm::app::Profiler profiler{"kws_asr"};
     caseContext.Set<arm::app::Profiler&>("profiler", profiler);
+#if BATCH_INFERENCE
+    caseContext.Set<bool>("batchInference", true);
+#endif /* BATCH_INFERENCE */
     caseContext.Set<arm::app::Model&>("kwsModel", kwsModel);
     caseContext.Set<arm::app::Model&>("asrModel", asrModel);
     caseContext.Set<uint32_t>("ctxLen", arm::app::asr::g_ctxLen);  /* Left and right context length (MFCC feat vectors). */
@@ -88,8 +92,8 @@ void MainLoop()
     caseContext.Set<uint32_t >("kwsNumMfcc", arm::app::kws::g_NumMfcc);
     caseContext.Set<uint32_t >("kwsNumAudioWins", arm::app::kws::g_NumAudioWins);
 
-    caseContext.Set<int>("asrFrameLength", arm::app::asr::g_FrameLength);
-    caseContext.Set<int>("asrFrameStride", arm::app::asr::g_FrameStride);
+    caseContext.Set<uint32_t>("asrFrameLength", arm::app::asr::g_FrameLength);
+    caseContext.Set<uint32_t>("asrFrameStride", arm::app::asr::g_FrameStride);
     caseContext.Set<float>("asrScoreThreshold", arm::app::asr::g_ScoreThreshold);  /* Normalised score threshold. */
 
     arm::app::KwsClassifier kwsClassifier;  /* Classifier wrapper object. */
@@ -20,6 +20,7 @@
 #include "AsrClassifier.hpp"
 #include "AsrResult.hpp"
 #include "AudioUtils.hpp"
+#include "BatchInference.hpp"
 #include "Classifier.hpp"
 #include "ImageUtils.hpp"
 #include "KwsProcessing.hpp"
@@ -46,6 +47,45 @@ namespace app {
         int32_t asrAudioSamples      = 0;
     };
 
+    /* Context attributes read by the KWS and ASR pipelines, resolved once per handler call. */
+    struct KwsAsrKeys {
+        explicit KwsAsrKeys(ApplicationContext& ctx)
+        :   profiler{ctx.GetKey<Profiler&>("profiler")},
+            batchInference{ctx.GetKey<bool>("batchInference")},
+            kwsModel{ctx.GetKey<Model&>("kwsModel")},
+            kwsFrameLength{ctx.GetKey<int>("kwsFrameLength")},
+            kwsFrameStride{ctx.GetKey<int>("kwsFrameStride")},
+            kwsScoreThreshold{ctx.GetKey<float>("kwsScoreThreshold")},
+            kwsClassifier{ctx.GetKey<KwsClassifier&>("kwsClassifier")},
+            kwsLabels{ctx.GetKey<const std::vector<std::string>&>("kwsLabels")},
+            triggerKeyword{ctx.GetKey<const std::string&>("triggerKeyword")},
+            asrModel{ctx.GetKey<Model&>("asrModel")},
+            asrFrameLength{ctx.GetKey<uint32_t>("asrFrameLength")},
+            asrFrameStride{ctx.GetKey<uint32_t>("asrFrameStride")},
+            asrScoreThreshold{ctx.GetKey<float>("asrScoreThreshold")},
+            ctxLen{ctx.GetKey<uint32_t>("ctxLen")},
+            asrClassifier{ctx.GetKey<AsrClassifier&>("asrClassifier")},
+            asrLabels{ctx.GetKey<const std::vector<std::string>&>("asrLabels")}
+        {}
+
+        const ContextKey<Profiler&> profiler;
+        const ContextKey<bool> batchInference;
+        const ContextKey<Model&> kwsModel;
+        const ContextKey<int> kwsFrameLength;
+        const ContextKey<int> kwsFrameStride;
+        const ContextKey<float> kwsScoreThreshold;
+        const ContextKey<KwsClassifier&> kwsClassifier;
+        const ContextKey<const std::vector<std::string>&> kwsLabels;
+        const ContextKey<const std::string&> triggerKeyword;
+        const ContextKey<Model&> asrModel;
+        const ContextKey<uint32_t> asrFrameLength;
+        const ContextKey<uint32_t> asrFrameStride;
+        const ContextKey<float> asrScoreThreshold;
+        const ContextKey<uint32_t> ctxLen;
+        const ContextKey<AsrClassifier&> asrClassifier;
+        const ContextKey<const std::vector<std::string>&> asrLabels;
+    };
+
     /**
      * @brief       Presents KWS inference results.
      * @param[in]   results   Vector of KWS classification results to be displayed.
@@ -63,18 +103,22 @@ namespace app {
     /**
      * @brief           Performs the KWS pipeline.
      * @param[in,out]   ctx   pointer to the application context object
+     * @param[in]       keys  Keys of the context attributes
      * @param[in]       audioBuffer Pointer to audio data buffer
      * @param[in]       nElements   Number of elements in the audio buffer
      * @return          struct containing pointer to audio data where ASR should begin
      *                  and how much data to process.
      **/
-    static KWSOutput doKws(ApplicationContext& ctx, const int16_t* audioBuffer, uint32_t nElements)
+    static KWSOutput doKws(ApplicationContext& ctx, const KwsAsrKeys& keys,
+                           const int16_t* audioBuffer, uint32_t nElements)
     {
-        auto& profiler                = ctx.Get<Profiler&>("profiler");
-        auto& kwsModel                = ctx.Get<Model&>("kwsModel");
-        const auto kwsMfccFrameLength = ctx.Get<int>("kwsFrameLength");
-        const auto kwsMfccFrameStride = ctx.Get<int>("kwsFrameStride");
-        const auto kwsScoreThreshold  = ctx.Get<float>("kwsScoreThreshold");
+        auto& profiler                = ctx.Get(keys.profiler);
+        auto& kwsModel                = ctx.Get(keys.kwsModel);
+        const auto kwsMfccFrameLength = ctx.Get(keys.kwsFrameLength);
+        const auto kwsMfccFrameStride = ctx.Get(keys.kwsFrameStride);
+        const auto kwsScoreThreshold  = ctx.Get(keys.kwsScoreThreshold);
+        const bool batchInference     = ctx.Has(keys.batchInference) && ctx.Get(keys.batchInference);
+        const std::string& triggerKeyword = ctx.Get(keys.triggerKeyword);
 
         constexpr uint32_t dataPsnTxtInfStartX = 20;
         constexpr uint32_t dataPsnTxtInfStartY = 40;
@@ -119,8 +163,8 @@ namespace app {
 
         std::vector<ClassificationResult> singleInfResult;
         KwsPostProcess postProcess = KwsPostProcess(kwsOutputTensor,
-                                                    ctx.Get<KwsClassifier&>("kwsClassifier"),
-                                                    ctx.Get<std::vector<std::string>&>("kwsLabels"),
+                                                    ctx.Get(keys.kwsClassifier),
+                                                    ctx.Get(keys.kwsLabels),
                                                     singleInfResult);
 
         /* Creating a sliding window through the whole audio clip. */
@@ -137,54 +181,87 @@ namespace app {
         hal_lcd_display_text(
             str_inf.c_str(), str_inf.size(), dataPsnTxtInfStartX, dataPsnTxtInfStartY, false);
 
-        /* Start sliding through audio clip. */
-        while (audioDataSlider.HasNext()) {
-            const int16_t* inferenceWindow = audioDataSlider.Next();
-
-            /* Run the pre-processing, inference and post-processing. */
-            if (!preProcess.DoPreProcess(inferenceWindow, audioDataSlider.Index())) {
-                printf_err("KWS Pre-processing failed.");
-                return output;
-            }
-
-            if (!RunInference(kwsModel, profiler)) {
-                printf_err("KWS Inference failed.");
-                return output;
-            }
-
+        /* Post-processes the output tensor of a window and keeps its result.
+         * Returns false on failure and sets triggered once the trigger keyword is detected. */
+        bool triggered = false;
+        auto collectResult = [&](const int16_t* inferenceWindow, size_t windowIdx) {
             if (!postProcess.DoPostProcess()) {
                 printf_err("KWS Post-processing failed.");
-                return output;
+                return false;
             }
 
-            info("Inference %zu/%zu\n",
-                 audioDataSlider.Index() + 1,
-                 audioDataSlider.TotalStrides() + 1);
-
             /* Add results from this window to our final results vector. */
             finalResults.emplace_back(
                 kws::KwsResult(singleInfResult,
-                               audioDataSlider.Index() * kwsAudioParamsSecondsPerSample *
+                               windowIdx * kwsAudioParamsSecondsPerSample *
                                    preProcess.m_audioDataStride,
-                               audioDataSlider.Index(),
+                               windowIdx,
                                kwsScoreThreshold));
 
-            /* Break out when trigger keyword is detected. */
-            if (singleInfResult[0].m_label == ctx.Get<const std::string&>("triggerKeyword") &&
+            /* Stop when trigger keyword is detected. */
+            if (singleInfResult[0].m_label == triggerKeyword &&
                 singleInfResult[0].m_normalisedVal > kwsScoreThreshold) {
                 output.asrAudioStart = inferenceWindow + preProcess.m_audioDataWindowSize;
                 output.asrAudioSamples =
                     nElements -
-                    (audioDataSlider.NextWindowStartIndex() - preProcess.m_audioDataStride +
-                     preProcess.m_audioDataWindowSize);
-                break;
+                    (windowIdx * preProcess.m_audioDataStride + preProcess.m_audioDataWindowSize);
+                triggered = true;
             }
 
 #if VERIFY_TEST_OUTPUT
             DumpTensor(kwsOutputTensor);
 #endif /* VERIFY_TEST_OUTPUT */
+            return true;
+        };
+
+        if (batchInference) {
+            /* Whole clip at once: features, then inferences, then results up to the trigger. */
+            std::vector<const int16_t*> windows;
+            while (audioDataSlider.HasNext()) {
+                windows.push_back(audioDataSlider.Next());
+            }
+
+            BatchInference batch{kwsModel};
+            if (!batch.Run(windows.size(),
+                           [&](size_t windowIdx) {
+                               return preProcess.DoPreProcess(windows[windowIdx], windowIdx);
+                           },
+                           [&](size_t windowIdx) {
+                               return triggered || collectResult(windows[windowIdx], windowIdx);
+                           })) {
+                return output;
+            }
+            batch.PrintStats();
+        } else {
+            /* Start sliding through audio clip. */
+            while (audioDataSlider.HasNext()) {
+                const int16_t* inferenceWindow = audioDataSlider.Next();
+
+                /* Run the pre-processing, inference and post-processing. */
+                if (!preProcess.DoPreProcess(inferenceWindow, audioDataSlider.Index())) {
+                    printf_err("KWS Pre-processing failed.");
+                    return output;
+                }
 
-        } /* while (audioDataSlider.HasNext()) */
+                if (!RunInference(kwsModel, profiler)) {
+                    printf_err("KWS Inference failed.");
+                    return output;
+                }
+
+                if (!collectResult(inferenceWindow, audioDataSlider.Index())) {
+                    return output;
+                }
+
+                info("Inference %zu/%zu\n",
+                     audioDataSlider.Index() + 1,
+                     audioDataSlider.TotalStrides() + 1);
+
+                /* Break out when trigger keyword is detected. */
+                if (triggered) {
+                    break;
+                }
+            } /* while (audioDataSlider.HasNext()) */
+        }
 
         /* Erase. */
         str_inf = std::string(str_inf.size(), ' ');
@@ -204,18 +281,19 @@ namespace app {
     /**
      * @brief           Performs the ASR pipeline.
      * @param[in,out]   ctx         Pointer to the application context object.
+     * @param[in]       keys        Keys of the context attributes.
      * @param[in]       kwsOutput   Struct containing pointer to audio data where ASR should begin
      *                              and how much data to process.
      * @return          true if pipeline executed without failure.
      **/
-    static bool doAsr(ApplicationContext& ctx, const KWSOutput& kwsOutput)
+    static bool doAsr(ApplicationContext& ctx, const KwsAsrKeys& keys, const KWSOutput& kwsOutput)
     {
-        auto& asrModel          = ctx.Get<Model&>("asrModel");
-        auto& profiler          = ctx.Get<Profiler&>("profiler");
-        auto asrMfccFrameLen    = ctx.Get<uint32_t>("asrFrameLength");
-        auto asrMfccFrameStride = ctx.Get<uint32_t>("asrFrameStride");
-        auto asrScoreThreshold  = ctx.Get<float>("asrScoreThreshold");
-        auto asrInputCtxLen     = ctx.Get<uint32_t>("ctxLen");
+        auto& asrModel          = ctx.Get(keys.asrModel);
+        auto& profiler          = ctx.Get(keys.profiler);
+        auto asrMfccFrameLen    = ctx.Get(keys.asrFrameLength);
+        auto asrMfccFrameStride = ctx.Get(keys.asrFrameStride);
+        auto asrScoreThreshold  = ctx.Get(keys.asrScoreThreshold);
+        auto asrInputCtxLen     = ctx.Get(keys.ctxLen);
 
         constexpr uint32_t dataPsnTxtInfStartX = 20;
         constexpr uint32_t dataPsnTxtInfStartY = 40;
@@ -287,14 +365,15 @@ namespace app {
                           arm::app::Wav2LetterModel::ms_numMfccFeatures,
                           inputShape->data[Wav2LetterModel::ms_inputRowsIdx],
                           asrMfccFrameLen,
-                          asrMfccFrameStride);
+                          asrMfccFrameStride,
+                          true);
 
         std::vector<ClassificationResult> singleInfResult;
         const uint32_t outputCtxLen = AsrPostProcess::GetOutputContextLen(asrModel, asrInputCtxLen);
         AsrPostProcess asrPostProcess =
             AsrPostProcess(asrOutputTensor,
-                           ctx.Get<AsrClassifier&>("asrClassifier"),
-                           ctx.Get<std::vector<std::string>&>("asrLabels"),
+                           ctx.Get(keys.asrClassifier),
+                           ctx.Get(keys.asrLabels),
                            singleInfResult,
                            outputCtxLen,
                            Wav2LetterModel::ms_blankTokenIdx,
@@ -308,6 +387,8 @@ namespace app {
                 asrInferenceWindowLen = audioBuffer.size() - nextStartIndex;
             }
 
+            /* Overlapping MFCC vectors of consecutive windows are only computed once. */
+            asrPreProcess.SetStreamOffset(nextStartIndex);
             const int16_t* asrInferenceWindow = audioDataSlider.Next();
 
             info("Inference %zu/%zu\n",
@@ -335,10 +416,10 @@ namespace app {
 
             /* Get results. */
             std::vector<ClassificationResult> asrClassificationResult;
-            auto& asrClassifier = ctx.Get<AsrClassifier&>("asrClassifier");
+            auto& asrClassifier = ctx.Get(keys.asrClassifier);
             asrClassifier.GetClassificationResults(asrOutputTensor,
                                                    asrClassificationResult,
-                                                   ctx.Get<std::vector<std::string>&>("asrLabels"),
+                                                   ctx.Get(keys.asrLabels),
                                                    1);
 
             asrResults.emplace_back(
@@ -379,6 +460,7 @@ namespace app {
         }
         hal_audio_start();
 
+        const KwsAsrKeys keys{ctx};
         while (true) {
             uint32_t nElements = 0;
             auto audioData = hal_audio_get_captured_frame(&nElements);
@@ -388,7 +470,7 @@ namespace app {
                 break;
             }
 
-            KWSOutput kwsOutput = doKws(ctx, audioData, nElements);
+            KWSOutput kwsOutput = doKws(ctx, keys, audioData, nElements);
             if (!kwsOutput.executionSuccess) {
                 printf_err("KWS failed\n");
                 return false;
@@ -396,7 +478,7 @@ namespace app {
 
             if (kwsOutput.asrAudioStart != nullptr && kwsOutput.asrAudioSamples > 0) {
                 info("Trigger keyword spotted\n");
-                if (!doAsr(ctx, kwsOutput)) {
+                if (!doAsr(ctx, keys, kwsOutput)) {
                     printf_err("ASR failed\n");
                     return false;
                 }
@@ -71,6 +71,14 @@ USER_OPTION(${use_case}_MODEL_SCORE_THRESHOLD_ASR "Specify the score threshold [
     0.5
     STRING)
 
+USER_OPTION(${use_case}_BATCH_INFERENCE "Run the KWS stage over all windows of a clip in batch: pre-process all windows first, then run the inferences back to back, then post-process."
+    OFF
+    BOOL)
+
+set(${use_case}_COMPILE_DEFS
+    BATCH_INFERENCE=$<BOOL:${${use_case}_BATCH_INFERENCE}>
+)
+
 if (ETHOS_U_NPU_ENABLED)
     set(DEFAULT_MODEL_PATH_KWS      ${DEFAULT_MODEL_DIR}/kws_micronet_m_vela_${ETHOS_U_NPU_CONFIG_ID}.tflite)
     set(DEFAULT_MODEL_PATH_ASR      ${DEFAULT_MODEL_DIR}/wav2letter_pruned_int8_vela_${ETHOS_U_NPU_CONFIG_ID}.tflite)
@@ -32,6 +32,7 @@
 #include "UseCaseCommonUtils.hpp"   
 #include "log_macros.h"             
 #include "BufAttributes.hpp"        
+#include "ArenaPlanner.hpp"
 
 /* KWS Includes */
 #include "KwsClassifier.hpp"
@@ -75,26 +76,26 @@ void MainLoop()
     arm::app::MicroNetKwsModel kwsModel;
     arm::app::MobileNetModel imgModel;
 
-    /* Load the models. */
-    if (!kwsModel.Init(arm::app::tensorArena,
-                       sizeof(arm::app::tensorArena),
-                       arm::app::kws::GetModelPointer(),
-                       arm::app::kws::GetModelLen())) {
+    /* Load the models. Both share the tensor arena: their persistent
+     * allocations stack up while the scratch area is shared. */
+    arm::app::ArenaPlanner arenaPlanner{arm::app::tensorArena, sizeof(arm::app::tensorArena)};
+
+    if (!arenaPlanner.Register(kwsModel, "KWS",
+                               arm::app::kws::GetModelPointer(),
+                               arm::app::kws::GetModelLen())) {
         printf_err("Failed to initialise KWS model\n");
         return;
     }
 
-    /* Initialise the image model using the same allocator from KWS
-     * to re-use the tensor arena. */
-    if (!imgModel.Init(arm::app::tensorArena,
-                       sizeof(arm::app::tensorArena),
-                       arm::app::img_class::GetModelPointer(),
-                       arm::app::img_class::GetModelLen(),
-                       kwsModel.GetAllocator())) {
+    if (!arenaPlanner.Register(imgModel, "Image",
+                               arm::app::img_class::GetModelPointer(),
+                               arm::app::img_class::GetModelLen())) {
         printf_err("Failed to initialise Image model\n");
         return;
     }
 
+    arenaPlanner.PrintReport();
+
     /* Instantiate application context. */
     arm::app::ApplicationContext caseContext;
     arm::app::Profiler profiler{"kws_img"};
@@ -128,7 +128,7 @@ namespace app {
         std::vector<ClassificationResult> results;
         ImgClassPostProcess postProcess = ImgClassPostProcess(outputTensor,
                                 ctx.Get<ImgClassClassifier&>("imgClassifier"),
-                                ctx.Get<std::vector<std::string>&>("imgLabels"),
+                                ctx.Get<const std::vector<std::string>&>("imgLabels"),
                                 results);
         
         hal_camera_stop();
@@ -210,7 +210,7 @@ namespace app {
         KwsPreProcess preProcess(inputTensor, numMfccFeatures, numMfccFrames, mfccFrameLength, mfccFrameStride);
         std::vector<ClassificationResult> singleInfResult;
         KwsPostProcess postProcess(outputTensor, ctx.Get<KwsClassifier &>("kwsClassifier"),
-                                    ctx.Get<std::vector<std::string>&>("kwsLabels"), singleInfResult);
+                                    ctx.Get<const std::vector<std::string>&>("kwsLabels"), singleInfResult);
 
         int index = 0;
         std::vector<arm::app::kws::KwsResult> infResults;
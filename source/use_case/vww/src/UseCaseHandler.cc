@@ -75,7 +75,7 @@ namespace app {
         VisualWakeWordPostProcess postProcess =
             VisualWakeWordPostProcess(outputTensor,
                                       ctx.Get<Classifier&>("classifier"),
-                                      ctx.Get<std::vector<std::string>&>("labels"),
+                                      ctx.Get<const std::vector<std::string>&>("labels"),
                                       results);
         hal_camera_init();
         auto bCamera = hal_camera_configure(nCols,
@@ -60,4 +60,59 @@ TEST_CASE("Common: Application context")
         REQUIRE(vect == data);
         delete(vect);
     }
+
+    SECTION("Access parameter through key")
+    {
+        arm::app::ApplicationContext context;
+        auto key = context.GetKey<uint32_t>("test");
+        REQUIRE(key.IsValid());
+        REQUIRE_FALSE(context.Has("test"));
+        REQUIRE_FALSE(context.Has(key));
+
+        context.Set<uint32_t>("test", 1);
+        REQUIRE(context.Has(key));
+        REQUIRE(1 == context.Get(key));
+
+        context.Set(key, 2u);
+        REQUIRE(2 == context.Get<uint32_t>("test"));
+    }
+
+    SECTION("Key resolved after set")
+    {
+        arm::app::ApplicationContext context;
+        std::string str{"a"};
+        context.Set<std::string&>("str", str);
+        context.Set<int>("other", 0);
+
+        auto key = context.GetKey<const std::string&>("str");
+        REQUIRE(context.Has(key));
+        REQUIRE(&str == &context.Get(key));
+    }
+
+    SECTION("Key type is checked")
+    {
+        arm::app::ApplicationContext context;
+        context.Set<int>("test", 0);
+
+        REQUIRE(context.Has(context.GetKey<int>("test")));
+        REQUIRE(context.Has(context.GetKey<const int>("test")));
+        REQUIRE_FALSE(context.Has(context.GetKey<float>("test")));
+        REQUIRE_FALSE(context.Has(context.GetKey<int&>("test")));
+        REQUIRE_FALSE(context.Has(arm::app::ContextKey<int>{}));
+    }
+
+    SECTION("Const is kept on references")
+    {
+        arm::app::ApplicationContext context;
+        std::vector <std::string> vect{"a"};
+        context.Set<const std::vector <std::string>&>("const", vect);
+        context.Set<std::vector <std::string>&>("mutable", vect);
+
+        /* Adding const is allowed, removing it is not. */
+        REQUIRE(context.Has(context.GetKey<const std::vector <std::string>&>("const")));
+        REQUIRE_FALSE(context.Has(context.GetKey<std::vector <std::string>&>("const")));
+        REQUIRE(context.Has(context.GetKey<const std::vector <std::string>&>("mutable")));
+        REQUIRE(&vect == &context.Get<const std::vector <std::string>&>("mutable"));
+        REQUIRE(&vect == &context.Get<const std::vector <std::string>&>("const"));
+    }
 }
\ No newline at end of file
@@ -0,0 +1,120 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "audio_ring.h"
+#include "AudioUtils.hpp"
+
+#include <catch.hpp>
+#include <numeric>
+#include <vector>
+
+TEST_CASE("Common: Audio ring")
+{
+    constexpr uint32_t capacity = 12;
+    constexpr uint32_t guard = 3;
+    constexpr uint32_t block = 4;
+    std::vector<int16_t> storage(capacity + guard, -1);
+    audio_ring ring;
+
+    REQUIRE(0 == audio_ring_init(&ring, storage.data(), capacity, guard));
+    REQUIRE(0 == audio_ring_available(&ring));
+    REQUIRE(nullptr == audio_ring_peek(&ring, 1));
+
+    std::vector<int16_t> samples(64);
+    std::iota(samples.begin(), samples.end(), 0);
+
+    SECTION("Blocks are written in place")
+    {
+        for (uint32_t i = 0; i < 3; ++i) {
+            int16_t* dst = audio_ring_write_ptr(&ring, block);
+            REQUIRE(dst == storage.data() + i * block);
+            std::copy(samples.begin() + i * block, samples.begin() + (i + 1) * block, dst);
+            audio_ring_commit(&ring, block);
+        }
+        REQUIRE(capacity == audio_ring_available(&ring));
+
+        const int16_t* window = audio_ring_peek(&ring, 8);
+        REQUIRE(window == storage.data());
+        audio_ring_consume(&ring, block);
+        REQUIRE(8 == audio_ring_available(&ring));
+
+        /* Blocks larger than the ring are rejected. */
+        REQUIRE(nullptr == audio_ring_write_ptr(&ring, capacity + 1));
+
+        const audio_ring_stats stats = audio_ring_get_stats(&ring);
+        REQUIRE(3 == stats.blocks_committed);
+        REQUIRE(capacity == stats.samples_written);
+        REQUIRE(0 == stats.overruns);
+    }
+
+    SECTION("Wrapped window reads in place through the guard")
+    {
+        REQUIRE(10 == audio_ring_write(&ring, samples.data(), 10));
+
+        /* Blocks that would not be contiguous are rejected. */
+        REQUIRE(nullptr == audio_ring_write_ptr(&ring, block));
+
+        audio_ring_consume(&ring, 8);
+        REQUIRE(6 == audio_ring_write(&ring, samples.data() + 10, 6));
+
+        /* Window of 8 samples starting at offset 8 wraps past the end of the ring. */
+        const int16_t* window = audio_ring_peek(&ring, 8);
+        REQUIRE(window == storage.data() + 8);
+
+        /* A frame of guard + 1 samples starting at the last position is contiguous. */
+        for (uint32_t i = 0; i <= guard; ++i) {
+            REQUIRE(window[3 + i] == samples[11 + i]);
+        }
+
+        /* Slide frames of 4 samples, stride 2, over the wrapped window. */
+        auto slider = arm::app::audio::WrappedSlidingWindow<const int16_t>(window, 8, 4, 2);
+        slider.SetWrapRegion(storage.data(), capacity);
+        for (int16_t expected = 8; slider.HasNext(); expected += 2) {
+            const int16_t* frame = slider.Next();
+            REQUIRE(frame >= storage.data());
+            REQUIRE(frame < storage.data() + capacity);
+            for (int16_t i = 0; i < 4; ++i) {
+                REQUIRE(frame[i] == expected + i);
+            }
+        }
+        REQUIRE(2 == slider.Index());
+    }
+
+    SECTION("Overruns drop the oldest samples and are counted")
+    {
+        REQUIRE(capacity == audio_ring_write(&ring, samples.data(), capacity));
+        REQUIRE(0 == audio_ring_get_stats(&ring).overruns);
+
+        /* Consumer does not keep up: the next block overwrites unread samples. */
+        REQUIRE(nullptr != audio_ring_write_ptr(&ring, block));
+        audio_ring_commit(&ring, block);
+
+        audio_ring_stats stats = audio_ring_get_stats(&ring);
+        REQUIRE(1 == stats.overruns);
+        REQUIRE(block == stats.samples_dropped);
+        REQUIRE(capacity == audio_ring_available(&ring));
+
+        /* Oldest readable sample is the first one that was not dropped. */
+        REQUIRE(*audio_ring_peek(&ring, 1) == samples[block]);
+
+        /* Writing more than the capacity at once keeps the newest samples. */
+        REQUIRE(20 == audio_ring_write(&ring, samples.data() + 20, 20));
+        stats = audio_ring_get_stats(&ring);
+        REQUIRE(stats.overruns > 1);
+        REQUIRE(block + 20 == stats.samples_dropped);
+        REQUIRE(*audio_ring_peek(&ring, capacity) == samples[28]);
+    }
+}
@@ -0,0 +1,156 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "CapturePipeline.hpp"
+#include "hal.h"
+
+#include <catch.hpp>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+    constexpr uint32_t imageSize = 64;
+    constexpr size_t numImages = 4;
+
+    /* Images filled with their own index. */
+    struct TestImages {
+        std::vector<std::vector<uint8_t>> data;
+        std::vector<const uint8_t*> ptrs;
+
+        TestImages()
+        {
+            for (size_t i = 0; i < numImages; ++i) {
+                data.emplace_back(imageSize, static_cast<uint8_t>(i + 1));
+            }
+            for (auto& image : data) {
+                ptrs.push_back(image.data());
+            }
+        }
+    };
+
+} /* anonymous namespace */
+
+TEST_CASE("Common: Capture pipeline overlaps capture and processing")
+{
+    hal_platform_init();
+
+    TestImages images;
+    arm::app::StaticImageSource source(images.ptrs.data(), numImages, imageSize);
+    arm::app::CapturePipeline pipeline(source);
+
+    std::vector<const uint8_t*> framePtrs;
+    uint32_t frameIdx = 0;
+
+    const uint32_t numProcessed = pipeline.Run([&](const uint8_t* frame, uint32_t size) {
+        REQUIRE(size == imageSize);
+
+        /* The next capture has already been started ... */
+        CHECK(source.GetNumCaptures() == frameIdx + 2);
+
+        /* ... without touching the frame being processed. */
+        std::vector<uint8_t> expected(imageSize, static_cast<uint8_t>(frameIdx + 1));
+        CHECK(0 == std::memcmp(frame, expected.data(), imageSize));
+
+        framePtrs.push_back(frame);
+        ++frameIdx;
+        return true;
+    });
+
+    REQUIRE(numProcessed == numImages);
+    REQUIRE(framePtrs.size() == numImages);
+
+    /* Consecutive frames live in alternating buffers. */
+    CHECK(framePtrs[0] != framePtrs[1]);
+    CHECK(framePtrs[0] == framePtrs[2]);
+    CHECK(framePtrs[1] == framePtrs[3]);
+
+    const auto stats = pipeline.GetStats();
+    CHECK(stats.framesProcessed == numImages);
+    CHECK(stats.framesDropped == 0);
+    CHECK(stats.unit != nullptr);
+    CHECK(stats.captureWaitMax <= stats.captureWaitTotal);
+    CHECK(stats.processMax <= stats.processTotal);
+}
+
+TEST_CASE("Common: Capture pipeline counts dropped frames")
+{
+    hal_platform_init();
+
+    TestImages images;
+
+    SECTION("Frame in flight when stopping") {
+        arm::app::StaticImageSource source(images.ptrs.data(), numImages, imageSize);
+        arm::app::CapturePipeline pipeline(source);
+
+        REQUIRE(2 == pipeline.Run([](const uint8_t*, uint32_t) { return true; }, 2));
+        CHECK(pipeline.GetStats().framesProcessed == 2);
+        CHECK(pipeline.GetStats().framesDropped == 1);
+
+        /* Restarts with the next frame the source has to offer. */
+        uint8_t firstValue = 0;
+        REQUIRE(pipeline.Step([&](const uint8_t* frame, uint32_t) {
+            firstValue = frame[0];
+            return true;
+        }));
+        CHECK(firstValue == 4);
+
+        pipeline.ResetStats();
+        CHECK(pipeline.GetStats().framesProcessed == 0);
+        CHECK(pipeline.GetStats().framesDropped == 0);
+    }
+
+    SECTION("Processing stage failure") {
+        arm::app::StaticImageSource source(images.ptrs.data(), numImages, imageSize);
+        arm::app::CapturePipeline pipeline(source);
+
+        CHECK(0 == pipeline.Run([](const uint8_t*, uint32_t) { return false; }));
+        CHECK(pipeline.GetStats().framesProcessed == 0);
+        CHECK(pipeline.GetStats().framesFailed == 1);
+        CHECK(pipeline.GetStats().processTotal == 0);
+        CHECK(pipeline.GetStats().framesDropped == 1);
+    }
+
+    SECTION("Frames overwritten in the source") {
+        arm::app::StaticImageSource source(images.ptrs.data(), numImages, imageSize);
+        arm::app::CapturePipeline pipeline(source);
+
+        REQUIRE(source.StartCapture(1));
+        REQUIRE(source.StartCapture(1));
+        CHECK(source.GetDroppedFrames() == 1);
+        CHECK(pipeline.GetStats().framesDropped == 1);
+    }
+}
+
+TEST_CASE("Common: Capture pipeline with looping static images")
+{
+    hal_platform_init();
+
+    TestImages images;
+    arm::app::StaticImageSource source(images.ptrs.data(), numImages, imageSize, true);
+    arm::app::CapturePipeline pipeline(source);
+
+    std::vector<uint8_t> values;
+    const uint32_t numFrames = numImages * 2 + 1;
+    REQUIRE(numFrames == pipeline.Run([&](const uint8_t* frame, uint32_t) {
+        values.push_back(frame[0]);
+        return true;
+    }, numFrames));
+
+    for (size_t i = 0; i < values.size(); ++i) {
+        CHECK(values[i] == (i % numImages) + 1);
+    }
+}
@@ -15,6 +15,7 @@
  * limitations under the License.
  */
 #include "Classifier.hpp"
+#include "PlatformMath.hpp"
 
 #include <catch.hpp>
 
@@ -42,6 +43,103 @@ void test_classifier_result(std::vector<std::pair<uint32_t, T>>& selectedResults
     }
 }
 
+namespace {
+
+    /* Exposes the set based top N selection over dequantised data. */
+    class ReferenceClassifier : public arm::app::Classifier {
+    public:
+        template<typename T>
+        void GetResults(const std::vector<T>& data, float scale, int offset, bool useSoftmax,
+                        uint32_t topNCount, const std::vector<std::string>& labels,
+                        std::vector<arm::app::ClassificationResult>& results)
+        {
+            std::vector<float> dequantised;
+            for (const T value : data) {
+                dequantised.push_back(scale * (static_cast<float>(value) - offset));
+            }
+            if (useSoftmax) {
+                arm::app::math::MathUtils::SoftmaxF32(dequantised);
+            }
+            this->GetTopNResults(dequantised, results, topNCount, labels);
+        }
+    };
+
+    template<typename T>
+    void TestTopNRefs(std::vector<T>& data, float scale, int offset, uint32_t topNCount)
+    {
+        std::vector<std::string> labels;
+        for (size_t i = 0; i < data.size(); ++i) {
+            labels.push_back("label" + std::to_string(i));
+        }
+        int dimArray[] = {1, static_cast<int>(data.size())};
+        TfLiteTensor tensor = tflite::testing::CreateQuantizedTensor(data.data(),
+            tflite::testing::IntArrayFromInts(dimArray), scale, offset);
+
+        arm::app::Classifier classifier;
+        ReferenceClassifier reference;
+
+        for (bool useSoftmax : {false, true}) {
+            std::vector<arm::app::ClassificationResult> expected;
+            reference.GetResults(data, scale, offset, useSoftmax, topNCount, labels, expected);
+
+            std::vector<arm::app::ClassificationResultRef> refs(topNCount);
+            REQUIRE(classifier.GetClassificationResultRefs(&tensor, refs.data(), labels, topNCount, useSoftmax));
+
+            std::vector<arm::app::ClassificationResult> results;
+            REQUIRE(classifier.GetClassificationResults(&tensor, results, labels, topNCount, useSoftmax));
+            REQUIRE(results.size() == topNCount);
+
+            for (uint32_t i = 0; i < topNCount; ++i) {
+                REQUIRE(refs[i].m_labelIdx == expected[i].m_labelIdx);
+                REQUIRE(refs[i].m_label == &labels[expected[i].m_labelIdx]);
+                REQUIRE(refs[i].m_normalisedVal == Approx(expected[i].m_normalisedVal).margin(1e-6));
+
+                REQUIRE(results[i].m_labelIdx == expected[i].m_labelIdx);
+                REQUIRE(results[i].m_label == expected[i].m_label);
+                REQUIRE(results[i].m_normalisedVal == refs[i].m_normalisedVal);
+            }
+        }
+    }
+
+} /* anonymous namespace */
+
+TEST_CASE("Common classifier top N on quantised data")
+{
+    /* Coarse values produce plenty of ties. */
+    uint32_t state = 12345;
+    auto next = [&state]() {
+        state = state * 1103515245 + 12345;
+        return static_cast<int>((state >> 16) % 40);
+    };
+
+    SECTION("int8") {
+        std::vector<int8_t> data(1001);
+        for (auto& value : data) {
+            value = static_cast<int8_t>(next() * 6 - 128);
+        }
+        TestTopNRefs(data, 0.0625f, -20, 5);
+        TestTopNRefs(data, 0.0625f, -20, 1);
+        TestTopNRefs(data, 0.0625f, -20, 40);
+    }
+
+    SECTION("uint8") {
+        std::vector<uint8_t> data(12);
+        for (auto& value : data) {
+            value = static_cast<uint8_t>(next() * 6);
+        }
+        TestTopNRefs(data, 0.00390625f, 0, 3);
+        TestTopNRefs(data, 0.00390625f, 0, 12);
+    }
+
+    SECTION("float") {
+        std::vector<float> data(100);
+        for (auto& value : data) {
+            value = next() * 0.25f - 3.0f;
+        }
+        TestTopNRefs(data, 1.0f, 0, 5);
+    }
+}
+
 TEST_CASE("Common classifier")
 {
     SECTION("Test invalid classifier")
@@ -0,0 +1,166 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DspTables.hpp"
+#include "MelFilterBank.hpp"
+
+#include <catch.hpp>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+    using arm::app::audio::FrontEndKind;
+    using arm::app::audio::FrontEndTables;
+    using arm::app::audio::MelFilterBank;
+    using arm::app::audio::MelFilterBankParams;
+
+    /* Generated tables are computed on the host; allow for the target's math functions. */
+    constexpr float tolerance = 1e-5f;
+
+    struct FrontEndConfig {
+        FrontEndKind        kind;
+        MelFilterBankParams melParams;
+        uint32_t            frameLen;
+        uint32_t            numMfccFeatures;
+    };
+
+    /* Defaults of MicroNetKwsMFCC, Wav2LetterMFCC and AdMelSpectrogram. */
+    const FrontEndConfig knownConfigs[] = {
+        {FrontEndKind::Mfcc, {16000, 40, 20, 4000, 1024, true}, 640, 10},
+        {FrontEndKind::Wav2LetterMfcc, {16000, 128, 0, 8000, 512, false}, 512, 13},
+        {FrontEndKind::AdMelSpectrogram, {16000, 64, 0, 8000, 1024, false}, 1024, 0},
+    };
+
+    std::vector<float> Normalisers(const FrontEndConfig& config)
+    {
+        const std::vector<float> melPoints = MelFilterBank::GetMelPoints(config.melParams);
+        std::vector<float> normalisers(config.melParams.numFbankBins, 1.f);
+        if (config.kind != FrontEndKind::Mfcc) {
+            /* Slaney normalisation. */
+            for (size_t i = 0; i < normalisers.size(); ++i) {
+                normalisers[i] = 2.0f / (
+                    MelFilterBank::InverseMelScale(melPoints[i + 2], config.melParams.useHtkMethod) -
+                    MelFilterBank::InverseMelScale(melPoints[i], config.melParams.useHtkMethod));
+            }
+        }
+        return normalisers;
+    }
+
+    /* Weights of a bank over all FFT bins. */
+    std::vector<float> DenseBank(const MelFilterBank& filterBank, uint32_t bank, size_t numFftBins)
+    {
+        std::vector<float> dense(numFftBins, 0);
+        const float* weights = filterBank.GetBankWeights(bank);
+        for (uint32_t i = 0; i < filterBank.GetBankSize(bank); ++i) {
+            dense[filterBank.GetBankFirstBin(bank) + i] = weights[i];
+        }
+        return dense;
+    }
+
+    float DctCoefficient(const FrontEndConfig& config, uint32_t k, uint32_t n)
+    {
+        const float numBins = config.melParams.numFbankBins;
+        const float angle = M_PI * k / numBins;
+        if (config.kind == FrontEndKind::Wav2LetterMfcc) {
+            /* Orthonormal DCT. */
+            if (k == 0) {
+                return 2 * std::sqrt(1.0f / (4 * numBins));
+            }
+            return 2 * std::sqrt(1.0f / (2 * numBins)) * std::cos((n + 0.5f) * angle);
+        }
+        return std::sqrt(2.0f / numBins) * std::cos((n + 0.5f) * angle);
+    }
+
+} /* anonymous namespace */
+
+TEST_CASE("Common: Generated front end tables match run time construction")
+{
+    for (const auto& config : knownConfigs) {
+        const FrontEndTables* tables = arm::app::audio::FindFrontEndTables(
+                config.kind, config.melParams, config.frameLen, config.numMfccFeatures);
+        if (!tables) {
+            /* Not generated in this build; the front end builds them at run time. */
+            continue;
+        }
+
+        REQUIRE(tables->window != nullptr);
+        for (uint32_t i = 0; i < config.frameLen; ++i) {
+            const float expected = 0.5f - 0.5f * std::cos(2 * M_PI * i / config.frameLen);
+            REQUIRE(tables->window[i] == Approx(expected).margin(tolerance));
+        }
+
+        const size_t numFftBins = config.melParams.frameLenPadded / 2;
+        const MelFilterBank generated{tables->melParams, tables->melWeights,
+                                      tables->melOffsets, tables->melFirstBins};
+        const MelFilterBank runtime{config.melParams, Normalisers(config)};
+        REQUIRE(generated.GetNumBanks() == runtime.GetNumBanks());
+        for (uint32_t bank = 0; bank < runtime.GetNumBanks(); ++bank) {
+            const std::vector<float> expected = DenseBank(runtime, bank, numFftBins);
+            const std::vector<float> actual = DenseBank(generated, bank, numFftBins);
+            for (size_t i = 0; i < numFftBins; ++i) {
+                REQUIRE(actual[i] == Approx(expected[i]).margin(tolerance));
+            }
+        }
+
+        if (config.numMfccFeatures) {
+            REQUIRE(tables->dctMatrix != nullptr);
+            for (uint32_t k = 0; k < config.numMfccFeatures; ++k) {
+                for (uint32_t n = 0; n < config.melParams.numFbankBins; ++n) {
+                    REQUIRE(tables->dctMatrix[k * config.melParams.numFbankBins + n] ==
+                            Approx(DctCoefficient(config, k, n)).margin(tolerance));
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Common: Generated RNNoise tables match run time construction")
+{
+    constexpr uint32_t frameSize = 512;
+    constexpr uint32_t numBands = 22;
+    const arm::app::audio::RNNoiseTables* tables = arm::app::audio::FindRNNoiseTables(frameSize, numBands);
+    if (!tables) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < frameSize; ++i) {
+        const float sinVal = std::sin(M_PI / 2 / frameSize * (i + 0.5f));
+        REQUIRE(tables->halfWindow[i] == Approx(std::sin(M_PI / 2 * sinVal * sinVal)).margin(tolerance));
+    }
+    for (uint32_t i = 0; i < numBands; ++i) {
+        for (uint32_t j = 0; j < numBands; ++j) {
+            float expected = std::cos((i + 0.5f) * j * M_PI / numBands);
+            if (j == 0) {
+                expected *= std::sqrt(0.5f);
+            }
+            REQUIRE(tables->dctTable[i * numBands + j] == Approx(expected).margin(tolerance));
+        }
+    }
+}
+
+TEST_CASE("Common: No generated tables for custom or unknown front ends")
+{
+    const FrontEndConfig& config = knownConfigs[0];
+    REQUIRE(arm::app::audio::FindFrontEndTables(FrontEndKind::Custom, config.melParams,
+                                                config.frameLen, config.numMfccFeatures) == nullptr);
+
+    MelFilterBankParams otherParams = config.melParams;
+    otherParams.numFbankBins += 1;
+    REQUIRE(arm::app::audio::FindFrontEndTables(config.kind, otherParams,
+                                                config.frameLen, config.numMfccFeatures) == nullptr);
+    REQUIRE(arm::app::audio::FindRNNoiseTables(480, 22) == nullptr);
+}
@@ -0,0 +1,71 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "FixedPointMel.hpp"
+
+#include <catch.hpp>
+#include <cmath>
+
+TEST_CASE("Common: Fixed point log2")
+{
+    const double lsb = 1.0 / (1 << arm::app::audio::FixedPointMel::ms_log2FracBits);
+
+    uint64_t state = 12345;
+    for (int i = 0; i < 10000; ++i) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        const uint64_t value = state >> (i % 64);
+        if (!value) {
+            continue;
+        }
+        const double log2 = arm::app::audio::FixedPointMel::Log2Q16(value) * lsb;
+        REQUIRE(log2 == Approx(std::log2(static_cast<double>(value))).margin(1.5 * lsb));
+    }
+
+    /* Exact powers of two. */
+    for (int i = 0; i < 64; ++i) {
+        REQUIRE(arm::app::audio::FixedPointMel::Log2Q16(uint64_t{1} << i) == i * 65536);
+    }
+}
+
+TEST_CASE("Common: Fixed point requantisation")
+{
+    arm::app::audio::FixedPointRequantiser requantiser;
+
+    struct {
+        double multiplier;
+        double bias;
+    } params[] = {
+        {1.0, 0},
+        {0.5, 3},
+        {1.7e-5, 95},
+        {0.3, -20.25},
+        {123.0, 0},
+    };
+
+    for (const auto& param : params) {
+        REQUIRE(requantiser.Set(param.multiplier, param.bias));
+        for (int64_t value : {0, 1, -1, 100, -12345, 654321, -7654321}) {
+            const double expected = std::floor(value * param.multiplier + param.bias + 0.5);
+            if (std::fabs(value * param.multiplier) < 1e6) {
+                REQUIRE(requantiser.Apply(value) == expected);
+            }
+        }
+    }
+
+    REQUIRE_FALSE(requantiser.Set(0, 0));
+    REQUIRE_FALSE(requantiser.Set(-1, 0));
+    REQUIRE_FALSE(requantiser.Set(1e12, 0));
+}
@@ -0,0 +1,179 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ImageUtils.hpp"
+
+#include <algorithm>
+#include <catch.hpp>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+    /* Previous VWW quantisation of a single pixel. */
+    int8_t QuantiseNormalised(uint8_t pixel, float scale, int offset)
+    {
+        auto value = static_cast<int8_t>(((static_cast<float>(pixel) / 255.0f) / scale) + offset);
+        return std::min<int8_t>(INT8_MAX, std::max<int8_t>(value, INT8_MIN));
+    }
+
+    std::vector<uint8_t> GenerateRgbImage(size_t numPixels)
+    {
+        std::vector<uint8_t> image(numPixels * 3);
+        uint32_t state = 12345;
+        for (auto& value : image) {
+            state = state * 1103515245 + 12345;
+            value = static_cast<uint8_t>(state >> 16);
+        }
+        return image;
+    }
+
+} /* anonymous namespace */
+
+TEST_CASE("Common: Integer RGB to gray conversion")
+{
+    std::vector<uint8_t> rgb(256 * 256 * 3);
+    std::vector<uint8_t> floatGray(256 * 256);
+    size_t numDiffering = 0;
+
+    for (uint32_t r = 0; r < 256; ++r) {
+        for (uint32_t g = 0; g < 256; ++g) {
+            for (uint32_t b = 0; b < 256; ++b) {
+                uint8_t* pixel = &rgb[(g * 256 + b) * 3];
+                pixel[0] = r;
+                pixel[1] = g;
+                pixel[2] = b;
+            }
+        }
+        arm::app::image::RgbToGrayscale(rgb.data(), floatGray.data(), floatGray.size());
+
+        for (size_t i = 0; i < floatGray.size(); ++i) {
+            const uint8_t* pixel = &rgb[i * 3];
+            const uint8_t gray = arm::app::image::RgbToGray(pixel[0], pixel[1], pixel[2]);
+            const uint32_t exact = (299 * pixel[0] + 587 * pixel[1] + 114 * pixel[2]) / 1000;
+            if (gray != exact) {
+                FAIL("Gray value differs from the exact one");
+            }
+            if (gray != floatGray[i]) {
+                /* Only where the floating point sum falls just below an integer. */
+                REQUIRE(gray == floatGray[i] + 1);
+                REQUIRE((299 * pixel[0] + 587 * pixel[1] + 114 * pixel[2]) % 1000 == 0);
+                ++numDiffering;
+            }
+        }
+    }
+
+    CHECK(numDiffering < 1000);
+}
+
+TEST_CASE("Common: Fused RGB to int8 grayscale conversion")
+{
+    /* Odd sizes exercise partial vectors. */
+    for (size_t numPixels : {1, 3, 4, 5, 17, 96 * 96}) {
+        const std::vector<uint8_t> rgb = GenerateRgbImage(numPixels);
+
+        /* Two pass reference: gray image, then in place conversion. */
+        std::vector<uint8_t> gray(numPixels);
+        std::vector<uint8_t> floatGray(numPixels);
+        for (size_t i = 0; i < numPixels; ++i) {
+            gray[i] = arm::app::image::RgbToGray(rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2]);
+        }
+        arm::app::image::RgbToGrayscale(rgb.data(), floatGray.data(), numPixels);
+        std::vector<uint8_t> twoPass = gray;
+        arm::app::image::ConvertImgToInt8(twoPass.data(), numPixels);
+
+        /* Guard entry checks nothing is written past the image. */
+        std::vector<int8_t> fused(numPixels + 1, 0x55);
+
+        SECTION("Offset by -128") {
+            arm::app::image::RgbToGrayscaleInt8(rgb.data(), fused.data(), numPixels);
+            for (size_t i = 0; i < numPixels; ++i) {
+                REQUIRE(fused[i] == static_cast<int8_t>(twoPass[i]));
+                REQUIRE(std::abs(fused[i] - (floatGray[i] - 128)) <= 1);
+            }
+            REQUIRE(fused[numPixels] == 0x55);
+        }
+
+        SECTION("Quantised through a look-up table") {
+            const float scale = 0.0039215689f;
+            const int offset = -128;
+            int8_t lut[arm::app::image::PixelLutSize];
+            arm::app::image::GetNormalisedInt8Lut(scale, offset, lut);
+
+            arm::app::image::RgbToGrayscaleInt8(rgb.data(), fused.data(), numPixels, lut);
+            for (size_t i = 0; i < numPixels; ++i) {
+                REQUIRE(fused[i] == QuantiseNormalised(gray[i], scale, offset));
+            }
+            REQUIRE(fused[numPixels] == 0x55);
+        }
+    }
+}
+
+TEST_CASE("Common: Normalised int8 look-up table matches float quantisation")
+{
+    struct {
+        float scale;
+        int offset;
+    } params[] = {
+        {0.0039215689f, -128},  /* Full int8 range. */
+        {0.0078431377f, 0},     /* Saturates above 0.5. */
+        {0.0123f, -50},
+        {1.0f, 0},
+    };
+
+    for (const auto& param : params) {
+        int8_t lut[arm::app::image::PixelLutSize];
+        arm::app::image::GetNormalisedInt8Lut(param.scale, param.offset, lut);
+
+        for (size_t i = 0; i < arm::app::image::PixelLutSize; ++i) {
+            const auto pixel = static_cast<uint8_t>(i);
+            const float value = ((pixel / 255.0f) / param.scale) + param.offset;
+            if (value >= INT8_MIN && value < INT8_MAX + 1) {
+                REQUIRE(lut[i] == QuantiseNormalised(pixel, param.scale, param.offset));
+            } else {
+                REQUIRE(lut[i] == (value < 0 ? INT8_MIN : INT8_MAX));
+            }
+        }
+    }
+}
+
+TEST_CASE("Common: Single pass uint8 to int8 conversion")
+{
+    std::vector<uint8_t> image(arm::app::image::PixelLutSize + 3);
+    for (size_t i = 0; i < image.size(); ++i) {
+        image[i] = static_cast<uint8_t>(i * 7);
+    }
+
+    std::vector<int8_t> converted(image.size());
+    arm::app::image::ConvertImgToInt8(image.data(), converted.data(), image.size());
+    for (size_t i = 0; i < image.size(); ++i) {
+        REQUIRE(converted[i] == static_cast<int8_t>(static_cast<int32_t>(image[i]) - 128));
+    }
+
+    /* In place. */
+    std::vector<uint8_t> inPlace = image;
+    arm::app::image::ConvertImgToInt8(inPlace.data(), inPlace.size());
+    for (size_t i = 0; i < image.size(); ++i) {
+        REQUIRE(static_cast<int8_t>(inPlace[i]) == converted[i]);
+    }
+
+    int8_t lut[arm::app::image::PixelLutSize];
+    arm::app::image::GetNormalisedInt8Lut(0.0078431377f, -128, lut);
+    arm::app::image::ConvertImgToInt8(image.data(), converted.data(), image.size(), lut);
+    for (size_t i = 0; i < image.size(); ++i) {
+        REQUIRE(converted[i] == QuantiseNormalised(image[i], 0.0078431377f, -128));
+    }
+}
@@ -0,0 +1,125 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "log_deferred.h"
+
+#include <catch.hpp>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+static void CollectLine(const char* line, void* user)
+{
+    static_cast<std::vector<std::string>*>(user)->emplace_back(line);
+}
+
+TEST_CASE("Common: Deferred log")
+{
+    auto ring = std::make_unique<log_ring>();
+    log_deferred_init(ring.get());
+    std::vector<std::string> lines;
+
+    SECTION("Messages are formatted at drain time, in order")
+    {
+        const long long big = 1LL << 40;
+        REQUIRE(0 == log_deferred_record(ring.get(), "INFO - ", "plain\n"));
+        REQUIRE(0 == log_deferred_record(ring.get(), "INFO - ", "%d %u %x %c %%\n", -3, 7u, 255, 'z'));
+        REQUIRE(0 == log_deferred_record(ring.get(), "DEBUG - ", "%lld %zu %.2f\n", big, size_t{42}, 1.5));
+        REQUIRE(0 == log_deferred_record(ring.get(), "WARN - ", "[%*d] [%-*s] [%.*f]\n", 4, 9, 3, "a", 1, 2.25));
+        REQUIRE(lines.empty());
+
+        REQUIRE(4 == log_deferred_drain(ring.get(), UINT32_MAX, CollectLine, &lines));
+        REQUIRE(lines == std::vector<std::string>{
+            "INFO - plain\n",
+            "INFO - -3 7 ff z %\n",
+            "DEBUG - 1099511627776 42 1.50\n",
+            "WARN - [   9] [a  ] [2.2]\n"});
+
+        lines.clear();
+        REQUIRE(0 == log_deferred_drain(ring.get(), UINT32_MAX, CollectLine, &lines));
+        REQUIRE(lines.empty());
+    }
+
+    SECTION("Strings are copied when recorded")
+    {
+        char name[] = "first";
+        REQUIRE(0 == log_deferred_record(ring.get(), "", "name: %s\n", name));
+        std::strcpy(name, "later");
+
+        REQUIRE(1 == log_deferred_drain(ring.get(), UINT32_MAX, CollectLine, &lines));
+        REQUIRE(lines[0] == "name: first\n");
+    }
+
+    SECTION("Arguments that do not fit are cut")
+    {
+        const std::string longText(2 * LOG_DEFERRED_ARG_BYTES, 'x');
+        REQUIRE(0 == log_deferred_record(ring.get(), "", "%d %s %d\n", 1, longText.c_str(), 2));
+
+        REQUIRE(1 == log_deferred_drain(ring.get(), UINT32_MAX, CollectLine, &lines));
+        const std::string expected = "1 " + std::string(LOG_DEFERRED_ARG_BYTES - sizeof(int) - 1, 'x') + " ...\n";
+        REQUIRE(lines[0] == expected);
+    }
+
+    SECTION("A single string that does not fit is cut")
+    {
+        const std::string longText(2 * LOG_DEFERRED_ARG_BYTES, 'x');
+        REQUIRE(0 == log_deferred_record(ring.get(), "", "%s\n", longText.c_str()));
+
+        REQUIRE(1 == log_deferred_drain(ring.get(), UINT32_MAX, CollectLine, &lines));
+        const std::string expected = std::string(LOG_DEFERRED_ARG_BYTES - 1, 'x') + "...\n";
+        REQUIRE(lines[0] == expected);
+    }
+
+    SECTION("Drain can be limited to a number of messages")
+    {
+        for (int i = 0; i < 5; ++i) {
+            REQUIRE(0 == log_deferred_record(ring.get(), "", "%d\n", i));
+        }
+        REQUIRE(2 == log_deferred_drain(ring.get(), 2, CollectLine, &lines));
+        REQUIRE(3 == log_deferred_drain(ring.get(), UINT32_MAX, CollectLine, &lines));
+        REQUIRE(lines == std::vector<std::string>{"0\n", "1\n", "2\n", "3\n", "4\n"});
+    }
+
+    SECTION("Overflow drops the newest messages and reports them")
+    {
+        constexpr int dropped = 3;
+        for (int i = 0; i < LOG_DEFERRED_SLOTS; ++i) {
+            REQUIRE(0 == log_deferred_record(ring.get(), "", "%d\n", i));
+        }
+        for (int i = 0; i < dropped; ++i) {
+            REQUIRE(-1 == log_deferred_record(ring.get(), "", "%d\n", LOG_DEFERRED_SLOTS + i));
+        }
+        REQUIRE(dropped == log_deferred_dropped(ring.get()));
+
+        REQUIRE(LOG_DEFERRED_SLOTS == log_deferred_drain(ring.get(), UINT32_MAX, CollectLine, &lines));
+        REQUIRE(lines.size() == LOG_DEFERRED_SLOTS + 1);
+        for (int i = 0; i < LOG_DEFERRED_SLOTS; ++i) {
+            REQUIRE(lines[i] == std::to_string(i) + "\n");
+        }
+        REQUIRE(lines.back() == "WARN - 3 log messages dropped\n");
+
+        /* The ring is usable again, wrapping around, and drops are reported once. */
+        lines.clear();
+        for (int i = 0; i < LOG_DEFERRED_SLOTS + LOG_DEFERRED_SLOTS / 2; ++i) {
+            REQUIRE(0 == log_deferred_record(ring.get(), "", "%d\n", i));
+            REQUIRE(1 == log_deferred_drain(ring.get(), UINT32_MAX, CollectLine, &lines));
+        }
+        REQUIRE(lines.size() == LOG_DEFERRED_SLOTS + LOG_DEFERRED_SLOTS / 2);
+        REQUIRE(lines.back() == std::to_string(LOG_DEFERRED_SLOTS + LOG_DEFERRED_SLOTS / 2 - 1) + "\n");
+        REQUIRE(dropped == log_deferred_dropped(ring.get()));
+    }
+}
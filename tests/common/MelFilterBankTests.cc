@@ -0,0 +1,171 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "MelFilterBank.hpp"
+#include "PlatformMath.hpp"
+
+#include <catch.hpp>
+#include <cfloat>
+#include <vector>
+
+namespace {
+
+    using arm::app::audio::MelFilterBank;
+    using arm::app::audio::MelFilterBankParams;
+
+    /* Per-bank filter bank as built before the packed representation. */
+    struct ReferenceFilterBank {
+        std::vector<std::vector<float>> weights;
+        std::vector<uint32_t> first;
+        std::vector<uint32_t> last;
+    };
+
+    ReferenceFilterBank CreateReference(const MelFilterBankParams& params, const std::vector<float>& normalisers)
+    {
+        ReferenceFilterBank ref;
+        const size_t numFftBins = params.frameLenPadded / 2;
+        const float fftBinWidth = static_cast<float>(params.samplingFreq) / params.frameLenPadded;
+        const float melLowFreq = MelFilterBank::MelScale(params.melLoFreq, params.useHtkMethod);
+        const float melHighFreq = MelFilterBank::MelScale(params.melHiFreq, params.useHtkMethod);
+        const float melFreqDelta = (melHighFreq - melLowFreq) / (params.numFbankBins + 1);
+
+        std::vector<float> thisBin(numFftBins);
+        ref.weights.resize(params.numFbankBins);
+        ref.first.resize(params.numFbankBins);
+        ref.last.resize(params.numFbankBins);
+
+        for (size_t bin = 0; bin < params.numFbankBins; bin++) {
+            const float leftMel = melLowFreq + bin * melFreqDelta;
+            const float centerMel = melLowFreq + (bin + 1) * melFreqDelta;
+            const float rightMel = melLowFreq + (bin + 2) * melFreqDelta;
+            uint32_t firstIndex = 0;
+            uint32_t lastIndex = 0;
+            bool firstIndexFound = false;
+
+            for (size_t i = 0; i < numFftBins; i++) {
+                const float mel = MelFilterBank::MelScale(fftBinWidth * i, params.useHtkMethod);
+                thisBin[i] = 0.0;
+                if (mel > leftMel && mel < rightMel) {
+                    const float weight = mel <= centerMel ? (mel - leftMel) / (centerMel - leftMel) :
+                                                            (rightMel - mel) / (rightMel - centerMel);
+                    thisBin[i] = weight * normalisers[bin];
+                    if (!firstIndexFound) {
+                        firstIndex = i;
+                        firstIndexFound = true;
+                    }
+                    lastIndex = i;
+                }
+            }
+
+            ref.first[bin] = firstIndex;
+            ref.last[bin] = lastIndex;
+            for (uint32_t i = firstIndex; i <= lastIndex; i++) {
+                ref.weights[bin].push_back(thisBin[i]);
+            }
+        }
+        return ref;
+    }
+
+    std::vector<float> SlaneyNormalisers(const MelFilterBankParams& params)
+    {
+        const std::vector<float> melPoints = MelFilterBank::GetMelPoints(params);
+        std::vector<float> normalisers(params.numFbankBins);
+        for (size_t bin = 0; bin < params.numFbankBins; ++bin) {
+            normalisers[bin] = 2.0f / (MelFilterBank::InverseMelScale(melPoints[bin + 2], params.useHtkMethod) -
+                                       MelFilterBank::InverseMelScale(melPoints[bin], params.useHtkMethod));
+        }
+        return normalisers;
+    }
+
+} /* anonymous namespace */
+
+TEST_CASE("Common: Packed mel filter bank matches per-bank filter bank")
+{
+    const MelFilterBankParams allParams[] = {
+        {16000, 40, 20, 4000, 1024, false},     /* KWS */
+        {16000, 128, 20, 8000, 512, false},     /* Wav2Letter */
+        {16000, 64, 0, 8000, 1024, false},      /* AD */
+        {16000, 40, 0, 8000, 256, true}         /* Narrow HTK banks, some empty. */
+    };
+
+    for (const auto& params : allParams) {
+        for (bool normalise : {false, true}) {
+            const std::vector<float> normalisers = normalise ? SlaneyNormalisers(params) :
+                                                   std::vector<float>(params.numFbankBins, 1.f);
+            const MelFilterBank filterBank(params, normalisers);
+            const ReferenceFilterBank ref = CreateReference(params, normalisers);
+            REQUIRE(filterBank.GetNumBanks() == params.numFbankBins);
+
+            for (uint32_t bank = 0; bank < params.numFbankBins; ++bank) {
+                const float* weights = filterBank.GetBankWeights(bank);
+                const uint32_t size = filterBank.GetBankSize(bank);
+
+                if (size == 0) {
+                    /* Empty banks were a single zero weight. */
+                    REQUIRE(ref.weights[bank] == std::vector<float>{0});
+                    continue;
+                }
+                REQUIRE(filterBank.GetBankFirstBin(bank) == ref.first[bank]);
+                REQUIRE(filterBank.GetBankFirstBin(bank) + size - 1 == ref.last[bank]);
+                REQUIRE(std::vector<float>(weights, weights + size) == ref.weights[bank]);
+                REQUIRE(filterBank.GetFirstBin() <= ref.first[bank]);
+                REQUIRE(filterBank.GetEndBin() > ref.last[bank]);
+            }
+
+            /* Magnitudes once per bin give the same energies as once per filter. */
+            std::vector<float> power(params.frameLenPadded);
+            for (size_t i = 0; i < power.size(); ++i) {
+                power[i] = static_cast<float>((i * 7919) % 1000) / 10.f;
+            }
+            std::vector<float> magnitude(power);
+            for (uint32_t i = filterBank.GetFirstBin(); i < filterBank.GetEndBin(); ++i) {
+                magnitude[i] = arm::app::math::MathUtils::SqrtF32(power[i]);
+            }
+            std::vector<float> energies(params.numFbankBins);
+            filterBank.Apply(magnitude.data(), energies.data(), FLT_MIN);
+
+            for (uint32_t bank = 0; bank < params.numFbankBins; ++bank) {
+                float expected = FLT_MIN;
+                for (size_t i = 0; i < ref.weights[bank].size(); ++i) {
+                    expected += ref.weights[bank][i] *
+                                arm::app::math::MathUtils::SqrtF32(power[ref.first[bank] + i]);
+                }
+                REQUIRE(energies[bank] == expected);
+            }
+        }
+    }
+}
+
+TEST_CASE("Common: Mel filter banks are shared between identical parameters")
+{
+    const MelFilterBankParams params{16000, 40, 20, 4000, 1024, false};
+    const std::vector<float> ones(params.numFbankBins, 1.f);
+
+    auto first = MelFilterBank::GetShared(params, ones);
+    auto second = MelFilterBank::GetShared(params, ones);
+    REQUIRE(first);
+    CHECK(first == second);
+
+    /* Different normalisers or parameters build a separate filter bank. */
+    CHECK(MelFilterBank::GetShared(params, SlaneyNormalisers(params)) != first);
+    MelFilterBankParams htkParams = params;
+    htkParams.useHtkMethod = true;
+    CHECK(MelFilterBank::GetShared(htkParams, ones) != first);
+
+    /* Still shared while any user holds it. */
+    first.reset();
+    CHECK(MelFilterBank::GetShared(params, ones) == second);
+}
@@ -0,0 +1,221 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "Nms.hpp"
+
+#include <algorithm>
+#include <catch.hpp>
+#include <cmath>
+#include <forward_list>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    constexpr int numClasses = 3;
+
+    /* Crowded scene: clusters of overlapping boxes, with a few classes. */
+    std::vector<arm::app::image::Detection> GenerateDetections(size_t numDetections)
+    {
+        std::vector<arm::app::image::Detection> detections(numDetections);
+        uint32_t state = 12345;
+        auto next = [&state](uint32_t range) {
+            state = state * 1103515245 + 12345;
+            return static_cast<float>((state >> 16) % range);
+        };
+
+        for (auto& det : detections) {
+            const float cluster = next(8);
+            det.bbox = {cluster * 40 + next(20), cluster * 25 + next(20), 20 + next(30), 20 + next(30)};
+            det.objectness = 1;
+            for (int c = 0; c < numClasses; ++c) {
+                /* Coarse scores produce ties. */
+                det.prob.push_back(next(3) ? 0.5f + next(50) / 100.0f : 0);
+            }
+        }
+        return detections;
+    }
+
+    /* One NMS box per detection and class with a non-zero score, in detection order. */
+    void FillBoxes(const std::vector<arm::app::image::Detection>& detections,
+                   arm::app::image::NmsBoxes& boxes, std::vector<std::pair<size_t, int>>& sources)
+    {
+        boxes.Clear();
+        sources.clear();
+        for (size_t i = 0; i < detections.size(); ++i) {
+            for (int c = 0; c < numClasses; ++c) {
+                if (detections[i].prob[c] > 0) {
+                    boxes.Add(detections[i].bbox, detections[i].prob[c], c);
+                    sources.emplace_back(i, c);
+                }
+            }
+        }
+    }
+
+    std::set<std::pair<size_t, int>> RunNms(const std::vector<arm::app::image::Detection>& detections,
+                                            const arm::app::image::NmsParams& params,
+                                            std::vector<uint32_t>& keep)
+    {
+        arm::app::image::NmsBoxes boxes;
+        std::vector<std::pair<size_t, int>> sources;
+        FillBoxes(detections, boxes, sources);
+
+        arm::app::image::NonMaxSuppression nms(params);
+        nms.Run(boxes, keep);
+
+        std::set<std::pair<size_t, int>> kept;
+        for (const uint32_t idx : keep) {
+            kept.insert(sources[idx]);
+        }
+        return kept;
+    }
+
+} /* anonymous namespace */
+
+TEST_CASE("Common: Per-class NMS matches list based NMS")
+{
+    /* The list based NMS sorts on the first class for every class, so compare
+     * a single class. */
+    auto detections = GenerateDetections(300);
+    for (auto& det : detections) {
+        std::fill(det.prob.begin() + 1, det.prob.end(), 0.0f);
+    }
+
+    /* Previous implementation, tagging each detection with its index. */
+    std::forward_list<arm::app::image::Detection> list;
+    for (size_t i = detections.size(); i > 0; --i) {
+        list.push_front(detections[i - 1]);
+        list.front().objectness = static_cast<float>(i - 1);
+    }
+    arm::app::image::CalculateNMS(list, 1, 0.45f);
+
+    std::set<std::pair<size_t, int>> expected;
+    for (const auto& det : list) {
+        if (det.prob[0] > 0) {
+            expected.emplace(static_cast<size_t>(det.objectness), 0);
+        }
+    }
+    REQUIRE(expected.size() > 10);
+
+    arm::app::image::NmsParams params;
+    params.mode = arm::app::image::NmsMode::PerClass;
+    std::vector<uint32_t> keep;
+    const auto perClass = RunNms(detections, params, keep);
+    CHECK(perClass == expected);
+
+    params.mode = arm::app::image::NmsMode::BatchedOffset;
+    CHECK(RunNms(detections, params, keep) == expected);
+}
+
+TEST_CASE("Common: NMS keeps boxes by decreasing score")
+{
+    const auto detections = GenerateDetections(100);
+    arm::app::image::NmsBoxes boxes;
+    std::vector<std::pair<size_t, int>> sources;
+    FillBoxes(detections, boxes, sources);
+
+    for (auto mode : {arm::app::image::NmsMode::ClassAgnostic,
+                      arm::app::image::NmsMode::PerClass,
+                      arm::app::image::NmsMode::BatchedOffset}) {
+        arm::app::image::NmsParams params;
+        params.mode = mode;
+        arm::app::image::NonMaxSuppression nms(params);
+        std::vector<uint32_t> keep;
+        const size_t numKept = nms.Run(boxes, keep);
+        REQUIRE(numKept == keep.size());
+        REQUIRE(numKept > 0);
+
+        for (size_t i = 1; i < keep.size(); ++i) {
+            REQUIRE(boxes.score[keep[i - 1]] >= boxes.score[keep[i]]);
+            if (boxes.score[keep[i - 1]] == boxes.score[keep[i]]) {
+                REQUIRE(keep[i - 1] < keep[i]);
+            }
+        }
+
+        /* No two kept boxes competing with each other overlap too much. */
+        for (size_t i = 0; i < keep.size(); ++i) {
+            for (size_t j = i + 1; j < keep.size(); ++j) {
+                const uint32_t a = keep[i];
+                const uint32_t b = keep[j];
+                if (mode != arm::app::image::NmsMode::ClassAgnostic && boxes.classId[a] != boxes.classId[b]) {
+                    continue;
+                }
+                arm::app::image::Box boxA = detections[sources[a].first].bbox;
+                arm::app::image::Box boxB = detections[sources[b].first].bbox;
+                REQUIRE(arm::app::image::CalculateBoxIOU(boxA, boxB) <= params.iouThreshold);
+            }
+        }
+    }
+}
+
+TEST_CASE("Common: Class-agnostic NMS and max detections")
+{
+    arm::app::image::NmsBoxes boxes;
+    boxes.Add({10, 10, 10, 10}, 0.9f, 0);
+    boxes.Add({11, 10, 10, 10}, 0.8f, 1);   /* Overlaps the first box. */
+    boxes.Add({50, 50, 10, 10}, 0.7f, 0);
+    boxes.Add({90, 90, 10, 10}, 0.95f, 2);
+
+    arm::app::image::NmsParams params;
+    std::vector<uint32_t> keep;
+
+    params.mode = arm::app::image::NmsMode::ClassAgnostic;
+    arm::app::image::NonMaxSuppression agnostic(params);
+    CHECK(agnostic.Run(boxes, keep) == 3);
+    CHECK(keep == std::vector<uint32_t>{3, 0, 2});
+
+    params.mode = arm::app::image::NmsMode::PerClass;
+    arm::app::image::NonMaxSuppression perClass(params);
+    CHECK(perClass.Run(boxes, keep) == 4);
+    CHECK(keep == std::vector<uint32_t>{3, 0, 1, 2});
+
+    params.maxDetections = 2;
+    arm::app::image::NonMaxSuppression limited(params);
+    CHECK(limited.Run(boxes, keep) == 2);
+    CHECK(keep == std::vector<uint32_t>{3, 0});
+}
+
+TEST_CASE("Common: Soft-NMS decays overlapping scores")
+{
+    arm::app::image::NmsBoxes boxes;
+    boxes.Add({10, 10, 10, 10}, 0.9f, 0);
+    boxes.Add({12, 10, 10, 10}, 0.85f, 0);  /* IoU 2/3 with the first box. */
+    boxes.Add({50, 50, 10, 10}, 0.7f, 0);
+
+    arm::app::image::NmsParams params;
+    params.softNms = true;
+    params.softSigma = 0.5f;
+    std::vector<uint32_t> keep;
+
+    SECTION("All boxes kept, overlapping one decayed") {
+        arm::app::image::NonMaxSuppression nms(params);
+        CHECK(nms.Run(boxes, keep) == 3);
+
+        const float decayed = 0.85f * std::exp(-(4.0f / 9.0f) / 0.5f);
+        CHECK(boxes.score[0] == Approx(0.9f));
+        CHECK(boxes.score[1] == Approx(decayed));
+        CHECK(boxes.score[2] == Approx(0.7f));
+        CHECK(keep == std::vector<uint32_t>{0, 2, 1});
+    }
+
+    SECTION("Decayed below the score threshold") {
+        params.scoreThreshold = 0.5f;
+        arm::app::image::NonMaxSuppression nms(params);
+        CHECK(nms.Run(boxes, keep) == 2);
+        CHECK(keep == std::vector<uint32_t>{0, 2});
+    }
+}
@@ -0,0 +1,149 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "OpProfiler.hpp"
+
+#include <catch.hpp>
+#include <cstring>
+
+namespace {
+
+    /* Operator profiler with a clock moved by the test. */
+    class FakeClockOpProfiler : public arm::app::OpProfiler {
+    public:
+        uint64_t now = 0;
+
+        /* Runs one operator that costs the given number of ticks. */
+        void RunOp(const char* name, uint64_t cost)
+        {
+            const uint32_t handle = this->BeginEvent(name);
+            this->now += cost;
+            this->EndEvent(handle);
+        }
+
+    protected:
+        uint64_t GetTimestamp() override
+        {
+            return this->now;
+        }
+
+        const char* GetUnit() const override
+        {
+            return "ticks";
+        }
+    };
+
+} /* namespace */
+
+TEST_CASE("Common: Operator profiler")
+{
+    FakeClockOpProfiler profiler;
+    profiler.Prepare(4);
+
+    /* Names are compared by content, as they would be across interpreters. */
+    char conv[] = "CONV_2D";
+
+    SECTION("Costs are recorded per operator index and per type")
+    {
+        const uint64_t costs[2][4] = {{100, 30, 10, 40}, {120, 30, 10, 60}};
+        for (const auto& run : costs) {
+            profiler.BeginInvoke();
+            profiler.RunOp("ethos-u", run[0]);
+            profiler.RunOp("CONV_2D", run[1]);
+            profiler.RunOp(conv, run[2]);
+            profiler.RunOp("ethos-u", run[3]);
+            profiler.EndInvoke();
+        }
+
+        REQUIRE(profiler.GetInvokeCount() == 2);
+
+        const auto& ops = profiler.GetOpStats();
+        REQUIRE(ops.size() == 4);
+        REQUIRE(std::strcmp(ops[0].name, "ethos-u") == 0);
+        REQUIRE(ops[0].isNpu);
+        REQUIRE(ops[0].count == 2);
+        REQUIRE(ops[0].total == 220);
+        REQUIRE(ops[0].min == 100);
+        REQUIRE(ops[0].max == 120);
+        REQUIRE_FALSE(ops[1].isNpu);
+        REQUIRE(ops[1].total == 60);
+        REQUIRE(ops[3].min == 40);
+        REQUIRE(ops[3].max == 60);
+
+        const auto& opTypes = profiler.GetOpTypeStats();
+        REQUIRE(opTypes.size() == 2);
+        REQUIRE(std::strcmp(opTypes[0].name, "ethos-u") == 0);
+        REQUIRE(opTypes[0].count == 4);
+        REQUIRE(opTypes[0].total == 320);
+        REQUIRE(std::strcmp(opTypes[1].name, "CONV_2D") == 0);
+        REQUIRE(opTypes[1].count == 4);
+        REQUIRE(opTypes[1].total == 80);
+
+        REQUIRE(profiler.GetNpuTotal() == 320);
+        REQUIRE(profiler.GetCpuTotal() == 80);
+
+        profiler.PrintResults(2);
+
+        profiler.Reset();
+        REQUIRE(profiler.GetInvokeCount() == 0);
+        REQUIRE(profiler.GetOpStats()[0].count == 0);
+        REQUIRE(profiler.GetOpTypeStats().empty());
+        REQUIRE(profiler.GetNpuTotal() + profiler.GetCpuTotal() == 0);
+    }
+
+    SECTION("Events outside an inference are ignored")
+    {
+        profiler.RunOp("CONV_2D", 50);
+        REQUIRE(profiler.GetOpStats()[0].count == 0);
+        REQUIRE(profiler.GetCpuTotal() == 0);
+    }
+
+    SECTION("Nested events count towards the enclosing operator")
+    {
+        profiler.BeginInvoke();
+        const uint32_t outer = profiler.BeginEvent("WHILE");
+        profiler.now += 5;
+        profiler.RunOp("ADD", 20);
+        profiler.RunOp("ADD", 20);
+        profiler.now += 5;
+        profiler.EndEvent(outer);
+        profiler.RunOp("SOFTMAX", 7);
+        profiler.EndInvoke();
+
+        const auto& ops = profiler.GetOpStats();
+        REQUIRE(std::strcmp(ops[0].name, "WHILE") == 0);
+        REQUIRE(ops[0].total == 50);
+        REQUIRE(std::strcmp(ops[1].name, "SOFTMAX") == 0);
+        REQUIRE(ops[1].total == 7);
+        REQUIRE(ops[2].count == 0);
+        REQUIRE(profiler.GetOpTypeStats().size() == 2);
+        REQUIRE(profiler.GetCpuTotal() == 57);
+    }
+
+    SECTION("Operators beyond the prepared graph only count in the totals")
+    {
+        profiler.BeginInvoke();
+        for (int i = 0; i < 6; ++i) {
+            profiler.RunOp("ethos-u", 10);
+        }
+        profiler.EndInvoke();
+
+        REQUIRE(profiler.GetOpStats().size() == 4);
+        REQUIRE(profiler.GetOpStats()[3].count == 1);
+        REQUIRE(profiler.GetOpTypeStats()[0].count == 6);
+        REQUIRE(profiler.GetNpuTotal() == 60);
+    }
+}
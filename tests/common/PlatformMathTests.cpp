@@ -16,9 +16,50 @@
  */
 #include "PlatformMath.hpp"
 #include <catch.hpp>
+#include <chrono>
+#include <cstdio>
 #include <limits>
 #include <numeric>
 
+namespace {
+
+    std::vector<float> GenerateSignal(size_t length)
+    {
+        std::vector<float> signal(length);
+        uint32_t state = 12345;
+        for (auto& value : signal) {
+            state = state * 1103515245 + 12345;
+            value = static_cast<float>((state >> 16) & 0x7FFF) / 0x4000 - 1.0f;
+        }
+        return signal;
+    }
+
+    /* Double precision DFT of fftLen complex values as [re, im] pairs. */
+    std::vector<double> ReferenceDft(const std::vector<float>& input, size_t fftLen)
+    {
+        std::vector<double> output(fftLen * 2, 0);
+        for (size_t k = 0; k < fftLen; ++k) {
+            for (size_t t = 0; t < fftLen; ++t) {
+                const double angle = 2 * M_PI * ((k * t) % fftLen) / fftLen;
+                output[k * 2] += input[t * 2] * cos(angle) + input[t * 2 + 1] * sin(angle);
+                output[k * 2 + 1] += input[t * 2 + 1] * cos(angle) - input[t * 2] * sin(angle);
+            }
+        }
+        return output;
+    }
+
+    /* Real input as complex values with zero imaginary parts. */
+    std::vector<float> ToComplex(const std::vector<float>& input)
+    {
+        std::vector<float> output(input.size() * 2, 0);
+        for (size_t i = 0; i < input.size(); ++i) {
+            output[i * 2] = input[i];
+        }
+        return output;
+    }
+
+} /* anonymous namespace */
+
 TEST_CASE("Test CosineF32")
 {
     /*Test  Constants: */
@@ -217,6 +258,25 @@ TEST_CASE("Test StdDevF32")
     CHECK (expectedResult4 == Approx(arm::app::math::MathUtils::StdDevF32(input4.data(), input4.size(), mean2)));
 }
 
+TEST_CASE("Test StdDevFromSumsF32")
+{
+    /* Same estimator as StdDevF32, from the sum and sum of squares only. */
+    std::vector<float> input {1, 2, 3, 4, 5, 6, 7, 8, 9, 0, 0.5, -2.25};
+    double sum = 0;
+    double sumSq = 0;
+    for (const float value : input) {
+        sum += value;
+        sumSq += value * value;
+    }
+    float mean = (std::accumulate(input.begin(), input.end(), 0.0f))/float(input.size());
+    CHECK (arm::app::math::MathUtils::StdDevF32(input.data(), input.size(), mean) ==
+           Approx(arm::app::math::MathUtils::StdDevFromSumsF32(sum, sumSq, input.size())));
+
+    /* All 1s should have 0 std dev. */
+    CHECK (0.0f == Approx(arm::app::math::MathUtils::StdDevFromSumsF32(4, 4, 4)));
+    CHECK (0.0f == arm::app::math::MathUtils::StdDevFromSumsF32(0, 0, 0));
+}
+
 TEST_CASE("Test FFT32")
 {
     constexpr size_t nElem = 512;
@@ -469,6 +529,119 @@ TEST_CASE("Test FFT32")
     }
 }
 
+TEST_CASE("Test FFT32 against reference DFT")
+{
+    /* Power of two lengths and a length only supported by the fallback DFT. */
+    for (uint16_t fftLen : {4, 8, 64, 512, 1024, 400}) {
+        const std::vector<float> signal = GenerateSignal(fftLen * 2);
+        const float tolerance = 1e-5 * fftLen;
+        arm::app::math::FftInstance fftInstance;
+
+        SECTION("Real FFT of length " + std::to_string(fftLen)) {
+            std::vector<float> input(signal.begin(), signal.begin() + fftLen);
+            std::vector<float> output(fftLen);
+            const std::vector<double> expected = ReferenceDft(ToComplex(input), fftLen);
+
+            arm::app::math::MathUtils::FftInitF32(fftLen, fftInstance, arm::app::math::FftType::real);
+            arm::app::math::MathUtils::FftF32(input, output, fftInstance);
+
+            /* Stored as [real0, realN/2, real1, im1, real2, im2, ...] */
+            REQUIRE(output[0] == Approx(expected[0]).margin(tolerance));
+            REQUIRE(output[1] == Approx(expected[fftLen]).margin(tolerance));
+            for (size_t i = 2; i < fftLen; ++i) {
+                REQUIRE(output[i] == Approx(expected[i]).margin(tolerance));
+            }
+        }
+
+        SECTION("Complex FFT of length " + std::to_string(fftLen)) {
+            std::vector<float> input = signal;
+            std::vector<float> output(fftLen * 2);
+            const std::vector<double> expected = ReferenceDft(input, fftLen);
+
+            arm::app::math::MathUtils::FftInitF32(fftLen, fftInstance, arm::app::math::FftType::complex);
+            arm::app::math::MathUtils::FftF32(input, output, fftInstance);
+
+            for (size_t i = 0; i < output.size(); ++i) {
+                REQUIRE(output[i] == Approx(expected[i]).margin(tolerance));
+            }
+            /* Input is left untouched. */
+            REQUIRE(input == signal);
+        }
+    }
+}
+
+TEST_CASE("Test fixed point real FFT")
+{
+    for (uint16_t fftLen : {4, 64, 512, 1024}) {
+        arm::app::math::FftInstanceQ31 fftInstance;
+        REQUIRE(arm::app::math::MathUtils::FftInitQ31(fftLen, fftInstance));
+
+        /* Full scale and quiet inputs. */
+        for (float amplitude : {0.999f, 0.001f}) {
+            const std::vector<float> signal = GenerateSignal(fftLen);
+            std::vector<int32_t> input(fftLen);
+            std::vector<float> inputF(fftLen);
+            for (size_t i = 0; i < fftLen; ++i) {
+                input[i] = static_cast<int32_t>(signal[i] * amplitude * 2147483648.0);
+                inputF[i] = input[i] / 2147483648.0;
+            }
+            const std::vector<double> expected = ReferenceDft(ToComplex(inputF), fftLen);
+
+            std::vector<int32_t> output(fftLen);
+            arm::app::math::MathUtils::FftRealQ31(input.data(), output.data(), fftInstance);
+
+            /* Output is divided by the FFT length; a few LSBs of rounding per stage. */
+            const double tolerance = 8.0 * std::log2(fftLen) / 2147483648.0;
+            REQUIRE(output[0] / 2147483648.0 == Approx(expected[0] / fftLen).margin(tolerance));
+            REQUIRE(output[1] / 2147483648.0 == Approx(expected[fftLen] / fftLen).margin(tolerance));
+            for (size_t i = 2; i < fftLen; ++i) {
+                REQUIRE(output[i] / 2147483648.0 == Approx(expected[i] / fftLen).margin(tolerance));
+            }
+        }
+    }
+
+    arm::app::math::FftInstanceQ31 fftInstance;
+    REQUIRE_FALSE(arm::app::math::MathUtils::FftInitQ31(400, fftInstance));
+}
+
+TEST_CASE("Test FFT32 benchmark", "[.benchmark]")
+{
+    const int iterations = 20;
+
+    for (uint16_t fftLen : {512, 1024}) {
+        std::vector<float> input = GenerateSignal(fftLen);
+        std::vector<float> output(fftLen);
+        arm::app::math::FftInstance fftInstance;
+        arm::app::math::MathUtils::FftInitF32(fftLen, fftInstance);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            arm::app::math::MathUtils::FftF32(input, output, fftInstance);
+        }
+        auto end = std::chrono::steady_clock::now();
+        const double fftTime = std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+
+        /* Direct DFT with trigonometric calls in the inner loop, as the fallback. */
+        start = std::chrono::steady_clock::now();
+        for (size_t k = 1; k < fftLen / 2u; ++k) {
+            float sumReal = 0;
+            float sumImag = 0;
+            const auto theta = static_cast<float>(2 * M_PI * k / fftLen);
+            for (size_t t = 0; t < fftLen; ++t) {
+                sumReal += input[t] * arm::app::math::MathUtils::CosineF32(t * theta);
+                sumImag -= input[t] * arm::app::math::MathUtils::SineF32(t * theta);
+            }
+            output[k * 2] = sumReal;
+            output[k * 2 + 1] = sumImag;
+        }
+        end = std::chrono::steady_clock::now();
+        const double dftTime = std::chrono::duration<double, std::micro>(end - start).count();
+
+        printf("Real FFT of length %d: DFT %.1f us, FFT %.1f us\n", fftLen, dftTime, fftTime);
+        CHECK(fftTime < dftTime);
+    }
+}
+
 TEST_CASE("Test VecLogarithmF32")
 {
     /*Test  Constants: */
@@ -498,6 +671,34 @@ TEST_CASE("Test DotProductF32")
     CHECK(dot_prod == expectedResult);
 }
 
+TEST_CASE("Test CrossCorrelationF32")
+{
+    /* Lag counts covering whole blocks of lags, a remainder and a single lag. */
+    for (size_t numLags : {1, 3, 4, 5, 157}) {
+        for (size_t len : {1, 7, 256}) {
+            const std::vector<float> y = GenerateSignal(len + numLags - 1);
+            const std::vector<float> x(y.rbegin(), y.rbegin() + len);
+            std::vector<float> xCorr(numLags);
+
+            arm::app::math::MathUtils::CrossCorrelationF32(x.data(), y.data(), len, xCorr.data(), numLags);
+
+            for (size_t k = 0; k < numLags; ++k) {
+                float expected = 0;
+                for (size_t j = 0; j < len; ++j) {
+                    expected += x[j] * y[k + j];
+                }
+#if (defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1))
+                /* CMSIS-DSP accumulates in a different order. */
+                REQUIRE(xCorr[k] == Approx(expected).margin(1e-4));
+#else  /* __ARM_FEATURE_DSP */
+                /* Each lag is summed in order, so results match a lag at a time. */
+                REQUIRE(xCorr[k] == expected);
+#endif /* __ARM_FEATURE_DSP */
+            }
+        }
+    }
+}
+
 TEST_CASE("Test ComplexMagnitudeSquaredF32")
 {
     /*Test  Constants: */
@@ -99,4 +99,353 @@ TEST_CASE("Common: Test Profiler")
         REQUIRE(foundCPU_ACTIVE);
     }
 #endif /* defined (CPU_PROFILE_ENABLED) */
-}
\ No newline at end of file
+}
+
+TEST_CASE("Common: Log histogram")
+{
+    arm::app::LogHistogram histogram;
+    REQUIRE(0 == histogram.Count());
+    REQUIRE(0 == histogram.Percentile(50));
+
+    SECTION("Buckets are exact for small values and log-linear above") {
+        for (uint64_t v = 0; v < arm::app::LogHistogram::ms_subBuckets; ++v) {
+            REQUIRE(v == arm::app::LogHistogram::BucketIndex(v));
+            REQUIRE(v == arm::app::LogHistogram::BucketUpperBound(v));
+        }
+
+        uint32_t previous = 0;
+        for (uint64_t v = 1; v < (uint64_t{1} << 20); v = v * 5 / 4 + 1) {
+            const uint32_t index = arm::app::LogHistogram::BucketIndex(v);
+            REQUIRE(index >= previous);
+            REQUIRE(arm::app::LogHistogram::BucketUpperBound(index) >= v);
+            /* Relative bucket width is bounded. */
+            REQUIRE(arm::app::LogHistogram::BucketUpperBound(index) <= v + v / 8);
+            previous = index;
+        }
+
+        /* The last bucket ends just below 2^ms_maxExponent; larger values overflow. */
+        const uint64_t top = uint64_t{1} << arm::app::LogHistogram::ms_maxExponent;
+        REQUIRE(arm::app::LogHistogram::ms_numBuckets - 1 == arm::app::LogHistogram::BucketIndex(top - 1));
+        REQUIRE(top - 1 == arm::app::LogHistogram::BucketUpperBound(arm::app::LogHistogram::ms_numBuckets - 1));
+        REQUIRE(arm::app::LogHistogram::ms_overflowBucket == arm::app::LogHistogram::BucketIndex(top));
+        REQUIRE(arm::app::LogHistogram::ms_overflowBucket == arm::app::LogHistogram::BucketIndex(UINT64_MAX));
+        REQUIRE(UINT64_MAX == arm::app::LogHistogram::BucketUpperBound(arm::app::LogHistogram::ms_overflowBucket));
+    }
+
+    SECTION("Percentiles of a uniform distribution") {
+        for (uint64_t v = 1; v <= 1000; ++v) {
+            histogram.Add(v * 100);
+        }
+        REQUIRE(1000 == histogram.Count());
+        /* Estimates are the top of a bucket, capped by the largest sample. */
+        REQUIRE(histogram.Percentile(0) >= 100);
+        REQUIRE(histogram.Percentile(0) <= 112);
+        REQUIRE(histogram.Percentile(100) == 100000);
+
+        for (double p : {50.0, 90.0, 99.0}) {
+            const double exact = p * 1000;
+            REQUIRE(histogram.Percentile(p) >= exact);
+            REQUIRE(histogram.Percentile(p) <= exact * 1.125);
+        }
+
+        histogram.Clear();
+        REQUIRE(0 == histogram.Count());
+    }
+
+    SECTION("Percentiles pick out a tail") {
+        for (int i = 0; i < 98; ++i) {
+            histogram.Add(1000);
+        }
+        histogram.Add(50000);
+        histogram.Add(90000);
+        REQUIRE(histogram.Percentile(50) >= 1000);
+        REQUIRE(histogram.Percentile(50) <= 1125);
+        REQUIRE(histogram.Percentile(98) == histogram.Percentile(50));
+        REQUIRE(histogram.Percentile(99) >= 50000);
+        REQUIRE(histogram.Percentile(99) < 90000);
+        REQUIRE(histogram.Percentile(100) == 90000);
+    }
+
+    SECTION("Counts are halved when a bucket fills") {
+        for (uint32_t i = 0; i < 3 * UINT16_MAX; ++i) {
+            histogram.Add(1000);
+        }
+        for (uint32_t i = 0; i < UINT16_MAX / 4; ++i) {
+            histogram.Add(50000);
+        }
+        REQUIRE(3 * UINT16_MAX + UINT16_MAX / 4 == histogram.Count());
+        /* The older samples were weighted down, so the recent tail reaches p90. */
+        REQUIRE(histogram.Percentile(50) <= 1125);
+        REQUIRE(histogram.Percentile(90) >= 50000);
+        REQUIRE(histogram.Percentile(100) == 50000);
+    }
+}
+
+TEST_CASE("Common: Profiler export")
+{
+    arm::app::Statistics stat{};
+    stat.name = "NPU TOTAL";
+    stat.unit = "cycles";
+    stat.samplesNum = 4;
+    stat.total = 10;
+    stat.avrg = 2.5;
+    stat.min = 1;
+    stat.p50 = 2;
+    stat.p90 = 4;
+    stat.p99 = 4;
+    stat.max = 4;
+    stat.jitter = 1.5;
+
+    arm::app::ProfileResult result{};
+    result.name = "Inference, \"warm\"";
+    result.samplesNum = 4;
+    result.data.push_back(stat);
+    const std::vector<arm::app::ProfileResult> results{result};
+
+    SECTION("CSV") {
+        std::vector<std::string> lines;
+        arm::app::Profiler::FormatProfilingResult(results, arm::app::ProfilingExportFormat::Csv, lines);
+        REQUIRE(lines.size() == 2);
+        REQUIRE(lines[0] == "region,counter,unit,samples,total,avg,min,p50,p90,p99,max,jitter");
+        REQUIRE(lines[1] == "\"Inference, \"\"warm\"\"\",NPU TOTAL,cycles,4,10,2.5,1,2,4,4,4,1.5");
+    }
+
+    SECTION("JSON lines") {
+        std::vector<std::string> lines;
+        arm::app::Profiler::FormatProfilingResult(results, arm::app::ProfilingExportFormat::JsonLines, lines);
+        REQUIRE(lines.size() == 1);
+        REQUIRE(lines[0] == "{\"region\":\"Inference, \\\"warm\\\"\",\"counter\":\"NPU TOTAL\","
+                            "\"unit\":\"cycles\",\"samples\":4,\"total\":10,\"avg\":2.5,\"min\":1,"
+                            "\"p50\":2,\"p90\":4,\"p99\":4,\"max\":4,\"jitter\":1.5}");
+    }
+
+    SECTION("Collected results carry percentiles and jitter") {
+        hal_platform_init();
+        arm::app::Profiler profiler{"stats"};
+        for (int i = 0; i < 3; ++i) {
+            REQUIRE(profiler.StartProfiling());
+            REQUIRE(profiler.StopProfiling());
+        }
+        std::vector<arm::app::ProfileResult> collected;
+        profiler.GetAllResultsAndReset(collected);
+        REQUIRE(collected.size() == 1);
+        for (const arm::app::Statistics& s : collected[0].data) {
+            REQUIRE(s.samplesNum == 3);
+            REQUIRE(s.min <= s.p50);
+            REQUIRE(s.p50 <= s.p90);
+            REQUIRE(s.p90 <= s.p99);
+            REQUIRE(s.p99 <= s.max);
+            REQUIRE(s.jitter >= 0);
+        }
+    }
+}
+
+/* Busy waits for at least the given time on the profiler's own clock. */
+static void BusyWait(arm::app::Profiler& profiler, arm::app::ProfileRegionId id)
+{
+    arm::app::ProfileScope scope{profiler, id};
+    pmu_counters start{};
+    pmu_counters now{};
+    hal_pmu_get_counters(&start);
+    do {
+        hal_pmu_get_counters(&now);
+    } while (now.num_counters > 0 && now.counters[0].value - start.counters[0].value < 2000);
+}
+
+TEST_CASE("Common: Profiler scopes")
+{
+    hal_platform_init();
+    arm::app::Profiler profiler{"scopes"};
+    const arm::app::ProfileRegionId frame = profiler.RegisterRegion("Frame");
+    const arm::app::ProfileRegionId invoke = profiler.RegisterRegion("Invoke");
+    const arm::app::ProfileRegionId display = profiler.RegisterRegion("Display");
+    REQUIRE(frame != invoke);
+    REQUIRE(invoke == profiler.RegisterRegion("Invoke"));
+
+    SECTION("Nested scopes report inclusive and exclusive statistics") {
+        constexpr uint32_t frames = 3;
+        for (uint32_t i = 0; i < frames; ++i) {
+            arm::app::ProfileScope frameScope{profiler, frame};
+            BusyWait(profiler, invoke);
+            {
+                arm::app::ProfileScope displayScope{profiler, display};
+            }
+        }
+
+        std::vector<arm::app::ProfileResult> results;
+        profiler.GetAllResultsAndReset(results);
+        REQUIRE(results.size() == 4);
+        REQUIRE(results[0].name == "Frame");
+        REQUIRE(results[1].name == "Frame (exclusive)");
+        REQUIRE(results[2].name == "Invoke");
+        REQUIRE(results[3].name == "Display");
+        for (const auto& result : results) {
+            REQUIRE(result.samplesNum == frames);
+        }
+
+        for (size_t c = 0; c < results[0].data.size(); ++c) {
+            const uint64_t frameTotal = results[0].data[c].total;
+            const uint64_t exclusiveTotal = results[1].data[c].total;
+            const uint64_t nestedTotal = results[2].data[c].total + results[3].data[c].total;
+            REQUIRE(frameTotal >= nestedTotal);
+            REQUIRE(exclusiveTotal == frameTotal - nestedTotal);
+        }
+        if (!results[2].data.empty()) {
+            REQUIRE(results[2].data[0].min >= 2000);
+        }
+
+        /* Registrations survive the reset. */
+        REQUIRE(display == profiler.RegisterRegion("Display"));
+    }
+
+    SECTION("Exclusive statistics start once a region has nested regions") {
+        {
+            arm::app::ProfileScope frameScope{profiler, frame};
+        }
+        {
+            arm::app::ProfileScope frameScope{profiler, frame};
+            BusyWait(profiler, invoke);
+        }
+
+        std::vector<arm::app::ProfileResult> results;
+        profiler.GetAllResultsAndReset(results);
+        REQUIRE(results.size() == 3);
+        REQUIRE(results[1].name == "Frame (exclusive)");
+        /* The frame before the first nested region counts as exclusive too. */
+        REQUIRE(results[1].samplesNum == 2);
+        for (size_t c = 0; c < results[0].data.size(); ++c) {
+            REQUIRE(results[1].data[c].total == results[0].data[c].total - results[2].data[c].total);
+        }
+    }
+
+    SECTION("Regions must be exited innermost first") {
+        REQUIRE(profiler.EnterRegion(frame));
+        REQUIRE(profiler.EnterRegion(invoke));
+        REQUIRE_FALSE(profiler.ExitRegion(frame));
+        REQUIRE(profiler.ExitRegion(invoke));
+        REQUIRE(profiler.ExitRegion(frame));
+        REQUIRE_FALSE(profiler.ExitRegion(frame));
+        REQUIRE_FALSE(profiler.EnterRegion(1000));
+    }
+
+    SECTION("Nesting depth is bounded") {
+        for (size_t i = 0; i < arm::app::Profiler::ms_maxRegionDepth; ++i) {
+            REQUIRE(profiler.EnterRegion(frame));
+        }
+        REQUIRE_FALSE(profiler.EnterRegion(frame));
+        for (size_t i = 0; i < arm::app::Profiler::ms_maxRegionDepth; ++i) {
+            REQUIRE(profiler.ExitRegion(frame));
+        }
+    }
+
+    SECTION("Overhead per scope") {
+        constexpr uint32_t scopes = 10000;
+        arm::app::Profiler timer{"overhead"};
+        const arm::app::ProfileRegionId outer = timer.RegisterRegion("Outer");
+        const arm::app::ProfileRegionId inner = timer.RegisterRegion("Inner");
+        {
+            arm::app::ProfileScope outerScope{timer, outer};
+            for (uint32_t i = 0; i < scopes; ++i) {
+                arm::app::ProfileScope innerScope{timer, inner};
+            }
+        }
+
+        std::vector<arm::app::ProfileResult> results;
+        timer.GetAllResultsAndReset(results);
+        REQUIRE(results.size() == 3);
+        REQUIRE(results[2].name == "Inner");
+        REQUIRE(results[2].samplesNum == scopes);
+        if (!results[0].data.empty()) {
+            /* Time spent outside the inner regions is their entry and exit cost. */
+            const double perScope = static_cast<double>(results[1].data[0].total) / scopes;
+            INFO("Overhead per scope: " << perScope << " " << results[1].data[0].unit);
+            REQUIRE(perScope < 50);
+        }
+    }
+}
+
+namespace {
+
+    /* Profiler reading a 32-bit event counter moved by the test. */
+    class FakeCounterProfiler : public arm::app::Profiler {
+    public:
+        uint32_t now = 0;
+        uint32_t overflowClears = 0;
+
+    protected:
+        void GetCounters(pmu_counters& counters) override
+        {
+            counters.num_counters = 1;
+            counters.initialised = true;
+            counters.counters[0].value = this->now;
+            counters.counters[0].name = "NPU ACTIVE";
+            counters.counters[0].unit = "cycles";
+            counters.counters[0].bits = 32;
+        }
+
+        void ClearCounterOverflow() override
+        {
+            ++this->overflowClears;
+        }
+    };
+
+} /* namespace */
+
+TEST_CASE("Common: Profiler counter wrap")
+{
+    SECTION("Deltas are taken modulo the counter width") {
+        pmu_counter_unit start{UINT32_MAX - 9, "NPU ACTIVE", "cycles", 32};
+        pmu_counter_unit end{5, "NPU ACTIVE", "cycles", 32};
+        REQUIRE(15 == arm::app::Profiler::CounterDelta(start, end));
+
+        start.bits = end.bits = PMU_COUNTER_MAX_BITS;
+        start.value = 100;
+        end.value = uint64_t{1} << 40;
+        REQUIRE(end.value - 100 == arm::app::Profiler::CounterDelta(start, end));
+    }
+
+    SECTION("Regions spanning a wrap") {
+        FakeCounterProfiler profiler;
+        const arm::app::ProfileRegionId frame = profiler.RegisterRegion("Frame");
+        const arm::app::ProfileRegionId invoke = profiler.RegisterRegion("Invoke");
+
+        profiler.now = UINT32_MAX - 99;
+        for (int i = 0; i < 2; ++i) {
+            REQUIRE(profiler.EnterRegion(frame));
+            profiler.now += 50;
+            REQUIRE(profiler.EnterRegion(invoke));
+            profiler.now += 300;
+            REQUIRE(profiler.ExitRegion(invoke));
+            profiler.now += 20;
+            REQUIRE(profiler.ExitRegion(frame));
+        }
+
+        /* Overflow is cleared once per frame, when no region is open. */
+        REQUIRE(profiler.overflowClears == 2);
+
+        std::vector<arm::app::ProfileResult> results;
+        profiler.GetAllResultsAndReset(results);
+        REQUIRE(results.size() == 3);
+        REQUIRE(results[0].name == "Frame");
+        REQUIRE(results[0].data[0].min == 370);
+        REQUIRE(results[0].data[0].max == 370);
+        REQUIRE(results[1].name == "Frame (exclusive)");
+        REQUIRE(results[1].data[0].total == 2 * 70);
+        REQUIRE(results[2].name == "Invoke");
+        REQUIRE(results[2].data[0].min == 300);
+        REQUIRE(results[2].data[0].max == 300);
+    }
+
+    SECTION("Start and stop spanning a wrap") {
+        FakeCounterProfiler profiler;
+        profiler.now = UINT32_MAX - 4;
+        REQUIRE(profiler.StartProfiling("wrap"));
+        profiler.now += 10;
+        REQUIRE(profiler.StopProfiling());
+
+        std::vector<arm::app::ProfileResult> results;
+        profiler.GetAllResultsAndReset(results);
+        REQUIRE(results.size() == 1);
+        REQUIRE(results[0].data[0].total == 10);
+    }
+}
@@ -215,3 +215,29 @@ TEST_CASE("Mel Spec calculation") {
         TestQuntisedMelSpec<int16_t>();
     }
 }
+
+TEST_CASE("Mel Spec fixed point calculation") {
+    const int frameLenSamples = 1024;
+    arm::app::audio::AdMelSpectrogram floatMelSpec(frameLenSamples);
+    arm::app::audio::AdMelSpectrogram fixedMelSpec(frameLenSamples, true);
+
+    SECTION("Matches floating point") {
+        const float trainingMean = 2.5f;
+        auto expected = floatMelSpec.ComputeMelSpec(testWav1, trainingMean);
+        auto melSpecOutput = fixedMelSpec.ComputeMelSpec(testWav1, trainingMean);
+        REQUIRE_THAT(melSpecOutput, Catch::Approx(expected).margin(0.01));
+        REQUIRE_THAT(fixedMelSpec.ComputeMelSpec(testWav1), Catch::Approx(testWavMelSpec).margin(0.1));
+    }
+
+    SECTION("Quantised output within one step") {
+        const float quantScale = 0.1410219967365265;
+        const int quantOffset = 11;
+        for (float trainingMean : {0.0f, -3.0f}) {
+            auto expected = floatMelSpec.MelSpecComputeQuant<int8_t>(testWav1, quantScale, quantOffset, trainingMean);
+            auto melSpecOutput = fixedMelSpec.MelSpecComputeQuant<int8_t>(testWav1, quantScale, quantOffset, trainingMean);
+            for (size_t i = 0; i < expected.size(); ++i) {
+                REQUIRE(std::abs(melSpecOutput[i] - expected[i]) <= 1);
+            }
+        }
+    }
+}
@@ -16,6 +16,8 @@
  */
 #include "Wav2LetterPreprocess.hpp"
 
+#include <algorithm>
+#include <cstdlib>
 #include <limits>
 #include <catch.hpp>
 
@@ -133,3 +135,75 @@ TEST_CASE("Preprocessing calculation INT8")
         }
     }
 }
+
+TEST_CASE("Preprocessing streaming matches full recomputation")
+{
+    const uint32_t  mfccWindowLen      = 512;
+    const uint32_t  mfccWindowStride   = 160;
+    const uint32_t  numFrames          = 30;
+    const uint32_t  innerLen           = 10;
+    int             dimArray[]         = {3, 1, numMfccFeatures * 3, numFrames};
+    const float     quantScale         = 0.1410219967365265;
+    const int       quantOffset        = -11;
+
+    /* Same window geometry as the ASR use case, with a partial last window. */
+    const uint32_t windowLen    = (numFrames - 1) * mfccWindowStride + mfccWindowLen;
+    const uint32_t windowStride = innerLen * mfccWindowStride;
+    std::vector<int16_t> testWav(windowLen + 4 * windowStride + 1000);
+    PopulateTestWavVector(testWav);
+
+    std::vector<int8_t> fullVec(dimArray[1]*dimArray[2]*dimArray[3]);
+    std::vector<int8_t> streamVec(fullVec.size());
+    TfLiteIntArray* dims = tflite::testing::IntArrayFromInts(dimArray);
+    TfLiteTensor fullTensor = tflite::testing::CreateQuantizedTensor(
+            fullVec.data(), dims, quantScale, quantOffset, "fullInput");
+    TfLiteTensor streamTensor = tflite::testing::CreateQuantizedTensor(
+            streamVec.data(), dims, quantScale, quantOffset, "streamInput");
+
+    arm::app::AsrPreProcess fullPrep{&fullTensor,
+                                     numMfccFeatures, numFrames, mfccWindowLen, mfccWindowStride};
+    arm::app::AsrPreProcess streamPrep{&streamTensor,
+                                       numMfccFeatures, numFrames, mfccWindowLen, mfccWindowStride,
+                                       true};
+
+    auto slider = arm::app::audio::FractionalSlidingWindow<const int16_t>(
+            testWav.data(), testWav.size(), windowLen, windowStride);
+
+    size_t windowIdx = 0;
+    while (slider.HasNext()) {
+        const size_t startIdx = slider.NextWindowStartIndex();
+        const size_t len = std::min<size_t>(windowLen, testWav.size() - startIdx);
+        const int16_t* window = slider.Next();
+
+        streamPrep.SetStreamOffset(startIdx);
+        REQUIRE(fullPrep.DoPreProcess(window, len));
+        REQUIRE(streamPrep.DoPreProcess(window, len));
+
+        /* Only the frames past the previous window are computed. */
+        if (windowIdx == 0) {
+            CHECK(streamPrep.GetNumComputedFrames() == numFrames);
+        } else if (len == windowLen) {
+            CHECK(streamPrep.GetNumComputedFrames() == innerLen);
+        } else {
+            CHECK(streamPrep.GetNumComputedFrames() < innerLen);
+        }
+
+        /* Standardisation statistics are accumulated differently: allow 1 LSB. */
+        for (size_t i = 0; i < fullVec.size(); ++i) {
+            CHECK(std::abs(fullVec[i] - streamVec[i]) <= 1);
+        }
+        ++windowIdx;
+    }
+    REQUIRE(windowIdx == 6);
+
+    SECTION("Restarting the stream recomputes all frames")
+    {
+        streamPrep.SetStreamOffset(0);
+        REQUIRE(streamPrep.DoPreProcess(testWav.data(), windowLen));
+        CHECK(streamPrep.GetNumComputedFrames() == numFrames);
+        REQUIRE(fullPrep.DoPreProcess(testWav.data(), windowLen));
+        for (size_t i = 0; i < fullVec.size(); ++i) {
+            CHECK(std::abs(fullVec[i] - streamVec[i]) <= 1);
+        }
+    }
+}
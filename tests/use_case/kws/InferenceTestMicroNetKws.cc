@@ -14,6 +14,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "BatchInference.hpp"
 #include "BufAttributes.hpp"
 #include "MicroNetKwsModel.hpp"
 #include "TensorFlowLiteMicro.hpp"
@@ -118,3 +119,62 @@ TEST_CASE("Running inference with TensorFlow Lite Micro and MicroNetKwsModel int
         }
     }
 }
+
+TEST_CASE("Running batch inference with TensorFlow Lite Micro and MicroNetKwsModel int8", "[MicroNetKws]")
+{
+    REQUIRE(NUMBER_OF_IFM_FILES == NUMBER_OF_OFM_FILES);
+
+    arm::app::MicroNetKwsModel model{};
+    REQUIRE(model.Init(arm::app::tensorArena,
+                       sizeof(arm::app::tensorArena),
+                       arm::app::kws::GetModelPointer(),
+                       arm::app::kws::GetModelLen()));
+
+    TfLiteTensor* inputTensor = model.GetInputTensor(0);
+    TfLiteTensor* outputTensor = model.GetOutputTensor(0);
+    REQUIRE(outputTensor->bytes == OFM_0_DATA_SIZE);
+
+    /* All inputs are written before the first inference; each output is checked after the last one. */
+    std::vector<size_t> postProcessed;
+    arm::app::BatchInference batch{model};
+    REQUIRE(batch.Run(NUMBER_OF_IFM_FILES,
+                      [&](size_t windowIdx) {
+                          const size_t copySz = inputTensor->bytes < IFM_0_DATA_SIZE ?
+                                                inputTensor->bytes : IFM_0_DATA_SIZE;
+                          memcpy(inputTensor->data.data, GetIfmDataArray(windowIdx), copySz);
+                          return true;
+                      },
+                      [&](size_t windowIdx) {
+                          auto output_goldenFV = reinterpret_cast<const int8_t*>(GetOfmDataArray(windowIdx));
+                          auto tensorData = tflite::GetTensorData<int8_t>(outputTensor);
+                          for (size_t i = 0; i < outputTensor->bytes; i++) {
+                              REQUIRE(static_cast<int>(tensorData[i]) == static_cast<int>(output_goldenFV[i]));
+                          }
+                          postProcessed.push_back(windowIdx);
+                          return true;
+                      }));
+
+    REQUIRE(postProcessed.size() == NUMBER_OF_IFM_FILES);
+    for (size_t i = 0; i < postProcessed.size(); ++i) {
+        REQUIRE(postProcessed[i] == i);
+    }
+}
+
+TEST_CASE("Batch inference stops at the first failing window", "[MicroNetKws]")
+{
+    arm::app::MicroNetKwsModel model{};
+    REQUIRE(model.Init(arm::app::tensorArena,
+                       sizeof(arm::app::tensorArena),
+                       arm::app::kws::GetModelPointer(),
+                       arm::app::kws::GetModelLen()));
+
+    size_t numPostProcessed = 0;
+    arm::app::BatchInference batch{model};
+    REQUIRE_FALSE(batch.Run(4,
+                            [](size_t windowIdx) { return windowIdx != 2; },
+                            [&](size_t) {
+                                ++numPostProcessed;
+                                return true;
+                            }));
+    REQUIRE(numPostProcessed == 0);
+}
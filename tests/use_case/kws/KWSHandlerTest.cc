@@ -23,8 +23,21 @@
 #include "Labels.hpp"
 #include "UseCaseHandler.hpp"
 #include "Classifier.hpp"
+#include "KwsClassifier.hpp"
 #include "UseCaseCommonUtils.hpp"
 #include "BufAttributes.hpp"
+#include "AudioUtils.hpp"
+#include "BatchInference.hpp"
+#include "KwsProcessing.hpp"
+
+#include <vector>
+
+extern "C" {
+    /* Baked-in audio clips, also streamed by the audio HAL. */
+    const int16_t* get_sample_data_ptr(const uint32_t idx);
+    uint32_t get_sample_data_size(const uint32_t idx);
+    uint32_t get_sample_n_elements(void);
+}
 
 namespace arm {
     namespace app {
@@ -36,6 +49,66 @@ namespace arm {
     } /* namespace app */
 } /* namespace arm */
 
+/**
+ * @brief   Runs every window of an audio clip through pre-processing, inference and
+ *          post-processing, either one window at a time or batched, and returns the
+ *          unthresholded result of each window.
+ */
+static std::vector<arm::app::kws::KwsResult> RunClip(arm::app::Model& model,
+                                                     const int16_t* audioData,
+                                                     const uint32_t nElements,
+                                                     const bool batchInference)
+{
+    TfLiteTensor* inputTensor  = model.GetInputTensor(0);
+    TfLiteTensor* outputTensor = model.GetOutputTensor(0);
+    TfLiteIntArray* inputShape = model.GetInputShape(0);
+
+    arm::app::KwsPreProcess preProcess{inputTensor,
+        static_cast<size_t>(inputShape->data[arm::app::MicroNetKwsModel::ms_inputColsIdx]),
+        static_cast<size_t>(inputShape->data[arm::app::MicroNetKwsModel::ms_inputRowsIdx]),
+        arm::app::kws::g_FrameLength, arm::app::kws::g_FrameStride};
+
+    arm::app::KwsClassifier classifier;
+    std::vector<std::string> labels;
+    GetLabelsVector(labels);
+    std::vector<arm::app::ClassificationResult> singleInfResult;
+    arm::app::KwsPostProcess postProcess{outputTensor, classifier, labels, singleInfResult};
+
+    std::vector<arm::app::kws::KwsResult> results;
+    auto collectResult = [&](size_t windowIdx) {
+        if (!postProcess.DoPostProcess()) {
+            return false;
+        }
+        results.emplace_back(arm::app::kws::KwsResult(singleInfResult, 0, windowIdx, 0));
+        return true;
+    };
+
+    auto audioDataSlider = arm::app::audio::SlidingWindow<const int16_t>(
+        audioData, nElements, preProcess.m_audioDataWindowSize, preProcess.m_audioDataStride);
+    std::vector<const int16_t*> windows;
+    while (audioDataSlider.HasNext()) {
+        windows.push_back(audioDataSlider.Next());
+    }
+
+    if (batchInference) {
+        arm::app::BatchInference batch{model};
+        REQUIRE(batch.Run(windows.size(),
+                          [&](size_t windowIdx) {
+                              return preProcess.DoPreProcess(windows[windowIdx], windowIdx);
+                          },
+                          collectResult));
+    } else {
+        arm::app::Profiler profiler{"kws"};
+        for (size_t i = 0; i < windows.size(); ++i) {
+            REQUIRE(preProcess.DoPreProcess(windows[i], i));
+            REQUIRE(arm::app::RunInference(model, profiler));
+            REQUIRE(collectResult(i));
+        }
+    }
+    REQUIRE(results.size() == windows.size());
+    return results;
+}
+
 TEST_CASE("Model info")
 {
     /* Model wrapper object. */
@@ -78,11 +151,64 @@ TEST_CASE("Inference run all clips")
     caseContext.Set<int>("frameLength", arm::app::kws::g_FrameLength);  /* 640 sample length for MicroNet. */
     caseContext.Set<int>("frameStride", arm::app::kws::g_FrameStride);  /* 320 sample stride for MicroNet. */
     caseContext.Set<float>("scoreThreshold", 0.7);       /* Normalised score threshold. */
-    arm::app::Classifier classifier;                     /* classifier wrapper object. */
-    caseContext.Set<arm::app::Classifier&>("classifier", classifier);
+    arm::app::KwsClassifier classifier;                  /* classifier wrapper object. */
+    caseContext.Set<arm::app::KwsClassifier&>("classifier", classifier);
+
+    std::vector <std::string> labels;
+    GetLabelsVector(labels);
+    caseContext.Set<const std::vector <std::string>&>("labels", labels);
+    REQUIRE(arm::app::ClassifyAudioHandler(caseContext));
+}
+
+TEST_CASE("Inference run all clips in batch")
+{
+    /* Initialise the HAL and platform. */
+    hal_platform_init();
+
+    /* Model wrapper object. */
+    arm::app::MicroNetKwsModel model;
+
+    /* Load the model. */
+    REQUIRE(model.Init(arm::app::tensorArena,
+                    sizeof(arm::app::tensorArena),
+                    arm::app::kws::GetModelPointer(),
+                    arm::app::kws::GetModelLen()));
+
+    /* Instantiate application context. */
+    arm::app::ApplicationContext caseContext;
+
+    arm::app::Profiler profiler{"kws"};
+    caseContext.Set<arm::app::Profiler&>("profiler", profiler);
+    caseContext.Set<bool>("batchInference", true);
+    caseContext.Set<arm::app::Model&>("model", model);
+    caseContext.Set<int>("frameLength", arm::app::kws::g_FrameLength);  /* 640 sample length for MicroNet. */
+    caseContext.Set<int>("frameStride", arm::app::kws::g_FrameStride);  /* 320 sample stride for MicroNet. */
+    caseContext.Set<float>("scoreThreshold", 0.7);       /* Normalised score threshold. */
+    arm::app::KwsClassifier classifier;                  /* classifier wrapper object. */
+    caseContext.Set<arm::app::KwsClassifier&>("classifier", classifier);
 
     std::vector <std::string> labels;
     GetLabelsVector(labels);
     caseContext.Set<const std::vector <std::string>&>("labels", labels);
     REQUIRE(arm::app::ClassifyAudioHandler(caseContext));
+
+    /* Every clip gives the same results, window by window, batched or not. */
+    REQUIRE(get_sample_n_elements() > 0);
+    for (uint32_t clip = 0; clip < get_sample_n_elements(); ++clip) {
+        const int16_t* audioData = get_sample_data_ptr(clip);
+        const uint32_t nElements = get_sample_data_size(clip);
+        REQUIRE(audioData);
+
+        const auto sequential = RunClip(model, audioData, nElements, false);
+        const auto batched = RunClip(model, audioData, nElements, true);
+        for (size_t i = 0; i < sequential.size(); ++i) {
+            REQUIRE(batched[i].m_inferenceNumber == sequential[i].m_inferenceNumber);
+            REQUIRE(batched[i].m_resultVec.size() == sequential[i].m_resultVec.size());
+            for (size_t j = 0; j < sequential[i].m_resultVec.size(); ++j) {
+                REQUIRE(batched[i].m_resultVec[j].m_labelIdx == sequential[i].m_resultVec[j].m_labelIdx);
+                REQUIRE(batched[i].m_resultVec[j].m_normalisedVal ==
+                        Approx(sequential[i].m_resultVec[j].m_normalisedVal));
+            }
+        }
+    }
 }
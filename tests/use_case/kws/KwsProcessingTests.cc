@@ -0,0 +1,113 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2023 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "KwsProcessing.hpp"
+#include "TensorFlowLiteMicro.hpp"
+
+#include <algorithm>
+#include <catch.hpp>
+#include <vector>
+
+namespace {
+
+    /* Pre-processor writing to its own int8 input tensor. */
+    struct KwsPreProcessFixture {
+        std::vector<int8_t> tensorData;
+        int dims[3];
+        TfLiteTensor tensor;
+        arm::app::KwsPreProcess preProcess;
+
+        KwsPreProcessFixture(int numFeatures, int numFrames, int frameLen, int frameStride):
+            tensorData(numFeatures * numFrames),
+            dims{2, numFrames, numFeatures},
+            tensor(tflite::testing::CreateQuantizedTensor(tensorData.data(),
+                tflite::testing::IntArrayFromInts(dims), 0.5f, 0)),
+            preProcess(&tensor, numFeatures, numFrames, frameLen, frameStride)
+        {}
+    };
+
+    std::vector<int16_t> GenerateAudio(size_t numSamples)
+    {
+        std::vector<int16_t> audio(numSamples);
+        uint32_t state = 12345;
+        for (size_t i = 0; i < numSamples; ++i) {
+            state = state * 1103515245 + 12345;
+            audio[i] = static_cast<int16_t>(((state >> 16) & 0x3FFF) - 0x2000 + (i % 200) * 40);
+        }
+        return audio;
+    }
+
+} /* anonymous namespace */
+
+TEST_CASE("KWS pre-processors with different geometries keep separate caches")
+{
+    /* MicroNet geometry and a smaller, differently strided one. */
+    KwsPreProcessFixture first(10, 49, 640, 320);
+    KwsPreProcessFixture second(13, 25, 512, 256);
+
+    /* References always compute every feature vector. */
+    KwsPreProcessFixture firstRef(10, 49, 640, 320);
+    KwsPreProcessFixture secondRef(13, 25, 512, 256);
+
+    const std::vector<int16_t> audio = GenerateAudio(16000 * 3);
+
+    for (size_t inferenceIdx = 0; inferenceIdx < 4; ++inferenceIdx) {
+        const int16_t* firstWindow = audio.data() + inferenceIdx * first.preProcess.m_audioDataStride;
+        const int16_t* secondWindow = audio.data() + inferenceIdx * second.preProcess.m_audioDataStride;
+        REQUIRE(firstWindow + first.preProcess.m_audioDataWindowSize <= audio.data() + audio.size());
+
+        /* Interleave calls so that a shared cache would be overwritten by the other instance. */
+        REQUIRE(first.preProcess.DoPreProcess(firstWindow, inferenceIdx));
+        REQUIRE(second.preProcess.DoPreProcess(secondWindow, inferenceIdx));
+        REQUIRE(firstRef.preProcess.DoPreProcess(firstWindow, 0));
+        REQUIRE(secondRef.preProcess.DoPreProcess(secondWindow, 0));
+
+        CHECK(first.tensorData == firstRef.tensorData);
+        CHECK(second.tensorData == secondRef.tensorData);
+    }
+}
+
+TEST_CASE("KWS pre-processing reads windows wrapping around an audio ring")
+{
+    KwsPreProcessFixture ringPrep(10, 49, 640, 320);
+    KwsPreProcessFixture contiguousPrep(10, 49, 640, 320);
+
+    const size_t windowSize = ringPrep.preProcess.m_audioDataWindowSize;
+    const size_t stride = ringPrep.preProcess.m_audioDataStride;
+    const std::vector<int16_t> audio = GenerateAudio(windowSize + stride);
+
+    /* Ring of a window plus a stride, followed by a guard mirroring its start. */
+    const size_t ringSize = windowSize + stride;
+    const size_t guard = 640 - 1;
+    std::vector<int16_t> ring(ringSize + guard);
+
+    /* Place the audio so that the second window runs past the end of the ring. */
+    const size_t ringOffset = ringSize - windowSize / 4;
+    for (size_t i = 0; i < audio.size(); ++i) {
+        ring[(ringOffset + i) % ringSize] = audio[i];
+    }
+    std::copy(ring.begin(), ring.begin() + guard, ring.begin() + ringSize);
+
+    ringPrep.preProcess.SetAudioRing(ring.data(), ringSize);
+
+    for (size_t inferenceIdx = 0; inferenceIdx < 2; ++inferenceIdx) {
+        const size_t start = inferenceIdx * stride;
+        REQUIRE(ringPrep.preProcess.DoPreProcess(
+            ring.data() + (ringOffset + start) % ringSize, inferenceIdx));
+        REQUIRE(contiguousPrep.preProcess.DoPreProcess(audio.data() + start, inferenceIdx));
+        CHECK(ringPrep.tensorData == contiguousPrep.tensorData);
+    }
+}
@@ -18,6 +18,7 @@
 
 #include <algorithm>
 #include <catch.hpp>
+#include <cmath>
 #include <limits>
 
 /* First 640 samples from yes.wav. */
@@ -144,4 +145,150 @@ TEST_CASE("MFCC calculation test") {
     {
         TestQuantisedMFCC<int16_t>();
     }
-}
\ No newline at end of file
+
+    SECTION("FP32 into caller owned buffer")
+    {
+        auto mfcc = GetMFCCInstance();
+        std::vector<float> mfccOutput(testWavMfcc.size() + 1, 0.f);
+        REQUIRE(mfcc.MfccCompute(testWav.data(), testWav.size(), mfccOutput.data()));
+        REQUIRE_THAT(std::vector<float>(mfccOutput.begin(), mfccOutput.end() - 1),
+                     Catch::Approx(testWavMfcc).margin(0.0001));
+
+        /* Nothing must be written beyond the number of features. */
+        REQUIRE(mfccOutput.back() == 0.f);
+    }
+
+    SECTION("FP32 into caller owned buffer with stride")
+    {
+        auto mfcc = GetMFCCInstance();
+        constexpr size_t stride = 3;
+        std::vector<float> mfccOutput(testWavMfcc.size() * stride, 0.f);
+        REQUIRE(mfcc.MfccCompute(testWav.data(), testWav.size(), mfccOutput.data(), stride));
+        for (size_t i = 0; i < testWavMfcc.size(); ++i) {
+            REQUIRE(mfccOutput[i * stride] == Approx(testWavMfcc[i]).margin(0.0001));
+        }
+    }
+
+    SECTION("int8_t into caller owned buffer matches vector API")
+    {
+        const float quantScale = 1.1088106632232666;
+        const int quantOffset = 95;
+        auto mfcc = GetMFCCInstance();
+        std::vector<int8_t> expected = mfcc.MfccComputeQuant<int8_t>(testWav, quantScale, quantOffset);
+        std::vector<int8_t> mfccOutput(expected.size());
+        REQUIRE(mfcc.MfccComputeQuant<int8_t>(testWav.data(), testWav.size(), mfccOutput.data(),
+                                              quantScale, quantOffset));
+        REQUIRE(mfccOutput == expected);
+    }
+
+    SECTION("Short input is zero padded")
+    {
+        auto mfcc = GetMFCCInstance();
+        std::vector<int16_t> paddedWav(testWav.begin(), testWav.begin() + testWav.size() / 2);
+        paddedWav.resize(testWav.size(), 0);
+        auto expected = mfcc.MfccCompute(paddedWav);
+
+        std::vector<float> mfccOutput(testWavMfcc.size());
+        REQUIRE(mfcc.MfccCompute(testWav.data(), testWav.size() / 2, mfccOutput.data()));
+        REQUIRE_THAT(mfccOutput, Catch::Approx(expected).margin(0.0001));
+    }
+}
+
+namespace {
+
+    /* Noise plus a tone, with peaks of the given amplitude. */
+    std::vector<int16_t> GenerateFrame(size_t numSamples, int amplitude, float toneStep, uint32_t& state)
+    {
+        std::vector<int16_t> frame(numSamples);
+        for (size_t i = 0; i < numSamples; ++i) {
+            state = state * 1103515245 + 12345;
+            const float noise = (static_cast<float>((state >> 16) & 0xFFFF) - 32768) / 32768;
+            frame[i] = static_cast<int16_t>(amplitude * (0.5f * noise + 0.5f * std::sin(i * toneStep)));
+        }
+        return frame;
+    }
+
+} /* anonymous namespace */
+
+TEST_CASE("MFCC fixed point calculation test") {
+    const int sampFreq = arm::app::audio::MicroNetKwsMFCC::ms_defaultSamplingFreq;
+    const int frameLenSamples = sampFreq * 40 * 0.001;
+    const int numMfccFeats = 10;
+    arm::app::audio::MicroNetKwsMFCC floatMfcc(numMfccFeats, frameLenSamples);
+    arm::app::audio::MicroNetKwsMFCC fixedMfcc(numMfccFeats, frameLenSamples, true);
+
+    SECTION("Golden output")
+    {
+        auto mfccOutput = fixedMfcc.MfccCompute(testWav);
+        REQUIRE_THAT(mfccOutput, Catch::Approx(testWavMfcc).margin(0.001));
+    }
+
+    SECTION("Error bound against floating point")
+    {
+        /* Noise and tone: every mel band within 80 dB of the strongest bin. */
+        uint32_t state = 12345;
+        for (int amplitude : {32767, 4096, 128, 16}) {
+            for (int i = 0; i < 20; ++i) {
+                const auto frame = GenerateFrame(frameLenSamples, amplitude, 0.02f * (i + 1), state);
+                const auto expected = floatMfcc.MfccCompute(frame);
+                const auto mfccOutput = fixedMfcc.MfccCompute(frame);
+                REQUIRE_THAT(mfccOutput, Catch::Approx(expected).margin(0.003));
+            }
+        }
+
+        /* Pure tones in the mel range and DC leave bands 115-140 dB down. */
+        for (int amplitude : {32767, 4096, 100, 16}) {
+            for (float freq : {250.f, 440.f, 1000.f, 2000.f, 3000.f, 3800.f}) {
+                std::vector<int16_t> frame(frameLenSamples);
+                for (int i = 0; i < frameLenSamples; ++i) {
+                    frame[i] = static_cast<int16_t>(amplitude * std::sin(2 * M_PI * freq * i / sampFreq));
+                }
+                REQUIRE_THAT(fixedMfcc.MfccCompute(frame),
+                             Catch::Approx(floatMfcc.MfccCompute(frame)).margin(0.25));
+            }
+        }
+        for (int level : {32767, 1000, 16, 1, -32768}) {
+            const std::vector<int16_t> frame(frameLenSamples, static_cast<int16_t>(level));
+            REQUIRE_THAT(fixedMfcc.MfccCompute(frame),
+                         Catch::Approx(floatMfcc.MfccCompute(frame)).margin(0.06));
+        }
+    }
+
+    SECTION("Silence takes the floating point floor")
+    {
+        const std::vector<int16_t> silence(frameLenSamples, 0);
+        REQUIRE_THAT(fixedMfcc.MfccCompute(silence),
+                     Catch::Approx(floatMfcc.MfccCompute(silence)).margin(0.01));
+    }
+
+    SECTION("Quantised output within one step")
+    {
+        const float quantScale = 1.1088106632232666;
+        const int quantOffset = 95;
+        uint32_t state = 54321;
+        for (int i = 0; i < 20; ++i) {
+            const auto frame = GenerateFrame(frameLenSamples, 2000, 0.03f * (i + 1), state);
+            const auto expected = floatMfcc.MfccComputeQuant<int8_t>(frame, quantScale, quantOffset);
+            const auto mfccOutput = fixedMfcc.MfccComputeQuant<int8_t>(frame, quantScale, quantOffset);
+            for (size_t j = 0; j < expected.size(); ++j) {
+                REQUIRE(std::abs(mfccOutput[j] - expected[j]) <= 1);
+            }
+        }
+
+        /* Saturates like the floating point path. */
+        const auto loud = fixedMfcc.MfccComputeQuant<int8_t>(testWav, 0.05f, 0);
+        const auto loudExpected = floatMfcc.MfccComputeQuant<int8_t>(testWav, 0.05f, 0);
+        REQUIRE(loud == loudExpected);
+    }
+
+    SECTION("Short input is zero padded")
+    {
+        std::vector<int16_t> paddedWav(testWav.begin(), testWav.begin() + testWav.size() / 2);
+        paddedWav.resize(testWav.size(), 0);
+        auto expected = fixedMfcc.MfccCompute(paddedWav);
+
+        std::vector<float> mfccOutput(testWavMfcc.size());
+        REQUIRE(fixedMfcc.MfccCompute(testWav.data(), testWav.size() / 2, mfccOutput.data()));
+        REQUIRE(mfccOutput == expected);
+    }
+}
@@ -17,6 +17,7 @@
 #include "MicroNetKwsModel.hpp"
 #include "Wav2LetterModel.hpp"
 #include "BufAttributes.hpp"
+#include "ArenaPlanner.hpp"
 
 #include <catch.hpp>
 
@@ -73,3 +74,76 @@ TEST_CASE("Init two Models", "[.]")
     REQUIRE(true == model1.IsInited());
     REQUIRE(true == model2.IsInited());
 }
+
+TEST_CASE("Arena planner")
+{
+    /* Several instances of the KWS model stand in for different models. */
+    arm::app::MicroNetKwsModel resident1;
+    arm::app::MicroNetKwsModel resident2;
+    arm::app::MicroNetKwsModel swapped1;
+    arm::app::MicroNetKwsModel swapped2;
+
+    arm::app::ArenaPlanner planner{arm::app::tensorArena,
+                                   sizeof(arm::app::tensorArena),
+                                   sizeof(arm::app::tensorArena) / 2};
+
+    REQUIRE(planner.Register(resident1, "resident1",
+                             arm::app::kws::GetModelPointer(),
+                             arm::app::kws::GetModelLen()));
+    REQUIRE(planner.Register(resident2, "resident2",
+                             arm::app::kws::GetModelPointer(),
+                             arm::app::kws::GetModelLen()));
+    REQUIRE(planner.Register(swapped1, "swapped1",
+                             arm::app::kws::GetModelPointer(),
+                             arm::app::kws::GetModelLen(),
+                             arm::app::ArenaPlacement::Swapped));
+    REQUIRE(planner.Register(swapped2, "swapped2",
+                             arm::app::kws::GetModelPointer(),
+                             arm::app::kws::GetModelLen(),
+                             arm::app::ArenaPlacement::Swapped));
+    REQUIRE_FALSE(planner.Register(resident1, "again",
+                                   arm::app::kws::GetModelPointer(),
+                                   arm::app::kws::GetModelLen()));
+
+    /* Resident models are initialised at registration and share the allocator. */
+    REQUIRE(resident1.IsInited());
+    REQUIRE(resident2.IsInited());
+    REQUIRE(resident1.GetAllocator() == resident2.GetAllocator());
+    REQUIRE_FALSE(swapped1.IsInited());
+
+    /* Each resident model adds persistent memory; the scratch area is shared. */
+    const auto& usage = planner.GetModelUsage();
+    REQUIRE(usage.size() == 4);
+    REQUIRE(usage[0].persistentBytes > 0);
+    REQUIRE(usage[1].persistentBytes > 0);
+    REQUIRE(usage[0].scratchGrowth == usage[0].scratchBytes);
+    REQUIRE(usage[1].scratchGrowth == 0);
+    const size_t residentUsed = planner.GetResidentUsedBytes();
+    REQUIRE(residentUsed < 2 * (usage[0].persistentBytes + usage[0].scratchBytes));
+
+    /* Swapped models take turns in the swap region. */
+    REQUIRE(planner.Load(swapped1));
+    REQUIRE(swapped1.IsInited());
+    REQUIRE(swapped1.RunInference());
+    const size_t swapPeak = planner.GetSwapPeakBytes();
+    REQUIRE(swapPeak > 0);
+
+    REQUIRE(planner.Load(swapped2));
+    REQUIRE_FALSE(swapped1.IsInited());
+    REQUIRE(swapped2.IsInited());
+    REQUIRE(swapped2.RunInference());
+    REQUIRE(planner.GetSwapPeakBytes() == swapPeak);
+
+    /* A model loaded again gets the same memory. */
+    planner.Unload(swapped2);
+    REQUIRE_FALSE(swapped2.IsInited());
+    REQUIRE(planner.Load(swapped1));
+    REQUIRE(swapped1.RunInference());
+
+    /* Swapping does not touch the resident region. */
+    REQUIRE(planner.GetResidentUsedBytes() == residentUsed);
+    REQUIRE(resident1.RunInference());
+    REQUIRE(resident2.RunInference());
+
+    planner.PrintReport();
+}
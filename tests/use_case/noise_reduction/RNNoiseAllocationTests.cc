@@ -0,0 +1,177 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "BufAttributes.hpp"
+#include "RNNoiseFeatureProcessor.hpp"
+#include "RNNoiseModel.hpp"
+#include "TensorFlowLiteMicro.hpp"
+
+#include <catch.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+namespace arm {
+namespace app {
+    static uint8_t tensorArena[ACTIVATION_BUF_SZ] ACTIVATION_BUF_ATTRIBUTE;
+    namespace rnn {
+        extern uint8_t* GetModelPointer();
+        extern size_t GetModelLen();
+    } /* namespace rnn */
+} /* namespace app */
+} /* namespace arm */
+
+namespace {
+
+    /* Heap allocations made while counting is enabled. */
+    bool countAllocations = false;
+    size_t numAllocations = 0;
+
+    void* CountedAlloc(std::size_t size)
+    {
+        if (countAllocations) {
+            ++numAllocations;
+        }
+        void* ptr = std::malloc(size ? size : 1);
+        if (!ptr) {
+            throw std::bad_alloc();
+        }
+        return ptr;
+    }
+
+    /* Deterministic speech-like frame: a tone with noise and occasional near silence. */
+    void FillFrame(std::vector<float>& frame, uint32_t frameIdx, uint32_t& seed)
+    {
+        const float level = frameIdx % 7 ? 1.f : 0.01f;
+        for (size_t i = 0; i < frame.size(); ++i) {
+            seed = seed * 1103515245 + 12345;
+            const float noise = static_cast<float>((seed >> 16) % 2000) - 1000.f;
+            frame[i] = 3000.f * level * std::sin(0.05f * (frameIdx * frame.size() + i)) + noise;
+        }
+    }
+
+} /* anonymous namespace */
+
+void* operator new(std::size_t size)
+{
+    return CountedAlloc(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return CountedAlloc(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+TEST_CASE("RNNoise feature processing does not allocate after construction", "[RNNoise]")
+{
+    constexpr uint32_t frameSize = arm::app::rnn::RNNoiseFeatureProcessor::FRAME_SIZE;
+    constexpr uint32_t numFrames = 16;
+
+    arm::app::rnn::RNNoiseFeatureProcessor rnnoiseProcessor;
+    arm::app::rnn::FrameFeatures features;
+    std::vector<float> frame(frameSize);
+    std::vector<float> gains(arm::app::rnn::RNNoiseFeatureProcessor::NB_BANDS, 0.5f);
+    std::vector<float> denoised(frameSize);
+    uint32_t seed = 1;
+
+    numAllocations = 0;
+    countAllocations = true;
+    for (uint32_t i = 0; i < numFrames; ++i) {
+        FillFrame(frame, i, seed);
+        rnnoiseProcessor.PreprocessFrame(frame.data(), frame.size(), features);
+        rnnoiseProcessor.PostProcessFrame(gains, features, denoised);
+    }
+    countAllocations = false;
+
+    REQUIRE(numAllocations == 0);
+}
+
+TEST_CASE("RNNoise GRU state copy does not allocate after the first frame", "[RNNoise]")
+{
+    arm::app::RNNoiseModel model{};
+    REQUIRE(model.Init(arm::app::tensorArena,
+                       sizeof(arm::app::tensorArena),
+                       arm::app::rnn::GetModelPointer(),
+                       arm::app::rnn::GetModelLen()));
+
+    model.ResetGruState();
+    REQUIRE(model.RunInference());
+    REQUIRE(model.CopyGruStates());
+
+    numAllocations = 0;
+    countAllocations = true;
+    bool copied = true;
+    for (int i = 0; i < 16; ++i) {
+        copied = model.RunInference() && model.CopyGruStates() && copied;
+    }
+    countAllocations = false;
+
+    REQUIRE(copied);
+    REQUIRE(numAllocations == 0);
+}
+
+TEST_CASE("RNNoise feature processing per frame latency", "[.benchmark]")
+{
+    constexpr uint32_t frameSize = arm::app::rnn::RNNoiseFeatureProcessor::FRAME_SIZE;
+    constexpr uint32_t numFrames = 400;
+
+    arm::app::rnn::RNNoiseFeatureProcessor rnnoiseProcessor;
+    arm::app::rnn::FrameFeatures features;
+    std::vector<float> frame(frameSize);
+    std::vector<float> gains(arm::app::rnn::RNNoiseFeatureProcessor::NB_BANDS, 0.5f);
+    std::vector<float> denoised(frameSize);
+    uint32_t seed = 1;
+
+    double preprocessTime = 0;
+    double postprocessTime = 0;
+    for (uint32_t i = 0; i < numFrames; ++i) {
+        FillFrame(frame, i, seed);
+        auto start = std::chrono::steady_clock::now();
+        rnnoiseProcessor.PreprocessFrame(frame.data(), frame.size(), features);
+        auto mid = std::chrono::steady_clock::now();
+        rnnoiseProcessor.PostProcessFrame(gains, features, denoised);
+        auto end = std::chrono::steady_clock::now();
+        preprocessTime += std::chrono::duration<double, std::micro>(mid - start).count();
+        postprocessTime += std::chrono::duration<double, std::micro>(end - mid).count();
+    }
+
+    printf("RNNoise per frame: pre-processing %.1f us, post-processing %.1f us\n",
+           preprocessTime / numFrames, postprocessTime / numFrames);
+    CHECK(preprocessTime > 0);
+}
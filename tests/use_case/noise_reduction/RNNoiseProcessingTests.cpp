@@ -14,8 +14,11 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "PlatformMath.hpp"
 #include "RNNoiseFeatureProcessor.hpp"
 #include <catch.hpp>
+#include <chrono>
+#include <cstdio>
 #include <limits>
 
 
@@ -212,10 +215,10 @@ TEST_CASE("RNNoise preprocessing calculation test",  "[RNNoise]")
         arm::app::rnn::FrameFeatures features;
 
         rnnoiseProcessor.PreprocessFrame(testWav0.data(), testWav0.size(), features);
-        REQUIRE_THAT( features.m_featuresVec,
+        REQUIRE_THAT( std::vector<float>(features.m_featuresVec.begin(), features.m_featuresVec.end()),
             Catch::Approx( RNNoisePreProcessGolden0 ).margin(0.1));
         rnnoiseProcessor.PreprocessFrame(testWav1.data(), testWav1.size(), features);
-        REQUIRE_THAT( features.m_featuresVec,
+        REQUIRE_THAT( std::vector<float>(features.m_featuresVec.begin(), features.m_featuresVec.end()),
             Catch::Approx( RNNoisePreProcessGolden1 ).margin(0.1));
     }
 }
@@ -237,4 +240,45 @@ TEST_CASE("RNNoise postprocessing test", "[RNNoise]")
     }
 
     REQUIRE_THAT( denoisedRoundedInt, Catch::Approx( RNNoisePostProcessDenoiseGolden0 ).margin(1));
-}
\ No newline at end of file
+}
+
+TEST_CASE("RNNoise pitch cross-correlation benchmark", "[.benchmark]")
+{
+    /* Coarse pitch search shape: a quarter of the pitch frame against 157 lags. */
+    constexpr size_t len = arm::app::rnn::RNNoiseFeatureProcessor::PITCH_FRAME_SIZE >> 2;
+    constexpr size_t numLags = (arm::app::rnn::RNNoiseFeatureProcessor::PITCH_MAX_PERIOD -
+                                3 * arm::app::rnn::RNNoiseFeatureProcessor::PITCH_MIN_PERIOD) >> 2;
+    constexpr int iterations = 200;
+
+    for (const auto* wav : {&testWav0, &testWav1}) {
+        REQUIRE(wav->size() >= len + numLags - 1);
+        const float* x = wav->data() + numLags - 1;
+        const float* y = wav->data();
+        std::vector<float> xCorr(numLags);
+        std::vector<float> xCorrRef(numLags);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            for (size_t k = 0; k < numLags; ++k) {
+                float sum = 0;
+                for (size_t j = 0; j < len; ++j) {
+                    sum += x[j] * y[k + j];
+                }
+                xCorrRef[k] = sum;
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+        const double refTime = std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            arm::app::math::MathUtils::CrossCorrelationF32(x, y, len, xCorr.data(), numLags);
+        }
+        end = std::chrono::steady_clock::now();
+        const double kernelTime = std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+
+        printf("Pitch cross-correlation, %zu lags of %zu: lag at a time %.1f us, blocked %.1f us\n",
+               numLags, len, refTime, kernelTime);
+        REQUIRE_THAT(xCorr, Catch::Approx(xCorrRef).epsilon(1e-5));
+    }
+}
@@ -0,0 +1,234 @@
+/*
+ * SPDX-FileCopyrightText: Copyright 2024 Arm Limited and/or its affiliates <open-source-office@arm.com>
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DetectorPostProcessing.hpp"
+#include "PlatformMath.hpp"
+
+#include <algorithm>
+#include <catch.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+    const float testAnchor1[] = {38, 77, 47, 97, 61, 126};
+    const float testAnchor2[] = {14, 26, 19, 37, 28, 55};
+    const float testAnchor3[] = {5, 9, 8, 14, 11, 19};
+
+    /* Network with random quantised outputs; branches at strides 32, 16 and 8. */
+    struct TestNetwork {
+        std::vector<std::vector<int8_t>> outputs;
+        arm::app::object_detection::Network net;
+
+        TestNetwork(int inputSize, int numClasses, int topN, int objectnessBias)
+        {
+            const float* anchors[] = {testAnchor1, testAnchor2, testAnchor3};
+            const int strides[] = {32, 16, 8};
+            uint32_t state = 12345;
+
+            net = arm::app::object_detection::Network{inputSize, inputSize, numClasses, {}, topN};
+            for (size_t i = 0; i < 3; ++i) {
+                const int resolution = inputSize / strides[i];
+                const size_t anchorSize = numClasses + 5;
+                outputs.emplace_back(resolution * resolution * 3 * anchorSize);
+
+                auto& output = outputs.back();
+                for (size_t j = 0; j < output.size(); ++j) {
+                    state = state * 1103515245 + 12345;
+                    int value = static_cast<int>((state >> 16) & 0xFF) - 128;
+                    if (j % anchorSize == 4) {
+                        value = std::min(127, std::max(-128, value / 4 + objectnessBias));
+                    }
+                    output[j] = static_cast<int8_t>(value);
+                }
+
+                net.branches.push_back(arm::app::object_detection::Branch{
+                    resolution, 3, anchors[i], output.data(),
+                    0.1f + 0.02f * i, static_cast<int>(i) * 3 - 2, output.size()});
+            }
+        }
+    };
+
+    /* Reference decoder: dequantises every anchor, keeps all boxes passing the threshold. */
+    void ReferenceDecode(const arm::app::object_detection::Network& net, int imageWidth, int imageHeight,
+                         float threshold, std::forward_list<arm::app::image::Detection>& detections)
+    {
+        using arm::app::math::MathUtils;
+        const int numClasses = net.numClasses;
+        for (const auto& branch : net.branches) {
+            const int width = branch.resolution;
+            const int height = branch.resolution;
+            const int channel = branch.numBox * (5 + numClasses);
+            auto dequantise = [&branch](int8_t value) {
+                return (static_cast<float>(value) - branch.zeroPoint) * branch.scale;
+            };
+
+            for (int h = 0; h < height; h++) {
+                for (int w = 0; w < width; w++) {
+                    for (int anc = 0; anc < branch.numBox; anc++) {
+                        const int8_t* output = branch.modelOutput + h * width * channel + w * channel +
+                                               anc * (numClasses + 5);
+                        const float objectness = MathUtils::SigmoidF32(dequantise(output[4]));
+                        if (objectness <= threshold) {
+                            continue;
+                        }
+                        arm::app::image::Detection det;
+                        det.objectness = objectness;
+                        det.bbox.x = (MathUtils::SigmoidF32(dequantise(output[0])) + w) / width * imageWidth;
+                        det.bbox.y = (MathUtils::SigmoidF32(dequantise(output[1])) + h) / height * imageHeight;
+                        det.bbox.w = std::exp(dequantise(output[2])) * branch.anchor[anc * 2] /
+                                     net.inputWidth * imageWidth;
+                        det.bbox.h = std::exp(dequantise(output[3])) * branch.anchor[anc * 2 + 1] /
+                                     net.inputHeight * imageHeight;
+                        for (int s = 0; s < numClasses; s++) {
+                            const float sig = MathUtils::SigmoidF32(dequantise(output[5 + s])) * objectness;
+                            det.prob.emplace_back(sig > threshold ? sig : 0);
+                        }
+                        detections.emplace_front(det);
+                    }
+                }
+            }
+        }
+    }
+
+    std::vector<arm::app::image::Detection> ToVector(const std::forward_list<arm::app::image::Detection>& list)
+    {
+        return std::vector<arm::app::image::Detection>(list.begin(), list.end());
+    }
+
+} /* anonymous namespace */
+
+TEST_CASE("YOLO decoder matches full dequantisation")
+{
+    const float threshold = 0.5f;
+    TestNetwork network(192, 3, 0, -10);
+    arm::app::object_detection::YoloDecoder decoder(network.net, threshold);
+
+    std::forward_list<arm::app::image::Detection> decoded;
+    std::forward_list<arm::app::image::Detection> expected;
+    decoder.Decode(network.net, 640, 480, decoded);
+    ReferenceDecode(network.net, 640, 480, threshold, expected);
+
+    const auto decodedVec = ToVector(decoded);
+    const auto expectedVec = ToVector(expected);
+    REQUIRE(!expectedVec.empty());
+    REQUIRE(decodedVec.size() == expectedVec.size());
+    CHECK(decoder.GetNumCandidates() == expectedVec.size());
+
+    for (size_t i = 0; i < decodedVec.size(); ++i) {
+        REQUIRE(decodedVec[i].objectness == expectedVec[i].objectness);
+        REQUIRE(decodedVec[i].bbox.x == expectedVec[i].bbox.x);
+        REQUIRE(decodedVec[i].bbox.y == expectedVec[i].bbox.y);
+        REQUIRE(decodedVec[i].bbox.w == expectedVec[i].bbox.w);
+        REQUIRE(decodedVec[i].bbox.h == expectedVec[i].bbox.h);
+        REQUIRE(decodedVec[i].prob == expectedVec[i].prob);
+    }
+
+    /* Box buffer for NMS: one entry per class above the threshold, in the same order. */
+    arm::app::image::NmsBoxes boxes;
+    decoder.Decode(network.net, 640, 480, boxes);
+    size_t boxIdx = 0;
+    for (const auto& det : expectedVec) {
+        for (int c = 0; c < network.net.numClasses; ++c) {
+            if (det.prob[c] > 0) {
+                REQUIRE(boxIdx < boxes.Size());
+                REQUIRE(boxes.classId[boxIdx] == c);
+                REQUIRE(boxes.score[boxIdx] == det.prob[c]);
+                REQUIRE(boxes.x0[boxIdx] == det.bbox.x - det.bbox.w/2);
+                REQUIRE(boxes.area[boxIdx] == det.bbox.w * det.bbox.h);
+                ++boxIdx;
+            }
+        }
+    }
+    CHECK(boxIdx == boxes.Size());
+}
+
+TEST_CASE("YOLO decoder objectness cutoff")
+{
+    TestNetwork network(96, 1, 0, 0);
+
+    for (float threshold : {0.0f, 0.3f, 0.5f, 0.73f, 0.999f, 1.0f}) {
+        arm::app::object_detection::YoloDecoder decoder(network.net, threshold);
+        std::forward_list<arm::app::image::Detection> decoded;
+        std::forward_list<arm::app::image::Detection> expected;
+        decoder.Decode(network.net, 96, 96, decoded);
+        ReferenceDecode(network.net, 96, 96, threshold, expected);
+        CHECK(ToVector(decoded).size() == ToVector(expected).size());
+    }
+}
+
+TEST_CASE("YOLO decoder keeps the top N candidates")
+{
+    const float threshold = 0.3f;
+    const int topN = 25;
+    TestNetwork network(320, 2, topN, 20);
+    arm::app::object_detection::YoloDecoder decoder(network.net, threshold);
+
+    std::forward_list<arm::app::image::Detection> decoded;
+    std::forward_list<arm::app::image::Detection> expected;
+    decoder.Decode(network.net, 320, 320, decoded);
+    ReferenceDecode(network.net, 320, 320, threshold, expected);
+
+    auto decodedVec = ToVector(decoded);
+    auto expectedVec = ToVector(expected);
+    REQUIRE(expectedVec.size() > static_cast<size_t>(topN));
+    REQUIRE(decodedVec.size() == static_cast<size_t>(topN));
+    CHECK(decoder.GetNumCandidates() == expectedVec.size());
+
+    /* Same objectness values as the strongest boxes; ties may pick different boxes. */
+    auto byObjectness = [](const arm::app::image::Detection& a, const arm::app::image::Detection& b) {
+        return a.objectness > b.objectness;
+    };
+    std::stable_sort(decodedVec.begin(), decodedVec.end(), byObjectness);
+    std::stable_sort(expectedVec.begin(), expectedVec.end(), byObjectness);
+    for (int i = 0; i < topN; ++i) {
+        REQUIRE(decodedVec[i].objectness == expectedVec[i].objectness);
+    }
+}
+
+TEST_CASE("YOLO decoder benchmark on dense outputs", "[.benchmark]")
+{
+    const float threshold = 0.5f;
+    const int iterations = 20;
+
+    for (int topN : {0, 100}) {
+        TestNetwork network(416, 1, topN, 30);
+        arm::app::object_detection::YoloDecoder decoder(network.net, threshold);
+
+        std::forward_list<arm::app::image::Detection> detections;
+        double decoderTime = 0;
+        double referenceTime = 0;
+        for (int i = 0; i < iterations; ++i) {
+            detections.clear();
+            auto start = std::chrono::steady_clock::now();
+            decoder.Decode(network.net, 416, 416, detections);
+            auto end = std::chrono::steady_clock::now();
+            decoderTime += std::chrono::duration<double, std::micro>(end - start).count();
+
+            detections.clear();
+            start = std::chrono::steady_clock::now();
+            ReferenceDecode(network.net, 416, 416, threshold, detections);
+            end = std::chrono::steady_clock::now();
+            referenceTime += std::chrono::duration<double, std::micro>(end - start).count();
+        }
+
+        printf("YOLO decode, %zu candidates, top N %d: full dequantisation %.1f us, decoder %.1f us\n",
+               decoder.GetNumCandidates(), topN, referenceTime / iterations, decoderTime / iterations);
+        CHECK(decoder.GetNumCandidates() > 1000);
+    }
+}